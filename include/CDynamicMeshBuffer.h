@@ -128,7 +128,9 @@ namespace scene
 
 			const u32 vertexCount = getVertexCount();
 
-			VertexBuffer->reallocate(vertexCount+numVertices, false);
+			// grow by at least the current size, so many appends take linear time
+			if (vertexCount+numVertices > VertexBuffer->allocated_size())
+				VertexBuffer->reallocate(core::max_(vertexCount+numVertices, VertexBuffer->allocated_size()*2), false);
 			if ( vertexType == getVertexType() )
 			{
 				const irr::u32 typeSize = getVertexPitchFromType(vertexType);
@@ -174,7 +176,8 @@ namespace scene
 				}
 			}
 
-			IndexBuffer->reallocate(getIndexCount()+numIndices, false);
+			if (getIndexCount()+numIndices > IndexBuffer->allocated_size())
+				IndexBuffer->reallocate(core::max_(getIndexCount()+numIndices, IndexBuffer->allocated_size()*2), false);
 			switch ( indexType )
 			{
 				case video::EIT_16BIT:
@@ -78,12 +78,24 @@ namespace scene
 		//! Quake3 Shader Scene Node
 		ESNT_Q3SHADER_SCENE_NODE  = MAKE_IRR_ID('q','3','s','h'),
 
+		//! Quake3 Level Scene Node ( BSP and PVS culled level geometry )
+		ESNT_Q3_LEVEL  = MAKE_IRR_ID('q','3','l','v'),
+
 		//! Quake3 Model Scene Node ( has tag to link to )
 		ESNT_MD3_SCENE_NODE  = MAKE_IRR_ID('m','d','3','_'),
 
 		//! Volume Light Scene Node
 		ESNT_VOLUME_LIGHT  = MAKE_IRR_ID('v','o','l','l'),
 
+		//! Instanced Mesh Scene Node
+		ESNT_INSTANCED_MESH = MAKE_IRR_ID('i','m','s','h'),
+
+		//! Static Batch Scene Node
+		ESNT_STATIC_BATCH  = MAKE_IRR_ID('s','b','a','t'),
+
+		//! Level Of Detail Mesh Scene Node
+		ESNT_LOD_MESH      = MAKE_IRR_ID('l','o','d','m'),
+
 		//! Maya Camera Scene Node
 		/** Legacy, for loading version <= 1.4.x .irr files */
 		ESNT_CAMERA_MAYA    = MAKE_IRR_ID('c','a','m','M'),
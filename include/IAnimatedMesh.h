@@ -51,7 +51,13 @@ namespace scene
 		outside of this loop.
 		If startFrameLoop and endFrameLoop are both -1, they are ignored.
 		\param endFrameLoop: see startFrameLoop.
-		\return Returns the animated mesh based on a detail level. */
+		\return Returns the animated mesh based on a detail level.
+		The returned mesh is owned by the animated mesh and is valid as
+		long as the animated mesh is, don't drop it. Meshes interpolating
+		key frames (.MD2, .MD3) may return the same mesh again for
+		another frame later, its vertices are overwritten then. Copy the
+		mesh, e.g. with IMeshManipulator::createMeshCopy(), to keep a
+		frame. */
 		virtual IMesh* getMesh(s32 frame, s32 detailLevel=255, s32 startFrameLoop=-1, s32 endFrameLoop=-1) = 0;
 
 		//! Returns the type of the animated mesh.
@@ -30,7 +30,7 @@ public:
 		: Parent(0), RelativeRect(rectangle), AbsoluteRect(rectangle),
 		AbsoluteClippingRect(rectangle), DesiredRect(rectangle),
 		MaxSize(0,0), MinSize(1,1), IsVisible(true), IsEnabled(true),
-		IsSubElement(false), NoClip(false), ID(id), IsTabStop(false), TabOrder(-1), IsTabGroup(false),
+		IsSubElement(false), NoClip(false), IsRetained(false), IsDirty(true), ID(id), IsTabStop(false), TabOrder(-1), IsTabGroup(false),
 		AlignLeft(EGUIA_UPPERLEFT), AlignRight(EGUIA_UPPERLEFT), AlignTop(EGUIA_UPPERLEFT), AlignBottom(EGUIA_UPPERLEFT),
 		Environment(environment), Type(type)
 	{
@@ -311,6 +311,7 @@ public:
 		for (; it != Children.end(); ++it)
 			if ((*it) == child)
 			{
+				markDirty();
 				(*it)->Parent = 0;
 				(*it)->drop();
 				Children.erase(it);
@@ -334,7 +335,12 @@ public:
 		{
 			core::list<IGUIElement*>::Iterator it = Children.begin();
 			for (; it != Children.end(); ++it)
-				(*it)->draw();
+			{
+				if ((*it)->isRetained() && Environment)
+					Environment->drawRetainedElement(*it);
+				else
+					(*it)->draw();
+			}
 		}
 	}
 
@@ -381,10 +387,72 @@ public:
 	//! Sets the visible state of this element.
 	virtual void setVisible(bool visible)
 	{
+		if (IsVisible != visible)
+			markDirty();
 		IsVisible = visible;
 	}
 
 
+	//! Sets whether this element and its children are drawn from a cached image.
+	/** A retained element is drawn into a render target texture only when
+	it or one of its children is marked dirty. In all other frames the
+	cached image is drawn instead, which saves most of the drawing cost of
+	large elements like tables or tree views which rarely change.
+	The cache has the size of the screen, so use it for a few large
+	elements and not for many small ones. Translucent parts are blended
+	twice, so retained elements should be opaque. Drivers without render
+	target support draw the element directly.
+	\param retained True to cache the drawing of this element. */
+	void setRetained(bool retained)
+	{
+		IsRetained = retained;
+		markDirty();
+	}
+
+
+	//! Returns true if this element is drawn from a cached image
+	bool isRetained() const
+	{
+		return IsRetained;
+	}
+
+
+	//! Marks the element as changed, so retained parents redraw it.
+	/** Changes by the methods of IGUIElement and the setters of the
+	engine's gui elements, user input, focus and hover changes mark the
+	affected elements automatically. Call this after changing what an
+	element inside a retained element draws in other ways, for example
+	after changing the rows of a table data source. */
+	void markDirty()
+	{
+		// parents of dirty elements are always dirty
+		IGUIElement* element = this;
+		while (element && !element->IsDirty)
+		{
+			element->IsDirty = true;
+			element = element->Parent;
+		}
+	}
+
+
+	//! Returns true if the element or one of its children changed since it was last drawn into a cache.
+	bool isDirty() const
+	{
+		return IsDirty;
+	}
+
+
+	//! Marks the element and its children as unchanged.
+	/** Only used by the GUI environment before it redraws a retained element. */
+	void clearDirty()
+	{
+		IsDirty = false;
+		core::list<IGUIElement*>::Iterator it = Children.begin();
+		for (; it != Children.end(); ++it)
+			(*it)->clearDirty();
+	}
+
+
 	//! Returns true if this element was created as part of its parent control
 	virtual bool isSubElement() const
 	{
@@ -499,6 +567,8 @@ public:
 	//! Sets the enabled state of this element.
 	virtual void setEnabled(bool enabled)
 	{
+		if (IsEnabled != enabled)
+			markDirty();
 		IsEnabled = enabled;
 	}
 
@@ -506,6 +576,7 @@ public:
 	//! Sets the new caption of this element.
 	virtual void setText(const wchar_t* text)
 	{
+		markDirty();
 		Text = text;
 	}
 
@@ -565,6 +636,7 @@ public:
 				{
 					Children.erase(it);
 					Children.push_back(element);
+					markDirty();
 				}
 				return true;
 			}
@@ -587,6 +659,7 @@ public:
 			{
 				Children.erase(it);
 				Children.push_front(child);
+				markDirty();
 				return true;
 			}
 		}
@@ -858,12 +931,15 @@ protected:
 			child->LastParentRect = getAbsolutePosition();
 			child->Parent = this;
 			Children.push_back(child);
+			markDirty();
 		}
 	}
 
 	// not virtual because needed in constructor
 	void recalculateAbsolutePosition(bool recursive)
 	{
+		const core::rect<s32> oldAbsoluteRect(AbsoluteRect);
+		const core::rect<s32> oldAbsoluteClippingRect(AbsoluteClippingRect);
 		core::rect<s32> parentAbsolute(0,0,0,0);
 		core::rect<s32> parentAbsoluteClip;
 		f32 fw=0.f, fh=0.f;
@@ -979,6 +1055,9 @@ protected:
 
 		LastParentRect = parentAbsolute;
 
+		if (AbsoluteRect != oldAbsoluteRect || AbsoluteClippingRect != oldAbsoluteClippingRect)
+			markDirty();
+
 		if ( recursive )
 		{
 			// update all children
@@ -1032,6 +1111,12 @@ protected:
 	//! does this element ignore its parent's clipping rectangle?
 	bool NoClip;
 
+	//! is drawn from a cached image?
+	bool IsRetained;
+
+	//! changed since it was last drawn into a cache?
+	bool IsDirty;
+
 	//! caption
 	core::stringw Text;
 
@@ -78,6 +78,13 @@ public:
 	            Can be set to false to control that size yourself, p.E when not the full size should be used for UI. */
 	virtual void drawAll(bool useScreenSize=true) = 0;
 
+	//! Draws an element from its cached image, redraws the cache first if the element is dirty.
+	/** Called by IGUIElement::draw() for children which are retained, see
+	IGUIElement::setRetained(). Custom elements which draw their children
+	themselves should call it for retained children as well.
+	\param element The element to draw. */
+	virtual void drawRetainedElement(IGUIElement* element) = 0;
+
 	//! Sets the focus to an element.
 	/** Causes a EGET_ELEMENT_FOCUS_LOST event followed by a
 	EGET_ELEMENT_FOCUSED event. If someone absorbed either of the events,
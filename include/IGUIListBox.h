@@ -36,6 +36,30 @@ namespace gui
 	};
 
 
+	//! Provides the items of a list box which does not store them itself.
+	/** See IGUIListBox::setDataSource(). The list box only asks for the
+	items in view, so it can show millions of items without memory per item
+	and with a drawing time independent of the item count. */
+	class IGUIListBoxDataSource : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Returns the number of items.
+		/** Called once per frame, the list box updates its scrollbar when the value changes. */
+		virtual u32 getItemCount() const = 0;
+
+		//! Returns the text of an item.
+		/** \return Text which stays valid until the next call, or 0 for an empty item. */
+		virtual const wchar_t* getItemText(u32 index) = 0;
+
+		//! Returns the sprite index of the icon of an item, or -1 for no icon.
+		virtual s32 getItemIcon(u32 index)
+		{
+			return -1;
+		}
+	};
+
+
 	//! Default list box GUI element.
 	/** \par This element can create the following events of type EGUI_EVENT_TYPE:
 	\li EGET_LISTBOX_CHANGED
@@ -148,6 +172,17 @@ namespace gui
 		/** This is the override font when one is set and the
 		font of the skin otherwise. */
 		virtual IGUIFont* getActiveFont() const = 0;
+
+		//! Get the items from a data source instead of the items stored in the list box.
+		/** While a data source is set, getItemCount(), getListItem() and
+		getIcon() return the values of the data source. The stored items are
+		kept, but not drawn. Item override colors and selecting items by typing
+		their first letters are only supported for stored items.
+		\param source The data source, or 0 to use the stored items again. */
+		virtual void setDataSource(IGUIListBoxDataSource* source) = 0;
+
+		//! Returns the data source, or 0 if the stored items are used.
+		virtual IGUIListBoxDataSource* getDataSource() const = 0;
 };
 
 
@@ -80,6 +80,31 @@ namespace gui
 		EGTDF_COUNT
 	};
 
+	//! Provides the rows of a table which does not store them itself.
+	/** See IGUITable::setDataSource(). The table only asks for the cells
+	of the rows in view, so it can show millions of rows without
+	memory per row and with a drawing time independent of the row count. */
+	class IGUITableDataSource : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Returns the number of rows.
+		/** Called once per frame, the table updates its scrollbars when the value changes. */
+		virtual u32 getRowCount() const = 0;
+
+		//! Returns the text of a cell.
+		/** \return Text which stays valid until the next call, or 0 for an empty cell. */
+		virtual const wchar_t* getCellText(u32 rowIndex, u32 columnIndex) = 0;
+
+		//! Returns the text color of a cell.
+		/** \param color Receives the color.
+		\return True if color should be used, false to use the skin color. */
+		virtual bool getCellColor(u32 rowIndex, u32 columnIndex, video::SColor& color)
+		{
+			return false;
+		}
+	};
+
 	//! Default list box GUI element.
 	/** \par This element can create the following events of type EGUI_EVENT_TYPE:
 	\li EGET_TABLE_CHANGED
@@ -164,7 +189,8 @@ namespace gui
 		/** You need to explicitly tell the table to re order the rows
 		when a new row is added or the cells data is changed. This
 		makes the system more flexible and doesn't make you pay the
-		cost of ordering when adding a lot of rows.
+		cost of ordering when adding a lot of rows. Does nothing while
+		a data source is set, see setDataSource().
 		\param columnIndex: When set to -1 the active column is used.
 		\param mode Ordering mode of the rows. */
 		virtual void orderRows(s32 columnIndex=-1, EGUI_ORDERING_MODE mode=EGOM_NONE) = 0;
@@ -225,6 +251,17 @@ namespace gui
 		//! Checks if background drawing is enabled
 		/** \return true if background drawing is enabled, false otherwise */
 		virtual bool isDrawBackgroundEnabled() const = 0;
+
+		//! Get the rows from a data source instead of the rows stored in the table.
+		/** While a data source is set, getRowCount() and getCellText()
+		return the values of the data source. The stored rows are kept, but
+		neither drawn nor ordered. Ordering has to be done by the data source,
+		use EGCO_CUSTOM column ordering to receive the header clicks.
+		\param source The data source, or 0 to use the stored rows again. */
+		virtual void setDataSource(IGUITableDataSource* source) = 0;
+
+		//! Returns the data source, or 0 if the stored rows are used.
+		virtual IGUITableDataSource* getDataSource() const = 0;
 	};
 
 
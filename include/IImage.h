@@ -16,6 +16,22 @@ namespace irr
 namespace video
 {
 
+//! Filters for resampling images with IImage::copyToScalingFiltered
+enum E_RESAMPLE_FILTER
+{
+	//! Average of all covered pixels
+	ERF_BOX = 0,
+
+	//! Linear interpolation (tent filter)
+	ERF_BILINEAR,
+
+	//! Cubic interpolation (Catmull-Rom spline). Sharper than bilinear.
+	ERF_BICUBIC,
+
+	//! Windowed sinc filter with 3 lobes. Sharpest, but slowest.
+	ERF_LANCZOS3
+};
+
 //! Interface for software image data.
 /** Image loaders create these images from files. IVideoDrivers convert
 these images into their (hardware) textures.
@@ -366,6 +382,17 @@ public:
 	/**	NOTE: mipmaps are ignored */
 	virtual void copyToScalingBoxFilter(IImage* target, s32 bias = 0, bool blend = false) = 0;
 
+	//! Copies this surface into another, resampling it to fit the target with a filter
+	/** Works for up- and downscaling. When downscaling, the filter is widened
+	to cover all source pixels, so there is no aliasing. Colors are filtered
+	with premultiplied alpha, so transparent pixels don't bleed into the result.
+	The filter is separable: each source row is filtered once, so this is
+	much faster than copyToScalingBoxFilter for large downscales.
+	NOTE: mipmaps are ignored
+	\param target Image receiving the result. Supports the same formats as copyToScaling.
+	\param filter Filter used for the resampling. */
+	virtual void copyToScalingFiltered(IImage* target, E_RESAMPLE_FILTER filter = ERF_BILINEAR) = 0;
+
 	//! Flips (mirrors) the image in one or two directions
 	/** \param topBottom Flip around central x-axis (vertical flipping)
 	\param leftRight Flip around central y-axis (typical mirror, horizontal flipping) */
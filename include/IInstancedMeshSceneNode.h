@@ -0,0 +1,77 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED
+#define IRR_I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class IMesh;
+
+//! A scene node drawing many copies (instances) of a static mesh
+/** Useful for forests, crowds or debris. Each instance has its own
+transformation relative to the node and a color multiplied with the vertex
+colors. Instances outside the view frustum are culled in one pass over all
+instances when the automatic culling of the node is not EAC_OFF. The
+remaining instances of each meshbuffer are drawn with a single
+IVideoDriver::drawMeshBufferInstanced() call. */
+class IInstancedMeshSceneNode : public ISceneNode
+{
+public:
+
+	//! Constructor
+	IInstancedMeshSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: ISceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Sets the mesh drawn for each instance
+	/** The materials of the mesh are copied into the node. */
+	virtual void setMesh(IMesh* mesh) = 0;
+
+	//! Returns the mesh drawn for each instance
+	virtual IMesh* getMesh() = 0;
+
+	//! Adds an instance
+	/** \param transform Transformation of the instance relative to the node.
+	\param color Color multiplied with the vertex colors of the instance.
+	\return Index of the new instance. */
+	virtual u32 addInstance(const core::matrix4& transform,
+		video::SColor color=video::SColor(255,255,255,255)) = 0;
+
+	//! Removes an instance
+	/** The last instance gets the index of the removed one. */
+	virtual void removeInstance(u32 index) = 0;
+
+	//! Removes all instances
+	virtual void removeAllInstances() = 0;
+
+	//! Returns the number of instances
+	virtual u32 getInstanceCount() const = 0;
+
+	//! Sets the transformation of an instance relative to the node
+	virtual void setInstanceTransform(u32 index, const core::matrix4& transform) = 0;
+
+	//! Returns the transformation of an instance relative to the node
+	virtual const core::matrix4& getInstanceTransform(u32 index) const = 0;
+
+	//! Sets the color of an instance
+	virtual void setInstanceColor(u32 index, video::SColor color) = 0;
+
+	//! Returns the color of an instance
+	virtual video::SColor getInstanceColor(u32 index) const = 0;
+
+	//! Returns the number of instances which were not culled when the node was drawn last
+	virtual u32 getVisibleInstanceCount() const = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -0,0 +1,88 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_I_LOD_MESH_SCENE_NODE_H_INCLUDED
+#define IRR_I_LOD_MESH_SCENE_NODE_H_INCLUDED
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class IMesh;
+
+//! A scene node drawing one of several meshes depending on its size on the screen
+/** Level 0 is the most detailed mesh, further levels are drawn when the
+node gets smaller on the screen. The screen size is the diameter of the
+bounding sphere of the node's transformed bounding box, projected by the
+active camera, as a fraction of the screen height. So a node filling the
+screen from top to bottom has a size of 1.
+
+To avoid popping between two levels when the node stays near the size where
+they change, a level is only left when the size is beyond that border by a
+fraction given with setHysteresis().
+
+The materials of the node are those of the level 0 mesh and are used for
+the meshbuffers of all levels, so the levels need the same meshbuffers in
+the same order like IMeshManipulator::createSimplifiedMesh() creates them.
+Each drawn level is counted in SFrameStats::LODLevels of the video driver. */
+class ILODMeshSceneNode : public ISceneNode
+{
+public:
+
+	//! Constructor
+	ILODMeshSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: ISceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Adds a less detailed level
+	/** \param mesh Mesh drawn for this level. Can be 0 to draw nothing
+	when the node is that small.
+	\param screenSize The level is drawn when the screen size of the node
+	is below this value. Has to be smaller than the screen size of the
+	previously added level.
+	\return True if the level was added, false if the screen size was
+	not smaller than the one of the last level. */
+	virtual bool addLevel(IMesh* mesh, f32 screenSize) = 0;
+
+	//! Removes all levels except level 0
+	virtual void removeLevels() = 0;
+
+	//! Returns the number of levels, including level 0
+	virtual u32 getLevelCount() const = 0;
+
+	//! Returns the mesh of a level
+	virtual IMesh* getLevelMesh(u32 level) const = 0;
+
+	//! Returns the screen size below which a level is drawn
+	/** Level 0 is drawn for all sizes above level 1, so it has no
+	screen size and returns 0. */
+	virtual f32 getLevelScreenSize(u32 level) const = 0;
+
+	//! Sets how far the screen size has to pass the border of a level before it changes
+	/** \param hysteresis Fraction of the screen size of the border, 0.1
+	by default. A node switches from level 1 to level 2 with a screen size
+	of 0.1 and a hysteresis of 0.1 when it gets smaller than 0.09 and
+	switches back when it gets bigger than 0.11. */
+	virtual void setHysteresis(f32 hysteresis) = 0;
+
+	//! Returns the hysteresis of the level changes
+	virtual f32 getHysteresis() const = 0;
+
+	//! Returns the level chosen when the node was registered last
+	virtual u32 getCurrentLevel() const = 0;
+
+	//! Returns the screen size of the node calculated when the node was registered last
+	/** Without an active camera and with the camera inside the bounding
+	sphere the size is FLT_MAX and level 0 is drawn. */
+	virtual f32 getScreenSize() const = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
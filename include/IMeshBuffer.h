@@ -41,6 +41,11 @@ namespace scene
 	{
 	public:
 
+		//! Constructor
+		IMeshBuffer() : HWBufferHandle(0xffffffff)
+		{
+		}
+
 		//! Get the material of this meshbuffer
 		/** \return Material of this buffer. */
 		virtual video::SMaterial& getMaterial() = 0;
@@ -211,6 +216,27 @@ s		\param updateBoundingBox When true update boundingbox by the added vertices *
 		//\param cloneFlags A combination of ECloneFlags
 		virtual IMeshBuffer* createClone(int cloneFlags=ECF_VERTICES|ECF_INDICES) const = 0;
 
+		//! Sets the slot of the hardware buffer of this meshbuffer in the video driver.
+		/** Set by the video driver to find the hardware buffer without a
+		search. Drivers which don't find their own link at the slot search
+		their links, so with several drivers it is only a hint. Not meant to
+		be called by users. */
+		void setHWBufferHandle(u32 handle) const
+		{
+			HWBufferHandle = handle;
+		}
+
+		//! Gets the slot of the hardware buffer of this meshbuffer in the video driver.
+		/** \return The slot, or 0xffffffff when the buffer has no hardware buffer. */
+		u32 getHWBufferHandle() const
+		{
+			return HWBufferHandle;
+		}
+
+	private:
+
+		//! Slot of the hardware buffer in the video driver
+		mutable u32 HWBufferHandle;
 	};
 
 } // end namespace scene
@@ -342,6 +342,25 @@ namespace scene
 		\return A new mesh optimized for the vertex cache. */
 		virtual IMesh* createForsythOptimizedMesh(const IMesh *mesh) const = 0;
 
+		//! Creates a copy of a mesh with less triangles
+		/** Edges are collapsed in the order of the error they cause,
+		measured with the quadric error metric of Garland and Heckbert.
+		Vertices are only removed, never moved, so normals, colors and
+		texture coordinates of the remaining vertices are kept. Vertices
+		sharing their position with others, like those on texture seams,
+		are kept to avoid cracks, vertices on open borders only move along
+		the border. Useful to create the levels of an ILODMeshSceneNode.
+		\param mesh Source mesh for the operation.
+		\param ratio Wanted fraction of the triangles of each meshbuffer,
+		between 0 and 1. Less triangles are removed when no more edges can
+		be collapsed.
+		\param maxError Maximal distance by which the surface may move, 0
+		for no limit.
+		\return New mesh with the same meshbuffers and materials. If you no
+		longer need the mesh, you should call IMesh::drop(). See
+		IReferenceCounted::drop() for more information. */
+		virtual IMesh* createSimplifiedMesh(const IMesh* mesh, f32 ratio, f32 maxError=0.f) const = 0;
+
 		//! Optimize the mesh with an algorithm tuned for heightmaps.
 		/**
 		This differs from usual simplification methods in two ways:
@@ -12,6 +12,8 @@ namespace irr
 {
 namespace scene
 {
+	struct SViewFrustum;
+
 	//! Interface for a Mesh which can be loaded directly from a Quake3 .bsp-file.
 	/** The Mesh tries to load all textures of the map.*/
 	class IQ3LevelMesh : public IAnimatedMesh
@@ -37,6 +39,35 @@ namespace scene
 
 		//! returns the requested brush entity
 		virtual IMesh* getBrushEntityMesh(quake3::IEntity &ent) const = 0;
+
+		//! Returns the visibility cluster of the BSP leaf containing a position
+		/** \param pos Position in mesh space.
+		\return Index of the cluster, or -1 if the position is outside of
+		the level or the level has no BSP tree. */
+		virtual s32 getClusterAt(const core::vector3df& pos) const = 0;
+
+		//! Collects the faces of the level geometry potentially visible from a position
+		/** Uses the BSP tree and the potentially visible set (PVS) of the
+		clusters stored in the level. Only faces of the mesh
+		getMesh(quake3::E_Q3_MESH_GEOMETRY) are returned.
+		\param pos Position of the viewer in mesh space.
+		\param frustum Optional view frustum in mesh space. BSP leafs whose
+		bounding box is outside of it are skipped.
+		\param faces Receives the indices of the visible faces, which can be
+		passed to getFaceRange().
+		\return False if pos is outside of the level or the level has no
+		visibility data. All geometry has to be drawn in that case. */
+		virtual bool getVisibleFaces(const core::vector3df& pos, const SViewFrustum* frustum,
+			core::array<u32>& faces) const = 0;
+
+		//! Returns where the triangles of a face are stored in the level geometry
+		/** \param face Index of the face as returned by getVisibleFaces().
+		\param meshBuffer Receives the index of the mesh buffer in
+		getMesh(quake3::E_Q3_MESH_GEOMETRY).
+		\param firstIndex Receives the first index of the face in the mesh buffer.
+		\param indexCount Receives the number of indices of the face.
+		\return False if the face has no triangles in the level geometry. */
+		virtual bool getFaceRange(u32 face, u32& meshBuffer, u32& firstIndex, u32& indexCount) const = 0;
 	};
 
 } // end namespace scene
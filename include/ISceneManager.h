@@ -146,6 +146,9 @@ namespace scene
 	class IMeshLoader;
 	class IMeshManipulator;
 	class IMeshSceneNode;
+	class IInstancedMeshSceneNode;
+	class IStaticBatchSceneNode;
+	class ILODMeshSceneNode;
 	class IMeshWriter;
 	class IMetaTriangleSelector;
 	class IOctreeSceneNode;
@@ -163,6 +166,7 @@ namespace scene
 	class ITextSceneNode;
 	class ITriangleSelector;
 	class IVolumeLightSceneNode;
+	class IQ3LevelMesh;
 
 	namespace quake3
 	{
@@ -550,6 +554,62 @@ namespace scene
 			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero=false) = 0;
 
+		//! Adds a scene node for rendering many instances of a static mesh.
+		/** The node starts without instances, add them with
+		IInstancedMeshSceneNode::addInstance(). All visible instances of a
+		meshbuffer are drawn with a single call to
+		IVideoDriver::drawMeshBufferInstanced().
+		\param mesh: Pointer to the static mesh drawn for each instance.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the space relative to its parent where the
+		scene node will be placed.
+		\param rotation: Initial rotation of the scene node.
+		\param scale: Initial scale of the scene node.
+		\return Pointer to the created scene node, or 0 if mesh is 0.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f)) = 0;
+
+		//! Adds a scene node drawing the merged geometry of static mesh scene nodes.
+		/** The node starts empty, add the nodes to merge with
+		IStaticBatchSceneNode::addNode() or IStaticBatchSceneNode::addNodes().
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param clusterSize: Edge length of the grid cells by which the geometry
+		is clustered. Each cluster is culled as a whole.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IStaticBatchSceneNode* addStaticBatchSceneNode(ISceneNode* parent=0, s32 id=-1,
+			f32 clusterSize=128.f) = 0;
+
+		//! Adds a scene node drawing less detailed versions of a mesh when it gets smaller on the screen.
+		/** The less detailed levels are created with
+		IMeshManipulator::createSimplifiedMesh(). Levels which would not have
+		less triangles than the level before are left out. More levels can
+		be added with ILODMeshSceneNode::addLevel().
+		\param mesh: Pointer to the static mesh drawn up close, level 0.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param levelCount: Number of levels including level 0.
+		\param reduction: Fraction of the triangles each level keeps from the
+		level before. The screen size at which a level starts shrinks by the
+		square root of this value, so the triangles per screen area stay
+		about the same.
+		\param position: Position of the space relative to its parent where the
+		scene node will be placed.
+		\param rotation: Initial rotation of the scene node.
+		\param scale: Initial scale of the scene node.
+		\return Pointer to the created scene node, or 0 if mesh is 0.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual ILODMeshSceneNode* addLODMeshSceneNode(IMesh* mesh, ISceneNode* parent=0, s32 id=-1,
+			u32 levelCount=4, f32 reduction=0.5f,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f)) = 0;
+
 		//! Adds a scene node for rendering a animated water surface mesh.
 		/** Looks really good when the Material type EMT_TRANSPARENT_REFLECTION
 		is used.
@@ -938,6 +998,22 @@ namespace scene
 												ISceneNode* parent=0, s32 id=-1
 												) = 0;
 
+		//! Adds a scene node drawing the geometry of a quake3 level.
+		/** Draws the mesh getMesh(quake3::E_Q3_MESH_GEOMETRY) of the level,
+		but only the faces in the clusters which are potentially visible
+		from the BSP leaf the active camera is in. When automatic culling is
+		enabled, the bounding boxes of the BSP leafs are also tested against
+		the view frustum. Levels without visibility data are drawn completely.
+		Shader and fog meshes of the level are not drawn by this node.
+		\param mesh The level, as returned by getMesh() for a .bsp file.
+		\param parent Parent of the scene node. Can be NULL if no parent.
+		\param id Id of the node. This id can be used to identify the scene node.
+		\return Pointer to the created scene node, or 0 if the quake3
+		loader is not compiled in. This pointer should not be dropped. See
+		IReferenceCounted::drop() for more information. */
+		virtual ISceneNode* addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+				ISceneNode* parent=0, s32 id=-1) = 0;
+
 
 		//! Adds an empty scene node to the scene graph.
 		/** Can be used for doing advanced transformations
@@ -1729,6 +1805,31 @@ namespace scene
 		\return True if node is not visible in the current scene, else
 		false. */
 		virtual bool isCulled(const ISceneNode* node) const =0;
+
+		//! Adds a node which hides other nodes for the software occlusion culling
+		/** At the start of drawAll() the meshes of all visible occluders
+		are rasterized into a small depth buffer. Nodes with the automatic
+		culling flag EAC_OCC_CPU are culled by isCulled() when their
+		bounding box is completely hidden behind the occluders. The
+		occluders are shrunk by a pixel of that buffer, so a box peeking
+		out behind an occluder edge is never culled. Unlike
+		occlusion queries this works in the same frame and with every
+		driver, including the null driver. Good occluders are large and
+		simple meshes, like low polygon versions of walls and buildings.
+		\param node The occluder. It is grabbed until it is removed with
+		removeOccluder() or removeAllOccluders(), until all nodes are removed
+		with clear(), or until the next drawAll() after it was removed from
+		the scene.
+		\param mesh Mesh rasterized for the node. If 0, the current mesh of
+		a mesh scene node or the first frame of an animated mesh scene node
+		is used, other nodes need a mesh. */
+		virtual void addOccluder(ISceneNode* node, const IMesh* mesh=0) =0;
+
+		//! Removes an occluder added with addOccluder()
+		virtual void removeOccluder(ISceneNode* node) =0;
+
+		//! Removes all occluders
+		virtual void removeAllOccluders() =0;
 	};
 
 
@@ -51,7 +51,7 @@ namespace scene
 			: RelativeTranslation(position), RelativeRotation(rotation), RelativeScale(scale),
 				Parent(0), SceneManager(mgr), TriangleSelector(0), ID(id),
 				AbsPosUpdateBehavior(ESNUA_TRANSFORM_MATRIX), AutomaticCullingState(EAC_BOX),
-				DebugDataVisible(EDS_OFF),
+				OcclusionQueryHandle(0xffffffff), DebugDataVisible(EDS_OFF),
 				IsVisible(true), IsDebugObject(false)
 		{
 			if (parent)
@@ -561,6 +561,23 @@ namespace scene
 			return AutomaticCullingState;
 		}
 
+
+		//! Sets the slot of the occlusion query of this node in the video driver.
+		/** Set by IVideoDriver::addOcclusionQuery() to find the query of
+		the node without a search. Not meant to be called by users. */
+		void setOcclusionQueryHandle(u32 handle)
+		{
+			OcclusionQueryHandle = handle;
+		}
+
+
+		//! Gets the slot of the occlusion query of this node in the video driver.
+		/** \return The slot, or 0xffffffff when the node has no query. */
+		u32 getOcclusionQueryHandle() const
+		{
+			return OcclusionQueryHandle;
+		}
+
 		//! Set how updateAbsolutePosition calculates the absolute transformation matrix
 		void setUpdateAbsolutePosBehavior(ESCENE_NODE_UPDATE_ABS behavior)
 		{
@@ -897,6 +914,9 @@ namespace scene
 		//! Automatic culling state
 		u32 AutomaticCullingState;
 
+		//! Slot of the occlusion query in the video driver
+		u32 OcclusionQueryHandle;
+
 		//! Flag if debug data should be drawn, such as Bounding Boxes.
 		u32 DebugDataVisible;
 
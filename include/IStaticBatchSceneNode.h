@@ -0,0 +1,86 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_I_STATIC_BATCH_SCENE_NODE_H_INCLUDED
+#define IRR_I_STATIC_BATCH_SCENE_NODE_H_INCLUDED
+
+#include "ISceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+class IMeshSceneNode;
+
+//! A scene node drawing the merged geometry of many static mesh scene nodes
+/** Scenes made of thousands of small static mesh scene nodes spend most of
+their time in registering, culling, transforming and setting materials of
+single nodes. This node copies the geometry of such nodes into a few large
+meshbuffers instead, transformed into the space of the batch node. The
+geometry is merged by material and by the cell of a regular grid in which
+the center of a node lies. Each of those clusters is culled against the view
+frustum as one unit and drawn with one call.
+
+Batched nodes are hidden, but stay in the scene graph. Their children are
+hidden with them, unless they are batched as well. Batched nodes are found
+again by the triangle selector of the batch node: the collision manager returns
+the batched node and not the batch node for hits on its triangles. Nodes
+which should be drawn on their own again are removed with removeNode().
+
+Batched nodes have to be at their final place, later changes of their
+transformation, mesh or materials are not noticed by the batch. */
+class IStaticBatchSceneNode : public ISceneNode
+{
+public:
+
+	//! Constructor
+	IStaticBatchSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: ISceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Copies the geometry of a mesh scene node into the batch and hides the node
+	/** Only meshbuffers of triangles with at most 65536 vertices can be
+	batched.
+	\param node Node to add. It is grabbed by the batch.
+	\return True if the node was added, false if it was already in the
+	batch or its mesh can't be batched. */
+	virtual bool addNode(IMeshSceneNode* node) = 0;
+
+	//! Adds all visible mesh scene nodes below a node
+	/** \param root All children of this node and their children are
+	tested, the node itself is not added.
+	\param idBitMask Only nodes with an id having one of these bits set
+	are added, 0 adds all nodes. Useful to mark the static nodes of a scene.
+	\return Number of nodes added. */
+	virtual u32 addNodes(ISceneNode* root, s32 idBitMask=0) = 0;
+
+	//! Removes the geometry of a node from the batch and shows the node again
+	/** The geometry of all nodes removed since the last frame is taken out
+	of the clusters when the batch is registered for drawing the next time,
+	so the cluster count and bounding box are updated then.
+	\return True if the node was in the batch. */
+	virtual bool removeNode(IMeshSceneNode* node) = 0;
+
+	//! Removes all nodes from the batch and shows them again
+	virtual void removeAllNodes() = 0;
+
+	//! Returns the number of batched nodes
+	virtual u32 getNodeCount() const = 0;
+
+	//! Returns a batched node
+	virtual IMeshSceneNode* getNode(u32 index) const = 0;
+
+	//! Returns the number of clusters, each is a meshbuffer of one material
+	virtual u32 getClusterCount() const = 0;
+
+	//! Returns the number of clusters which were not culled when the node was drawn last
+	virtual u32 getVisibleClusterCount() const = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -162,6 +162,20 @@ public:
 		const core::matrix4* transform=0, bool useNodeTransform=true,
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo=0) const = 0;
 
+	//! Gets the triangles which may contain the closest contact with a 3d line.
+	/** Like getTriangles() for lines, but selectors may leave out
+	triangles which can only be hit behind the closest hit, for example
+	when they have already found a hit in front of them. Used by
+	ISceneCollisionManager::getCollisionPoint(). The parameters are the
+	same as for getTriangles(). */
+	virtual void getTrianglesForClosestHit(core::triangle3df* triangles, s32 arraySize,
+		s32& outTriangleCount, const core::line3d<f32>& line,
+		const core::matrix4* transform=0, bool useNodeTransform=true,
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo=0) const
+	{
+		getTriangles(triangles, arraySize, outTriangleCount, line, transform, useNodeTransform, outTriangleInfo);
+	}
+
 	//! Get number of TriangleSelectors that are part of this one
 	/** Only useful for MetaTriangleSelector, others return 1
 	*/
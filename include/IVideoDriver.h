@@ -18,6 +18,7 @@
 #include "EDriverFeatures.h"
 #include "EPrimitiveTypes.h"
 #include "SExposedVideoData.h"
+#include "SFrameStats.h"
 #include "S3DVertex.h"
 #include "SVertexIndex.h"
 
@@ -1010,6 +1011,22 @@ namespace video
 		/** \param mb Buffer to draw */
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb) =0;
 
+		//! Draws copies of a mesh buffer with one call
+		/** Each copy (instance) is drawn with its own world transformation
+		instead of the one set with setTransform(ETS_WORLD), which is not
+		changed by this call. The current material is used for all
+		instances. The null and burnings video driver draw all instances
+		with a single call, setting up the shared state once. The other
+		drivers draw the instances one by one.
+		\param mb Buffer to draw
+		\param transforms World transformation of each instance.
+		\param instanceCount Number of instances.
+		\param colors Color of each instance, multiplied with the vertex
+		colors. Can be 0 to draw all instances with the vertex colors. */
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const core::matrix4* transforms, u32 instanceCount,
+			const SColor* colors=0) =0;
+
 		//! Draws normals of a mesh buffer
 		/** \param mb Buffer to draw the normals of
 		\param length length scale factor of the normals
@@ -1059,6 +1076,12 @@ namespace video
 		\return Size of render target or screen/window */
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const =0;
 
+		//! Get the current render target
+		/** Allows to switch back to it after drawing into another target.
+		eturn Render target set by setRenderTarget() or
+		setRenderTargetEx(), 0 when drawing to the screen. */
+		virtual IRenderTarget* getCurrentRenderTarget() const =0;
+
 		//! Returns current frames per second value.
 		/** This value is updated approximately every 1.5 seconds and
 		is only intended to provide a rough guide to the average frame
@@ -1074,6 +1097,22 @@ namespace video
 		\return Amount of primitives drawn in the last frame. */
 		virtual u32 getPrimitiveCountDrawn( u32 mode =0 ) const =0;
 
+		//! Returns counters describing the cost of a frame.
+		/** Counters are reset in beginScene() and published in endScene().
+		\param currentFrame When false the counters of the last completed
+		frame are returned, otherwise the counters of the frame currently
+		being rendered.
+		\return Draw calls, primitives, state changes and uploads of the frame. */
+		virtual const SFrameStats& getFrameStats(bool currentFrame=false) const =0;
+
+		//! Counts a mesh drawn with a level of detail in the counters of the frame.
+		/** Called by scene nodes like ILODMeshSceneNode which choose
+		between meshes of different detail.
+		\param level Level which was drawn, 0 being the most detailed.
+		\param primitivesSaved Amount of primitives less than the most
+		detailed level has. */
+		virtual void countLODLevel(u32 level, u32 primitivesSaved) =0;
+
 		//! Deletes all dynamic lights which were previously added with addDynamicLight().
 		virtual void deleteAllDynamicLights() =0;
 
@@ -1284,6 +1323,17 @@ namespace video
 				const core::position2d<s32>& pos,
 				const core::dimension2d<u32>& size) =0;
 
+		//! Creates a software image by resampling another image to a new size.
+		/**
+		\param imageToScale Image to resample. The new image has the same color format.
+		\param size Size of the new image.
+		\param filter Filter used for resampling, see IImage::copyToScalingFiltered().
+		\return The created image, 0 if the image can't be resampled.
+		If you no longer need the image, you should call IImage::drop().
+		See IReferenceCounted::drop() for more information. */
+		virtual IImage* createImage(IImage* imageToScale, const core::dimension2d<u32>& size,
+				E_RESAMPLE_FILTER filter) =0;
+
 		//! Creates a software image from a part of a texture.
 		/**
 		\param texture Texture to copy to the new image in part.
@@ -241,6 +241,15 @@ define out. */
 #undef _IRR_LINUX_XCURSOR_
 #endif
 
+//! The software drivers present their images with XPutImage, which sends all pixels through the X connection.
+//! With the MIT-SHM extension the image is shared with a local X server instead, Burning's Video renders straight
+//! into it. Needs linking to the Xext library, disable this if you don't have it. The extension is queried at
+//! runtime, remote displays fall back to XPutImage.
+#define _IRR_LINUX_X11_SHM_
+#ifdef NO_IRR_LINUX_X11_SHM_
+#undef _IRR_LINUX_X11_SHM_
+#endif
+
 #endif
 
 //! Define _IRR_COMPILE_WITH_GUI_ to compile the engine with the built-in GUI
@@ -451,6 +460,11 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_IRR_MESH_LOADER_
 #undef _IRR_COMPILE_WITH_IRR_MESH_LOADER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_ if you want to load binary Irrlicht Engine .irrbm files
+#define _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#undef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#endif
 //! Define _IRR_COMPILE_WITH_HALFLIFE_LOADER_ if you want to load Halflife animated files
 #define _IRR_COMPILE_WITH_HALFLIFE_LOADER_
 #ifdef NO_IRR_COMPILE_WITH_HALFLIFE_LOADER_
@@ -566,6 +580,11 @@ B3D, MS3D or X meshes */
 #ifdef NO_IRR_COMPILE_WITH_B3D_WRITER_
 #undef _IRR_COMPILE_WITH_B3D_WRITER_
 #endif
+//! Define _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_ if you want to write binary .irrbm files
+#define _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+#ifdef NO_IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+#undef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+#endif
 
 //! Define _IRR_COMPILE_WITH_BMP_LOADER_ if you want to load .bmp files
 //! Disabling this loader will also disable the built-in font
@@ -774,6 +793,22 @@ precision will be lower but speed higher. currently X86 only
 	#endif
 #endif
 
+//! Use SSE or NEON instructions for f32 matrix operations
+/** Enabled when the compiler targets a cpu with one of these instruction sets.
+Define NO__IRR_COMPILE_WITH_SSE_ or NO__IRR_COMPILE_WITH_NEON_ to use plain C++ code instead.
+*/
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define _IRR_COMPILE_WITH_SSE_
+	#ifdef NO__IRR_COMPILE_WITH_SSE_
+	#undef _IRR_COMPILE_WITH_SSE_
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define _IRR_COMPILE_WITH_NEON_
+	#ifdef NO__IRR_COMPILE_WITH_NEON_
+	#undef _IRR_COMPILE_WITH_NEON_
+	#endif
+#endif
+
 // Some cleanup and standard stuff
 
 #ifdef _IRR_WINDOWS_API_
@@ -0,0 +1,121 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef S_FRAME_STATS_H_INCLUDED
+#define S_FRAME_STATS_H_INCLUDED
+
+#include "irrTypes.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Number of levels of detail counted separately in SFrameStats::LODLevels
+const u32 FRAME_STATS_MAX_LOD_LEVELS = 8;
+
+//! Counters describing the cost of a rendered frame.
+/** The counters are reset by IVideoDriver::beginScene() and published by
+IVideoDriver::endScene(). They can be queried with
+IVideoDriver::getFrameStats(). Drivers only count what they can observe, so
+for example hardware buffer uploads stay 0 for drivers without hardware
+buffers. All drivers count draw calls and primitives, so the null driver can
+be used to check batching and sorting headless. */
+struct SFrameStats
+{
+	SFrameStats()
+	{
+		reset();
+	}
+
+	//! Set all counters to 0
+	void reset()
+	{
+		DrawCalls = 0;
+		Primitives = 0;
+		MaterialChanges = 0;
+		TextureBinds = 0;
+		HardwareBufferUploads = 0;
+		HardwareBufferUploadBytes = 0;
+		RenderTargetSwitches = 0;
+		Draw2DBatches = 0;
+		Instances = 0;
+		for (u32 i=0; i<FRAME_STATS_MAX_LOD_LEVELS; ++i)
+			LODLevels[i] = 0;
+		LODPrimitivesSaved = 0;
+		HiZTrianglesRejected = 0;
+		HiZSpansRejected = 0;
+		HiZTileTests = 0;
+		HiZTileUpdates = 0;
+		ClearTilesDeferred = 0;
+		ClearTilesResolved = 0;
+	}
+
+	//! Number of geometry submissions, 3d vertex lists as well as 2d images.
+	u32 DrawCalls;
+
+	//! Number of primitives (mostly triangles) submitted with vertex lists.
+	/** Same value as IVideoDriver::getPrimitiveCountDrawn(0) reports. */
+	u32 Primitives;
+
+	//! Number of materials set which differ from the previously used one.
+	/** The null driver has no state cache and counts every setMaterial call. */
+	u32 MaterialChanges;
+
+	//! Number of textures bound to a texture stage.
+	u32 TextureBinds;
+
+	//! Number of vertex and index buffers uploaded into hardware buffers.
+	u32 HardwareBufferUploads;
+
+	//! Amount of bytes uploaded into hardware buffers.
+	u32 HardwareBufferUploadBytes;
+
+	//! Number of successful render target changes.
+	u32 RenderTargetSwitches;
+
+	//! Number of calls to draw2DImageBatch.
+	u32 Draw2DBatches;
+
+	//! Number of instances drawn with IVideoDriver::drawMeshBufferInstanced().
+	/** Drivers which draw all instances at once count one draw call
+	for each call, the others one draw call for each instance. */
+	u32 Instances;
+
+	//! Number of meshes drawn with each level of detail, 0 being the most detailed.
+	/** Counted by IVideoDriver::countLODLevel(). Levels beyond the last
+	entry are counted in the last entry. */
+	u32 LODLevels[FRAME_STATS_MAX_LOD_LEVELS];
+
+	//! Number of primitives saved by drawing less detailed levels.
+	u32 LODPrimitivesSaved;
+
+	//! Number of triangles rejected by the hierarchical z test before rasterizing them.
+	/** Only the burning's video driver has a hierarchical z test. It keeps
+	the farthest depth of each tile of 8x8 pixels and rejects triangles and
+	scanlines behind all tiles they touch. */
+	u32 HiZTrianglesRejected;
+
+	//! Number of scanlines rejected by the hierarchical z test before shading them.
+	u32 HiZSpansRejected;
+
+	//! Number of tiles tested by the hierarchical z test.
+	u32 HiZTileTests;
+
+	//! Number of tiles whose farthest depth was recalculated after being drawn to.
+	u32 HiZTileUpdates;
+
+	//! Number of depth and stencil buffer tiles cleared without writing them.
+	/** Only the burning's video driver defers clears. A tile of 8x8 pixels
+	is written with the clear value when something is drawn to it, tiles
+	nothing is drawn to until the next clear are never written. */
+	u32 ClearTilesDeferred;
+
+	//! Number of depth and stencil buffer tiles written with a deferred clear value.
+	u32 ClearTilesResolved;
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
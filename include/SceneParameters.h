@@ -176,6 +176,20 @@ namespace scene
 	**/
 	const c8* const DEBUG_NORMAL_COLOR = "DEBUG_Normal_Color";
 
+	//! Name of the parameter for caching loaded meshes as binary .irrbm files
+	/** When set to a directory, ISceneManager::getMesh() converts each
+	static or skinned mesh it loads into a .irrbm file in that directory.
+	The files are named by a hash of the source file, so later loads of
+	unchanged files read the binary file instead of parsing the source
+	again. Other files opened while parsing the source, like the material
+	libraries of .obj files, are checked too. Textures are loaded by name
+	with the binary file. Use it like this:
+	\code
+	SceneManager->getParameters()->setAttribute(scene::BINARY_MESH_CACHE_PATH, "path/to/cache");
+	\endcode
+	**/
+	const c8* const BINARY_MESH_CACHE_PATH = "Binary_Mesh_Cache_Path";
+
 
 } // end namespace scene
 } // end namespace irr
@@ -105,6 +105,7 @@
 #include "IImageWriter.h"
 #include "IIndexBuffer.h"
 #include "ILightSceneNode.h"
+#include "ILODMeshSceneNode.h"
 #include "ILogger.h"
 #include "IMaterialRenderer.h"
 #include "IMaterialRendererServices.h"
@@ -114,6 +115,7 @@
 #include "IMeshLoader.h"
 #include "IMeshManipulator.h"
 #include "IMeshSceneNode.h"
+#include "IInstancedMeshSceneNode.h"
 #include "IMeshWriter.h"
 #include "IOctreeSceneNode.h"
 #include "IColladaMeshWriter.h"
@@ -149,6 +151,7 @@
 #include "IShaderConstantSetCallBack.h"
 #include "IShadowVolumeSceneNode.h"
 #include "ISkinnedMesh.h"
+#include "IStaticBatchSceneNode.h"
 #include "ITerrainSceneNode.h"
 #include "ITextSceneNode.h"
 #include "ITexture.h"
@@ -176,6 +179,7 @@
 #include "SceneParameters.h"
 #include "SColor.h"
 #include "SExposedVideoData.h"
+#include "SFrameStats.h"
 #include "SIrrCreationParameters.h"
 #include "SKeyMap.h"
 #include "SLight.h"
@@ -13,6 +13,12 @@
 #include "rect.h"
 #include "irrString.h"
 
+#if defined(_IRR_COMPILE_WITH_SSE_)
+#include <xmmintrin.h>
+#elif defined(_IRR_COMPILE_WITH_NEON_)
+#include <arm_neon.h>
+#endif
+
 // enable this to keep track of changes to the matrix
 // and make simpler identity check for seldom changing matrices
 // otherwise identity check will always compare the elements
@@ -287,6 +293,17 @@ namespace core
 			is slower than transformBox(). */
 			void transformBoxEx(core::aabbox3d<f32>& box) const;
 
+			//! Transforms an array of vectors by this matrix
+			/** Same as calling transformVect(out[i], in[i]) for each vector.
+			\param out Array receiving the transformed vectors, may be the same as in
+			\param in Array of the vectors to transform
+			\param count Number of vectors in both arrays */
+			void transformVectArray(vector3df* out, const vector3df* in, u32 count) const;
+
+			//! Transforms an array of axis aligned bounding boxes
+			/** Same as calling transformBoxEx() for each box. */
+			void transformBoxExArray(core::aabbox3d<f32>* boxes, u32 count) const;
+
 			//! Transforms matrix1x4 by this matrix
 			/** Like transformVec4, just with single parameter */
 			void multiplyWith1x4Matrix(T* matrix1x4) const;
@@ -1360,6 +1377,20 @@ namespace core
 		box.MaxEdge.Z = Bmax[2];
 	}
 
+	template <class T>
+	inline void CMatrix4<T>::transformVectArray(vector3df* out, const vector3df* in, u32 count) const
+	{
+		for (u32 i=0; i<count; ++i)
+			transformVect(out[i], in[i]);
+	}
+
+	template <class T>
+	inline void CMatrix4<T>::transformBoxExArray(core::aabbox3d<f32>* boxes, u32 count) const
+	{
+		for (u32 i=0; i<count; ++i)
+			transformBoxEx(boxes[i]);
+	}
+
 	//! Transforms matrix1x4 by this matrix
 	template <class T>
 	inline void CMatrix4<T>::multiplyWith1x4Matrix(T* matrix1x4) const
@@ -2296,6 +2327,283 @@ namespace core
 	}
 
 
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+	//! Thin wrappers around the vector instructions used by the f32 matrix functions
+	namespace simd
+	{
+#if defined(_IRR_COMPILE_WITH_SSE_)
+		typedef __m128 f32x4;
+		inline f32x4 load(const f32* p) { return _mm_loadu_ps(p); }
+		inline void store(f32* p, f32x4 v) { _mm_storeu_ps(p, v); }
+		inline f32x4 splat(f32 f) { return _mm_set1_ps(f); }
+		inline f32x4 add(f32x4 a, f32x4 b) { return _mm_add_ps(a, b); }
+		inline f32x4 mul(f32x4 a, f32x4 b) { return _mm_mul_ps(a, b); }
+		inline f32x4 minimum(f32x4 a, f32x4 b) { return _mm_min_ps(a, b); }
+		inline f32x4 maximum(f32x4 a, f32x4 b) { return _mm_max_ps(a, b); }
+		template <int lane> inline f32x4 splatLane(f32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane)); }
+#else
+		typedef float32x4_t f32x4;
+		inline f32x4 load(const f32* p) { return vld1q_f32(p); }
+		inline void store(f32* p, f32x4 v) { vst1q_f32(p, v); }
+		inline f32x4 splat(f32 f) { return vdupq_n_f32(f); }
+		inline f32x4 add(f32x4 a, f32x4 b) { return vaddq_f32(a, b); }
+		inline f32x4 mul(f32x4 a, f32x4 b) { return vmulq_f32(a, b); }
+		inline f32x4 minimum(f32x4 a, f32x4 b) { return vminq_f32(a, b); }
+		inline f32x4 maximum(f32x4 a, f32x4 b) { return vmaxq_f32(a, b); }
+		template <int lane> inline f32x4 splatLane(f32x4 v) { return vdupq_n_f32(vgetq_lane_f32(v, lane)); }
+#endif
+
+		//! Returns the row combination v.x*r0 + v.y*r1 + v.z*r2 + v.w*r3
+		/** Sums up in the same order as the plain C++ code. */
+		inline f32x4 combine(f32x4 r0, f32x4 r1, f32x4 r2, f32x4 r3, f32x4 v)
+		{
+			return add(add(add(mul(r0, splatLane<0>(v)), mul(r1, splatLane<1>(v))), mul(r2, splatLane<2>(v))), mul(r3, splatLane<3>(v)));
+		}
+
+		//! Returns x*r0 + y*r1 + z*r2 + r3
+		inline f32x4 transform(f32x4 r0, f32x4 r1, f32x4 r2, f32x4 r3, f32 x, f32 y, f32 z)
+		{
+			return add(add(add(mul(r0, splat(x)), mul(r1, splat(y))), mul(r2, splat(z))), r3);
+		}
+
+		//! Transforms a box by the rows of a matrix, like CMatrix4<T>::transformBoxEx
+		inline void transformBox(f32x4 r0, f32x4 r1, f32x4 r2, f32x4 r3, core::aabbox3d<f32>& box)
+		{
+			f32x4 a = mul(r0, splat(box.MinEdge.X));
+			f32x4 b = mul(r0, splat(box.MaxEdge.X));
+			f32x4 bmin = add(r3, minimum(a, b));
+			f32x4 bmax = add(r3, maximum(b, a));
+			a = mul(r1, splat(box.MinEdge.Y));
+			b = mul(r1, splat(box.MaxEdge.Y));
+			bmin = add(bmin, minimum(a, b));
+			bmax = add(bmax, maximum(b, a));
+			a = mul(r2, splat(box.MinEdge.Z));
+			b = mul(r2, splat(box.MaxEdge.Z));
+			bmin = add(bmin, minimum(a, b));
+			bmax = add(bmax, maximum(b, a));
+
+			f32 tmp[4];
+			store(tmp, bmin);
+			box.MinEdge.set(tmp[0], tmp[1], tmp[2]);
+			store(tmp, bmax);
+			box.MaxEdge.set(tmp[0], tmp[1], tmp[2]);
+		}
+	} // end namespace simd
+
+	// f32 versions of the most used functions, selected at compile time.
+	// They give the same results as the plain C++ code, except for getInverse
+	// which differs in the last bits.
+
+	template <>
+	inline CMatrix4<f32>& CMatrix4<f32>::setbyproduct_nocheck(const CMatrix4<f32>& other_a, const CMatrix4<f32>& other_b)
+	{
+		const f32 *m1 = other_a.M;
+		const f32 *m2 = other_b.M;
+
+		const simd::f32x4 r0 = simd::load(m1);
+		const simd::f32x4 r1 = simd::load(m1+4);
+		const simd::f32x4 r2 = simd::load(m1+8);
+		const simd::f32x4 r3 = simd::load(m1+12);
+
+		// this may be one of the factors, so everything is read before the first write
+		const simd::f32x4 p0 = simd::combine(r0, r1, r2, r3, simd::load(m2));
+		const simd::f32x4 p1 = simd::combine(r0, r1, r2, r3, simd::load(m2+4));
+		const simd::f32x4 p2 = simd::combine(r0, r1, r2, r3, simd::load(m2+8));
+		const simd::f32x4 p3 = simd::combine(r0, r1, r2, r3, simd::load(m2+12));
+		simd::store(M, p0);
+		simd::store(M+4, p1);
+		simd::store(M+8, p2);
+		simd::store(M+12, p3);
+#if defined ( USE_MATRIX_TEST )
+		definitelyIdentityMatrix=false;
+#endif
+		return *this;
+	}
+
+	template <>
+	inline CMatrix4<f32> CMatrix4<f32>::operator*(const CMatrix4<f32>& m2) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		// Testing purpose..
+		if ( this->isIdentity() )
+			return m2;
+		if ( m2.isIdentity() )
+			return *this;
+#endif
+		CMatrix4<f32> m3 ( EM4CONST_NOTHING );
+		return m3.setbyproduct_nocheck(*this, m2);
+	}
+
+	template <>
+	inline void CMatrix4<f32>::transformVect(vector3df& out, const vector3df& in) const
+	{
+		f32 tmp[4];
+		simd::store(tmp, simd::transform(simd::load(M), simd::load(M+4), simd::load(M+8), simd::load(M+12), in.X, in.Y, in.Z));
+		out.set(tmp[0], tmp[1], tmp[2]);
+	}
+
+	template <>
+	inline void CMatrix4<f32>::transformVect(vector3df& vect) const
+	{
+		transformVect(vect, vect);
+	}
+
+	template <>
+	inline void CMatrix4<f32>::transformVect(f32 *out, const core::vector3df &in) const
+	{
+		simd::store(out, simd::transform(simd::load(M), simd::load(M+4), simd::load(M+8), simd::load(M+12), in.X, in.Y, in.Z));
+	}
+
+	template <>
+	inline void CMatrix4<f32>::transformVec4(f32 *out, const f32 * in) const
+	{
+		simd::store(out, simd::combine(simd::load(M), simd::load(M+4), simd::load(M+8), simd::load(M+12), simd::load(in)));
+	}
+
+	template <>
+	inline void CMatrix4<f32>::transformVectArray(vector3df* out, const vector3df* in, u32 count) const
+	{
+		const simd::f32x4 r0 = simd::load(M);
+		const simd::f32x4 r1 = simd::load(M+4);
+		const simd::f32x4 r2 = simd::load(M+8);
+		const simd::f32x4 r3 = simd::load(M+12);
+
+		f32 tmp[4];
+		for (u32 i=0; i<count; ++i)
+		{
+			simd::store(tmp, simd::transform(r0, r1, r2, r3, in[i].X, in[i].Y, in[i].Z));
+			out[i].set(tmp[0], tmp[1], tmp[2]);
+		}
+	}
+
+	template <>
+	inline void CMatrix4<f32>::transformBoxEx(core::aabbox3d<f32>& box) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		if (isIdentity())
+			return;
+#endif
+		simd::transformBox(simd::load(M), simd::load(M+4), simd::load(M+8), simd::load(M+12), box);
+	}
+
+	template <>
+	inline void CMatrix4<f32>::transformBoxExArray(core::aabbox3d<f32>* boxes, u32 count) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		if (isIdentity())
+			return;
+#endif
+		const simd::f32x4 r0 = simd::load(M);
+		const simd::f32x4 r1 = simd::load(M+4);
+		const simd::f32x4 r2 = simd::load(M+8);
+		const simd::f32x4 r3 = simd::load(M+12);
+
+		for (u32 i=0; i<count; ++i)
+			simd::transformBox(r0, r1, r2, r3, boxes[i]);
+	}
+
+#if defined(_IRR_COMPILE_WITH_SSE_)
+	// shuffle mask with the source lanes in register order
+	#define IRR_SSE_MASK(x,y,z,w) ((x) | ((y)<<2) | ((z)<<4) | ((w)<<6))
+	#define IRR_SSE_SWIZZLE(v,x,y,z,w) _mm_shuffle_ps(v, v, IRR_SSE_MASK(x,y,z,w))
+
+	namespace simd
+	{
+		//! 2x2 matrix product A*B, the matrices are stored row by row
+		inline __m128 mat2Mul(__m128 a, __m128 b)
+		{
+			return _mm_add_ps(_mm_mul_ps(a, IRR_SSE_SWIZZLE(b, 0,3,0,3)),
+				_mm_mul_ps(IRR_SSE_SWIZZLE(a, 1,0,3,2), IRR_SSE_SWIZZLE(b, 2,1,2,1)));
+		}
+
+		//! 2x2 matrix product adj(A)*B
+		inline __m128 mat2AdjMul(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(IRR_SSE_SWIZZLE(a, 3,3,0,0), b),
+				_mm_mul_ps(IRR_SSE_SWIZZLE(a, 1,1,2,2), IRR_SSE_SWIZZLE(b, 2,3,0,1)));
+		}
+
+		//! 2x2 matrix product A*adj(B)
+		inline __m128 mat2MulAdj(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(a, IRR_SSE_SWIZZLE(b, 3,0,3,0)),
+				_mm_mul_ps(IRR_SSE_SWIZZLE(a, 1,0,3,2), IRR_SSE_SWIZZLE(b, 2,1,2,1)));
+		}
+	} // end namespace simd
+
+	//! Inverse by the block matrix method on 2x2 sub matrices
+	template <>
+	inline bool CMatrix4<f32>::getInverse(CMatrix4<f32>& out) const
+	{
+#if defined ( USE_MATRIX_TEST )
+		if ( this->isIdentity() )
+		{
+			out=*this;
+			return true;
+		}
+#endif
+		const __m128 r0 = _mm_loadu_ps(M);
+		const __m128 r1 = _mm_loadu_ps(M+4);
+		const __m128 r2 = _mm_loadu_ps(M+8);
+		const __m128 r3 = _mm_loadu_ps(M+12);
+
+		// the matrix is | A B |
+		//               | C D |
+		const __m128 A = _mm_movelh_ps(r0, r1);
+		const __m128 B = _mm_movehl_ps(r1, r0);
+		const __m128 C = _mm_movelh_ps(r2, r3);
+		const __m128 D = _mm_movehl_ps(r3, r2);
+
+		// determinants of the sub matrices as (|A| |B| |C| |D|)
+		const __m128 detSub = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(r0, r2, IRR_SSE_MASK(0,2,0,2)), _mm_shuffle_ps(r1, r3, IRR_SSE_MASK(1,3,1,3))),
+			_mm_mul_ps(_mm_shuffle_ps(r0, r2, IRR_SSE_MASK(1,3,1,3)), _mm_shuffle_ps(r1, r3, IRR_SSE_MASK(0,2,0,2))));
+		const __m128 detA = IRR_SSE_SWIZZLE(detSub, 0,0,0,0);
+		const __m128 detB = IRR_SSE_SWIZZLE(detSub, 1,1,1,1);
+		const __m128 detC = IRR_SSE_SWIZZLE(detSub, 2,2,2,2);
+		const __m128 detD = IRR_SSE_SWIZZLE(detSub, 3,3,3,3);
+
+		const __m128 D_C = simd::mat2AdjMul(D, C);
+		const __m128 A_B = simd::mat2AdjMul(A, B);
+
+		// adjugates of the blocks of the inverse
+		__m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), simd::mat2Mul(B, D_C));
+		__m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), simd::mat2Mul(C, A_B));
+		__m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), simd::mat2MulAdj(D, A_B));
+		__m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), simd::mat2MulAdj(A, D_C));
+
+		// |M| = |A|*|D| + |B|*|C| - tr(adj(A)B adj(D)C)
+		__m128 tr = _mm_mul_ps(A_B, IRR_SSE_SWIZZLE(D_C, 0,2,1,3));
+		tr = _mm_add_ps(tr, IRR_SSE_SWIZZLE(tr, 2,3,0,1));
+		tr = _mm_add_ps(tr, IRR_SSE_SWIZZLE(tr, 1,0,3,2));
+		const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+		if( core::iszero ( _mm_cvtss_f32(detM), FLT_MIN ) )
+			return false;
+
+		const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), detM);
+		X_ = _mm_mul_ps(X_, rDetM);
+		Y_ = _mm_mul_ps(Y_, rDetM);
+		Z_ = _mm_mul_ps(Z_, rDetM);
+		W_ = _mm_mul_ps(W_, rDetM);
+
+		_mm_storeu_ps(out.M, _mm_shuffle_ps(X_, Y_, IRR_SSE_MASK(3,1,3,1)));
+		_mm_storeu_ps(out.M+4, _mm_shuffle_ps(X_, Y_, IRR_SSE_MASK(2,0,2,0)));
+		_mm_storeu_ps(out.M+8, _mm_shuffle_ps(Z_, W_, IRR_SSE_MASK(3,1,3,1)));
+		_mm_storeu_ps(out.M+12, _mm_shuffle_ps(Z_, W_, IRR_SSE_MASK(2,0,2,0)));
+
+#if defined ( USE_MATRIX_TEST )
+		out.definitelyIdentityMatrix = definitelyIdentityMatrix;
+#endif
+		return true;
+	}
+
+	#undef IRR_SSE_SWIZZLE
+	#undef IRR_SSE_MASK
+#endif // _IRR_COMPILE_WITH_SSE_
+#endif // _IRR_COMPILE_WITH_SSE_ || _IRR_COMPILE_WITH_NEON_
+
+
 	//! Typedef for f32 matrix
 	typedef CMatrix4<f32> matrix4;
 
@@ -257,8 +257,46 @@ IMesh* CAnimatedMeshMD2::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 		endFrameLoop = getFrameCount();
 	}
 
-	updateInterpolationBuffer(frame, startFrameLoop, endFrameLoop);
-	return this;
+	u32 firstFrame, secondFrame;
+	s32 blend;
+	getKeyFrames(frame, startFrameLoop, endFrameLoop, firstFrame, secondFrame, blend);
+
+	// nodes showing the same frame share the interpolated mesh
+	SMesh* mesh;
+	bool copy;
+	const u32 version = InterpolationBuffer->getChangedID_Vertex() + InterpolationBuffer->getChangedID_Index();
+	if (Cache.get(firstFrame, secondFrame, blend, version, mesh, copy))
+	{
+		if (!mesh->getMeshBufferCount())
+		{
+			SMeshBuffer* buffer = new SMeshBuffer();
+			mesh->addMeshBuffer(buffer);
+			buffer->drop();
+		}
+
+		SMeshBuffer* buffer = static_cast<SMeshBuffer*>(mesh->getMeshBuffer(0));
+		if (copy)
+		{
+			buffer->Vertices = InterpolationBuffer->Vertices;
+			buffer->Indices = InterpolationBuffer->Indices;
+			buffer->setDirty(EBT_INDEX);
+		}
+
+		interpolate(buffer, firstFrame, secondFrame, blend * MD2_FRAME_SHIFT_RECIPROCAL);
+		mesh->BoundingBox = buffer->BoundingBox;
+	}
+
+	// the material and hints may have been changed on the meshbuffer of the
+	// animated mesh since the frame was cached
+	SMeshBuffer* buffer = static_cast<SMeshBuffer*>(mesh->getMeshBuffer(0));
+	if (buffer->Material != InterpolationBuffer->Material)
+		buffer->Material = InterpolationBuffer->Material;
+	buffer->setHardwareMappingHint(InterpolationBuffer->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+	buffer->setHardwareMappingHint(InterpolationBuffer->getHardwareMappingHint_Index(), EBT_INDEX);
+
+	// the box of the animated mesh follows the most recent frame
+	InterpolationBuffer->BoundingBox = mesh->BoundingBox;
+	return mesh;
 }
 
 
@@ -289,19 +327,17 @@ IMeshBuffer* CAnimatedMeshMD2::getMeshBuffer(const video::SMaterial &material) c
 }
 
 
-// updates the interpolation buffer
-void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop, s32 endFrameLoop)
+// Returns the key frames and the blend between them in fixed point
+void CAnimatedMeshMD2::getKeyFrames(s32 frame, s32 startFrameLoop, s32 endFrameLoop,
+		u32& outFirst, u32& outSecond, s32& outBlend) const
 {
-	u32 firstFrame, secondFrame;
-	f32 div;
-
 	// TA: resolve missing ipol in loop between end-start
 
 	if (endFrameLoop - startFrameLoop == 0)
 	{
-		firstFrame = frame>>MD2_FRAME_SHIFT;
-		secondFrame = frame>>MD2_FRAME_SHIFT;
-		div = 1.0f;
+		outFirst = frame>>MD2_FRAME_SHIFT;
+		outSecond = frame>>MD2_FRAME_SHIFT;
+		outBlend = 0;
 	}
 	else
 	{
@@ -309,16 +345,24 @@ void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop,
 		u32 s = startFrameLoop >> MD2_FRAME_SHIFT;
 		u32 e = endFrameLoop >> MD2_FRAME_SHIFT;
 
-		firstFrame = frame >> MD2_FRAME_SHIFT;
-		secondFrame = core::if_c_a_else_b(firstFrame + 1 > e, s, firstFrame + 1);
+		outFirst = frame >> MD2_FRAME_SHIFT;
+		outSecond = core::if_c_a_else_b(outFirst + 1 > e, s, outFirst + 1);
 
-		firstFrame = core::s32_min(FrameCount - 1, firstFrame);
-		secondFrame = core::s32_min(FrameCount - 1, secondFrame);
+		outFirst = core::s32_min(FrameCount - 1, outFirst);
+		outSecond = core::s32_min(FrameCount - 1, outSecond);
 
-		//div = (frame % (1<<MD2_FRAME_SHIFT)) / (f32)(1<<MD2_FRAME_SHIFT);
-		frame &= (1<<MD2_FRAME_SHIFT) - 1;
-		div = frame * MD2_FRAME_SHIFT_RECIPROCAL;
+		outBlend = frame & ((1<<MD2_FRAME_SHIFT) - 1);
 	}
+}
+
+
+// updates the interpolation buffer
+void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop, s32 endFrameLoop)
+{
+	u32 firstFrame, secondFrame;
+	s32 blend;
+	getKeyFrames(frame, startFrameLoop, endFrameLoop, firstFrame, secondFrame, blend);
+	const f32 div = blend * MD2_FRAME_SHIFT_RECIPROCAL;
 
 	if ( firstFrame != InterpolationFirstFrame || secondFrame != InterpolationSecondFrame || div != InterpolationFrameDiv )
 	{
@@ -326,39 +370,45 @@ void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop,
 		InterpolationSecondFrame = secondFrame;
 		InterpolationFrameDiv = div;
 
-		video::S3DVertex* target = static_cast<video::S3DVertex*>(InterpolationBuffer->getVertices());
-		SMD2Vert* first = FrameList[firstFrame].pointer();
-		SMD2Vert* second = FrameList[secondFrame].pointer();
+		interpolate(InterpolationBuffer, firstFrame, secondFrame, div);
+	}
+}
 
-		// interpolate both frames
-		const u32 count = FrameList[firstFrame].size();
-		for (u32 i=0; i<count; ++i)
-		{
-			const core::vector3df one = core::vector3df(f32(first->Pos.X) * FrameTransforms[firstFrame].scale.X + FrameTransforms[firstFrame].translate.X,
-					f32(first->Pos.Y) * FrameTransforms[firstFrame].scale.Y + FrameTransforms[firstFrame].translate.Y,
-					f32(first->Pos.Z) * FrameTransforms[firstFrame].scale.Z + FrameTransforms[firstFrame].translate.Z);
-			const core::vector3df two = core::vector3df(f32(second->Pos.X) * FrameTransforms[secondFrame].scale.X + FrameTransforms[secondFrame].translate.X,
-					f32(second->Pos.Y) * FrameTransforms[secondFrame].scale.Y + FrameTransforms[secondFrame].translate.Y,
-					f32(second->Pos.Z) * FrameTransforms[secondFrame].scale.Z + FrameTransforms[secondFrame].translate.Z);
-			target->Pos = two.getInterpolated(one, div);
-			const core::vector3df n1(
-					Q2_VERTEX_NORMAL_TABLE[first->NormalIdx][0],
-					Q2_VERTEX_NORMAL_TABLE[first->NormalIdx][2],
-					Q2_VERTEX_NORMAL_TABLE[first->NormalIdx][1]);
-			const core::vector3df n2(
-					Q2_VERTEX_NORMAL_TABLE[second->NormalIdx][0],
-					Q2_VERTEX_NORMAL_TABLE[second->NormalIdx][2],
-					Q2_VERTEX_NORMAL_TABLE[second->NormalIdx][1]);
-			target->Normal = n2.getInterpolated(n1, div);
-			++target;
-			++first;
-			++second;
-		}
 
-		//update bounding box
-		InterpolationBuffer->setBoundingBox(BoxList[secondFrame].getInterpolated(BoxList[firstFrame], div));
-		InterpolationBuffer->setDirty();
+// interpolates the positions and normals of two key frames
+void CAnimatedMeshMD2::interpolate(SMeshBuffer* buffer, u32 firstFrame, u32 secondFrame, f32 div) const
+{
+	video::S3DVertex* target = static_cast<video::S3DVertex*>(buffer->getVertices());
+	const SMD2Vert* first = FrameList[firstFrame].const_pointer();
+	const SMD2Vert* second = FrameList[secondFrame].const_pointer();
+
+	const core::vector3df& firstScale = FrameTransforms[firstFrame].scale;
+	const core::vector3df& firstTranslate = FrameTransforms[firstFrame].translate;
+	const core::vector3df& secondScale = FrameTransforms[secondFrame].scale;
+	const core::vector3df& secondTranslate = FrameTransforms[secondFrame].translate;
+
+	// interpolate both frames
+	const u32 count = FrameList[firstFrame].size();
+	for (u32 i=0; i<count; ++i)
+	{
+		const core::vector3df one = core::vector3df(f32(first->Pos.X) * firstScale.X + firstTranslate.X,
+				f32(first->Pos.Y) * firstScale.Y + firstTranslate.Y,
+				f32(first->Pos.Z) * firstScale.Z + firstTranslate.Z);
+		const core::vector3df two = core::vector3df(f32(second->Pos.X) * secondScale.X + secondTranslate.X,
+				f32(second->Pos.Y) * secondScale.Y + secondTranslate.Y,
+				f32(second->Pos.Z) * secondScale.Z + secondTranslate.Z);
+		target->Pos = two.getInterpolated(one, div);
+		const f32* n1 = Q2_VERTEX_NORMAL_TABLE[first->NormalIdx];
+		const f32* n2 = Q2_VERTEX_NORMAL_TABLE[second->NormalIdx];
+		target->Normal = core::vector3df(n2[0], n2[2], n2[1]).getInterpolated(core::vector3df(n1[0], n1[2], n1[1]), div);
+		++target;
+		++first;
+		++second;
 	}
+
+	//update bounding box
+	buffer->setBoundingBox(BoxList[secondFrame].getInterpolated(BoxList[firstFrame], div));
+	buffer->setDirty(EBT_VERTEX);
 }
 
 
@@ -366,6 +416,7 @@ void CAnimatedMeshMD2::updateInterpolationBuffer(s32 frame, s32 startFrameLoop,
 void CAnimatedMeshMD2::setMaterialFlag(video::E_MATERIAL_FLAG flag, bool newvalue)
 {
 	InterpolationBuffer->Material.setFlag(flag, newvalue);
+	Cache.setMaterialFlag(flag, newvalue);
 }
 
 
@@ -374,6 +425,7 @@ void CAnimatedMeshMD2::setHardwareMappingHint(E_HARDWARE_MAPPING newMappingHint,
 		E_BUFFER_TYPE buffer)
 {
 	InterpolationBuffer->setHardwareMappingHint(newMappingHint, buffer);
+	Cache.setHardwareMappingHint(newMappingHint, buffer);
 }
 
 
@@ -381,6 +433,7 @@ void CAnimatedMeshMD2::setHardwareMappingHint(E_HARDWARE_MAPPING newMappingHint,
 void CAnimatedMeshMD2::setDirty(E_BUFFER_TYPE buffer)
 {
 	InterpolationBuffer->setDirty(buffer);
+	Cache.setDirty(buffer);
 }
 
 
@@ -8,6 +8,7 @@
 #include "IAnimatedMeshMD2.h"
 #include "IMesh.h"
 #include "CMeshBuffer.h"
+#include "CInterpolatedMeshCache.h"
 #include "irrArray.h"
 #include "irrString.h"
 
@@ -97,13 +98,18 @@ namespace scene
 		// exposed for loader
 		//
 
-		//! the buffer that contains the most recent animation
+		//! the buffer with the static vertex data, indices and material
+		/** Interpolated to the frame of updateInterpolationBuffer(). The
+		meshes returned by getMesh() are copies of it. */
 		SMeshBuffer* InterpolationBuffer;
 
 		//! Frames used to calculate InterpolationBuffer
 		u32 InterpolationFirstFrame, InterpolationSecondFrame;
 		f32 InterpolationFrameDiv;
 
+		//! updates the interpolation buffer
+		void updateInterpolationBuffer(s32 frame, s32 startFrame, s32 endFrame);
+
 		//! named animations
 		struct SAnimationData
 		{
@@ -143,8 +149,15 @@ namespace scene
 
 	private:
 
-		//! updates the interpolation buffer
-		void updateInterpolationBuffer(s32 frame, s32 startFrame, s32 endFrame);
+		//! Returns the key frames and the blend between them in fixed point
+		void getKeyFrames(s32 frame, s32 startFrameLoop, s32 endFrameLoop,
+			u32& outFirst, u32& outSecond, s32& outBlend) const;
+
+		//! Interpolates the positions and normals of two key frames into a buffer
+		void interpolate(SMeshBuffer* target, u32 firstFrame, u32 secondFrame, f32 div) const;
+
+		//! Interpolated frames shared by all nodes using this mesh
+		CInterpolatedMeshCache Cache;
 
 		f32 FramesPerSecond;
 	};
@@ -14,6 +14,34 @@ namespace scene
 {
 
 
+namespace
+{
+	//! Sine and cosine of the angles of compressed MD3 normals
+	struct SMD3NormalTable
+	{
+		SMD3NormalTable()
+		{
+			for (u32 i=0; i<256; ++i)
+			{
+				const f32 angle = i * 2.0f * core::PI / 255.0f;
+				Sin[i] = sinf(angle);
+				Cos[i] = cosf(angle);
+			}
+		}
+
+		//! Same as quake3::getMD3Normal without trigonometric functions
+		core::vector3df get(u32 i, u32 j) const
+		{
+			return core::vector3df(Cos[j] * Sin[i], Sin[j] * Sin[i], Cos[i]);
+		}
+
+		f32 Sin[256];
+		f32 Cos[256];
+	};
+
+	const SMD3NormalTable MD3NormalTable;
+}
+
 // byte-align structures
 #include "irrpack.h"
 
@@ -83,6 +111,10 @@ void CAnimatedMeshMD3::setInterpolationShift(u32 shift, u32 loopMode)
 {
 	IPolShift = shift;
 	LoopMode = loopMode;
+
+	// the blend of cached frames depends on the shift
+	Cache.invalidate();
+	Current = SCacheInfo();
 }
 
 
@@ -110,6 +142,7 @@ IMeshBuffer* CAnimatedMeshMD3::getMeshBuffer(const video::SMaterial &material) c
 void CAnimatedMeshMD3::setMaterialFlag(video::E_MATERIAL_FLAG flag, bool newvalue)
 {
 	MeshIPol->setMaterialFlag(flag, newvalue);
+	Cache.setMaterialFlag(flag, newvalue);
 }
 
 
@@ -118,6 +151,7 @@ void CAnimatedMeshMD3::setHardwareMappingHint(E_HARDWARE_MAPPING newMappingHint,
 		E_BUFFER_TYPE buffer)
 {
 	MeshIPol->setHardwareMappingHint(newMappingHint, buffer);
+	Cache.setHardwareMappingHint(newMappingHint, buffer);
 }
 
 
@@ -125,6 +159,7 @@ void CAnimatedMeshMD3::setHardwareMappingHint(E_HARDWARE_MAPPING newMappingHint,
 void CAnimatedMeshMD3::setDirty(E_BUFFER_TYPE buffer)
 {
 	MeshIPol->setDirty(buffer);
+	Cache.setDirty(buffer);
 }
 
 
@@ -152,10 +187,7 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 	if (0 == Mesh)
 		return 0;
 
-	//! check if we have the mesh in our private cache
-	SCacheInfo candidate(frame, startFrameLoop, endFrameLoop);
-	if (candidate == Current)
-		return MeshIPol;
+	const SCacheInfo candidate(frame, startFrameLoop, endFrameLoop);
 
 	startFrameLoop = core::s32_max(0, startFrameLoop >> IPolShift);
 	endFrameLoop = core::if_c_a_else_b(endFrameLoop < 0, Mesh->MD3Header.numFrames - 1, endFrameLoop >> IPolShift);
@@ -165,6 +197,7 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 	s32 frameA;
 	s32 frameB;
 	f32 iPol;
+	s32 blend;
 
 	if (LoopMode)
 	{
@@ -172,7 +205,8 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 		frame -= mask >> 1;
 
 		// interpolation
-		iPol = f32(frame & (mask - 1)) * core::reciprocal(f32(mask));
+		blend = frame & (mask - 1);
+		iPol = f32(blend) * core::reciprocal(f32(mask));
 
 		// wrap anim
 		frame >>= IPolShift;
@@ -184,7 +218,8 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 		// correct frame to "pixel center"
 		frame -= mask >> 1;
 
-		iPol = f32(frame & (mask - 1)) * core::reciprocal(f32(mask));
+		blend = frame & (mask - 1);
+		iPol = f32(blend) * core::reciprocal(f32(mask));
 
 		// clamp anim
 		frame >>= IPolShift;
@@ -192,20 +227,62 @@ IMesh* CAnimatedMeshMD3::getMesh(s32 frame, s32 detailLevel, s32 startFrameLoop,
 		frameB = core::s32_min(frameA + 1, endFrameLoop);
 	}
 
-	// build current vertex
-	for (u32 i = 0; i!= Mesh->Buffer.size(); ++i)
+	// build current tags
+	if (!(candidate == Current))
+	{
+		buildTagArray(frameA, frameB, iPol);
+		Current = candidate;
+	}
+
+	// nodes showing the same frame share the interpolated mesh
+	u32 version = 0;
+	for (u32 i = 0; i!= MeshIPol->getMeshBufferCount(); ++i)
+		version += MeshIPol->getMeshBuffer(i)->getChangedID_Vertex() + MeshIPol->getMeshBuffer(i)->getChangedID_Index();
+
+	SMesh* mesh;
+	bool copy;
+	if (Cache.get(frameA, frameB, blend, version, mesh, copy))
 	{
-		buildVertexArray(frameA, frameB, iPol,
-					Mesh->Buffer[i],
-					(SMeshBufferLightMap*) MeshIPol->getMeshBuffer(i));
+		// build current vertex
+		for (u32 i = 0; i!= Mesh->Buffer.size(); ++i)
+		{
+			if (i == mesh->getMeshBufferCount())
+			{
+				SMeshBufferLightMap* buffer = new SMeshBufferLightMap();
+				mesh->addMeshBuffer(buffer);
+				buffer->drop();
+			}
+
+			SMeshBufferLightMap* dest = (SMeshBufferLightMap*) mesh->getMeshBuffer(i);
+			if (copy)
+			{
+				const SMeshBufferLightMap* source = (SMeshBufferLightMap*) MeshIPol->getMeshBuffer(i);
+				dest->Vertices = source->Vertices;
+				dest->Indices = source->Indices;
+				dest->setDirty(EBT_INDEX);
+			}
+
+			buildVertexArray(frameA, frameB, iPol, Mesh->Buffer[i], dest);
+			dest->setDirty(EBT_VERTEX);
+		}
+		mesh->recalculateBoundingBox();
 	}
-	MeshIPol->recalculateBoundingBox();
 
-	// build current tags
-	buildTagArray(frameA, frameB, iPol);
+	// the materials and hints may have been changed on the meshbuffers of
+	// the animated mesh since the frame was cached
+	for (u32 i = 0; i!= mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* source = MeshIPol->getMeshBuffer(i);
+		IMeshBuffer* dest = mesh->getMeshBuffer(i);
+		if (dest->getMaterial() != source->getMaterial())
+			dest->getMaterial() = source->getMaterial();
+		dest->setHardwareMappingHint(source->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+		dest->setHardwareMappingHint(source->getHardwareMappingHint_Index(), EBT_INDEX);
+	}
 
-	Current = candidate;
-	return MeshIPol;
+	// the box of the animated mesh follows the most recent frame
+	MeshIPol->BoundingBox = mesh->BoundingBox;
+	return mesh;
 }
 
 
@@ -258,26 +335,24 @@ void CAnimatedMeshMD3::buildVertexArray(u32 frameA, u32 frameB, f32 interpolate,
 	const u32 frameOffsetA = frameA * source->MeshHeader.numVertices;
 	const u32 frameOffsetB = frameB * source->MeshHeader.numVertices;
 	const f32 scale = (1.f/ 64.f);
+	const SMD3Vertex* vA = source->Vertices.const_pointer() + frameOffsetA;
+	const SMD3Vertex* vB = source->Vertices.const_pointer() + frameOffsetB;
+	video::S3DVertex2TCoords* v = dest->Vertices.pointer();
 
-	for (s32 i = 0; i != source->MeshHeader.numVertices; ++i)
+	for (s32 i = 0; i != source->MeshHeader.numVertices; ++i, ++v, ++vA, ++vB)
 	{
-		video::S3DVertex2TCoords &v = dest->Vertices [ i ];
-
-		const SMD3Vertex &vA = source->Vertices [ frameOffsetA + i ];
-		const SMD3Vertex &vB = source->Vertices [ frameOffsetB + i ];
-
 		// position
-		v.Pos.X = scale * (vA.position[0] + interpolate * (vB.position[0] - vA.position[0]));
-		v.Pos.Y = scale * (vA.position[2] + interpolate * (vB.position[2] - vA.position[2]));
-		v.Pos.Z = scale * (vA.position[1] + interpolate * (vB.position[1] - vA.position[1]));
+		v->Pos.X = scale * (vA->position[0] + interpolate * (vB->position[0] - vA->position[0]));
+		v->Pos.Y = scale * (vA->position[2] + interpolate * (vB->position[2] - vA->position[2]));
+		v->Pos.Z = scale * (vA->position[1] + interpolate * (vB->position[1] - vA->position[1]));
 
 		// normal
-		const core::vector3df nA(quake3::getMD3Normal(vA.normal[0], vA.normal[1]));
-		const core::vector3df nB(quake3::getMD3Normal(vB.normal[0], vB.normal[1]));
+		const core::vector3df nA(MD3NormalTable.get(vA->normal[0], vA->normal[1]));
+		const core::vector3df nB(MD3NormalTable.get(vB->normal[0], vB->normal[1]));
 
-		v.Normal.X = nA.X + interpolate * (nB.X - nA.X);
-		v.Normal.Y = nA.Z + interpolate * (nB.Z - nA.Z);
-		v.Normal.Z = nA.Y + interpolate * (nB.Y - nA.Y);
+		v->Normal.X = nA.X + interpolate * (nB.X - nA.X);
+		v->Normal.Y = nA.Z + interpolate * (nB.Z - nA.Z);
+		v->Normal.Z = nA.Y + interpolate * (nB.Y - nA.Y);
 	}
 
 	dest->recalculateBoundingBox();
@@ -430,6 +505,8 @@ bool CAnimatedMeshMD3::loadModelFile(u32 modelIndex, io::IReadFile* file,
 		MeshIPol->addMeshBuffer(buffer);
 		buffer->drop();
 	}
+	for (i = 0; i != Mesh->Buffer.size(); ++i)
+		buildVertexArray(0, 0, 0.f, Mesh->Buffer[i], (SMeshBufferLightMap*) MeshIPol->getMeshBuffer(i));
 	MeshIPol->recalculateBoundingBox();
 
 	// Init Tag Interpolation
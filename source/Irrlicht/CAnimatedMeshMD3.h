@@ -10,6 +10,7 @@
 #include "IFileSystem.h"
 #include "SMesh.h"
 #include "CMeshBuffer.h"
+#include "CInterpolatedMeshCache.h"
 
 namespace irr
 {
@@ -107,12 +108,16 @@ namespace scene
 			s32 startFrameLoop;
 			s32 endFrameLoop;
 		};
+		//! frame of TagListIPol
 		SCacheInfo Current;
 
-		//! return a Mesh per frame
+		//! static vertex data, indices and materials of the interpolated meshes
 		SMesh* MeshIPol;
 		SMD3QuaternionTagList TagListIPol;
 
+		//! Interpolated frames shared by all nodes using this mesh
+		CInterpolatedMeshCache Cache;
+
 		IMeshBuffer* createMeshBuffer(const SMD3MeshBuffer* source,
 				const io::IFileSystem* fs, video::IVideoDriver* driver);
 
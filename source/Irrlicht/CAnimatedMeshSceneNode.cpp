@@ -39,7 +39,7 @@ CAnimatedMeshSceneNode::CAnimatedMeshSceneNode(IAnimatedMesh* mesh,
 	TransitionTime(0), Transiting(0.f), TransitingBlend(0.f),
 	JointMode(EJUOR_NONE), JointsUsed(false),
 	Looping(true), ReadOnlyMaterials(false), RenderFromIdentity(false),
-	LoopCallBack(0), PassCount(0), Shadow(0), MD3Special(0)
+	LoopCallBack(0), PassCount(0), Shadow(0), ShadowOfMesh(false), MD3Special(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CAnimatedMeshSceneNode");
@@ -293,7 +293,12 @@ void CAnimatedMeshSceneNode::render()
 	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
 
 	if (Shadow && PassCount==1)
+	{
+		// vertex animated meshes return another mesh for each frame
+		if (ShadowOfMesh && m)
+			Shadow->setShadowMesh(m);
 		Shadow->updateShadowVolumes();
+	}
 
 	// for debug purposes only:
 
@@ -559,6 +564,7 @@ IShadowVolumeSceneNode* CAnimatedMeshSceneNode::addShadowVolumeSceneNode(
 
 	if (!shadowMesh)
 		shadowMesh = Mesh; // if null is given, use the mesh of node
+	ShadowOfMesh = (shadowMesh == Mesh);
 
 	if (Shadow)
 		Shadow->drop();
@@ -1111,6 +1117,7 @@ ISceneNode* CAnimatedMeshSceneNode::clone(ISceneNode* newParent, ISceneManager*
 	newNode->Shadow = Shadow;
 	if (newNode->Shadow)
 		newNode->Shadow->grab();
+	newNode->ShadowOfMesh = ShadowOfMesh;
 	newNode->JointChildSceneNodes = JointChildSceneNodes;
 	newNode->PretransitingSave = PretransitingSave;
 	newNode->RenderFromIdentity = RenderFromIdentity;
@@ -196,6 +196,8 @@ namespace scene
 		s32 PassCount;
 
 		IShadowVolumeSceneNode* Shadow;
+		//! Shadow is cast by the animated mesh, so it gets the mesh of the current frame
+		bool ShadowOfMesh;
 
 		core::array<IBoneSceneNode* > JointChildSceneNodes;
 		core::array<core::matrix4> PretransitingSave;
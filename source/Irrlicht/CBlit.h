@@ -7,6 +7,12 @@
 
 #include "SoftwareDriver2_helper.h"
 
+//! SSE2 integer code for the 32 bit blend, SSE alone has no integer vectors
+#if defined(_IRR_COMPILE_WITH_SSE_) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define CBLIT_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 
@@ -483,6 +489,67 @@ static void RenderLine16_Blend(video::IImage *t,
 }
 
 
+/*!
+	Same result as PixelBlend32, without the alpha test branches.
+	Faster for images mixing transparent, translucent and opaque pixels,
+	like antialiased fonts and gui skins, where the branches mispredict.
+*/
+inline u32 PixelBlend32_noBranch(const u32 c2, const u32 c1)
+{
+	u32 alpha = c1 >> 24;
+
+	// transparent keeps the destination alpha, opaque (256) returns the source color
+	const u32 blendAlpha = alpha ? (c1 & 0xFF000000) : (c2 & 0xFF000000);
+	alpha += (alpha >> 7);
+
+	const u32 dstRB = c2 & 0x00FF00FF;
+	const u32 dstXG = c2 & 0x0000FF00;
+
+	u32 rb = (c1 & 0x00FF00FF) - dstRB;
+	u32 xg = (c1 & 0x0000FF00) - dstXG;
+
+	rb = ((rb * alpha) >> 8) + dstRB;
+	xg = ((xg * alpha) >> 8) + dstXG;
+
+	return blendAlpha | (rb & 0x00FF00FF) | (xg & 0x0000FF00);
+}
+
+#if defined(CBLIT_USE_SSE2)
+//! 32 bit multiplication of 4 lanes, like the u32 multiplication of the plain code
+inline __m128i mul32_sse2(const __m128i a, const __m128i b)
+{
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+//! PixelBlend32_noBranch of 4 pixels, with the same results
+inline __m128i PixelBlend32_sse2(const __m128i c2, const __m128i c1)
+{
+	const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+	const __m128i maskXG = _mm_set1_epi32(0x0000FF00);
+	const __m128i maskA = _mm_set1_epi32((int)0xFF000000);
+
+	__m128i alpha = _mm_srli_epi32(c1, 24);
+
+	// transparent keeps the destination alpha
+	const __m128i transparent = _mm_cmpeq_epi32(alpha, _mm_setzero_si128());
+	const __m128i blendAlpha = _mm_and_si128(_mm_or_si128(_mm_andnot_si128(transparent, c1), _mm_and_si128(transparent, c2)), maskA);
+	alpha = _mm_add_epi32(alpha, _mm_srli_epi32(alpha, 7));
+
+	const __m128i dstRB = _mm_and_si128(c2, maskRB);
+	const __m128i dstXG = _mm_and_si128(c2, maskXG);
+
+	__m128i rb = _mm_sub_epi32(_mm_and_si128(c1, maskRB), dstRB);
+	__m128i xg = _mm_sub_epi32(_mm_and_si128(c1, maskXG), dstXG);
+
+	rb = _mm_add_epi32(_mm_srli_epi32(mul32_sse2(rb, alpha), 8), dstRB);
+	xg = _mm_add_epi32(_mm_srli_epi32(mul32_sse2(xg, alpha), 8), dstXG);
+
+	return _mm_or_si128(blendAlpha, _mm_or_si128(_mm_and_si128(rb, maskRB), _mm_and_si128(xg, maskXG)));
+}
+#endif
+
 /*!
 */
 static void executeBlit_TextureCopy_x_to_x( const SBlitJob * job )
@@ -821,6 +888,37 @@ static void executeBlit_TextureCopy_32_to_24( const SBlitJob * job )
 */
 static void executeBlit_TextureBlend_16_to_16( const SBlitJob * job )
 {
+	if (!job->stretch)
+	{
+		const u16* src = (const u16*)job->src;
+		u16* dst = (u16*)job->dst;
+		for (u32 dy = 0; dy != job->height; ++dy)
+		{
+			u32 dx = 0;
+
+			// two pixels at once, if source and destination have the same alignment
+			if ((((size_t)src ^ (size_t)dst) & 3) == 0)
+			{
+				if (((size_t)dst & 3) && dx != job->width)
+				{
+					dst[0] = PixelBlend16(dst[0], src[0]);
+					dx = 1;
+				}
+				const u32* src2 = (const u32*)(src + dx);
+				u32* dst2 = (u32*)(dst + dx);
+				for (u32 i = 0; i != (job->width - dx) >> 1; ++i)
+					dst2[i] = PixelBlend16_simd(dst2[i], src2[i]);
+				dx += (job->width - dx) & ~1u;
+			}
+			for (; dx != job->width; ++dx)
+				dst[dx] = PixelBlend16(dst[dx], src[dx]);
+
+			src = (const u16*)((const u8*)(src)+job->srcPitch);
+			dst = (u16*)((u8*)(dst)+job->dstPitch);
+		}
+		return;
+	}
+
 	const f18 wscale = f32_to_f18(job->x_stretch);
 	const f18 hscale = f32_to_f18(job->y_stretch);
 
@@ -843,6 +941,29 @@ static void executeBlit_TextureBlend_16_to_16( const SBlitJob * job )
 */
 static void executeBlit_TextureBlend_32_to_32( const SBlitJob * job )
 {
+	if (!job->stretch)
+	{
+		const u32* src = (const u32*)job->src;
+		u32* dst = (u32*)job->dst;
+		for (u32 dy = 0; dy != job->height; ++dy)
+		{
+			u32 dx = 0;
+#if defined(CBLIT_USE_SSE2)
+			for (; dx + 4 <= job->width; dx += 4)
+			{
+				const __m128i c2 = _mm_loadu_si128((const __m128i*)(dst + dx));
+				const __m128i c1 = _mm_loadu_si128((const __m128i*)(src + dx));
+				_mm_storeu_si128((__m128i*)(dst + dx), PixelBlend32_sse2(c2, c1));
+			}
+#endif
+			for (; dx != job->width; ++dx)
+				dst[dx] = PixelBlend32_noBranch(dst[dx], src[dx]);
+			src = (const u32*)((const u8*)(src)+job->srcPitch);
+			dst = (u32*)((u8*)(dst)+job->dstPitch);
+		}
+		return;
+	}
+
 	const f18 wscale = f32_to_f18(job->x_stretch);
 	const f18 hscale = f32_to_f18(job->y_stretch);
 
@@ -853,9 +974,26 @@ static void executeBlit_TextureBlend_32_to_32( const SBlitJob * job )
 		const u32* src = (u32*)((u8*)(job->src) + job->srcPitch*f18_floor(src_y));
 
 		f18 src_x = f18_zero;
-		for (u32 dx = 0; dx < job->width; ++dx, src_x += wscale)
+		u32 dx = 0;
+#if defined(CBLIT_USE_SSE2)
+		for (; dx + 4 <= job->width; dx += 4)
 		{
-			dst[dx] = PixelBlend32(dst[dx], src[f18_floor(src_x)]);
+			const u32 s0 = src[f18_floor(src_x)];
+			src_x += wscale;
+			const u32 s1 = src[f18_floor(src_x)];
+			src_x += wscale;
+			const u32 s2 = src[f18_floor(src_x)];
+			src_x += wscale;
+			const u32 s3 = src[f18_floor(src_x)];
+			src_x += wscale;
+			const __m128i c2 = _mm_loadu_si128((const __m128i*)(dst + dx));
+			const __m128i c1 = _mm_set_epi32((int)s3, (int)s2, (int)s1, (int)s0);
+			_mm_storeu_si128((__m128i*)(dst + dx), PixelBlend32_sse2(c2, c1));
+		}
+#endif
+		for (; dx < job->width; ++dx, src_x += wscale)
+		{
+			dst[dx] = PixelBlend32_noBranch(dst[dx], src[f18_floor(src_x)]);
 		}
 		dst = (u32*)((u8*)(dst)+job->dstPitch);
 	}
@@ -893,6 +1031,20 @@ static void executeBlit_TextureBlendColor_16_to_16( const SBlitJob * job )
 */
 static void executeBlit_TextureBlendColor_32_to_32( const SBlitJob * job )
 {
+	if (!job->stretch)
+	{
+		const u32* src = (const u32*)job->src;
+		u32* dst = (u32*)job->dst;
+		for (u32 dy = 0; dy != job->height; ++dy)
+		{
+			for (u32 dx = 0; dx != job->width; ++dx)
+				dst[dx] = PixelBlend32_noBranch(dst[dx], PixelMul32_2(src[dx], job->argb));
+			src = (const u32*)((const u8*)(src)+job->srcPitch);
+			dst = (u32*)((u8*)(dst)+job->dstPitch);
+		}
+		return;
+	}
+
 	const f18 wscale = f32_to_f18(job->x_stretch);
 	const f18 hscale = f32_to_f18(job->y_stretch);
 
@@ -905,7 +1057,7 @@ static void executeBlit_TextureBlendColor_32_to_32( const SBlitJob * job )
 		f18 src_x = f18_zero;
 		for (u32 dx = 0; dx < job->width; ++dx, src_x += wscale)
 		{
-			dst[dx] = PixelBlend32(dst[dx], PixelMul32_2(src[f18_floor(src_x)], job->argb));
+			dst[dx] = PixelBlend32_noBranch(dst[dx], PixelMul32_2(src[f18_floor(src_x)], job->argb));
 		}
 		dst = (u32*)((u8*)(dst)+job->dstPitch);
 	}
@@ -968,6 +1120,18 @@ static void executeBlit_ColorAlpha_32_to_32( const SBlitJob * job )
 		return;
 
 	u32 *dst = (u32*)job->dst;
+
+	// full alpha replaces the color. PixelBlend32 with alpha clears the alpha channel
+	if (256 == alpha)
+	{
+		for ( u32 dy = 0; dy < job->height; ++dy )
+		{
+			memset32( dst, job->argb & 0x00FFFFFF, job->width * 4 );
+			dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+		}
+		return;
+	}
+
 	for ( u32 dy = 0; dy < job->height; ++dy )
 	{
 		for ( u32 dx = 0; dx < job->width; ++dx )
@@ -1197,7 +1361,9 @@ static void executeBlit_TextureCombineColor_32_to_32( const SBlitJob * job )
 	{
 		for (u32 dx = 0; dx != job->width; ++dx )
 		{
-			dst[dx] = PixelCombine32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
+			// transparent source pixels keep the destination
+			if (src[dx] & 0xFF000000)
+				dst[dx] = PixelCombine32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
 		}
 		src = (u32*) ( (u8*) (src) + job->srcPitch );
 		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
@@ -6,11 +6,75 @@
 #include "IImage.h"
 #include "os.h"
 
+//! SSE2 integer code for the 16 bit conversions, SSE alone has no integer vectors
+#if defined(_IRR_COMPILE_WITH_SSE_) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define COLOR_CONVERTER_USE_SSE2
+	#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 namespace video
 {
 
+#if defined(COLOR_CONVERTER_USE_SSE2)
+namespace
+{
+
+//! Packs the low 16 bits of the 32 bit lanes of a and b into one vector
+inline __m128i pack32to16(const __m128i a, const __m128i b)
+{
+	// _mm_packs_epi32 saturates signed values, sign extended low halves pass unchanged
+	return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+}
+
+//! A8R8G8B8toA1R5G5B5 of 4 pixels, the results are in the low 16 bits
+inline __m128i A8R8G8B8toA1R5G5B5_sse2(const __m128i c)
+{
+	return _mm_or_si128(_mm_or_si128(
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32((int)0x80000000)), 16),
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00F80000)), 9)), _mm_or_si128(
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000F800)), 6),
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000000F8)), 3)));
+}
+
+//! A8R8G8B8toR5G6B5 of 4 pixels, the results are in the low 16 bits
+inline __m128i A8R8G8B8toR5G6B5_sse2(const __m128i c)
+{
+	return _mm_or_si128(_mm_or_si128(
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00F80000)), 8),
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000FC00)), 5)),
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000000F8)), 3));
+}
+
+//! A1R5G5B5toA8R8G8B8 of 4 pixels in the low 16 bits of the lanes
+inline __m128i A1R5G5B5toA8R8G8B8_sse2(const __m128i c)
+{
+	const __m128i alpha = _mm_and_si128(_mm_srai_epi32(_mm_slli_epi32(c, 16), 31), _mm_set1_epi32((int)0xFF000000));
+	const __m128i r = _mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00007C00)), 9),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00007000)), 4));
+	const __m128i g = _mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x000003E0)), 6),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x00000380)), 1));
+	const __m128i b = _mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000001F)), 3),
+		_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0000001C)), 2));
+	return _mm_or_si128(_mm_or_si128(alpha, r), _mm_or_si128(g, b));
+}
+
+//! R5G6B5toA8R8G8B8 of 4 pixels in the low 16 bits of the lanes
+inline __m128i R5G6B5toA8R8G8B8_sse2(const __m128i c)
+{
+	return _mm_or_si128(_mm_or_si128(_mm_set1_epi32((int)0xFF000000),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0xF800)), 8)), _mm_or_si128(
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x07E0)), 5),
+		_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3)));
+}
+
+} // end anonymous namespace
+#endif
+
 //! converts a monochrome bitmap to A1R5G5B5 data
 void CColorConverter::convert1BitTo16Bit(const u8* in, s16* out, u32 width, u32 height, u32 linepad, bool flip, s16 col0, s16 col1)
 {
@@ -332,9 +396,9 @@ void CColorConverter::convert_A1R5G5B5toR8G8B8(const void* sP, u32 sN, void* dP)
 
 	for (u32 x = 0; x < sN; ++x)
 	{
-		dB[2] = (*sB & 0x7c00) >> 7;
+		dB[0] = (*sB & 0x7c00) >> 7;
 		dB[1] = (*sB & 0x03e0) >> 2;
-		dB[0] = (*sB & 0x1f) << 3;
+		dB[2] = (*sB & 0x1f) << 3;
 
 		sB += 1;
 		dB += 3;
@@ -348,9 +412,9 @@ void CColorConverter::convert_A1R5G5B5toB8G8R8(const void* sP, u32 sN, void* dP)
 
 	for (u32 x = 0; x < sN; ++x)
 	{
-		dB[0] = (*sB & 0x7c00) >> 7;
+		dB[2] = (*sB & 0x7c00) >> 7;
 		dB[1] = (*sB & 0x03e0) >> 2;
-		dB[2] = (*sB & 0x1f) << 3;
+		dB[0] = (*sB & 0x1f) << 3;
 
 		sB += 1;
 		dB += 3;
@@ -362,7 +426,16 @@ void CColorConverter::convert_A1R5G5B5toA8R8G8B8(const void* sP, u32 sN, void* d
 	u16* sB = (u16*)sP;
 	u32* dB = (u32*)dP;
 
-	for (u32 x = 0; x < sN; ++x)
+	u32 x = 0;
+#if defined(COLOR_CONVERTER_USE_SSE2)
+	for (; x + 8 <= sN; x += 8, sB += 8, dB += 8)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)sB);
+		_mm_storeu_si128((__m128i*)dB, A1R5G5B5toA8R8G8B8_sse2(_mm_unpacklo_epi16(c, _mm_setzero_si128())));
+		_mm_storeu_si128((__m128i*)(dB + 4), A1R5G5B5toA8R8G8B8_sse2(_mm_unpackhi_epi16(c, _mm_setzero_si128())));
+	}
+#endif
+	for (; x < sN; ++x)
 		*dB++ = A1R5G5B5toA8R8G8B8(*sB++);
 }
 
@@ -376,7 +449,17 @@ void CColorConverter::convert_A1R5G5B5toR5G6B5(const void* sP, u32 sN, void* dP)
 	u16* sB = (u16*)sP;
 	u16* dB = (u16*)dP;
 
-	for (u32 x = 0; x < sN; ++x)
+	u32 x = 0;
+#if defined(COLOR_CONVERTER_USE_SSE2)
+	for (; x + 8 <= sN; x += 8, sB += 8, dB += 8)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)sB);
+		_mm_storeu_si128((__m128i*)dB, _mm_or_si128(
+			_mm_slli_epi16(_mm_and_si128(c, _mm_set1_epi16(0x7FE0)), 1),
+			_mm_and_si128(c, _mm_set1_epi16(0x1F))));
+	}
+#endif
+	for (; x < sN; ++x)
 		*dB++ = A1R5G5B5toR5G6B5(*sB++);
 }
 
@@ -424,7 +507,16 @@ void CColorConverter::convert_A8R8G8B8toA1R5G5B5(const void* sP, u32 sN, void* d
 	u32* sB = (u32*)sP;
 	u16* dB = (u16*)dP;
 
-	for (u32 x = 0; x < sN; ++x)
+	u32 x = 0;
+#if defined(COLOR_CONVERTER_USE_SSE2)
+	for (; x + 8 <= sN; x += 8, sB += 8, dB += 8)
+	{
+		_mm_storeu_si128((__m128i*)dB, pack32to16(
+			A8R8G8B8toA1R5G5B5_sse2(_mm_loadu_si128((const __m128i*)sB)),
+			A8R8G8B8toA1R5G5B5_sse2(_mm_loadu_si128((const __m128i*)(sB + 4)))));
+	}
+#endif
+	for (; x < sN; ++x)
 		*dB++ = A8R8G8B8toA1R5G5B5(*sB++);
 }
 
@@ -452,7 +544,16 @@ void CColorConverter::convert_A8R8G8B8toR5G6B5(const void* sP, u32 sN, void* dP)
 	u8 * sB = (u8 *)sP;
 	u16* dB = (u16*)dP;
 
-	for (u32 x = 0; x < sN; ++x)
+	u32 x = 0;
+#if defined(COLOR_CONVERTER_USE_SSE2)
+	for (; x + 8 <= sN; x += 8, sB += 32, dB += 8)
+	{
+		_mm_storeu_si128((__m128i*)dB, pack32to16(
+			A8R8G8B8toR5G6B5_sse2(_mm_loadu_si128((const __m128i*)sB)),
+			A8R8G8B8toR5G6B5_sse2(_mm_loadu_si128((const __m128i*)(sB + 16)))));
+	}
+#endif
+	for (; x < sN; ++x)
 	{
 		s32 r = sB[2] >> 3;
 		s32 g = sB[1] >> 2;
@@ -624,7 +725,16 @@ void CColorConverter::convert_R5G6B5toA8R8G8B8(const void* sP, u32 sN, void* dP)
 	u16* sB = (u16*)sP;
 	u32* dB = (u32*)dP;
 
-	for (u32 x = 0; x < sN; ++x)
+	u32 x = 0;
+#if defined(COLOR_CONVERTER_USE_SSE2)
+	for (; x + 8 <= sN; x += 8, sB += 8, dB += 8)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)sB);
+		_mm_storeu_si128((__m128i*)dB, R5G6B5toA8R8G8B8_sse2(_mm_unpacklo_epi16(c, _mm_setzero_si128())));
+		_mm_storeu_si128((__m128i*)(dB + 4), R5G6B5toA8R8G8B8_sse2(_mm_unpackhi_epi16(c, _mm_setzero_si128())));
+	}
+#endif
+	for (; x < sN; ++x)
 		*dB++ = R5G6B5toA8R8G8B8(*sB++);
 }
 
@@ -633,7 +743,17 @@ void CColorConverter::convert_R5G6B5toA1R5G5B5(const void* sP, u32 sN, void* dP)
 	u16* sB = (u16*)sP;
 	u16* dB = (u16*)dP;
 
-	for (u32 x = 0; x < sN; ++x)
+	u32 x = 0;
+#if defined(COLOR_CONVERTER_USE_SSE2)
+	for (; x + 8 <= sN; x += 8, sB += 8, dB += 8)
+	{
+		const __m128i c = _mm_loadu_si128((const __m128i*)sB);
+		_mm_storeu_si128((__m128i*)dB, _mm_or_si128(_mm_or_si128(_mm_set1_epi16((short)0x8000),
+			_mm_srli_epi16(_mm_and_si128(c, _mm_set1_epi16((short)0xFFC0)), 1)),
+			_mm_and_si128(c, _mm_set1_epi16(0x1F))));
+	}
+#endif
+	for (; x < sN; ++x)
 		*dB++ = R5G6B5toA1R5G5B5(*sB++);
 }
 
@@ -695,116 +815,65 @@ bool CColorConverter::canConvertFormat(ECOLOR_FORMAT sourceFormat, ECOLOR_FORMAT
 	return false;
 }
 
-void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, u32 sN,
-				void* dP, ECOLOR_FORMAT dF)
+CColorConverter::tConvertFunc CColorConverter::getConvertFunc(ECOLOR_FORMAT sF, ECOLOR_FORMAT dF)
 {
-	// please also update can_convert_viaFormat when adding new conversions
+	// please also update canConvertFormat when adding new conversions
 	switch (sF)
 	{
 		case ECF_A1R5G5B5:
 			switch (dF)
 			{
-				case ECF_A1R5G5B5:
-					convert_A1R5G5B5toA1R5G5B5(sP, sN, dP);
-				break;
-				case ECF_R5G6B5:
-					convert_A1R5G5B5toR5G6B5(sP, sN, dP);
-				break;
-				case ECF_A8R8G8B8:
-					convert_A1R5G5B5toA8R8G8B8(sP, sN, dP);
-				break;
-				case ECF_R8G8B8:
-					convert_A1R5G5B5toR8G8B8(sP, sN, dP);
-				break;
-				IRR_CASE_IIMAGE_COMPRESSED_FORMAT
-					os::Printer::log("CColorConverter::convert_viaFormat method doesn't support compressed images.", ELL_WARNING);
-				break;
-#ifndef _DEBUG
-				default:
-					break;
-#endif
+				case ECF_A1R5G5B5: return convert_A1R5G5B5toA1R5G5B5;
+				case ECF_R5G6B5: return convert_A1R5G5B5toR5G6B5;
+				case ECF_A8R8G8B8: return convert_A1R5G5B5toA8R8G8B8;
+				case ECF_R8G8B8: return convert_A1R5G5B5toR8G8B8;
+				default: break;
 			}
 		break;
 		case ECF_R5G6B5:
 			switch (dF)
 			{
-				case ECF_A1R5G5B5:
-					convert_R5G6B5toA1R5G5B5(sP, sN, dP);
-				break;
-				case ECF_R5G6B5:
-					convert_R5G6B5toR5G6B5(sP, sN, dP);
-				break;
-				case ECF_A8R8G8B8:
-					convert_R5G6B5toA8R8G8B8(sP, sN, dP);
-				break;
-				case ECF_R8G8B8:
-					convert_R5G6B5toR8G8B8(sP, sN, dP);
-				break;
-				IRR_CASE_IIMAGE_COMPRESSED_FORMAT
-					os::Printer::log("CColorConverter::convert_viaFormat method doesn't support compressed images.", ELL_WARNING);
-				break;
-#ifndef _DEBUG
-				default:
-					break;
-#endif
+				case ECF_A1R5G5B5: return convert_R5G6B5toA1R5G5B5;
+				case ECF_R5G6B5: return convert_R5G6B5toR5G6B5;
+				case ECF_A8R8G8B8: return convert_R5G6B5toA8R8G8B8;
+				case ECF_R8G8B8: return convert_R5G6B5toR8G8B8;
+				default: break;
 			}
 		break;
 		case ECF_A8R8G8B8:
 			switch (dF)
 			{
-				case ECF_A1R5G5B5:
-					convert_A8R8G8B8toA1R5G5B5(sP, sN, dP);
-				break;
-				case ECF_R5G6B5:
-					convert_A8R8G8B8toR5G6B5(sP, sN, dP);
-				break;
-				case ECF_A8R8G8B8:
-					convert_A8R8G8B8toA8R8G8B8(sP, sN, dP);
-				break;
-				case ECF_R8G8B8:
-					convert_A8R8G8B8toR8G8B8(sP, sN, dP);
-				break;
-				IRR_CASE_IIMAGE_COMPRESSED_FORMAT
-					os::Printer::log("CColorConverter::convert_viaFormat method doesn't support compressed images.", ELL_WARNING);
-				break;
-#ifndef _DEBUG
-				default:
-					break;
-#endif
+				case ECF_A1R5G5B5: return convert_A8R8G8B8toA1R5G5B5;
+				case ECF_R5G6B5: return convert_A8R8G8B8toR5G6B5;
+				case ECF_A8R8G8B8: return convert_A8R8G8B8toA8R8G8B8;
+				case ECF_R8G8B8: return convert_A8R8G8B8toR8G8B8;
+				default: break;
 			}
 		break;
 		case ECF_R8G8B8:
 			switch (dF)
 			{
-				case ECF_A1R5G5B5:
-					convert_R8G8B8toA1R5G5B5(sP, sN, dP);
-				break;
-				case ECF_R5G6B5:
-					convert_R8G8B8toR5G6B5(sP, sN, dP);
-				break;
-				case ECF_A8R8G8B8:
-					convert_R8G8B8toA8R8G8B8(sP, sN, dP);
-				break;
-				case ECF_R8G8B8:
-					convert_R8G8B8toR8G8B8(sP, sN, dP);
-				break;
-				IRR_CASE_IIMAGE_COMPRESSED_FORMAT
-					os::Printer::log("CColorConverter::convert_viaFormat method doesn't support compressed images.", ELL_WARNING);
-				break;
-#ifndef _DEBUG
-				default:
-					break;
-#endif
+				case ECF_A1R5G5B5: return convert_R8G8B8toA1R5G5B5;
+				case ECF_R5G6B5: return convert_R8G8B8toR5G6B5;
+				case ECF_A8R8G8B8: return convert_R8G8B8toA8R8G8B8;
+				case ECF_R8G8B8: return convert_R8G8B8toR8G8B8;
+				default: break;
 			}
 		break;
-		IRR_CASE_IIMAGE_COMPRESSED_FORMAT
-			os::Printer::log("CColorConverter::convert_viaFormat method doesn't support compressed images.", ELL_WARNING);
-			break;
-#ifndef _DEBUG
 		default:
 		break;
-#endif
 	}
+	return 0;
+}
+
+void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, u32 sN,
+				void* dP, ECOLOR_FORMAT dF)
+{
+	tConvertFunc convert = getConvertFunc(sF, dF);
+	if (convert)
+		convert(sP, sN, dP);
+	else if (IImage::isCompressedFormat(sF) || IImage::isCompressedFormat(dF))
+		os::Printer::log("CColorConverter::convert_viaFormat method doesn't support compressed images.", ELL_WARNING);
 }
 
 
@@ -17,6 +17,9 @@ class CColorConverter
 {
 public:
 
+	//! Type of the convert_ functions converting sN pixels from sP into dP
+	typedef void (*tConvertFunc)(const void* sP, u32 sN, void* dP);
+
 	//! converts a monochrome bitmap to A1R5G5B5
 	static void convert1BitTo16Bit(const u8* in, s16* out, u32 width, u32 height, u32 linepad=0, bool flip=false, s16 col0=(s16)0x8000, s16 col1=(s16)0xffff);
 
@@ -86,6 +89,11 @@ public:
 	static void convert_R5G6B5toA1R5G5B5(const void* sP, u32 sN, void* dP);
 	static void convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, u32 sN,
 				void* dP, ECOLOR_FORMAT dF);
+
+	//! Returns the function convert_viaFormat uses for the formats, 0 if they can't be converted.
+	/** Resolving the function once avoids the format switch when converting
+	many small spans, like single pixels or rows. */
+	static tConvertFunc getConvertFunc(ECOLOR_FORMAT sF, ECOLOR_FORMAT dF);
 	// Check if convert_viaFormat is usable
 	static bool canConvertFormat(ECOLOR_FORMAT sourceFormat, ECOLOR_FORMAT destFormat);
 };
@@ -700,6 +700,7 @@ bool CD3D9Driver::setActiveTexture(u32 stage, const video::ITexture* texture)
 		return true;
 
 	CurrentTexture[stage] = texture;
+	++FrameStats.TextureBinds;
 
 	if (!texture)
 	{
@@ -881,6 +882,7 @@ bool CD3D9Driver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag, SColor
 	CurrentRenderTarget = target;
 
 	clearBuffers(clearFlag, clearColor, clearDepth, clearStencil);
+	++FrameStats.RenderTargetSwitches;
 
 	return true;
 }
@@ -976,6 +978,9 @@ bool CD3D9Driver::updateVertexHardwareBuffer(SHWBufferLink_d3d9 *hwBuffer)
 		hwBuffer->vertexBuffer->Unlock();
 	}
 
+	++FrameStats.HardwareBufferUploads;
+	FrameStats.HardwareBufferUploadBytes += bufSize;
+
 	return true;
 }
 
@@ -1045,6 +1050,9 @@ bool CD3D9Driver::updateIndexHardwareBuffer(SHWBufferLink_d3d9 *hwBuffer)
 		}
 	}
 
+	++FrameStats.HardwareBufferUploads;
+	FrameStats.HardwareBufferUploadBytes += bufSize;
+
 	return true;
 }
 
@@ -1093,8 +1101,8 @@ CD3D9Driver::SHWBufferLink *CD3D9Driver::createHardwareBuffer(const scene::IMesh
 
 	SHWBufferLink_d3d9 *hwBuffer=new SHWBufferLink_d3d9(mb);
 
-	//add to map
-	HWBufferMap.insert(hwBuffer->MeshBuffer, hwBuffer);
+	//add to links
+	registerHardwareBuffer(hwBuffer);
 
 	hwBuffer->ChangedID_Vertex=hwBuffer->MeshBuffer->getChangedID_Vertex();
 	hwBuffer->ChangedID_Index=hwBuffer->MeshBuffer->getChangedID_Index();
@@ -1183,7 +1191,7 @@ void CD3D9Driver::addOcclusionQuery(scene::ISceneNode* node,
 	if (!queryFeature(EVDF_OCCLUSION_QUERY))
 		return;
 	CNullDriver::addOcclusionQuery(node, mesh);
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	const s32 index = findOcclusionQuery(node);
 	if ((index != -1) && (OcclusionQueries[index].PID == 0))
 		pID3DDevice->CreateQuery(D3DQUERYTYPE_OCCLUSION, reinterpret_cast<IDirect3DQuery9**>(&OcclusionQueries[index].PID));
 }
@@ -1192,7 +1200,7 @@ void CD3D9Driver::addOcclusionQuery(scene::ISceneNode* node,
 //! Remove occlusion query.
 void CD3D9Driver::removeOcclusionQuery(scene::ISceneNode* node)
 {
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	const s32 index = findOcclusionQuery(node);
 	if (index != -1)
 	{
 		if (OcclusionQueries[index].PID != 0)
@@ -1202,65 +1210,45 @@ void CD3D9Driver::removeOcclusionQuery(scene::ISceneNode* node)
 }
 
 
-//! Run occlusion query. Draws mesh stored in query.
-/** If the mesh shall not be rendered visible, use
-overrideMaterial to disable the color and depth buffer. */
-void CD3D9Driver::runOcclusionQuery(scene::ISceneNode* node, bool visible)
+//! Starts counting the samples of a query
+void CD3D9Driver::beginOcclusionQuery(SOccQuery& query)
 {
-	if (!node)
-		return;
+	if (query.PID)
+		static_cast<IDirect3DQuery9*>(query.PID)->Issue(D3DISSUE_BEGIN);
+}
 
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
-	if (index != -1)
-	{
-		if (OcclusionQueries[index].PID)
-			static_cast<IDirect3DQuery9*>(OcclusionQueries[index].PID)->Issue(D3DISSUE_BEGIN);
-		CNullDriver::runOcclusionQuery(node,visible);
-		if (OcclusionQueries[index].PID)
-			static_cast<IDirect3DQuery9*>(OcclusionQueries[index].PID)->Issue(D3DISSUE_END);
-	}
+
+//! Stops counting the samples of a query
+void CD3D9Driver::endOcclusionQuery(SOccQuery& query)
+{
+	if (query.PID)
+		static_cast<IDirect3DQuery9*>(query.PID)->Issue(D3DISSUE_END);
 }
 
 
-//! Update occlusion query. Retrieves results from GPU.
+//! Retrieves the result of a query from the GPU.
 /** If the query shall not block, set the flag to false.
 Update might not occur in this case, though */
-void CD3D9Driver::updateOcclusionQuery(scene::ISceneNode* node, bool block)
+void CD3D9Driver::fetchOcclusionQueryResult(SOccQuery& query, bool block)
 {
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
-	if (index != -1)
+	if (!query.PID)
+		return;
+	bool available = block?true:false;
+	int tmp=0;
+	if (!block)
+		available=(static_cast<IDirect3DQuery9*>(query.PID)->GetData(&tmp, sizeof(DWORD), 0)==S_OK);
+	else
 	{
-		// not yet started
-		if (OcclusionQueries[index].Run==u32(~0))
-			return;
-		bool available = block?true:false;
-		int tmp=0;
-		if (!block)
-			available=(static_cast<IDirect3DQuery9*>(OcclusionQueries[index].PID)->GetData(&tmp, sizeof(DWORD), 0)==S_OK);
-		else
+		do
 		{
-			do
-			{
-				HRESULT hr = static_cast<IDirect3DQuery9*>(OcclusionQueries[index].PID)->GetData(&tmp, sizeof(DWORD), D3DGETDATA_FLUSH);
-				available = (hr == S_OK);
-				if (hr!=S_FALSE)
-					break;
-			} while (!available);
-		}
-		if (available)
-			OcclusionQueries[index].Result = tmp;
+			HRESULT hr = static_cast<IDirect3DQuery9*>(query.PID)->GetData(&tmp, sizeof(DWORD), D3DGETDATA_FLUSH);
+			available = (hr == S_OK);
+			if (hr!=S_FALSE)
+				break;
+		} while (!available);
 	}
-}
-
-
-//! Return query result.
-/** Return value is the number of visible pixels/fragments.
-The value is a safe approximation, i.e. can be larger than the
-actual value of pixels. */
-u32 CD3D9Driver::getOcclusionQueryResult(const scene::ISceneNode* node) const
-{
-	const s32 index = OcclusionQueries.linear_search(node);
-	return index < 0 ? ~0 : OcclusionQueries[index].Result;
+	if (available)
+		query.Result = tmp;
 }
 
 
@@ -1274,6 +1262,14 @@ IRenderTarget* CD3D9Driver::addRenderTarget()
 }
 
 
+//! Draws copies of a mesh buffer, one after the other
+void CD3D9Driver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+	const core::matrix4* transforms, u32 instanceCount, const SColor* colors)
+{
+	drawInstancesOneByOne(mb, transforms, instanceCount, colors);
+}
+
+
 //! draws a vertex primitive list
 void CD3D9Driver::drawVertexPrimitiveList(const void* vertices,
 		u32 vertexCount, const void* indexList, u32 primitiveCount,
@@ -1514,6 +1510,7 @@ void CD3D9Driver::draw2DImage(const video::ITexture* texture,
 		pID3DDevice->SetScissorRect(&scissor);
 	}
 
+	++FrameStats.DrawCalls;
 	pID3DDevice->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, 4, 2, &indices[0],
 				D3DFMT_INDEX16,&vtx[0], sizeof(S3DVertex));
 
@@ -1532,6 +1529,8 @@ void CD3D9Driver::draw2DImageBatch(const video::ITexture* texture,
 	if (!texture)
 		return;
 
+	++FrameStats.Draw2DBatches;
+
 	if (!setActiveTexture(0, texture))
 		return;
 
@@ -1662,12 +1661,38 @@ void CD3D9Driver::draw2DImageBatch(const video::ITexture* texture,
 	{
 		setVertexShader(EVT_STANDARD);
 
+		++FrameStats.DrawCalls;
 		pID3DDevice->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, vtx.size(), indices.size() / 3, indices.pointer(),
 			D3DFMT_INDEX16,vtx.pointer(), sizeof(S3DVertex));
 	}
 }
 
 
+//! Draws the subtextures chosen by the indices in one line as one batch.
+void CD3D9Driver::draw2DImageBatch(const video::ITexture* texture,
+				const core::position2d<s32>& pos,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::array<s32>& indices,
+				s32 kerningWidth,
+				const core::rect<s32>* clipRect, SColor color,
+				bool useAlphaChannelOfTexture)
+{
+	core::array<core::position2d<s32> > positions(indices.size());
+	core::array<core::rect<s32> > rects(indices.size());
+	core::position2d<s32> target(pos);
+	for (u32 i=0; i<indices.size(); ++i)
+	{
+		positions.push_back(target);
+		rects.push_back(sourceRects[indices[i]]);
+		target.X += sourceRects[indices[i]].getWidth();
+		target.X += kerningWidth;
+	}
+
+	// counted as one batch there
+	draw2DImageBatch(texture, positions, rects, clipRect, color, useAlphaChannelOfTexture);
+}
+
+
 //! draws a 2d image, using a color and the alpha channel of the texture if
 //! desired. The image is drawn at pos and clipped against clipRect (if != 0).
 void CD3D9Driver::draw2DImage(const video::ITexture* texture,
@@ -1796,6 +1821,7 @@ void CD3D9Driver::draw2DImage(const video::ITexture* texture,
 
 	setVertexShader(EVT_STANDARD);
 
+	++FrameStats.DrawCalls;
 	pID3DDevice->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, 4, 2, &indices[0],
 		D3DFMT_INDEX16,&vtx[0],	sizeof(S3DVertex));
 }
@@ -1836,6 +1862,7 @@ void CD3D9Driver::draw2DRectangle(const core::rect<s32>& position,
 
 	setVertexShader(EVT_STANDARD);
 
+	++FrameStats.DrawCalls;
 	pID3DDevice->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, 4, 2, &indices[0],
 		D3DFMT_INDEX16, &vtx[0], sizeof(S3DVertex));
 }
@@ -1865,6 +1892,7 @@ void CD3D9Driver::draw2DLine(const core::position2d<s32>& start,
 
 		setVertexShader(EVT_STANDARD);
 
+		++FrameStats.DrawCalls;
 		pID3DDevice->DrawPrimitiveUP(D3DPT_LINELIST, 1,
 						&vtx[0], sizeof(S3DVertex) );
 	}
@@ -1885,6 +1913,7 @@ void CD3D9Driver::drawPixel(u32 x, u32 y, const SColor & color)
 
 	S3DVertex vertex((f32)x+0.375f, (f32)y+0.375f, 0.f, 0.f, 0.f, 0.f, color, 0.f, 0.f);
 
+	++FrameStats.DrawCalls;
 	pID3DDevice->DrawPrimitiveUP(D3DPT_POINTLIST, 1, &vertex, sizeof(vertex));
 }
 
@@ -1944,6 +1973,8 @@ bool CD3D9Driver::setRenderStates3DMode()
 
 	if (ResetRenderStates || LastMaterial != Material)
 	{
+		++FrameStats.MaterialChanges;
+
 		// unset old material
 
 		if (CurrentRenderMode == ERM_3D &&
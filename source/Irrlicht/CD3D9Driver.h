@@ -101,22 +101,6 @@ namespace video
 		//! Remove occlusion query.
 		virtual void removeOcclusionQuery(scene::ISceneNode* node) IRR_OVERRIDE;
 
-		//! Run occlusion query. Draws mesh stored in query.
-		/** If the mesh shall not be rendered visible, use
-		overrideMaterial to disable the color and depth buffer. */
-		virtual void runOcclusionQuery(scene::ISceneNode* node, bool visible=false) IRR_OVERRIDE;
-
-		//! Update occlusion query. Retrieves results from GPU.
-		/** If the query shall not block, set the flag to false.
-		Update might not occur in this case, though */
-		virtual void updateOcclusionQuery(scene::ISceneNode* node, bool block=true) IRR_OVERRIDE;
-
-		//! Return query result.
-		/** Return value is the number of visible pixels/fragments.
-		The value is a safe approximation, i.e. can be larger then the
-		actual value of pixels. */
-		virtual u32 getOcclusionQueryResult(const scene::ISceneNode* node) const IRR_OVERRIDE;
-
 		//! Create render target.
 		virtual IRenderTarget* addRenderTarget() IRR_OVERRIDE;
 
@@ -126,6 +110,11 @@ namespace video
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType,
 				E_INDEX_TYPE iType) IRR_OVERRIDE;
 
+		//! Draws copies of a mesh buffer, one after the other
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const core::matrix4* transforms, u32 instanceCount,
+			const SColor* colors=0) IRR_OVERRIDE;
+
 		//! draws a vertex primitive list in 2d
 		virtual void draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount,
 				const void* indexList, u32 primitiveCount,
@@ -150,6 +139,16 @@ namespace video
 				SColor color=SColor(255,255,255,255),
 				bool useAlphaChannelOfTexture=false) IRR_OVERRIDE;
 
+		//! Draws a set of 2d images in one line, chosen from sourceRects by the indices.
+		virtual void draw2DImageBatch(const video::ITexture* texture,
+				const core::position2d<s32>& pos,
+				const core::array<core::rect<s32> >& sourceRects,
+				const core::array<s32>& indices,
+				s32 kerningWidth=0,
+				const core::rect<s32>* clipRect=0,
+				SColor color=SColor(255,255,255,255),
+				bool useAlphaChannelOfTexture=false) IRR_OVERRIDE;
+
 		//!Draws an 2d rectangle with a gradient.
 		virtual void draw2DRectangle(const core::rect<s32>& pos,
 			SColor colorLeftUp, SColor colorRightUp, SColor colorLeftDown, SColor colorRightDown,
@@ -325,6 +324,17 @@ namespace video
 		//! Get bridge calls.
 		CD3D9CallBridge* getBridgeCalls() const;
 
+	protected:
+
+		//! Starts counting the samples of a query
+		virtual void beginOcclusionQuery(SOccQuery& query) IRR_OVERRIDE;
+
+		//! Stops counting the samples of a query
+		virtual void endOcclusionQuery(SOccQuery& query) IRR_OVERRIDE;
+
+		//! Retrieves the result of a query which has been run
+		virtual void fetchOcclusionQueryResult(SOccQuery& query, bool block) IRR_OVERRIDE;
+
 	private:
 
 		//! enumeration for rendering modes such as 2d and 3d for minimizing the switching of renderStates.
@@ -13,6 +13,81 @@ namespace irr
 namespace video
 {
 
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+
+//! sets the buffer and allocates its tiles, nothing is pending afterwards
+void sDeferredClear::setBuffer(u8* buffer, u32 pitch, u32 sampleSize, const core::dimension2d<u32>& size)
+{
+	Buffer = buffer;
+	Pitch = pitch;
+	SampleSize = sampleSize;
+	Size = size;
+
+	const u32 tileSize = 1 << SOFTWARE_DRIVER_2_TILE_SHIFT;
+	Columns = (size.Width + tileSize - 1) >> SOFTWARE_DRIVER_2_TILE_SHIFT;
+	Rows = (size.Height + tileSize - 1) >> SOFTWARE_DRIVER_2_TILE_SHIFT;
+	Pending.set_used(Columns * Rows);
+	for (u32 i = 0; i < Pending.size(); ++i)
+		Pending[i] = 0;
+	PendingCount = 0;
+}
+
+
+//! records a clear of all tiles with a value replicated to 32 bit
+void sDeferredClear::clear(u32 value)
+{
+	Value = value;
+	for (u32 i = 0; i < Pending.size(); ++i)
+		Pending[i] = 1;
+	PendingCount = Pending.size();
+}
+
+
+//! writes the pending tiles touched by an inclusive pixel rectangle
+u32 sDeferredClear::resolveTiles(s32 x0, s32 y0, s32 x1, s32 y1)
+{
+	x0 = core::max_(x0, 0);
+	y0 = core::max_(y0, 0);
+	x1 = core::min_(x1, (s32)Size.Width - 1);
+	y1 = core::min_(y1, (s32)Size.Height - 1);
+	if (x0 > x1 || y0 > y1)
+		return 0;
+
+	u32 written = 0;
+	for (s32 ty = y0 >> SOFTWARE_DRIVER_2_TILE_SHIFT; ty <= y1 >> SOFTWARE_DRIVER_2_TILE_SHIFT; ++ty)
+	{
+		for (s32 tx = x0 >> SOFTWARE_DRIVER_2_TILE_SHIFT; tx <= x1 >> SOFTWARE_DRIVER_2_TILE_SHIFT; ++tx)
+		{
+			u8& pending = Pending[ty * Columns + tx];
+			if (!pending)
+				continue;
+
+			const u32 px = tx << SOFTWARE_DRIVER_2_TILE_SHIFT;
+			const u32 py = ty << SOFTWARE_DRIVER_2_TILE_SHIFT;
+			const u32 bytes = (core::min_(px + (1 << SOFTWARE_DRIVER_2_TILE_SHIFT), Size.Width) - px) * SampleSize;
+			const u32 height = core::min_(py + (1 << SOFTWARE_DRIVER_2_TILE_SHIFT), Size.Height) - py;
+
+			u8* dst = Buffer + py * Pitch + px * SampleSize;
+			for (u32 y = 0; y < height; ++y)
+			{
+				if (SampleSize == 4)
+					memset32(dst, Value, bytes);
+				else
+					memset(dst, (u8)Value, bytes);
+				dst += Pitch;
+			}
+
+			pending = 0;
+			PendingCount -= 1;
+			written += 1;
+		}
+	}
+	return written;
+}
+
+#endif // SOFTWARE_DRIVER_2_DEFERRED_CLEAR
+
+// -----------------------------------------------------------------
 
 //! constructor
 CDepthBuffer::CDepthBuffer(const core::dimension2d<u32>& size)
@@ -50,7 +125,39 @@ void CDepthBuffer::clear(f32 value, const interlaced_control interlaced)
 	zMaxValue.f = value;
 #endif
 
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	if (interlaced.bypass)
+		DeferredClear.clear(zMaxValue.u);
+	else
+	{
+		// only some lines are cleared, the others need their pending clear
+		DeferredClear.resolve();
+		memset32_interlaced(Buffer, zMaxValue.u, Pitch, Size.Height, interlaced);
+	}
+#else
 	memset32_interlaced(Buffer, zMaxValue.u, Pitch, Size.Height, interlaced);
+#endif
+
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+	if (interlaced.bypass)
+	{
+		for (u32 i = 0; i < TileFar.size(); ++i)
+		{
+			TileFar[i] = zMaxValue.f;
+			TileWritten[i] = 0;
+		}
+	}
+	else
+	{
+		// only some lines are cleared, the others keep their depth
+		for (u32 i = 0; i < TileFar.size(); ++i)
+		{
+			if (zMaxValue.f < TileFar[i])
+				TileFar[i] = zMaxValue.f;
+			TileWritten[i] = 1;
+		}
+	}
+#endif
 }
 
 
@@ -69,6 +176,18 @@ void CDepthBuffer::setSize(const core::dimension2d<u32>& size)
 	size_t TotalSize = Pitch * size.Height;
 	Buffer = new u8[align_next(TotalSize,16)];
 
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	DeferredClear.setBuffer(Buffer, Pitch, sizeof(fp24), size);
+#endif
+
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+	const u32 tileSize = 1 << SOFTWARE_DRIVER_2_TILE_SHIFT;
+	TileColumns = (size.Width + tileSize - 1) >> SOFTWARE_DRIVER_2_TILE_SHIFT;
+	TileRows = (size.Height + tileSize - 1) >> SOFTWARE_DRIVER_2_TILE_SHIFT;
+	TileFar.set_used(TileColumns * TileRows);
+	TileWritten.set_used(TileColumns * TileRows);
+#endif
+
 	clear( 1.f, interlaced_disabled());
 }
 
@@ -80,6 +199,101 @@ const core::dimension2d<u32>& CDepthBuffer::getSize() const
 	return Size;
 }
 
+
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+
+//! returns true if w is behind the farthest depth of all tiles touched by a rectangle
+bool CDepthBuffer::isHidden(s32 x0, s32 y0, s32 x1, s32 y1, fp24 w, bool update, SFrameStats& stats)
+{
+	x0 = core::max_(x0, 0);
+	y0 = core::max_(y0, 0);
+	x1 = core::min_(x1, (s32)Size.Width - 1);
+	y1 = core::min_(y1, (s32)Size.Height - 1);
+	if (x0 > x1 || y0 > y1)
+		return false;
+
+	x0 >>= SOFTWARE_DRIVER_2_TILE_SHIFT;
+	y0 >>= SOFTWARE_DRIVER_2_TILE_SHIFT;
+	x1 >>= SOFTWARE_DRIVER_2_TILE_SHIFT;
+	y1 >>= SOFTWARE_DRIVER_2_TILE_SHIFT;
+
+	for (s32 ty = y0; ty <= y1; ++ty)
+	{
+		for (s32 tx = x0; tx <= x1; ++tx)
+		{
+			const u32 tile = ty * TileColumns + tx;
+			stats.HiZTileTests += 1;
+
+			// the w-buffer test passes for w >= z
+			if (w < TileFar[tile])
+				continue;
+
+			if (!update || !TileWritten[tile])
+				return false;
+
+			updateTile(tx, ty);
+			stats.HiZTileUpdates += 1;
+			if (w >= TileFar[tile])
+				return false;
+		}
+	}
+
+	return true;
+}
+
+
+//! lowers the farthest depth of the tiles of a rectangle for writes without depth test
+void CDepthBuffer::setWrittenFarther(s32 x0, s32 y0, s32 x1, s32 y1, fp24 w)
+{
+	x0 = core::max_(x0, 0);
+	y0 = core::max_(y0, 0);
+	x1 = core::min_(x1, (s32)Size.Width - 1);
+	y1 = core::min_(y1, (s32)Size.Height - 1);
+
+	for (s32 ty = y0 >> SOFTWARE_DRIVER_2_TILE_SHIFT; ty <= y1 >> SOFTWARE_DRIVER_2_TILE_SHIFT; ++ty)
+	{
+		for (s32 tx = x0 >> SOFTWARE_DRIVER_2_TILE_SHIFT; tx <= x1 >> SOFTWARE_DRIVER_2_TILE_SHIFT; ++tx)
+		{
+			const u32 tile = ty * TileColumns + tx;
+			if (w < TileFar[tile])
+				TileFar[tile] = w;
+			TileWritten[tile] = 1;
+		}
+	}
+}
+
+
+//! recalculates the farthest depth of a tile from the buffer
+void CDepthBuffer::updateTile(u32 tx, u32 ty)
+{
+	const u32 x0 = tx << SOFTWARE_DRIVER_2_TILE_SHIFT;
+	const u32 y0 = ty << SOFTWARE_DRIVER_2_TILE_SHIFT;
+	const u32 x1 = core::min_(x0 + (1 << SOFTWARE_DRIVER_2_TILE_SHIFT), Size.Width);
+	const u32 y1 = core::min_(y0 + (1 << SOFTWARE_DRIVER_2_TILE_SHIFT), Size.Height);
+
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	DeferredClear.resolve(x0, y0, x1 - 1, y1 - 1);
+#endif
+
+	const fp24* row = (const fp24*)(Buffer + y0 * Pitch);
+	fp24 farthest = row[x0];
+	for (u32 y = y0; y < y1; ++y)
+	{
+		for (u32 x = x0; x < x1; ++x)
+		{
+			if (row[x] < farthest)
+				farthest = row[x];
+		}
+		row = (const fp24*)((const u8*)row + Pitch);
+	}
+
+	const u32 tile = ty * TileColumns + tx;
+	TileFar[tile] = farthest;
+	TileWritten[tile] = 0;
+}
+
+#endif // SOFTWARE_DRIVER_2_HIERARCHICAL_Z
+
 // -----------------------------------------------------------------
 
 //! constructor
@@ -116,7 +330,19 @@ void CStencilBuffer::clear(u32 value, const interlaced_control interlaced)
 		set |= set << 8;
 		set |= set << 16;
 	}
+
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	if (interlaced.bypass)
+		DeferredClear.clear(set);
+	else
+	{
+		// only some lines are cleared, the others need their pending clear
+		DeferredClear.resolve();
+		memset32_interlaced ( Buffer, set, Pitch,Size.Height,interlaced );
+	}
+#else
 	memset32_interlaced ( Buffer, set, Pitch,Size.Height,interlaced );
+#endif
 }
 
 
@@ -135,6 +361,10 @@ void CStencilBuffer::setSize(const core::dimension2d<u32>& size)
 	size_t TotalSize = Pitch * size.Height;
 	Buffer = new u8[align_next(TotalSize,16)];
 
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	DeferredClear.setBuffer(Buffer, Pitch, sizeof(tStencilSample), size);
+#endif
+
 	clear(0, interlaced_disabled());
 }
 
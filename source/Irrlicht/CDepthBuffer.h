@@ -6,12 +6,62 @@
 #define IRR_C_Z_BUFFER_H_INCLUDED
 
 #include "IDepthBuffer.h"
+#include "SFrameStats.h"
+#include "irrArray.h"
 
 namespace irr
 {
 namespace video
 {
 
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	//! clear of a buffer recorded per tile and written when a tile is touched first
+	/** A full clear only marks all tiles as pending, so tiles nothing is
+	drawn to until the next clear never cost memory bandwidth. */
+	struct sDeferredClear
+	{
+		sDeferredClear() : Buffer(0), Pitch(0), SampleSize(0), Columns(0), Rows(0), Value(0), PendingCount(0) {}
+
+		//! sets the buffer and allocates its tiles, nothing is pending afterwards
+		void setBuffer(u8* buffer, u32 pitch, u32 sampleSize, const core::dimension2d<u32>& size);
+
+		//! records a clear of all tiles with a value replicated to 32 bit
+		void clear(u32 value);
+
+		//! writes the pending tiles touched by an inclusive pixel rectangle
+		/** \return Number of tiles written. */
+		inline u32 resolve(s32 x0, s32 y0, s32 x1, s32 y1)
+		{
+			return PendingCount ? resolveTiles(x0, y0, x1, y1) : 0;
+		}
+
+		//! writes all pending tiles
+		inline u32 resolve()
+		{
+			return PendingCount ? resolveTiles(0, 0, (s32)Size.Width - 1, (s32)Size.Height - 1) : 0;
+		}
+
+		//! returns the number of tiles
+		u32 getTileCount() const { return Pending.size(); }
+
+	private:
+
+		u32 resolveTiles(s32 x0, s32 y0, s32 x1, s32 y1);
+
+		u8* Buffer;
+		core::dimension2d<u32> Size;
+		u32 Pitch;
+		u32 SampleSize;
+		u32 Columns;
+		u32 Rows;
+		u32 Value;
+
+		//! tiles not written since the last clear
+		core::array<u8> Pending;
+		u32 PendingCount;
+	};
+#endif
+
 	class CDepthBuffer : public IDepthBuffer
 	{
 	public:
@@ -40,12 +90,66 @@ namespace video
 		//! returns pitch of depthbuffer (in bytes)
 		virtual u32 getPitch() const IRR_OVERRIDE { return Pitch; }
 
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+		//! writes a pending clear to the tiles touched by an inclusive pixel rectangle
+		/** Has to be called before the buffer is accessed there.
+		\return Number of tiles written. */
+		inline u32 resolveClear(s32 x0, s32 y0, s32 x1, s32 y1) { return DeferredClear.resolve(x0, y0, x1, y1); }
+
+		//! writes a pending clear to all tiles
+		inline u32 resolveClear() { return DeferredClear.resolve(); }
+
+		//! returns the number of tiles a clear is recorded for
+		u32 getClearTileCount() const { return DeferredClear.getTileCount(); }
+#endif
+
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+		//! returns true if w is behind the farthest depth of all tiles touched by a rectangle
+		/** Writes passing the w-buffer test only move pixels nearer, so the
+		farthest depth stored for a tile stays conservative after writes.
+		With update set, written tiles not hiding w are recalculated first.
+		\param x0,y0,x1,y1 Inclusive pixel rectangle, clamped to the buffer. */
+		bool isHidden(s32 x0, s32 y0, s32 x1, s32 y1, fp24 w, bool update, SFrameStats& stats);
+
+		//! marks the tiles of a scanline as written by writes passing the depth test
+		inline void setWritten(s32 y, s32 x0, s32 x1)
+		{
+			if (y < 0 || y >= (s32)Size.Height || x1 < 0 || x0 >= (s32)Size.Width)
+				return;
+
+			u8* written = TileWritten.pointer() + (y >> SOFTWARE_DRIVER_2_TILE_SHIFT) * TileColumns;
+			const s32 end = core::min_(x1, (s32)Size.Width - 1) >> SOFTWARE_DRIVER_2_TILE_SHIFT;
+			for (s32 tx = core::max_(x0, 0) >> SOFTWARE_DRIVER_2_TILE_SHIFT; tx <= end; ++tx)
+				written[tx] = 1;
+		}
+
+		//! lowers the farthest depth of the tiles of a rectangle for writes without depth test
+		void setWrittenFarther(s32 x0, s32 y0, s32 x1, s32 y1, fp24 w);
+#endif
 
 	private:
 
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+		//! recalculates the farthest depth of a tile from the buffer
+		void updateTile(u32 tx, u32 ty);
+#endif
+
 		u8* Buffer;
 		core::dimension2d<u32> Size;
 		u32 Pitch;
+
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+		sDeferredClear DeferredClear;
+#endif
+
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+		//! farthest (smallest) w of each tile
+		core::array<fp24> TileFar;
+		//! tiles written since their farthest w was calculated
+		core::array<u8> TileWritten;
+		u32 TileColumns;
+		u32 TileRows;
+#endif
 	};
 
 
@@ -77,12 +181,28 @@ namespace video
 		//! returns pitch of depthbuffer (in bytes)
 		virtual u32 getPitch() const IRR_OVERRIDE { return Pitch; }
 
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+		//! writes a pending clear to the tiles touched by an inclusive pixel rectangle
+		/** Has to be called before the buffer is accessed there.
+		\return Number of tiles written. */
+		inline u32 resolveClear(s32 x0, s32 y0, s32 x1, s32 y1) { return DeferredClear.resolve(x0, y0, x1, y1); }
+
+		//! writes a pending clear to all tiles
+		inline u32 resolveClear() { return DeferredClear.resolve(); }
+
+		//! returns the number of tiles a clear is recorded for
+		u32 getClearTileCount() const { return DeferredClear.getTileCount(); }
+#endif
 
 	private:
 		u8* Buffer;
 		core::dimension2d<u32> Size;
 		u32 Pitch;
 		u32 Bit;
+
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+		sDeferredClear DeferredClear;
+#endif
 	};
 
 } // end namespace video
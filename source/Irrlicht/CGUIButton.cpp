@@ -52,6 +52,7 @@ CGUIButton::~CGUIButton()
 //! Sets if the images should be scaled to fit the button
 void CGUIButton::setScaleImage(bool scaleImage)
 {
+	markDirty();
 	ScaleImage = scaleImage;
 }
 
@@ -66,12 +67,14 @@ bool CGUIButton::isScalingImage() const
 //! Sets if the button should use the skin to draw its border
 void CGUIButton::setDrawBorder(bool border)
 {
+	markDirty();
 	DrawBorder = border;
 }
 
 
 void CGUIButton::setSpriteBank(IGUISpriteBank* sprites)
 {
+	markDirty();
 	if (sprites)
 		sprites->grab();
 
@@ -84,6 +87,10 @@ void CGUIButton::setSpriteBank(IGUISpriteBank* sprites)
 
 void CGUIButton::setSprite(EGUI_BUTTON_STATE state, s32 index, video::SColor color, bool loop, bool scale)
 {
+	// the combo box sets its sprites while drawing
+	const ButtonSprite& sprite = ButtonSprites[(u32)state];
+	if (sprite.Index != index || sprite.Color != color || sprite.Loop != loop || sprite.Scale != scale)
+		markDirty();
 	ButtonSprites[(u32)state].Index	= index;
 	ButtonSprites[(u32)state].Color	= color;
 	ButtonSprites[(u32)state].Loop	= loop;
@@ -340,6 +347,11 @@ void CGUIButton::drawSprite(EGUI_BUTTON_STATE state, u32 startTime, const core::
 
 	if (ButtonSprites[stateIdx].Index != -1)
 	{
+		// animated sprites have to be redrawn when drawn from a cache
+		if ((u32)ButtonSprites[stateIdx].Index < SpriteBank->getSprites().size() &&
+			SpriteBank->getSprites()[ButtonSprites[stateIdx].Index].Frames.size() > 1)
+			markDirty();
+
 		if ( ButtonSprites[stateIdx].Scale )
 		{
 			const video::SColor colors[] = {ButtonSprites[stateIdx].Color,ButtonSprites[stateIdx].Color,ButtonSprites[stateIdx].Color,ButtonSprites[stateIdx].Color};
@@ -425,6 +437,7 @@ EGUI_BUTTON_IMAGE_STATE CGUIButton::getImageState(bool pressed) const
 //! sets another skin independent font. if this is set to zero, the button uses the font of the skin.
 void CGUIButton::setOverrideFont(IGUIFont* font)
 {
+	markDirty();
 	if (OverrideFont == font)
 		return;
 
@@ -457,6 +470,7 @@ IGUIFont* CGUIButton::getActiveFont() const
 //! Sets another color for the text.
 void CGUIButton::setOverrideColor(video::SColor color)
 {
+	markDirty();
 	OverrideColor = color;
 	OverrideColorEnabled = true;
 }
@@ -488,6 +502,7 @@ bool CGUIButton::isOverrideColorEnabled() const
 
 void CGUIButton::setImage(EGUI_BUTTON_IMAGE_STATE state, video::ITexture* image, const core::rect<s32>& sourceRect)
 {
+	markDirty();
 	if ( state >= EGBIS_COUNT )
 		return;
 
@@ -507,6 +522,7 @@ void CGUIButton::setImage(EGUI_BUTTON_IMAGE_STATE state, video::ITexture* image,
 //! the user can change the state of the button.
 void CGUIButton::setIsPushButton(bool isPushButton)
 {
+	markDirty();
 	IsPushButton = isPushButton;
 }
 
@@ -521,6 +537,7 @@ bool CGUIButton::isPressed() const
 //! Sets the pressed state of the button if this is a pushbutton
 void CGUIButton::setPressed(bool pressed)
 {
+	markDirty();
 	if (Pressed != pressed)
 	{
 		ClickTime = os::Timer::getTime();
@@ -539,6 +556,7 @@ bool CGUIButton::isPushButton() const
 //! Sets if the alpha channel should be used for drawing images on the button (default is false)
 void CGUIButton::setUseAlphaChannel(bool useAlphaChannel)
 {
+	markDirty();
 	UseAlphaChannel = useAlphaChannel;
 }
 
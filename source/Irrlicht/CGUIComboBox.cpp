@@ -60,6 +60,7 @@ CGUIComboBox::CGUIComboBox(IGUIEnvironment* environment, IGUIElement* parent,
 
 void CGUIComboBox::setTextAlignment(EGUI_ALIGNMENT horizontal, EGUI_ALIGNMENT vertical)
 {
+	markDirty();
 	HAlign = horizontal;
 	VAlign = vertical;
 	SelectedText->setTextAlignment(horizontal, vertical);
@@ -126,6 +127,7 @@ s32 CGUIComboBox::getIndexForItemData(u32 data ) const
 //! Removes an item from the combo box.
 void CGUIComboBox::removeItem(u32 idx)
 {
+	markDirty();
 	if (idx >= Items.size())
 		return;
 
@@ -146,6 +148,7 @@ const wchar_t* CGUIComboBox::getText() const
 //! adds an item and returns the index of it
 u32 CGUIComboBox::addItem(const wchar_t* text, u32 data)
 {
+	markDirty();
 	Items.push_back( SComboData ( text, data ) );
 
 	if (Selected == -1)
@@ -158,6 +161,7 @@ u32 CGUIComboBox::addItem(const wchar_t* text, u32 data)
 //! deletes all items in the combo box
 void CGUIComboBox::clear()
 {
+	markDirty();
 	Items.clear();
 	setSelected(-1);
 }
@@ -173,6 +177,7 @@ s32 CGUIComboBox::getSelected() const
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIComboBox::setSelected(s32 idx)
 {
+	markDirty();
 	if (idx < -1 || idx >= (s32)Items.size())
 		return;
 
@@ -406,8 +411,11 @@ void CGUIComboBox::draw()
 		LastFocus = currentFocus;
 	}
 
-	// set colors each time as skin-colors can be changed
-	SelectedText->setBackgroundColor(skin->getColor(EGDC_HIGH_LIGHT));
+	// set colors each time as skin-colors can be changed. setting the background
+	// color also enables the background, so only set it when it changed.
+	const video::SColor highLight = skin->getColor(EGDC_HIGH_LIGHT);
+	if (SelectedText->getBackgroundColor() != highLight)
+		SelectedText->setBackgroundColor(highLight);
 	if(isEnabled())
 	{
 		SelectedText->setDrawBackground(HasFocus);
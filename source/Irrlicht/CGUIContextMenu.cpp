@@ -73,6 +73,7 @@ u32 CGUIContextMenu::getItemCount() const
 //! Adds a menu item.
 u32 CGUIContextMenu::addItem(const wchar_t* text, s32 commandId, bool enabled, bool hasSubMenu, bool checked, bool autoChecking)
 {
+	markDirty();
     return insertItem(Items.size(), text, commandId, enabled, hasSubMenu, checked, autoChecking);
 }
 
@@ -80,6 +81,7 @@ u32 CGUIContextMenu::addItem(const wchar_t* text, s32 commandId, bool enabled, b
 u32 CGUIContextMenu::insertItem(u32 idx, const wchar_t* text, s32 commandId, bool enabled,
     bool hasSubMenu, bool checked, bool autoChecking)
 {
+	markDirty();
 	SItem s;
 	s.Enabled = enabled;
 	s.Checked = checked;
@@ -127,6 +129,7 @@ s32 CGUIContextMenu::findItemWithCommandId(s32 commandId, u32 idxStartSearch) co
 //! Adds a sub menu from an element that already exists.
 void CGUIContextMenu::setSubMenu(u32 index, CGUIContextMenu* menu)
 {
+	markDirty();
 	if (index >= Items.size())
 		return;
 
@@ -154,6 +157,7 @@ void CGUIContextMenu::setSubMenu(u32 index, CGUIContextMenu* menu)
 //! Adds a separator item to the menu
 void CGUIContextMenu::addSeparator()
 {
+	markDirty();
 	addItem(0, -1, true, false, false, false);
 }
 
@@ -171,6 +175,7 @@ const wchar_t* CGUIContextMenu::getItemText(u32 idx) const
 //! Sets text of the menu item.
 void CGUIContextMenu::setItemText(u32 idx, const wchar_t* text)
 {
+	markDirty();
 	if (idx >= Items.size())
 		return;
 
@@ -224,6 +229,7 @@ bool CGUIContextMenu::isItemChecked(u32 idx) const
 //! Sets if the menu item should be enabled.
 void CGUIContextMenu::setItemEnabled(u32 idx, bool enabled)
 {
+	markDirty();
 	if (idx >= Items.size())
 		return;
 
@@ -234,6 +240,7 @@ void CGUIContextMenu::setItemEnabled(u32 idx, bool enabled)
 //! Sets if the menu item should be checked.
 void CGUIContextMenu::setItemChecked(u32 idx, bool checked )
 {
+	markDirty();
 	if (idx >= Items.size())
 		return;
 
@@ -244,6 +251,7 @@ void CGUIContextMenu::setItemChecked(u32 idx, bool checked )
 //! Removes a menu item
 void CGUIContextMenu::removeItem(u32 idx)
 {
+	markDirty();
 	if (idx >= Items.size())
 		return;
 
@@ -261,6 +269,7 @@ void CGUIContextMenu::removeItem(u32 idx)
 //! Removes all menu items
 void CGUIContextMenu::removeAllItems()
 {
+	markDirty();
 	for (u32 i=0; i<Items.size(); ++i)
 		if (Items[i].SubMenu)
 			Items[i].SubMenu->drop();
@@ -440,6 +449,8 @@ bool CGUIContextMenu::highlight(const core::position2d<s32>& p)
 		return false;
 	}
 
+	markDirty();
+
 	// get index of open submenu
 	u32 openMenuIndex = (u32)-1;
 	const bool hasOpenSub = hasOpenSubMenu(&openMenuIndex);
@@ -75,6 +75,7 @@ CGUIEditBox::~CGUIEditBox()
 //! Sets another skin independent font.
 void CGUIEditBox::setOverrideFont(IGUIFont* font)
 {
+	markDirty();
 	if (OverrideFont == font)
 		return;
 
@@ -109,6 +110,7 @@ IGUIFont* CGUIEditBox::getActiveFont() const
 //! Sets another color for the text.
 void CGUIEditBox::setOverrideColor(video::SColor color)
 {
+	markDirty();
 	OverrideColor = color;
 	OverrideColorEnabled = true;
 }
@@ -123,6 +125,7 @@ video::SColor CGUIEditBox::getOverrideColor() const
 //! Turns the border on or off
 void CGUIEditBox::setDrawBorder(bool border)
 {
+	markDirty();
 	Border = border;
 }
 
@@ -135,6 +138,7 @@ bool CGUIEditBox::isDrawBorderEnabled() const
 //! Sets whether to draw the background
 void CGUIEditBox::setDrawBackground(bool draw)
 {
+	markDirty();
 	Background = draw;
 }
 
@@ -158,6 +162,7 @@ bool CGUIEditBox::isOverrideColorEnabled() const
 //! Enables or disables word wrap
 void CGUIEditBox::setWordWrap(bool enable)
 {
+	markDirty();
 	WordWrap = enable;
 	breakText();
 }
@@ -186,6 +191,7 @@ bool CGUIEditBox::isWordWrapEnabled() const
 //! Enables or disables newlines.
 void CGUIEditBox::setMultiLine(bool enable)
 {
+	markDirty();
 	MultiLine = enable;
 	breakText();
 }
@@ -200,6 +206,7 @@ bool CGUIEditBox::isMultiLineEnabled() const
 
 void CGUIEditBox::setPasswordBox(bool passwordBox, wchar_t passwordChar)
 {
+	markDirty();
 	PasswordBox = passwordBox;
 	if (PasswordBox)
 	{
@@ -220,6 +227,7 @@ bool CGUIEditBox::isPasswordBox() const
 //! Sets text justification
 void CGUIEditBox::setTextAlignment(EGUI_ALIGNMENT horizontal, EGUI_ALIGNMENT vertical)
 {
+	markDirty();
 	HAlign = horizontal;
 	VAlign = vertical;
 }
@@ -776,6 +784,10 @@ void CGUIEditBox::draw()
 
 	const bool focus = Environment->hasFocus(this);
 
+	// keep the cursor blinking when drawn from a cache
+	if (focus && CursorBlinkTime)
+		markDirty();
+
 	IGUISkin* skin = Environment->getSkin();
 	if (!skin)
 		return;
@@ -984,6 +996,7 @@ void CGUIEditBox::draw()
 //! Sets the new caption of this element.
 void CGUIEditBox::setText(const wchar_t* text)
 {
+	markDirty();
 	Text = text;
 	if (u32(CursorPos) > Text.size())
 		CursorPos = Text.size();
@@ -1033,6 +1046,7 @@ core::dimension2du CGUIEditBox::getTextDimension()
 //! infinity.
 void CGUIEditBox::setMax(u32 max)
 {
+	markDirty();
 	Max = max;
 
 	if (Text.size() > Max && Max != 0)
@@ -1050,6 +1064,7 @@ u32 CGUIEditBox::getMax() const
 /** By default it's "_" */
 void CGUIEditBox::setCursorChar(const wchar_t cursorChar)
 {
+	markDirty();
 	CursorChar[0] = cursorChar;
 }
 
@@ -1603,6 +1618,7 @@ void CGUIEditBox::setTextMarkers(s32 begin, s32 end)
 {
 	if ( begin != MarkBegin || end != MarkEnd )
 	{
+		markDirty();
 		MarkBegin = begin;
 		MarkEnd = end;
 		sendGuiEvent(EGET_EDITBOX_MARKING_CHANGED);
@@ -8,6 +8,7 @@
 #ifdef _IRR_COMPILE_WITH_GUI_
 
 #include "IVideoDriver.h"
+#include "IRenderTarget.h"
 
 #include "CGUISkin.h"
 #include "CGUIButton.h"
@@ -59,7 +60,8 @@ const io::path CGUIEnvironment::DefaultFontName = "#DefaultFont";
 CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, IOSOperator* op)
 : IGUIElement(EGUIET_ROOT, 0, 0, 0, core::rect<s32>(driver ? core::dimension2d<s32>(driver->getScreenSize()) : core::dimension2d<s32>(0,0))),
 	Driver(driver), Hovered(0), HoveredNoSubelement(0), Focus(0), LastHoveredMousePos(0,0), CurrentSkin(0),
-	FileSystem(fs), UserReceiver(0), Operator(op), FocusFlags(EFF_SET_ON_LMOUSE_DOWN|EFF_SET_ON_TAB), MenuShowDelay(400)
+	FileSystem(fs), UserReceiver(0), Operator(op), FocusFlags(EFF_SET_ON_LMOUSE_DOWN|EFF_SET_ON_TAB), MenuShowDelay(400),
+	RetainedTarget(0), DrawingRetained(false)
 {
 	if (Driver)
 		Driver->grab();
@@ -102,6 +104,9 @@ CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* drive
 CGUIEnvironment::~CGUIEnvironment()
 {
 	clearDeletionQueue();
+	updateRetainedElements(true);
+	if (RetainedTarget && Driver)
+		Driver->removeRenderTarget(RetainedTarget);
 
 	if ( HoveredNoSubelement && HoveredNoSubelement != this )
 	{
@@ -216,6 +221,123 @@ void CGUIEnvironment::drawAll(bool useScreenSize)
 	OnPostRender ( os::Timer::getTime () );
 
 	clearDeletionQueue();
+	updateRetainedElements(false);
+}
+
+
+//! draws an element from its cached image
+void CGUIEnvironment::drawRetainedElement(IGUIElement* element)
+{
+	if (!element || !element->isVisible())
+		return;
+
+	// Nested retained elements are part of the cache of their parent.
+	// Drivers without render targets just draw.
+	if (DrawingRetained || !Driver || !Driver->queryFeature(video::EVDF_RENDER_TO_TARGET))
+	{
+		element->clearDirty();
+		element->draw();
+		return;
+	}
+
+	SRetainedElement* entry = 0;
+	for (u32 i=0; i<RetainedElements.size(); ++i)
+	{
+		if (RetainedElements[i].Element == element)
+		{
+			entry = &RetainedElements[i];
+			break;
+		}
+	}
+
+	if (!entry)
+	{
+		SRetainedElement e;
+		e.Element = element;
+		e.Texture = 0;
+		element->grab();
+		RetainedElements.push_back(e);
+		entry = &RetainedElements.getLast();
+	}
+
+	// The cache uses screen coordinates, so it has the size of the render target
+	const core::dimension2du size(Driver->getCurrentRenderTargetSize());
+	if (entry->Texture && entry->Texture->getSize() != size)
+	{
+		Driver->removeTexture(entry->Texture);
+		entry->Texture = 0;
+	}
+
+	if (!entry->Texture)
+	{
+		entry->Texture = Driver->addRenderTargetTexture(size, "GUIRetained", video::ECF_A8R8G8B8);
+		if (!entry->Texture)
+		{
+			element->clearDirty();
+			element->draw();
+			return;
+		}
+		element->markDirty();
+	}
+
+	if (element->isDirty())
+	{
+		// clear before drawing, so animated elements can mark themselves dirty again
+		element->clearDirty();
+
+		// the GUI may itself be drawn into a render target texture
+		video::IRenderTarget* previous = Driver->getCurrentRenderTarget();
+		const core::rect<s32> viewPort = Driver->getViewPort();
+
+		if (!RetainedTarget)
+			RetainedTarget = Driver->addRenderTarget();
+		if (RetainedTarget)
+			RetainedTarget->setTexture(entry->Texture, 0);
+
+		if (RetainedTarget && Driver->setRenderTargetEx(RetainedTarget, video::ECBF_COLOR, video::SColor(0,0,0,0)))
+		{
+			DrawingRetained = true;
+			element->draw();
+			DrawingRetained = false;
+			Driver->setRenderTargetEx(previous, 0);
+			Driver->setViewPort(viewPort);
+		}
+		else
+		{
+			element->draw();
+			return;
+		}
+	}
+
+	const core::rect<s32>& clip = element->getAbsoluteClippingRect();
+	Driver->draw2DImage(entry->Texture, clip.UpperLeftCorner, clip, 0,
+		video::SColor(255,255,255,255), true);
+}
+
+
+//! release caches of elements which are no longer retained or were removed
+void CGUIEnvironment::updateRetainedElements(bool removeAll)
+{
+	for (u32 i=0; i<RetainedElements.size(); )
+	{
+		SRetainedElement& entry = RetainedElements[i];
+
+		// still part of this environment?
+		IGUIElement* root = entry.Element;
+		while (root->getParent())
+			root = root->getParent();
+
+		if (!removeAll && entry.Element->isRetained() && root == this)
+		{
+			++i;
+			continue;
+		}
+
+		if (entry.Texture && Driver)
+			Driver->removeTexture(entry.Texture);
+		entry.Element->drop();
+		RetainedElements.erase(i);
+	}
 }
 
 
@@ -231,6 +353,12 @@ bool CGUIEnvironment::setFocus(IGUIElement* element)
 	if (element == this)
 		element = 0;
 
+	// most elements look different when focused
+	if (Focus)
+		Focus->markDirty();
+	if (element)
+		element->markDirty();
+
 	// stop element from being deleted
 	if (element)
 		element->grab();
@@ -537,6 +665,7 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 
 		if (lastHovered)
 		{
+			lastHovered->markDirty();
 			event.GUIEvent.Caller = lastHovered;
 			event.GUIEvent.Element = 0;
 			event.GUIEvent.EventType = EGET_ELEMENT_LEFT;
@@ -545,6 +674,7 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 
 		if ( Hovered )
 		{
+			Hovered->markDirty();
 			event.GUIEvent.Caller  = Hovered;
 			event.GUIEvent.Element = Hovered;
 			event.GUIEvent.EventType = EGET_ELEMENT_HOVERED;
@@ -624,6 +754,16 @@ bool CGUIEnvironment::postEventFromUser(const SEvent& event)
 			}
 		}
 
+		// Elements can change on any input. But the focus gets all mouse
+		// moves, so only count moves while dragging.
+		if (event.MouseInput.Event != EMIE_MOUSE_MOVED || event.MouseInput.ButtonStates)
+		{
+			if (Focus)
+				Focus->markDirty();
+			else if (Hovered)
+				Hovered->markDirty();
+		}
+
 		// sending input to focus
 		if (Focus && Focus->OnEvent(event))
 			return true;
@@ -637,6 +777,9 @@ bool CGUIEnvironment::postEventFromUser(const SEvent& event)
 		break;
 	case EET_KEY_INPUT_EVENT:
 		{
+			if (Focus)
+				Focus->markDirty();
+
 			if (Focus && Focus->OnEvent(event))
 				return true;
 
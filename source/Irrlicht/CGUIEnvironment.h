@@ -16,6 +16,10 @@
 
 namespace irr
 {
+namespace video
+{
+	class IRenderTarget;
+}
 
 namespace gui
 {
@@ -33,6 +37,9 @@ public:
 	//! draws all gui elements
 	virtual void drawAll(bool useScreenSize) IRR_OVERRIDE;
 
+	//! draws an element from its cached image
+	virtual void drawRetainedElement(IGUIElement* element) IRR_OVERRIDE;
+
 	//! returns the current video driver
 	virtual video::IVideoDriver* getVideoDriver() const IRR_OVERRIDE;
 
@@ -291,6 +298,9 @@ private:
 
 	void updateHoveredElement(core::position2d<s32> mousePos);
 
+	//! release caches of elements which are no longer retained or were removed
+	void updateRetainedElements(bool removeAll);
+
 	void loadBuiltInFont();
 
 	struct SFont
@@ -326,6 +336,12 @@ private:
 
 	SToolTip ToolTip;
 
+	struct SRetainedElement
+	{
+		IGUIElement* Element;
+		video::ITexture* Texture;
+	};
+
 	core::array<IGUIElementFactory*> GUIElementFactoryList;
 
 	core::array<SFont> Fonts;
@@ -342,6 +358,9 @@ private:
 	u32 FocusFlags;
 	u32 MenuShowDelay;
 	core::array<IGUIElement*> DeletionQueue;
+	core::array<SRetainedElement> RetainedElements;
+	video::IRenderTarget* RetainedTarget;	// own target, so a texture set by the user with setRenderTarget stays bound to the shared one
+	bool DrawingRetained;
 
 	static const io::path DefaultFontName;
 };
@@ -21,7 +21,7 @@ namespace gui
 //! constructor
 CGUIFont::CGUIFont(IGUIEnvironment *env, const io::path& filename)
 : Driver(0), SpriteBank(0), Environment(env), WrongCharacter(0),
-	MaxHeight(0), GlobalKerningWidth(0), GlobalKerningHeight(0)
+	MaxHeight(0), GlobalKerningWidth(0), GlobalKerningHeight(0), LayoutCacheTime(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CGUIFont");
@@ -188,6 +188,8 @@ bool CGUIFont::load(io::IXMLReader* xml, const io::path& directory)
 		}
 	}
 
+	updateCharacterTables();
+
 	// set bad character
 	WrongCharacter = getAreaFromCharacter(L' ');
 
@@ -284,6 +286,7 @@ bool CGUIFont::loadTexture(video::IImage* image, const io::path& name)
 		return false;
 	}
 	readPositions(tmpImage, lowerRightPositions);
+	updateCharacterTables();
 
 	WrongCharacter = getAreaFromCharacter(L' ');
 
@@ -310,6 +313,7 @@ bool CGUIFont::loadTexture(video::IImage* image, const io::path& name)
 	image->drop();
 
 	setMaxHeight();
+	clearLayoutCache();
 
 	return ret;
 }
@@ -388,6 +392,8 @@ void CGUIFont::readPositions(video::IImage* image, s32& lowerRightPositions)
 //! set an Pixel Offset on Drawing ( scale position on width )
 void CGUIFont::setKerningWidth(s32 kerning)
 {
+	if (GlobalKerningWidth != kerning)
+		clearLayoutCache();
 	GlobalKerningWidth = kerning;
 }
 
@@ -434,6 +440,13 @@ u32 CGUIFont::getSpriteNoFromChar(const wchar_t *c) const
 
 s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 {
+	const u32 idx = (u32)c;
+	if (idx < CharacterTable.size())
+	{
+		const s32 area = CharacterTable[idx];
+		return area >= 0 ? area : (s32)WrongCharacter;
+	}
+
 	core::map<wchar_t, s32>::Node* n = CharacterMap.find(c);
 	if (n)
 		return n->getValue();
@@ -441,9 +454,67 @@ s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 		return WrongCharacter;
 }
 
+
+bool CGUIFont::isInvisibleCharacter(const wchar_t c) const
+{
+	const u32 idx = (u32)c;
+	if (idx < InvisibleTable.size())
+		return InvisibleTable[idx];
+
+	// only characters outside the basic multilingual plane are not in the table
+	return idx > 0xffff && InvisibleCharacters.findFirst(c) >= 0;
+}
+
+
+void CGUIFont::updateCharacterTables()
+{
+	u32 tableSize = 0;
+	core::map<wchar_t, s32>::ConstIterator it = CharacterMap.getConstIterator();
+	for (; !it.atEnd(); it++)
+	{
+		const u32 idx = (u32)it->getKey();
+		if (idx <= 0xffff && idx >= tableSize)
+			tableSize = idx + 1;
+	}
+
+	CharacterTable.set_used(tableSize);
+	for (u32 i=0; i < tableSize; ++i)
+		CharacterTable[i] = -1;
+
+	for (it = CharacterMap.getConstIterator(); !it.atEnd(); it++)
+	{
+		const u32 idx = (u32)it->getKey();
+		if (idx < tableSize)
+			CharacterTable[idx] = it->getValue();
+	}
+
+	clearLayoutCache();
+}
+
+
 void CGUIFont::setInvisibleCharacters( const wchar_t *s )
 {
 	InvisibleCharacters = s;
+
+	u32 tableSize = 0;
+	for (u32 i=0; i < InvisibleCharacters.size(); ++i)
+	{
+		const u32 idx = (u32)InvisibleCharacters[i];
+		if (idx <= 0xffff && idx >= tableSize)
+			tableSize = idx + 1;
+	}
+
+	InvisibleTable.set_used(tableSize);
+	for (u32 i=0; i < tableSize; ++i)
+		InvisibleTable[i] = false;
+	for (u32 i=0; i < InvisibleCharacters.size(); ++i)
+	{
+		const u32 idx = (u32)InvisibleCharacters[i];
+		if (idx < tableSize)
+			InvisibleTable[idx] = true;
+	}
+
+	clearLayoutCache();
 }
 
 
@@ -488,40 +559,22 @@ core::dimension2d<u32> CGUIFont::getDimension(const wchar_t* text) const
 	return dim;
 }
 
-//! draws some text and clips it to the specified rectangle if wanted
-void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
-					video::SColor color,
-					bool hcenter, bool vcenter, const core::rect<s32>* clip
-				)
+//! Resolves the glyphs of a text into texture batches relative to the text origin
+void CGUIFont::layoutText(const core::stringw& text, STextLayout& layout) const
 {
-	if (!Driver || !SpriteBank || text.empty())
-		return;
-
-	core::dimension2d<s32> textDimension;	// NOTE: don't make this u32 or the >> later on can fail when the dimension width is < position width
-	core::position2d<s32> offset = position.UpperLeftCorner;
-
-	if (hcenter || vcenter || clip)
-		textDimension = getDimension(text.c_str());
-
-	if (hcenter)
-		offset.X += (position.getWidth() - textDimension.Width) >> 1;
-
-	if (vcenter)
-		offset.Y += (position.getHeight() - textDimension.Height) >> 1;
-
-	if (clip)
+	layout.Dimension = core::dimension2d<s32>(getDimension(text.c_str()));
+	for (u32 i=0; i < layout.Batches.size(); ++i)
 	{
-		core::rect<s32> clippedRect(offset, textDimension);
-		clippedRect.clipAgainst(*clip);
-		if (!clippedRect.isValid())
-			return;
+		layout.Batches[i].Positions.set_used(0);
+		layout.Batches[i].SourceRects.set_used(0);
 	}
 
-	const irr::u32 textSize = text.size();
-	IndicesSB.set_used(0);
-	IndicesSB.reallocate(textSize, false);
-	OffsetsSB.set_used(0);
-	OffsetsSB.reallocate(textSize, false);
+	const core::array<SGUISprite>& sprites = SpriteBank->getSprites();
+	const core::array<core::rect<s32> >& rectangles = SpriteBank->getPositions();
+	const u32 textureCount = SpriteBank->getTextureCount();
+
+	core::position2d<s32> offset(0, 0);
+	STextBatch* batch = 0;
 
 	for(u32 i = 0;i < text.size();i++)
 	{
@@ -542,36 +595,157 @@ void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
 		if (lineBreak)
 		{
 			offset.Y += MaxHeight;
-			offset.X = position.UpperLeftCorner.X;
-
-			if ( hcenter )
-			{
-				offset.X += (position.getWidth() - textDimension.Width) >> 1;
-			}
+			offset.X = 0;
 			continue;
 		}
 
-		SFontArea& area = Areas[getAreaFromCharacter(c)];
+		const SFontArea& area = Areas[getAreaFromCharacter(c)];
 
 		offset.X += area.underhang;
-		if ( InvisibleCharacters.findFirst ( c ) < 0 )
+		if ( !isInvisibleCharacter(c) && area.spriteno < sprites.size()
+			&& !sprites[area.spriteno].Frames.empty() )
 		{
-			IndicesSB.push_back(area.spriteno);
-			OffsetsSB.push_back(offset);
+			const SGUISpriteFrame& frame = sprites[area.spriteno].Frames[0];
+			if (frame.textureNumber < textureCount && frame.rectNumber < rectangles.size())
+			{
+				// glyphs are usually on a single texture, so the last batch is nearly always the right one
+				if (!batch || batch->TextureNumber != frame.textureNumber)
+				{
+					batch = 0;
+					for (u32 b=0; b < layout.Batches.size(); ++b)
+					{
+						if (layout.Batches[b].TextureNumber == frame.textureNumber)
+						{
+							batch = &layout.Batches[b];
+							break;
+						}
+					}
+					if (!batch)
+					{
+						layout.Batches.push_back(STextBatch());
+						batch = &layout.Batches.getLast();
+						batch->TextureNumber = frame.textureNumber;
+					}
+				}
+				batch->Positions.push_back(offset);
+				batch->SourceRects.push_back(rectangles[frame.rectNumber]);
+			}
 		}
 
 		offset.X += area.width + area.overhang + GlobalKerningWidth;
 	}
+}
 
-	SpriteBank->draw2DSpriteBatch(IndicesSB, OffsetsSB, clip, color);
 
-	// We keep arrays around to avoid constant re-allocations for every drawn text.
+//! Returns the layout of a text, from the cache when possible
+const CGUIFont::STextLayout& CGUIFont::getLayout(const core::stringw& text)
+{
+	// We keep layouts around to avoid constant re-allocations and glyph lookups for every drawn text.
 	// But don't want them to block memory forever just because one huge text was written once.
-	const u32 maxBufferSize = 2000;	// large enough for typical strings, but not too expensive
-	if ( textSize > maxBufferSize )
+	const u32 maxCachedSize = 2000;	// large enough for typical strings, but not too expensive
+	const u32 maxCacheEntries = 64;
+
+	if (text.size() > maxCachedSize)
+	{
+		layoutText(text, ScratchLayout);
+		return ScratchLayout;
+	}
+
+	// FNV-1a
+	u32 hash = 2166136261u;
+	for (u32 i=0; i < text.size(); ++i)
+	{
+		hash ^= (u32)text[i];
+		hash *= 16777619u;
+	}
+
+	++LayoutCacheTime;
+	u32 oldest = 0;
+	for (u32 i=0; i < LayoutCache.size(); ++i)
+	{
+		STextLayout& cached = LayoutCache[i];
+		if (cached.Hash == hash && cached.Text == text)
+		{
+			cached.LastUsed = LayoutCacheTime;
+			return cached;
+		}
+		if (cached.LastUsed < LayoutCache[oldest].LastUsed)
+			oldest = i;
+	}
+
+	STextLayout* layout;
+	if (LayoutCache.size() < maxCacheEntries)
+	{
+		LayoutCache.push_back(STextLayout());
+		layout = &LayoutCache.getLast();
+	}
+	else
+		layout = &LayoutCache[oldest];
+
+	layout->Text = text;
+	layout->Hash = hash;
+	layout->LastUsed = LayoutCacheTime;
+	layoutText(text, *layout);
+
+	return *layout;
+}
+
+
+void CGUIFont::clearLayoutCache()
+{
+	LayoutCache.clear();
+	LayoutCacheTime = 0;
+	ScratchLayout.Batches.clear();
+}
+
+
+//! draws some text and clips it to the specified rectangle if wanted
+void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
+					video::SColor color,
+					bool hcenter, bool vcenter, const core::rect<s32>* clip
+				)
+{
+	if (!Driver || !SpriteBank || text.empty())
+		return;
+
+	const STextLayout& layout = getLayout(text);
+
+	// NOTE: Dimension is s32 or the >> later on can fail when the dimension width is < position width
+	core::position2d<s32> offset = position.UpperLeftCorner;
+
+	if (hcenter)
+		offset.X += (position.getWidth() - layout.Dimension.Width) >> 1;
+
+	if (vcenter)
+		offset.Y += (position.getHeight() - layout.Dimension.Height) >> 1;
+
+	if (clip)
+	{
+		core::rect<s32> clippedRect(offset, layout.Dimension);
+		clippedRect.clipAgainst(*clip);
+		if (!clippedRect.isValid() || clippedRect.getArea() == 0)
+			return;
+	}
+
+	// one draw call for each texture the glyphs are on
+	for (u32 b=0; b < layout.Batches.size(); ++b)
+	{
+		const STextBatch& batch = layout.Batches[b];
+		if (batch.Positions.empty())
+			continue;
+
+		PositionsBatch.set_used(batch.Positions.size());
+		for (u32 i=0; i < batch.Positions.size(); ++i)
+			PositionsBatch[i] = batch.Positions[i] + offset;
+
+		Driver->draw2DImageBatch(SpriteBank->getTexture(batch.TextureNumber),
+			PositionsBatch, batch.SourceRects, clip, color, true);
+	}
+
+	if (&layout == &ScratchLayout)
 	{
-		IndicesSB.clear();
-		OffsetsSB.clear();
+		ScratchLayout.Batches.clear();
+		PositionsBatch.clear();
 	}
 }
 
@@ -90,19 +90,54 @@ private:
 		u32				spriteno;
 	};
 
+	//! Glyphs of a text using the same texture, positions relative to the text origin
+	struct STextBatch
+	{
+		u32 TextureNumber;
+		core::array<core::position2di> Positions;
+		core::array<core::rect<s32> > SourceRects;
+	};
+
+	//! Cached result of laying out a text
+	struct STextLayout
+	{
+		STextLayout() : Hash(0), LastUsed(0) {}
+
+		core::stringw Text;
+		u32 Hash;
+		u32 LastUsed;
+		core::dimension2d<s32> Dimension;
+		core::array<STextBatch> Batches;
+	};
+
 	//! load & prepare font from ITexture
 	bool loadTexture(video::IImage * image, const io::path& name);
 
 	void readPositions(video::IImage* texture, s32& lowerRightPositions);
 
 	s32 getAreaFromCharacter (const wchar_t c) const;
+	bool isInvisibleCharacter(const wchar_t c) const;
 	void setMaxHeight();
 
+	//! Rebuild the flat lookup tables after the character map changed
+	void updateCharacterTables();
+
+	//! Returns the layout of a text, from the cache when possible
+	const STextLayout& getLayout(const core::stringw& text);
+	void layoutText(const core::stringw& text, STextLayout& layout) const;
+	void clearLayoutCache();
+
 	void pushTextureCreationFlags(bool(&flags)[3]);
 	void popTextureCreationFlags(const bool(&flags)[3]);
 
 	core::array<SFontArea>		Areas;
 	core::map<wchar_t, s32>		CharacterMap;
+	// Areas indexed by character for the characters of the basic multilingual
+	// plane up to the highest one used. -1 for characters not in the font.
+	// Others are looked up in CharacterMap.
+	core::array<s32>		CharacterTable;
+	// Invisible flags indexed by character up to the highest invisible character
+	core::array<bool>		InvisibleTable;
 	video::IVideoDriver*		Driver;
 	IGUISpriteBank*			SpriteBank;
 	IGUIEnvironment*		Environment;
@@ -112,9 +147,13 @@ private:
 
 	core::stringw InvisibleCharacters;
 
-	// Indices and offsets for spritebank. Member instead of local to avoid constant re-allocations
-	core::array<u32> IndicesSB;
-	core::array<core::position2di> OffsetsSB;
+	// Recently drawn texts, replaced least recently used first
+	core::array<STextLayout> LayoutCache;
+	u32 LayoutCacheTime;
+	// Layout of texts too long for the cache
+	STextLayout ScratchLayout;
+	// Positions moved to the draw origin. Member instead of local to avoid constant re-allocations
+	core::array<core::position2di> PositionsBatch;
 };
 
 } // end namespace gui
@@ -53,7 +53,10 @@ void CGUIInOutFader::draw()
 		if (now > EndTime)
 			d = 0.0f;
 		else
+		{
 			d = (EndTime - now) / (f32)(EndTime - StartTime);
+			markDirty();
+		}
 
 		video::SColor newCol = FullColor.getInterpolated(TransColor, d);
 		driver->draw2DRectangle(newCol, AbsoluteRect, &AbsoluteClippingRect);
@@ -24,7 +24,7 @@ CGUIListBox::CGUIListBox(IGUIEnvironment* environment, IGUIElement* parent,
 			bool drawBack, bool moveOverSelect)
 : IGUIListBox(environment, parent, id, rectangle), Selected(-1), HoverSelected(-1),
 	ItemHeight(0), ItemHeightOverride(0),
-	TotalItemHeight(0), ItemsIconWidth(0), Font(0), OverrideFont(0), IconBank(0),
+	TotalItemHeight(0), ItemsIconWidth(0), Font(0), OverrideFont(0), DataSource(0), IconBank(0),
 	ScrollBar(0), SelectTime(0), LastKeyTime(0), Selecting(false), DrawBack(drawBack),
 	MoveOverSelect(moveOverSelect), AutoScroll(true), HighlightWhenNotFocused(true)
 {
@@ -66,12 +66,18 @@ CGUIListBox::~CGUIListBox()
 
 	if (IconBank)
 		IconBank->drop();
+
+	if (DataSource)
+		DataSource->drop();
 }
 
 
 //! returns amount of list items
 u32 CGUIListBox::getItemCount() const
 {
+	if (DataSource)
+		return DataSource->getItemCount();
+
 	return Items.size();
 }
 
@@ -79,9 +85,12 @@ u32 CGUIListBox::getItemCount() const
 //! returns string of a list item. the may be a value from 0 to itemCount-1
 const wchar_t* CGUIListBox::getListItem(u32 id) const
 {
-	if (id>=Items.size())
+	if (id>=getItemCount())
 		return 0;
 
+	if (DataSource)
+		return DataSource->getItemText(id);
+
 	return Items[id].Text.c_str();
 }
 
@@ -89,9 +98,12 @@ const wchar_t* CGUIListBox::getListItem(u32 id) const
 //! Returns the icon of an item
 s32 CGUIListBox::getIcon(u32 id) const
 {
-	if (id>=Items.size())
+	if (id>=getItemCount())
 		return -1;
 
+	if (DataSource)
+		return DataSource->getItemIcon(id);
+
 	return Items[id].Icon;
 }
 
@@ -99,9 +111,17 @@ s32 CGUIListBox::getIcon(u32 id) const
 //! adds a list item, returns id of item
 void CGUIListBox::removeItem(u32 id)
 {
+	markDirty();
 	if (id >= Items.size())
 		return;
 
+	// the selection is an item of the data source while one is set
+	if (DataSource)
+	{
+		Items.erase(id);
+		return;
+	}
+
 	if ((u32)Selected==id)
 	{
 		Selected = -1;
@@ -129,7 +149,7 @@ s32 CGUIListBox::getItemAt(s32 xpos, s32 ypos) const
 		return -1;
 
 	s32 item = ((ypos - AbsoluteRect.UpperLeftCorner.Y - 1) + ScrollBar->getPos()) / ItemHeight;
-	if ( item < 0 || item >= (s32)Items.size())
+	if ( item < 0 || item >= (s32)getItemCount())
 		return -1;
 
 	return item;
@@ -138,6 +158,7 @@ s32 CGUIListBox::getItemAt(s32 xpos, s32 ypos) const
 //! clears the list
 void CGUIListBox::clear()
 {
+	markDirty();
 	Items.clear();
 	ItemsIconWidth = 0;
 	Selected = -1;
@@ -150,6 +171,7 @@ void CGUIListBox::clear()
 
 void CGUIListBox::setOverrideFont(IGUIFont* font)
 {
+	markDirty();
 	if (OverrideFont == font)
 		return;
 
@@ -199,7 +221,7 @@ void CGUIListBox::recalculateItemHeight(bool forceRecalculation)
 	if ( Font && 0 == ItemHeightOverride && (fontChanged || forceRecalculation) )
 		ItemHeight = Font->getDimension(L"A").Height + 4;
 
-	TotalItemHeight = ItemHeight * Items.size();
+	TotalItemHeight = ItemHeight * getItemCount();
 	ScrollBar->setMax( core::max_(0, TotalItemHeight - AbsoluteRect.getHeight()) );
 	s32 minItemHeight = ItemHeight > 0 ? ItemHeight : 1;
 	ScrollBar->setSmallStep ( minItemHeight );
@@ -221,7 +243,8 @@ s32 CGUIListBox::getSelected() const
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIListBox::setSelected(s32 id)
 {
-	if ((u32)id>=Items.size())
+	markDirty();
+	if ((u32)id>=getItemCount())
 		Selected = -1;
 	else
 		Selected = id;
@@ -235,13 +258,16 @@ void CGUIListBox::setSelected(s32 id)
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIListBox::setSelected(const wchar_t *item)
 {
+	markDirty();
 	s32 index = -1;
 
 	if ( item )
 	{
-		for ( index = 0; index < (s32) Items.size(); ++index )
+		const s32 count = (s32)getItemCount();
+		for ( index = 0; index < count; ++index )
 		{
-			if ( Items[index].Text == item )
+			const wchar_t* text = getListItem(index);
+			if ( text && !wcscmp(text, item) )
 				break;
 		}
 	}
@@ -277,7 +303,7 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 						Selected = 0;
 						break;
 					case KEY_END:
-						Selected = (s32)Items.size()-1;
+						Selected = (s32)getItemCount()-1;
 						break;
 					case KEY_NEXT:
 						Selected += AbsoluteRect.getHeight() / ItemHeight;
@@ -290,8 +316,8 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 				}
 				if (Selected<0)
 					Selected = 0;
-				if (Selected >= (s32)Items.size())
-					Selected = Items.size() - 1;	// will set Selected to -1 for empty listboxes which is correct
+				if (Selected >= (s32)getItemCount())
+					Selected = getItemCount() - 1;	// will set Selected to -1 for empty listboxes which is correct
 
 
 				recalculateScrollPos();
@@ -328,7 +354,7 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 			{
 				return false;
 			}
-			else if (event.KeyInput.PressedDown && event.KeyInput.Char)
+			else if (event.KeyInput.PressedDown && event.KeyInput.Char && !DataSource)
 			{
 				// change selection based on text as it is typed.
 				u32 now = os::Timer::getTime();
@@ -476,9 +502,10 @@ void CGUIListBox::selectNew(s32 ypos, bool onlyHover)
 {
 	u32 now = os::Timer::getTime();
 	s32 oldSelected = Selected;
+	markDirty();
 
 	HoverSelected = getItemAt(AbsoluteRect.UpperLeftCorner.X, ypos);
-	if (HoverSelected<0 && !Items.empty())
+	if (HoverSelected<0 && getItemCount())
 		HoverSelected = 0;
 	if  (!onlyHover)
 	{
@@ -557,10 +584,23 @@ void CGUIListBox::draw()
 	bool hl = (HighlightWhenNotFocused || Environment->hasFocus(this) || Environment->hasFocus(ScrollBar));
 	const irr::s32 selected = getSelected();
 
-	for (s32 i=0; i<(s32)Items.size(); ++i)
+	// skip the items above the visible area
+	const s32 itemCount = (s32)getItemCount();
+	s32 first = 0;
+	if ( ItemHeight > 0 && frameRect.LowerRightCorner.Y < AbsoluteRect.UpperLeftCorner.Y )
 	{
-		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
-			frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
+		first = (AbsoluteRect.UpperLeftCorner.Y - frameRect.LowerRightCorner.Y) / ItemHeight;
+		frameRect.UpperLeftCorner.Y += first * ItemHeight;
+		frameRect.LowerRightCorner.Y += first * ItemHeight;
+	}
+
+	for (s32 i=first; i<itemCount; ++i)
+	{
+		// all other items are below the visible area
+		if (frameRect.UpperLeftCorner.Y > AbsoluteRect.LowerRightCorner.Y)
+			break;
+
+		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y)
 		{
 			if (i == selected && hl)
 			{
@@ -576,7 +616,12 @@ void CGUIListBox::draw()
 
 			if (Font)
 			{
-				if (IconBank && (Items[i].Icon > -1))
+				const s32 icon = getIcon(i);
+				const wchar_t* text = getListItem(i);
+				if (DataSource)
+					recalculateItemWidth(icon);
+
+				if (IconBank && (icon > -1))
 				{
 					core::position2di iconPos = textRect.UpperLeftCorner;
 					iconPos.Y += textRect.getHeight() / 2;
@@ -584,14 +629,14 @@ void CGUIListBox::draw()
 
 					if ( i==selected && hl )
 					{
-						IconBank->draw2DSprite( (u32)Items[i].Icon, iconPos, &clientClip,
+						IconBank->draw2DSprite( (u32)icon, iconPos, &clientClip,
 							hasItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) ?
 							getItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_ICON_HIGHLIGHT),
 							SelectTime, os::Timer::getTime(), false, true);
 					}
 					else
 					{
-						IconBank->draw2DSprite( (u32)Items[i].Icon, iconPos, &clientClip,
+						IconBank->draw2DSprite( (u32)icon, iconPos, &clientClip,
 							hasItemOverrideColor(i, EGUI_LBC_ICON) ? getItemOverrideColor(i, EGUI_LBC_ICON) : getItemDefaultColor(EGUI_LBC_ICON),
 							0 , (i==selected) ? os::Timer::getTime() : 0, false, true);
 					}
@@ -601,14 +646,14 @@ void CGUIListBox::draw()
 
 				if ( i==selected && hl )
 				{
-					Font->draw(Items[i].Text, textRect,
+					Font->draw(text, textRect,
 						hasItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) ?
 						getItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_TEXT_HIGHLIGHT),
 						false, true, &clientClip);
 				}
 				else
 				{
-					Font->draw(Items[i].Text, textRect,
+					Font->draw(text, textRect,
 						hasItemOverrideColor(i, EGUI_LBC_TEXT) ? getItemOverrideColor(i, EGUI_LBC_TEXT) : getItemDefaultColor(EGUI_LBC_TEXT),
 						false, true, &clientClip);
 				}
@@ -628,6 +673,7 @@ void CGUIListBox::draw()
 //! adds an list item with an icon
 u32 CGUIListBox::addItem(const wchar_t* text, s32 icon)
 {
+	markDirty();
 	ListItem i;
 	i.Text = text;
 	i.Icon = icon;
@@ -642,6 +688,7 @@ u32 CGUIListBox::addItem(const wchar_t* text, s32 icon)
 
 void CGUIListBox::setSpriteBank(IGUISpriteBank* bank)
 {
+	markDirty();
 	if ( bank == IconBank )
 		return;
 	if (IconBank)
@@ -830,6 +877,7 @@ void CGUIListBox::recalculateItemWidth(s32 icon)
 
 void CGUIListBox::setItem(u32 index, const wchar_t* text, s32 icon)
 {
+	markDirty();
 	if ( index >= Items.size() )
 		return;
 
@@ -845,6 +893,7 @@ void CGUIListBox::setItem(u32 index, const wchar_t* text, s32 icon)
 //! Return the index on success or -1 on failure.
 s32 CGUIListBox::insertItem(u32 index, const wchar_t* text, s32 icon)
 {
+	markDirty();
 	ListItem i;
 	i.Text = text;
 	i.Icon = icon;
@@ -859,6 +908,7 @@ s32 CGUIListBox::insertItem(u32 index, const wchar_t* text, s32 icon)
 
 void CGUIListBox::swapItems(u32 index1, u32 index2)
 {
+	markDirty();
 	if ( index1 >= Items.size() || index2 >= Items.size() )
 		return;
 
@@ -870,6 +920,7 @@ void CGUIListBox::swapItems(u32 index1, u32 index2)
 
 void CGUIListBox::setItemOverrideColor(u32 index, video::SColor color)
 {
+	markDirty();
 	for ( u32 c=0; c < EGUI_LBC_COUNT; ++c )
 	{
 		Items[index].OverrideColors[c].Use = true;
@@ -880,6 +931,7 @@ void CGUIListBox::setItemOverrideColor(u32 index, video::SColor color)
 
 void CGUIListBox::setItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType, video::SColor color)
 {
+	markDirty();
 	if ( index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT )
 		return;
 
@@ -890,6 +942,7 @@ void CGUIListBox::setItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType,
 
 void CGUIListBox::clearItemOverrideColor(u32 index)
 {
+	markDirty();
 	for (u32 c=0; c < (u32)EGUI_LBC_COUNT; ++c )
 	{
 		Items[index].OverrideColors[c].Use = false;
@@ -899,6 +952,7 @@ void CGUIListBox::clearItemOverrideColor(u32 index)
 
 void CGUIListBox::clearItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType)
 {
+	markDirty();
 	if ( index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT )
 		return;
 
@@ -908,7 +962,7 @@ void CGUIListBox::clearItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType
 
 bool CGUIListBox::hasItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType) const
 {
-	if ( index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT )
+	if ( DataSource || index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT )
 		return false;
 
 	return Items[index].OverrideColors[colorType].Use;
@@ -952,14 +1006,45 @@ video::SColor CGUIListBox::getItemDefaultColor(EGUI_LISTBOX_COLOR colorType) con
 //! set global itemHeight
 void CGUIListBox::setItemHeight( s32 height )
 {
+	markDirty();
 	ItemHeightOverride = height;
 	recalculateItemHeight(0 == ItemHeightOverride);
 }
 
 
+//! Get the items from a data source instead of the stored items.
+void CGUIListBox::setDataSource(IGUIListBoxDataSource* source)
+{
+	markDirty();
+	if ( source == DataSource )
+		return;
+
+	if ( source )
+		source->grab();
+	if ( DataSource )
+		DataSource->drop();
+	DataSource = source;
+
+	Selected = -1;
+	HoverSelected = -1;
+	ScrollBar->setPos(0);
+
+	recalculateItemHeight();
+	markDirty();
+}
+
+
+//! Returns the data source, or 0 if the stored items are used.
+IGUIListBoxDataSource* CGUIListBox::getDataSource() const
+{
+	return DataSource;
+}
+
+
 //! Sets whether to draw the background
 void CGUIListBox::setDrawBackground(bool draw)
 {
+	markDirty();
     DrawBack = draw;
 }
 
@@ -140,6 +140,12 @@ namespace gui
 		//! Get the font which is used for drawing
 		virtual IGUIFont* getActiveFont() const IRR_OVERRIDE;
 
+		//! Get the items from a data source instead of the stored items.
+		virtual void setDataSource(IGUIListBoxDataSource* source) IRR_OVERRIDE;
+
+		//! Returns the data source, or 0 if the stored items are used.
+		virtual IGUIListBoxDataSource* getDataSource() const IRR_OVERRIDE;
+
 	private:
 
 		struct ListItem
@@ -180,6 +186,7 @@ namespace gui
 		s32 ItemsIconWidth;
 		IGUIFont* Font;
 		IGUIFont* OverrideFont;
+		IGUIListBoxDataSource* DataSource;
 		IGUISpriteBank* IconBank;
 		IGUIScrollBar* ScrollBar;
 		u32 SelectTime;
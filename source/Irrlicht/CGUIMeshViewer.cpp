@@ -41,6 +41,7 @@ CGUIMeshViewer::~CGUIMeshViewer()
 //! sets the mesh to be shown
 void CGUIMeshViewer::setMesh(scene::IAnimatedMesh* mesh)
 {
+	markDirty();
 	if (mesh)
 		mesh->grab();
 	if (Mesh)
@@ -68,6 +69,7 @@ scene::IAnimatedMesh* CGUIMeshViewer::getMesh() const
 //! sets the material
 void CGUIMeshViewer::setMaterial(const video::SMaterial& material)
 {
+	markDirty();
 	Material = material;
 }
 
@@ -148,6 +150,8 @@ void CGUIMeshViewer::draw()
 		u32 frame = 0;
 		if(Mesh->getFrameCount())
 			frame = (os::Timer::getTime()/20)%Mesh->getFrameCount();
+		if (Mesh->getFrameCount() > 1)
+			markDirty();
 		const scene::IMesh* const m = Mesh->getMesh(frame);
 		for (u32 i=0; i<m->getMeshBufferCount(); ++i)
 		{
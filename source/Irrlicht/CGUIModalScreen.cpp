@@ -168,6 +168,8 @@ void CGUIModalScreen::draw()
 		return;
 
 	u32 now = os::Timer::getTime();
+	if (BlinkMode && now - MouseDownTime < 300)
+		markDirty();
 	if (BlinkMode && now - MouseDownTime < 300 && (now / 70)%2)
 	{
 		core::list<IGUIElement*>::Iterator it = Children.begin();
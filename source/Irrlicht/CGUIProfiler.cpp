@@ -90,6 +90,7 @@ u32 CGUIProfiler::addDataToTable(u32 rowIndex, u32 dataIndex, u32 groupIndex)
 
 void CGUIProfiler::updateDisplay()
 {
+	markDirty();
 	if ( DisplayTable )
 	{
 		DisplayTable->clearRows();
@@ -246,6 +247,7 @@ void CGUIProfiler::previousPage(bool includeOverview)
 
 void CGUIProfiler::setShowGroupsTogether(bool groupsTogether)
 {
+	markDirty();
 	ShowGroupsTogether = groupsTogether;
 }
 
@@ -267,6 +269,7 @@ void CGUIProfiler::firstPage(bool includeOverview)
 //! Sets another skin independent font.
 void CGUIProfiler::setOverrideFont(IGUIFont* font)
 {
+	markDirty();
 	if ( DisplayTable )
 	{
 		DisplayTable->setOverrideFont(font);
@@ -293,6 +296,7 @@ IGUIFont* CGUIProfiler::getActiveFont() const
 //! Sets whether to draw the background. By default disabled,
 void CGUIProfiler::setDrawBackground(bool draw)
 {
+	markDirty();
 	DrawBackground = draw;
 	if ( DisplayTable )
 		DisplayTable->setDrawBackground(draw);
@@ -343,6 +343,11 @@ s32 CGUIScrollBar::getPosFromMousePos(const core::position2di &pos) const
 //! sets the position of the scrollbar
 void CGUIScrollBar::setPos(s32 pos)
 {
+	// the list box sets this while drawing, only changes need a redraw
+	const s32 oldPos = Pos;
+	const s32 oldDrawPos = DrawPos;
+	const s32 oldDrawHeight = DrawHeight;
+
 	Pos = core::s32_clamp ( pos, Min, Max );
 
 	if ( core::isnotzero ( range() ) )
@@ -361,6 +366,9 @@ void CGUIScrollBar::setPos(s32 pos)
 			DrawHeight = RelativeRect.getWidth();
 		}
 	}
+
+	if (Pos != oldPos || DrawPos != oldDrawPos || DrawHeight != oldDrawHeight)
+		markDirty();
 }
 
 
@@ -408,6 +416,8 @@ s32 CGUIScrollBar::getMax() const
 //! sets the maximum value of the scrollbar.
 void CGUIScrollBar::setMax(s32 max)
 {
+	if (Max != max)
+		markDirty();
 	Max = max;
 	if ( Min > Max )
 		Min = Max;
@@ -428,6 +438,8 @@ s32 CGUIScrollBar::getMin() const
 //! sets the minimum value of the scrollbar.
 void CGUIScrollBar::setMin(s32 min)
 {
+	if (Min != min)
+		markDirty();
 	Min = min;
 	if ( Max < Min )
 		Max = Min;
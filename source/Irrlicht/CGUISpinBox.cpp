@@ -113,6 +113,7 @@ IGUIEditBox* CGUISpinBox::getEditBox() const
 
 void CGUISpinBox::setValue(f32 val)
 {
+	markDirty();
 	wchar_t str[100];
 	swprintf_irr(str, 99, FormatString.c_str(), val);
 	EditBox->setText(str);
@@ -135,6 +136,7 @@ f32 CGUISpinBox::getValueFor(const wchar_t* val) const
 
 void CGUISpinBox::setRange(f32 min, f32 max)
 {
+	markDirty();
 	if (max<min)
 		core::swap(min, max);
 	RangeMin = min;
@@ -177,6 +179,7 @@ void CGUISpinBox::setStepSize(f32 step)
 //! Sets the number of decimal places to display.
 void CGUISpinBox::setDecimalPlaces(s32 places)
 {
+	markDirty();
 	DecimalPlaces = places;
 	if (places == -1)
 		FormatString = "%f";
@@ -146,6 +146,7 @@ void CGUIStaticText::draw()
 //! Sets another skin independent font.
 void CGUIStaticText::setOverrideFont(IGUIFont* font)
 {
+	markDirty();
 	if (OverrideFont == font)
 		return;
 
@@ -180,6 +181,9 @@ IGUIFont* CGUIStaticText::getActiveFont() const
 //! Sets another color for the text.
 void CGUIStaticText::setOverrideColor(video::SColor color)
 {
+	// the combo box sets this while drawing
+	if (!OverrideColorEnabled || OverrideColor != color)
+		markDirty();
 	OverrideColor = color;
 	OverrideColorEnabled = true;
 }
@@ -188,6 +192,8 @@ void CGUIStaticText::setOverrideColor(video::SColor color)
 //! Sets another color for the text.
 void CGUIStaticText::setBackgroundColor(video::SColor color)
 {
+	if (!OverrideBGColorEnabled || !Background || BGColor != color)
+		markDirty();
 	BGColor = color;
 	OverrideBGColorEnabled = true;
 	Background = true;
@@ -197,6 +203,8 @@ void CGUIStaticText::setBackgroundColor(video::SColor color)
 //! Sets whether to draw the background
 void CGUIStaticText::setDrawBackground(bool draw)
 {
+	if (Background != draw)
+		markDirty();
 	Background = draw;
 }
 
@@ -218,6 +226,7 @@ bool CGUIStaticText::isDrawBackgroundEnabled() const
 //! Sets whether to draw the border
 void CGUIStaticText::setDrawBorder(bool draw)
 {
+	markDirty();
 	Border = draw;
 }
 
@@ -231,6 +240,7 @@ bool CGUIStaticText::isDrawBorderEnabled() const
 
 void CGUIStaticText::setTextRestrainedInside(bool restrainTextInside)
 {
+	markDirty();
 	RestrainTextInside = restrainTextInside;
 }
 
@@ -243,6 +253,7 @@ bool CGUIStaticText::isTextRestrainedInside() const
 
 void CGUIStaticText::setTextAlignment(EGUI_ALIGNMENT horizontal, EGUI_ALIGNMENT vertical)
 {
+	markDirty();
 	HAlign = horizontal;
 	VAlign = vertical;
 }
@@ -282,6 +293,7 @@ bool CGUIStaticText::isOverrideColorEnabled() const
 //! multiline text control.
 void CGUIStaticText::setWordWrap(bool enable)
 {
+	markDirty();
 	WordWrap = enable;
 	breakText();
 }
@@ -295,6 +307,7 @@ bool CGUIStaticText::isWordWrapEnabled() const
 
 void CGUIStaticText::setRightToLeft(bool rtl)
 {
+	markDirty();
 	if (RightToLeft != rtl)
 	{
 		RightToLeft = rtl;
@@ -56,6 +56,7 @@ void CGUITab::draw()
 //! sets if the tab should draw its background
 void CGUITab::setDrawBackground(bool draw)
 {
+	markDirty();
 	DrawBackground = draw;
 }
 
@@ -63,6 +64,7 @@ void CGUITab::setDrawBackground(bool draw)
 //! sets the color of the background, if it should be drawn.
 void CGUITab::setBackgroundColor(video::SColor c)
 {
+	markDirty();
 	BackColor = c;
 }
 
@@ -70,6 +72,7 @@ void CGUITab::setBackgroundColor(video::SColor c)
 //! sets the color of the text
 void CGUITab::setTextColor(video::SColor c)
 {
+	markDirty();
 	OverrideTextColorEnabled = true;
 	TextColor = c;
 }
@@ -232,6 +235,7 @@ void CGUITabControl::refreshSprites()
 //! Adds a tab
 IGUITab* CGUITabControl::addTab(const wchar_t* caption, s32 id)
 {
+	markDirty();
 	CGUITab* tab = new CGUITab(Environment, this, calcTabPos(), id);
 
 	tab->setText(caption);
@@ -254,12 +258,14 @@ IGUITab* CGUITabControl::addTab(const wchar_t* caption, s32 id)
 //! adds a tab which has been created elsewhere
 s32 CGUITabControl::addTab(IGUITab* tab)
 {
+	markDirty();
 	return insertTab( Tabs.size(), tab, false);
 }
 
 //! Insert the tab at the given index
 IGUITab* CGUITabControl::insertTab(s32 idx, const wchar_t* caption, s32 id)
 {
+	markDirty();
 	if ( idx < 0 || idx > (s32)Tabs.size() )	// idx == Tabs.size() is indeed OK here as core::array can handle that
 		return NULL;
 
@@ -288,6 +294,7 @@ IGUITab* CGUITabControl::insertTab(s32 idx, const wchar_t* caption, s32 id)
 
 s32 CGUITabControl::insertTab(s32 idx, IGUITab* tab, bool serializationMode)
 {
+	markDirty();
 	if (!tab)
 		return -1;
 	if ( idx > (s32)Tabs.size() && !serializationMode )	// idx == Tabs.size() is indeed OK here as core::array can handle that
@@ -358,6 +365,7 @@ void CGUITabControl::removeChild(IGUIElement* child)
 //! Removes a tab from the tabcontrol
 void CGUITabControl::removeTab(s32 idx)
 {
+	markDirty();
 	if ( idx < 0 || idx >= (s32)Tabs.size() )
 		return;
 
@@ -388,6 +396,7 @@ void CGUITabControl::removeTabButNotChild(s32 idx)
 //! Clears the tabcontrol removing all tabs
 void CGUITabControl::clear()
 {
+	markDirty();
 	for (u32 i=0; i<Tabs.size(); ++i)
 	{
 		if (Tabs[i])
@@ -782,6 +791,7 @@ void CGUITabControl::draw()
 //! Set the height of the tabs
 void CGUITabControl::setTabHeight( s32 height )
 {
+	markDirty();
 	if ( height < 0 )
 		height = 0;
 
@@ -801,6 +811,7 @@ s32 CGUITabControl::getTabHeight() const
 //! set the maximal width of a tab. Per default width is 0 which means "no width restriction".
 void CGUITabControl::setTabMaxWidth(s32 width )
 {
+	markDirty();
 	TabMaxWidth = width;
 }
 
@@ -814,6 +825,7 @@ s32 CGUITabControl::getTabMaxWidth() const
 //! Set the extra width added to tabs on each side of the text
 void CGUITabControl::setTabExtraWidth( s32 extraWidth )
 {
+	markDirty();
 	if ( extraWidth < 0 )
 		extraWidth = 0;
 
@@ -855,6 +867,7 @@ void CGUITabControl::recalculateScrollBar()
 //! Set the alignment of the tabs
 void CGUITabControl::setTabVerticalAlignment( EGUI_ALIGNMENT alignment )
 {
+	markDirty();
 	VerticalAlignment = alignment;
 
 	recalculateScrollButtonPlacement();
@@ -967,6 +980,7 @@ s32 CGUITabControl::getActiveTab() const
 //! Brings a tab to front.
 bool CGUITabControl::setActiveTab(s32 idx)
 {
+	markDirty();
 	if ((u32)idx >= Tabs.size())
 		return false;
 
@@ -999,6 +1013,7 @@ void CGUITabControl::setVisibleTab(s32 idx)
 
 bool CGUITabControl::setActiveTab(IGUITab *tab)
 {
+	markDirty();
 	return setActiveTab(getTabIndex(tab));
 }
 
@@ -33,7 +33,7 @@ CGUITable::CGUITable(IGUIEnvironment* environment, IGUIElement* parent,
 	CellHeightPadding(2), CellWidthPadding(5), ActiveTab(-1),
 	CurrentOrdering(EGOM_NONE), DrawFlags(EGTDF_ROWS | EGTDF_COLUMNS | EGTDF_ACTIVE_ROW ),
 	ScrollBarSize(0),
-	OverrideFont(0)
+	OverrideFont(0), DataSource(0), DataSourceRowCount(0)
 {
 	#ifdef _DEBUG
 	setDebugName("CGUITable");
@@ -69,11 +69,15 @@ CGUITable::~CGUITable()
 
 	if (OverrideFont)
 		OverrideFont->drop();
+
+	if (DataSource)
+		DataSource->drop();
 }
 
 
 void CGUITable::addColumn(const wchar_t* caption, s32 columnIndex)
 {
+	markDirty();
 	Column tabHeader;
 	tabHeader.Name = caption;
 	tabHeader.Width = getActiveFont()->getDimension(caption).Width + (CellWidthPadding * 2) + ARROW_PAD;
@@ -108,6 +112,7 @@ void CGUITable::addColumn(const wchar_t* caption, s32 columnIndex)
 //! remove a column from the table
 void CGUITable::removeColumn(u32 columnIndex)
 {
+	markDirty();
 	if ( columnIndex < Columns.size() )
 	{
 		Columns.erase(columnIndex);
@@ -131,12 +136,13 @@ s32 CGUITable::getColumnCount() const
 
 s32 CGUITable::getRowCount() const
 {
-	return Rows.size();
+	return DataSource ? (s32)DataSource->getRowCount() : (s32)Rows.size();
 }
 
 
 bool CGUITable::setActiveColumn(s32 idx, bool doOrder )
 {
+	markDirty();
 	if ( idx >= (s32)Columns.size() )
 		idx = -1;
 
@@ -213,6 +219,7 @@ EGUI_ORDERING_MODE CGUITable::getActiveColumnOrdering() const
 
 void CGUITable::setColumnWidth(u32 columnIndex, u32 width)
 {
+	markDirty();
 	if ( columnIndex < Columns.size() )
 	{
 		const u32 MIN_WIDTH = getActiveFont()->getDimension(Columns[columnIndex].Name.c_str() ).Width + (CellWidthPadding * 2);
@@ -252,6 +259,7 @@ bool CGUITable::hasResizableColumns() const
 
 u32 CGUITable::addRow(u32 rowIndex)
 {
+	markDirty();
 	if ( rowIndex > Rows.size() )
 	{
 		rowIndex = Rows.size();
@@ -277,13 +285,15 @@ u32 CGUITable::addRow(u32 rowIndex)
 
 void CGUITable::removeRow(u32 rowIndex)
 {
-	if ( rowIndex > Rows.size() )
+	markDirty();
+	if ( rowIndex >= Rows.size() )
 		return;
 
 	Rows.erase( rowIndex );
 
-	if ( !(Selected < s32(Rows.size())) )
-		Selected = Rows.size() - 1;
+	// the selection is a row of the data source while one is set
+	if ( !(Selected < getRowCount()) )
+		Selected = getRowCount() - 1;
 
 	recalculateHeights();
 }
@@ -292,6 +302,7 @@ void CGUITable::removeRow(u32 rowIndex)
 //! adds an list item, returns id of item
 void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw& text)
 {
+	markDirty();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
@@ -305,6 +316,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 
 void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw& text, video::SColor color)
 {
+	markDirty();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
@@ -317,6 +329,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 
 void CGUITable::setCellColor(u32 rowIndex, u32 columnIndex, video::SColor color)
 {
+	markDirty();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Color = color;
@@ -336,6 +349,13 @@ void CGUITable::setCellData(u32 rowIndex, u32 columnIndex, void *data)
 
 const wchar_t* CGUITable::getCellText(u32 rowIndex, u32 columnIndex ) const
 {
+	if ( DataSource )
+	{
+		if ( rowIndex < DataSource->getRowCount() && columnIndex < Columns.size() )
+			return DataSource->getCellText(rowIndex, columnIndex);
+		return 0;
+	}
+
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		return Rows[rowIndex].Items[columnIndex].Text.c_str();
@@ -359,6 +379,7 @@ void* CGUITable::getCellData(u32 rowIndex, u32 columnIndex ) const
 //! clears the list
 void CGUITable::clear()
 {
+	markDirty();
     Selected = -1;
 	Rows.clear();
 	Columns.clear();
@@ -375,6 +396,7 @@ void CGUITable::clear()
 
 void CGUITable::clearRows()
 {
+	markDirty();
     Selected = -1;
 	Rows.clear();
 
@@ -395,8 +417,9 @@ s32 CGUITable::getSelected() const
 //! set which row is currently selected
 void CGUITable::setSelected( s32 index )
 {
+	markDirty();
 	Selected = -1;
-	if ( index >= 0 && index < (s32) Rows.size() )
+	if ( index >= 0 && index < getRowCount() )
 		Selected = index;
 }
 
@@ -418,7 +441,8 @@ void CGUITable::recalculateHeights()
 	if(activeFont)
 	{
 		ItemHeight = activeFont->getDimension(L"A").Height + (CellHeightPadding * 2);
-		TotalItemHeight = ItemHeight * Rows.size();		//  header is not counted, because we only want items
+		DataSourceRowCount = DataSource ? DataSource->getRowCount() : 0;
+		TotalItemHeight = ItemHeight * getRowCount();		//  header is not counted, because we only want items
 	}
 	else
 	{
@@ -658,6 +682,7 @@ bool CGUITable::OnEvent(const SEvent &event)
 
 void CGUITable::setColumnOrdering(u32 columnIndex, EGUI_COLUMN_ORDERING mode)
 {
+	markDirty();
 	if ( columnIndex < Columns.size() )
 		Columns[columnIndex].OrderingMode = mode;
 }
@@ -665,6 +690,7 @@ void CGUITable::setColumnOrdering(u32 columnIndex, EGUI_COLUMN_ORDERING mode)
 
 void CGUITable::swapRows(u32 rowIndexA, u32 rowIndexB)
 {
+	markDirty();
 	if ( rowIndexA >= Rows.size() )
 		return;
 
@@ -675,6 +701,9 @@ void CGUITable::swapRows(u32 rowIndexA, u32 rowIndexB)
 	Rows[rowIndexA] = Rows[rowIndexB];
 	Rows[rowIndexB] = swap;
 
+	if ( DataSource )
+		return;
+
 	if ( Selected == s32(rowIndexA) )
 		Selected = rowIndexB;
 	else if( Selected == s32(rowIndexB) )
@@ -766,6 +795,7 @@ bool CGUITable::selectColumnHeader(s32 xpos, s32 ypos)
 
 void CGUITable::orderRows(s32 columnIndex, EGUI_ORDERING_MODE mode)
 {
+	markDirty();
 	Row swap;
 
 	if ( columnIndex == -1 )
@@ -773,6 +803,10 @@ void CGUITable::orderRows(s32 columnIndex, EGUI_ORDERING_MODE mode)
 	if ( columnIndex < 0 )
 		return;
 
+	// data sources order their rows themselves, the stored rows are not shown
+	if ( DataSource )
+		return;
+
 	if ( mode == EGOM_ASCENDING )
 	{
 		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
@@ -831,8 +865,8 @@ void CGUITable::selectNew(s32 ypos, bool onlyHover)
 	if (ItemHeight!=0)
 		Selected = ((ypos - AbsoluteRect.UpperLeftCorner.Y - ItemHeight - 1) + VerticalScrollBar->getPos()) / ItemHeight;
 
-	if (Selected >= (s32)Rows.size())
-		Selected = Rows.size() - 1;
+	if (Selected >= getRowCount())
+		Selected = getRowCount() - 1;
 	else if (Selected<0)
 		Selected = 0;
 
@@ -865,6 +899,13 @@ void CGUITable::draw()
 	if (!font)
 		return;
 
+	if ( DataSource && DataSource->getRowCount() != DataSourceRowCount )
+	{
+		recalculateHeights();
+		if ( Selected >= getRowCount() )
+			Selected = getRowCount() - 1;
+	}
+
 	if ( ScrollBarSize != skin->getSize(EGDS_SCROLLBAR_SIZE) )
 		checkScrollbars();
 
@@ -908,11 +949,24 @@ void CGUITable::draw()
 	core::rect<s32> rowRect(scrolledTableClient);
 	rowRect.LowerRightCorner.Y = rowRect.UpperLeftCorner.Y + ItemHeight;
 
+	// skip the rows above the visible area
+	const u32 rowCount = (u32)getRowCount();
+	u32 firstRow = 0;
+	if ( ItemHeight > 0 && rowRect.LowerRightCorner.Y < AbsoluteRect.UpperLeftCorner.Y )
+	{
+		firstRow = (u32)((AbsoluteRect.UpperLeftCorner.Y - rowRect.LowerRightCorner.Y) / ItemHeight);
+		rowRect.UpperLeftCorner.Y += (s32)firstRow * ItemHeight;
+		rowRect.LowerRightCorner.Y += (s32)firstRow * ItemHeight;
+	}
+
 	u32 pos;
-	for ( u32 i = 0 ; i < Rows.size() ; ++i )
+	for ( u32 i = firstRow ; i < rowCount ; ++i )
 	{
-		if (rowRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
-			rowRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
+		// all other rows are below the visible area
+		if ( rowRect.UpperLeftCorner.Y > AbsoluteRect.LowerRightCorner.Y )
+			break;
+
+		if (rowRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y)
 		{
 			// draw row separator
 			if ( DrawFlags & EGTDF_ROWS )
@@ -935,7 +989,19 @@ void CGUITable::draw()
 				textRect.LowerRightCorner.X = pos + Columns[j].Width - CellWidthPadding;
 
 				// draw item text
-				if ((s32)i == Selected)
+				if ( DataSource )
+				{
+					const wchar_t* text = DataSource->getCellText(i, j);
+					breakText(text ? text : L"", DataSourceBrokenText, Columns[j].Width);
+
+					video::SColor color = skin->getColor((s32)i == Selected ? EGDC_HIGH_LIGHT_TEXT : EGDC_BUTTON_TEXT);
+					if ( (s32)i != Selected )
+						DataSource->getCellColor(i, j, color);
+					if ( !isEnabled() )
+						color = skin->getColor(EGDC_GRAY_TEXT);
+					font->draw(DataSourceBrokenText, textRect, color, false, true, &clientClip);
+				}
+				else if ((s32)i == Selected)
 				{
 					font->draw(Rows[i].Items[j].BrokenText, textRect, skin->getColor(isEnabled() ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT), false, true, &clientClip);
 				}
@@ -1059,6 +1125,7 @@ void CGUITable::breakText(const core::stringw& text, core::stringw& brokenText,
 //! Set some flags influencing the layout of the table
 void CGUITable::setDrawFlags(s32 flags)
 {
+	markDirty();
 	DrawFlags = flags;
 }
 
@@ -1072,6 +1139,7 @@ s32 CGUITable::getDrawFlags() const
 //! Sets another skin independent font.
 void CGUITable::setOverrideFont(IGUIFont* font)
 {
+	markDirty();
 	if (OverrideFont == font)
 		return;
 
@@ -1124,9 +1192,39 @@ IGUIScrollBar* CGUITable::getHorizontalScrollBar() const
 //! Sets whether to draw the background.
 void CGUITable::setDrawBackground(bool draw)
 {
+	markDirty();
 	DrawBack = draw;
 }
 
+//! Get the rows from a data source instead of the rows stored in the table.
+void CGUITable::setDataSource(IGUITableDataSource* source)
+{
+	markDirty();
+	if ( source == DataSource )
+		return;
+
+	if ( source )
+		source->grab();
+	if ( DataSource )
+		DataSource->drop();
+	DataSource = source;
+
+	Selected = -1;
+	if (VerticalScrollBar)
+		VerticalScrollBar->setPos(0);
+
+	recalculateHeights();
+	markDirty();
+}
+
+
+//! Returns the data source, or 0 if the stored rows are used.
+IGUITableDataSource* CGUITable::getDataSource() const
+{
+	return DataSource;
+}
+
+
 //! Checks if background drawing is enabled
 /** \return true if background drawing is enabled, false otherwise */
 bool CGUITable::isDrawBackgroundEnabled() const
@@ -168,6 +168,12 @@ namespace gui
 		/** \return true if background drawing is enabled, false otherwise */
 		virtual bool isDrawBackgroundEnabled() const IRR_OVERRIDE;
 
+		//! Get the rows from a data source instead of the rows stored in the table.
+		virtual void setDataSource(IGUITableDataSource* source) IRR_OVERRIDE;
+
+		//! Returns the data source, or 0 if the stored rows are used.
+		virtual IGUITableDataSource* getDataSource() const IRR_OVERRIDE;
+
 		//! Writes attributes of the object.
 		//! Implement this to expose the attributes of your scene node animator for
 		//! scripting languages, editors, debuggers or xml serialization purposes.
@@ -243,6 +249,12 @@ namespace gui
 		s32 ScrollBarSize;
 
 		gui::IGUIFont* OverrideFont;
+
+		IGUITableDataSource* DataSource;
+		// row count of the data source used for the current scrollbars
+		u32 DataSourceRowCount;
+		// cell text of the data source shortened to the column width
+		core::stringw DataSourceBrokenText;
 	};
 
 } // end namespace gui
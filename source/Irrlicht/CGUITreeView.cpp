@@ -51,16 +51,22 @@ IGUITreeViewNode* CGUITreeViewNode::getParent() const
 
 void CGUITreeViewNode::setText( const wchar_t* text )
 {
+	if (Owner)
+		Owner->markDirty();
 	Text = text;
 }
 
 void CGUITreeViewNode::setIcon( const wchar_t* icon )
 {
+	if (Owner)
+		Owner->markDirty();
 	Icon = icon;
 }
 
 void CGUITreeViewNode::clearChildren()
 {
+	if (Owner)
+		Owner->markDirty();
 	for(core::list<CGUITreeViewNode*>::Iterator it = Children.begin(); it != Children.end(); it++ )
 	{
 		( *it )->setSelected(false);
@@ -77,6 +83,8 @@ IGUITreeViewNode* CGUITreeViewNode::addChildBack(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2 /*= 0*/ )
 {
+	if (Owner)
+		Owner->markDirty();
 	CGUITreeViewNode*	newChild = new CGUITreeViewNode( Owner, this );
 
 	Children.push_back( newChild );
@@ -101,6 +109,8 @@ IGUITreeViewNode* CGUITreeViewNode::addChildFront(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2 /*= 0*/ )
 {
+	if (Owner)
+		Owner->markDirty();
 	CGUITreeViewNode*	newChild = new CGUITreeViewNode( Owner, this );
 
 	Children.push_front( newChild );
@@ -126,6 +136,8 @@ IGUITreeViewNode* CGUITreeViewNode::insertChildAfter(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2/* = 0*/ )
 {
+	if (Owner)
+		Owner->markDirty();
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									newChild = 0;
 
@@ -160,6 +172,8 @@ IGUITreeViewNode* CGUITreeViewNode::insertChildBefore(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2/* = 0*/ )
 {
+	if (Owner)
+		Owner->markDirty();
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									newChild = 0;
 
@@ -384,6 +398,8 @@ bool CGUITreeViewNode::deleteChild( IGUITreeViewNode* child )
 
 bool CGUITreeViewNode::moveChildUp( IGUITreeViewNode* child )
 {
+	if (Owner)
+		Owner->markDirty();
 	core::list<CGUITreeViewNode*>::Iterator	itChild;
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									nodeTmp;
@@ -409,6 +425,8 @@ bool CGUITreeViewNode::moveChildUp( IGUITreeViewNode* child )
 
 bool CGUITreeViewNode::moveChildDown( IGUITreeViewNode* child )
 {
+	if (Owner)
+		Owner->markDirty();
 	core::list<CGUITreeViewNode*>::Iterator	itChild;
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									nodeTmp;
@@ -435,6 +453,8 @@ bool CGUITreeViewNode::moveChildDown( IGUITreeViewNode* child )
 
 void CGUITreeViewNode::setExpanded( bool expanded )
 {
+	if (Owner)
+		Owner->markDirty();
 	Expanded = expanded;
 	if ( !expanded && Owner )
 	{
@@ -448,6 +468,8 @@ void CGUITreeViewNode::setExpanded( bool expanded )
 
 void CGUITreeViewNode::setSelected( bool selected )
 {
+	if (Owner)
+		Owner->markDirty();
 	if( Owner )
 	{
 		if( selected )
@@ -604,6 +626,7 @@ CGUITreeView::~CGUITreeView()
 //! Sets another skin independent font.
 void CGUITreeView::setOverrideFont(IGUIFont* font)
 {
+	markDirty();
 	if (OverrideFont == font)
 		return;
 
@@ -1227,6 +1250,10 @@ void CGUITreeView::draw()
 		NodeIteratorStack.push_back(Root->Children.begin());
 	while( !NodeIteratorStack.empty() )
 	{
+		// all other nodes are below the visible area
+		if ( frameRect.UpperLeftCorner.Y > AbsoluteRect.LowerRightCorner.Y )
+			break;
+
 		CGUITreeViewNode* node = *NodeIteratorStack.getLast();
 
 		const bool isSelected = node == getSelected();
@@ -1415,6 +1442,7 @@ void CGUITreeView::draw()
 //! Irrlicht engine as icon font, the icon strings defined in GUIIcons.h can be used.
 void CGUITreeView::setIconFont( IGUIFont* font )
 {
+	markDirty();
 	s32	height;
 
 	if ( font )
@@ -1439,6 +1467,7 @@ void CGUITreeView::setIconFont( IGUIFont* font )
 //! The default is 0 (no images).
 void CGUITreeView::setImageList( IGUIImageList* imageList )
 {
+	markDirty();
 	if (imageList )
 		imageList->grab();
 	if( ImageList )
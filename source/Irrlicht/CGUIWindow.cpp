@@ -308,6 +308,7 @@ void CGUIWindow::setDraggable(bool draggable)
 //! Set if the window background will be drawn
 void CGUIWindow::setDrawBackground(bool draw)
 {
+	markDirty();
 	DrawBackground = draw;
 }
 
@@ -322,6 +323,7 @@ bool CGUIWindow::getDrawBackground() const
 //! Set if the window titlebar will be drawn
 void CGUIWindow::setDrawTitlebar(bool draw)
 {
+	markDirty();
 	DrawTitlebar = draw;
 }
 
@@ -7,6 +7,7 @@
 #include "CBlit.h"
 #include "os.h"
 #include "SoftwareDriver2_helper.h"
+#include "matrix4.h"
 
 namespace irr
 {
@@ -223,6 +224,27 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 	//     Similar for y.
 	// As scaling is done without any antialiasing it doesn't matter too much which outermost pixels we use and keeping
 	// border pixels intact is probably mostly better (with AA the other solution would be more correct).
+	const CColorConverter::tConvertFunc convert = CColorConverter::getConvertFunc(Format, format);
+	if (!convert)
+	{
+		os::Printer::log("IImage::copyToScaling can't convert between the color formats.", ELL_WARNING);
+		return;
+	}
+
+	// same size: convert whole scanlines
+	if (Size.Width==width && Size.Height==height)
+	{
+		u8* tgtpos = (u8*) target;
+		const u8* srcpos = Data;
+		for (u32 y=0; y<height; ++y)
+		{
+			convert(srcpos, width, tgtpos);
+			tgtpos += pitch;
+			srcpos += Pitch;
+		}
+		return;
+	}
+
 	const f32 sourceXStep = width > 1 ? (f32)(Size.Width-1) / (f32)(width-1) : 0.f;
 	const f32 sourceYStep = height > 1 ? (f32)(Size.Height-1) / (f32)(height-1) : 0.f;
 	s32 yval=0, syval=0;
@@ -232,7 +254,7 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 		f32 sx = 0.5f;	// for rounding to nearest pixel
 		for (u32 x=0; x<width; ++x)
 		{
-			CColorConverter::convert_viaFormat(Data+ syval + ((s32)sx)*BytesPerPixel, Format, 1, ((u8*)target)+ yval + (x*bpp), format);
+			convert(Data+ syval + ((s32)sx)*BytesPerPixel, 1, ((u8*)target)+ yval + (x*bpp));
 			sx+=sourceXStep;
 		}
 		sy+=sourceYStep;
@@ -303,6 +325,255 @@ void CImage::copyToScalingBoxFilter(IImage* target, s32 bias, bool blend)
 }
 
 
+namespace
+{
+
+//! Half width of the filter kernels in pixels
+f32 resampleSupport(E_RESAMPLE_FILTER filter)
+{
+	switch (filter)
+	{
+		case ERF_BOX: return 0.5f;
+		case ERF_BILINEAR: return 1.f;
+		case ERF_BICUBIC: return 2.f;
+		case ERF_LANCZOS3: return 3.f;
+	}
+	return 1.f;
+}
+
+f32 resampleKernel(E_RESAMPLE_FILTER filter, f32 x)
+{
+	x = core::abs_(x);
+	switch (filter)
+	{
+		case ERF_BOX:
+			return x < 0.5f ? 1.f : 0.f;
+		case ERF_BILINEAR:
+			return x < 1.f ? 1.f - x : 0.f;
+		case ERF_BICUBIC:
+			// Catmull-Rom
+			if (x < 1.f)
+				return (1.5f * x - 2.5f) * x * x + 1.f;
+			if (x < 2.f)
+				return ((-0.5f * x + 2.5f) * x - 4.f) * x + 2.f;
+			return 0.f;
+		case ERF_LANCZOS3:
+			if (x < 0.00001f)
+				return 1.f;
+			if (x < 3.f)
+			{
+				const f32 px = core::PI * x;
+				return 3.f * sinf(px) * sinf(px / 3.f) / (px * px);
+			}
+			return 0.f;
+	}
+	return 0.f;
+}
+
+//! Source pixels and weights contributing to each pixel of one axis
+struct SResampleAxis
+{
+	core::array<u32> Index;
+	core::array<f32> Weight;
+
+	//! Entries of destination pixel i are [First[i], First[i+1])
+	core::array<u32> First;
+
+	//! Maximal range of source pixels used by one destination pixel
+	u32 MaxRange;
+
+	SResampleAxis(u32 srcSize, u32 dstSize, E_RESAMPLE_FILTER filter) : MaxRange(1)
+	{
+		const f32 scale = (f32)dstSize / (f32)srcSize;
+
+		// widen the filter for downscaling
+		const f32 filterScale = scale < 1.f ? 1.f / scale : 1.f;
+		const f32 support = resampleSupport(filter) * filterScale;
+
+		First.reallocate(dstSize + 1);
+		First.push_back(0);
+		for (u32 d = 0; d < dstSize; ++d)
+		{
+			const f32 center = ((f32)d + 0.5f) / scale;
+			const s32 left = core::floor32(center - support);
+			const s32 right = core::ceil32(center + support);
+
+			const u32 first = Index.size();
+			f32 sum = 0.f;
+			u32 lowest = srcSize;
+			u32 highest = 0;
+			for (s32 j = left; j <= right; ++j)
+			{
+				const f32 w = resampleKernel(filter, ((f32)j + 0.5f - center) / filterScale);
+				if (w == 0.f)
+					continue;
+
+				const u32 index = (u32)core::s32_clamp(j, 0, (s32)srcSize - 1);
+				Index.push_back(index);
+				Weight.push_back(w);
+				sum += w;
+				lowest = core::min_(lowest, index);
+				highest = core::max_(highest, index);
+			}
+
+			if (sum == 0.f)
+			{
+				// can't happen with the filters above, but stay safe
+				Index.set_used(first);
+				Weight.set_used(first);
+				lowest = highest = (u32)core::s32_clamp(core::floor32(center), 0, (s32)srcSize - 1);
+				Index.push_back(lowest);
+				Weight.push_back(1.f);
+				sum = 1.f;
+			}
+
+			const f32 invSum = 1.f / sum;
+			for (u32 i = first; i < Index.size(); ++i)
+				Weight[i] *= invSum;
+
+			MaxRange = core::max_(MaxRange, highest - lowest + 1);
+			First.push_back(Index.size());
+		}
+	}
+};
+
+} // end anonymous namespace
+
+
+//! copies this surface into another, resampling it with a separable filter
+void CImage::copyToScalingFiltered(IImage* target, E_RESAMPLE_FILTER filter)
+{
+	if (IImage::isCompressedFormat(Format))
+	{
+		os::Printer::log("IImage::copyToScalingFiltered method doesn't work with compressed images.", ELL_WARNING);
+		return;
+	}
+
+	if (!target || !target->getData() || !Size.Width || !Size.Height)
+		return;
+
+	const CColorConverter::tConvertFunc readRow = CColorConverter::getConvertFunc(Format, ECF_A8R8G8B8);
+	const CColorConverter::tConvertFunc writeRow = CColorConverter::getConvertFunc(ECF_A8R8G8B8, target->getColorFormat());
+	if (!readRow || !writeRow)
+	{
+		os::Printer::log("IImage::copyToScalingFiltered can't convert between the color formats.", ELL_WARNING);
+		return;
+	}
+
+	const core::dimension2du& destSize = target->getDimension();
+	if (!destSize.Width || !destSize.Height)
+		return;
+
+	const SResampleAxis axisX(Size.Width, destSize.Width, filter);
+	const SResampleAxis axisY(Size.Height, destSize.Height, filter);
+
+	// Horizontally filtered source rows, premultiplied alpha, 4 floats per pixel.
+	// The rows used for a destination row are a window moving down the image,
+	// so a ring buffer of the window size keeps each source row filtered only once.
+	const u32 ringSize = axisY.MaxRange;
+	const u32 rowFloats = destSize.Width * 4;
+	core::array<f32> ring;
+	ring.set_used(ringSize * rowFloats);
+	core::array<s32> ringRow;
+	ringRow.set_used(ringSize);
+	for (u32 i = 0; i < ringSize; ++i)
+		ringRow[i] = -1;
+
+	core::array<u32> sourceRow;
+	sourceRow.set_used(Size.Width);
+	core::array<f32> premultiplied;
+	premultiplied.set_used(Size.Width * 4);
+	core::array<f32> sum;
+	sum.set_used(rowFloats);
+	core::array<u32> destRow;
+	destRow.set_used(destSize.Width);
+
+	u8* destData = (u8*)target->getData();
+	const u32 destPitch = target->getPitch();
+
+	for (u32 dy = 0; dy < destSize.Height; ++dy)
+	{
+		for (u32 i = 0; i < rowFloats; ++i)
+			sum[i] = 0.f;
+
+		for (u32 k = axisY.First[dy]; k < axisY.First[dy + 1]; ++k)
+		{
+			const u32 sy = axisY.Index[k];
+			f32* filtered = &ring[(sy % ringSize) * rowFloats];
+			if (ringRow[sy % ringSize] != (s32)sy)
+			{
+				ringRow[sy % ringSize] = (s32)sy;
+
+				readRow(Data + sy * Pitch, Size.Width, sourceRow.pointer());
+				for (u32 x = 0; x < Size.Width; ++x)
+				{
+					const u32 c = sourceRow[x];
+					const f32 alpha = (f32)(c >> 24);
+					const f32 scale = alpha * (1.f / 255.f);
+					premultiplied[x * 4 + 0] = (f32)((c >> 16) & 0xFF) * scale;
+					premultiplied[x * 4 + 1] = (f32)((c >> 8) & 0xFF) * scale;
+					premultiplied[x * 4 + 2] = (f32)(c & 0xFF) * scale;
+					premultiplied[x * 4 + 3] = alpha;
+				}
+
+				for (u32 dx = 0; dx < destSize.Width; ++dx)
+				{
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+					// the 4 channels of a pixel are one vector
+					core::simd::f32x4 acc = core::simd::splat(0.f);
+					for (u32 i = axisX.First[dx]; i < axisX.First[dx + 1]; ++i)
+						acc = core::simd::add(acc, core::simd::mul(core::simd::load(&premultiplied[axisX.Index[i] * 4]), core::simd::splat(axisX.Weight[i])));
+					core::simd::store(&filtered[dx * 4], acc);
+#else
+					f32 r = 0.f, g = 0.f, b = 0.f, a = 0.f;
+					for (u32 i = axisX.First[dx]; i < axisX.First[dx + 1]; ++i)
+					{
+						const f32* p = &premultiplied[axisX.Index[i] * 4];
+						const f32 w = axisX.Weight[i];
+						r += p[0] * w;
+						g += p[1] * w;
+						b += p[2] * w;
+						a += p[3] * w;
+					}
+					filtered[dx * 4 + 0] = r;
+					filtered[dx * 4 + 1] = g;
+					filtered[dx * 4 + 2] = b;
+					filtered[dx * 4 + 3] = a;
+#endif
+				}
+			}
+
+			const f32 w = axisY.Weight[k];
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+			const core::simd::f32x4 weight = core::simd::splat(w);
+			for (u32 i = 0; i < rowFloats; i += 4)
+				core::simd::store(&sum[i], core::simd::add(core::simd::load(&sum[i]), core::simd::mul(core::simd::load(&filtered[i]), weight)));
+#else
+			for (u32 i = 0; i < rowFloats; ++i)
+				sum[i] += filtered[i] * w;
+#endif
+		}
+
+		for (u32 dx = 0; dx < destSize.Width; ++dx)
+		{
+			const f32* p = &sum[dx * 4];
+			const s32 a = core::s32_clamp(core::round32(p[3]), 0, 255);
+			if (0 == a)
+			{
+				destRow[dx] = 0;
+				continue;
+			}
+			const f32 unpremultiply = 255.f / p[3];
+			destRow[dx] = (u32)a << 24 |
+				(u32)core::s32_clamp(core::round32(p[0] * unpremultiply), 0, 255) << 16 |
+				(u32)core::s32_clamp(core::round32(p[1] * unpremultiply), 0, 255) << 8 |
+				(u32)core::s32_clamp(core::round32(p[2] * unpremultiply), 0, 255);
+		}
+		writeRow(destRow.const_pointer(), destSize.Width, destData + dy * destPitch);
+	}
+}
+
+
 //! fills the surface with given color
 void CImage::fill(const SColor &color)
 {
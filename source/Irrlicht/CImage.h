@@ -58,6 +58,9 @@ public:
 	//! copies this surface into another, scaling it to fit, applying a box filter
 	virtual void copyToScalingBoxFilter(IImage* target, s32 bias = 0, bool blend = false) IRR_OVERRIDE;
 
+	//! copies this surface into another, resampling it with a separable filter
+	virtual void copyToScalingFiltered(IImage* target, E_RESAMPLE_FILTER filter = ERF_BILINEAR) IRR_OVERRIDE;
+
 	//! Flips (mirrors) the image in one or two directions
 	virtual void flip(bool topBottom, bool leftRight) IRR_OVERRIDE;
 
@@ -74,7 +74,7 @@ bool CImageWriterBMP::writeImage(io::IWriteFile* file, IImage* image, u32 param)
 		break;
 	case ECF_A1R5G5B5:
 		CColorConverter_convertFORMATtoFORMAT
-			= CColorConverter::convert_A1R5G5B5toR8G8B8;
+			= CColorConverter::convert_A1R5G5B5toB8G8R8;
 		break;
 	case ECF_R5G6B5:
 		CColorConverter_convertFORMATtoFORMAT
@@ -116,7 +116,7 @@ static bool writeJPEGFile(io::IWriteFile* file, IImage* image, u32 quality)
 			format = CColorConverter::convert_A8R8G8B8toR8G8B8;
 			break;
 		case ECF_A1R5G5B5:
-			format = CColorConverter::convert_A1R5G5B5toB8G8R8;
+			format = CColorConverter::convert_A1R5G5B5toR8G8B8;
 			break;
 		case ECF_R5G6B5:
 			format = CColorConverter::convert_R5G6B5toR8G8B8;
@@ -0,0 +1,342 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CInstancedMeshSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CInstancedMeshSceneNode::CInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& rotation,
+			const core::vector3df& scale)
+	: IInstancedMeshSceneNode(parent, mgr, id, position, rotation, scale),
+	Mesh(0), ColoredCount(0), BoxDirty(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CInstancedMeshSceneNode");
+	#endif
+
+	setMesh(mesh);
+}
+
+
+//! destructor
+CInstancedMeshSceneNode::~CInstancedMeshSceneNode()
+{
+	if (Mesh)
+		Mesh->drop();
+}
+
+
+//! culls the instances and registers the node for the passes of its materials
+void CInstancedMeshSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Mesh)
+	{
+		// in case the mesh was modified
+		if (Mesh->getBoundingBox() != MeshBox)
+			updateInstanceBoxes();
+
+		cullInstances();
+
+		if (!VisibleTransforms.empty())
+		{
+			video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+			u32 transparentCount = 0;
+			u32 solidCount = 0;
+			for (u32 i=0; i<Materials.size(); ++i)
+			{
+				if (driver->needsTransparentRenderPass(Materials[i]))
+					++transparentCount;
+				else
+					++solidCount;
+			}
+
+			if (solidCount)
+				SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+
+			if (transparentCount)
+				SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+
+			if (DebugDataVisible)
+				SceneManager->registerNodeForRendering(this, ESNRP_SHADOW);
+		}
+
+		ISceneNode::OnRegisterSceneNode();
+	}
+}
+
+
+//! renders the node.
+void CInstancedMeshSceneNode::render()
+{
+	if (!Mesh || VisibleTransforms.empty())
+		return;
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	const E_SCENE_NODE_RENDER_PASS renderPass = SceneManager->getSceneNodeRenderPass();
+
+	if (renderPass == ESNRP_SHADOW)
+	{
+		// for debug purposes only
+		driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+		video::SMaterial m;
+		m.Lighting = false;
+		m.AntiAliasing = 0;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & EDS_BBOX)
+			driver->draw3DBox(getBoundingBox(), video::SColor(255,255,255,255));
+
+		if (DebugDataVisible & EDS_BBOX_BUFFERS)
+		{
+			for (u32 i=0; i<Boxes.size(); ++i)
+				driver->draw3DBox(Boxes[i], video::SColor(255,190,128,128));
+		}
+		return;
+	}
+
+	const video::SColor* colors = ColoredCount ? VisibleColors.const_pointer() : 0;
+	const u32 count = core::min_(Materials.size(), Mesh->getMeshBufferCount());
+	for (u32 i=0; i<count; ++i)
+	{
+		// only the buffers of the current pass, all without a scene manager pass
+		const bool transparent = driver->needsTransparentRenderPass(Materials[i]);
+		if ((transparent && renderPass == ESNRP_SOLID) ||
+			(!transparent && renderPass == ESNRP_TRANSPARENT))
+			continue;
+
+		driver->setMaterial(Materials[i]);
+		driver->drawMeshBufferInstanced(Mesh->getMeshBuffer(i),
+			VisibleTransforms.const_pointer(), VisibleTransforms.size(), colors);
+	}
+}
+
+
+//! returns the axis aligned bounding box of all instances
+const core::aabbox3d<f32>& CInstancedMeshSceneNode::getBoundingBox() const
+{
+	if (BoxDirty)
+		updateBox();
+	return Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CInstancedMeshSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CInstancedMeshSceneNode::getMaterialCount() const
+{
+	return Materials.size();
+}
+
+
+//! Sets the mesh drawn for each instance
+void CInstancedMeshSceneNode::setMesh(IMesh* mesh)
+{
+	if (mesh)
+		mesh->grab();
+	if (Mesh)
+		Mesh->drop();
+	Mesh = mesh;
+
+	Materials.clear();
+	if (!Mesh)
+		return;
+
+	Materials.reallocate(Mesh->getMeshBufferCount());
+	for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+		Materials.push_back(mb ? mb->getMaterial() : video::SMaterial());
+	}
+
+	updateInstanceBoxes();
+}
+
+
+//! Adds an instance
+u32 CInstancedMeshSceneNode::addInstance(const core::matrix4& transform, video::SColor color)
+{
+	core::aabbox3d<f32> box(MeshBox);
+	transform.transformBoxEx(box);
+
+	// the box of the node only grows, no need to merge all boxes again
+	if (!BoxDirty)
+	{
+		if (Boxes.empty())
+			Box = box;
+		else
+			Box.addInternalBox(box);
+	}
+
+	Transforms.push_back(transform);
+	Colors.push_back(color);
+	Boxes.push_back(box);
+	if (color.color != 0xffffffff)
+		++ColoredCount;
+
+	return Transforms.size()-1;
+}
+
+
+//! Removes an instance
+void CInstancedMeshSceneNode::removeInstance(u32 index)
+{
+	if (index >= Transforms.size())
+		return;
+
+	if (Colors[index].color != 0xffffffff)
+		--ColoredCount;
+
+	// move the last instance into the gap
+	const u32 last = Transforms.size()-1;
+	if (index != last)
+	{
+		Transforms[index] = Transforms[last];
+		Colors[index] = Colors[last];
+		Boxes[index] = Boxes[last];
+	}
+	Transforms.erase(last);
+	Colors.erase(last);
+	Boxes.erase(last);
+
+	BoxDirty = true;
+}
+
+
+//! Removes all instances
+void CInstancedMeshSceneNode::removeAllInstances()
+{
+	Transforms.clear();
+	Colors.clear();
+	Boxes.clear();
+	VisibleTransforms.clear();
+	VisibleColors.clear();
+	ColoredCount = 0;
+	BoxDirty = true;
+}
+
+
+//! Sets the transformation of an instance relative to the node
+void CInstancedMeshSceneNode::setInstanceTransform(u32 index, const core::matrix4& transform)
+{
+	if (index >= Transforms.size())
+		return;
+
+	Transforms[index] = transform;
+	Boxes[index] = MeshBox;
+	transform.transformBoxEx(Boxes[index]);
+	BoxDirty = true;
+}
+
+
+//! Sets the color of an instance
+void CInstancedMeshSceneNode::setInstanceColor(u32 index, video::SColor color)
+{
+	if (index >= Colors.size())
+		return;
+
+	if (Colors[index].color != 0xffffffff)
+		--ColoredCount;
+	if (color.color != 0xffffffff)
+		++ColoredCount;
+	Colors[index] = color;
+}
+
+
+//! Transforms the box of the mesh into the boxes of the instances
+void CInstancedMeshSceneNode::updateInstanceBoxes()
+{
+	MeshBox = Mesh ? Mesh->getBoundingBox() : core::aabbox3d<f32>(core::vector3df(0.f, 0.f, 0.f));
+	for (u32 i=0; i<Transforms.size(); ++i)
+	{
+		Boxes[i] = MeshBox;
+		Transforms[i].transformBoxEx(Boxes[i]);
+	}
+	BoxDirty = true;
+}
+
+
+//! Merges the instance boxes into the box of the node
+void CInstancedMeshSceneNode::updateBox() const
+{
+	if (Boxes.empty())
+		Box.reset(0.f, 0.f, 0.f);
+	else
+	{
+		Box = Boxes[0];
+		for (u32 i=1; i<Boxes.size(); ++i)
+			Box.addInternalBox(Boxes[i]);
+	}
+	BoxDirty = false;
+}
+
+
+//! Collects the absolute transformations and colors of the instances in the view frustum
+void CInstancedMeshSceneNode::cullInstances()
+{
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	const bool cull = camera && AutomaticCullingState != EAC_OFF;
+
+	// the frustum in the space of the node, the instance boxes are in that space
+	SViewFrustum frustum;
+	if (cull)
+	{
+		frustum = *camera->getViewFrustum();
+		frustum.transform(core::matrix4(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE));
+	}
+
+	const bool identity = AbsoluteTransformation.isIdentity();
+	VisibleTransforms.set_used(Transforms.size());
+	VisibleColors.set_used(ColoredCount ? Colors.size() : 0);
+
+	u32 visible = 0;
+	for (u32 i=0; i<Transforms.size(); ++i)
+	{
+		if (cull)
+		{
+			const core::aabbox3d<f32>& box = Boxes[i];
+			u32 p = 0;
+			for (; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+			{
+				if (box.classifyPlaneRelation(frustum.planes[p]) == core::ISREL3D_FRONT)
+					break;
+			}
+			if (p != SViewFrustum::VF_PLANE_COUNT)
+				continue;
+		}
+
+		if (identity)
+			VisibleTransforms[visible] = Transforms[i];
+		else
+			VisibleTransforms[visible].setbyproduct_nocheck(AbsoluteTransformation, Transforms[i]);
+		if (ColoredCount)
+			VisibleColors[visible] = Colors[i];
+		++visible;
+	}
+
+	VisibleTransforms.set_used(visible);
+	VisibleColors.set_used(ColoredCount ? visible : 0);
+}
+
+
+} // end namespace scene
+} // end namespace irr
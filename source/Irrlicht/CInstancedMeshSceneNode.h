@@ -0,0 +1,113 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_C_INSTANCED_MESH_SCENE_NODE_H_INCLUDED
+#define IRR_C_INSTANCED_MESH_SCENE_NODE_H_INCLUDED
+
+#include "IInstancedMeshSceneNode.h"
+#include "IMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	class CInstancedMeshSceneNode : public IInstancedMeshSceneNode
+	{
+	public:
+
+		//! constructor
+		CInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+		//! destructor
+		virtual ~CInstancedMeshSceneNode();
+
+		//! culls the instances and registers the node for the passes of its materials
+		virtual void OnRegisterSceneNode() IRR_OVERRIDE;
+
+		//! renders the node.
+		virtual void render() IRR_OVERRIDE;
+
+		//! returns the axis aligned bounding box of all instances
+		virtual const core::aabbox3d<f32>& getBoundingBox() const IRR_OVERRIDE;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) IRR_OVERRIDE;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const IRR_OVERRIDE;
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const IRR_OVERRIDE { return ESNT_INSTANCED_MESH; }
+
+		//! Sets the mesh drawn for each instance
+		virtual void setMesh(IMesh* mesh) IRR_OVERRIDE;
+
+		//! Returns the mesh drawn for each instance
+		virtual IMesh* getMesh() IRR_OVERRIDE { return Mesh; }
+
+		//! Adds an instance
+		virtual u32 addInstance(const core::matrix4& transform, video::SColor color) IRR_OVERRIDE;
+
+		//! Removes an instance
+		virtual void removeInstance(u32 index) IRR_OVERRIDE;
+
+		//! Removes all instances
+		virtual void removeAllInstances() IRR_OVERRIDE;
+
+		//! Returns the number of instances
+		virtual u32 getInstanceCount() const IRR_OVERRIDE { return Transforms.size(); }
+
+		//! Sets the transformation of an instance relative to the node
+		virtual void setInstanceTransform(u32 index, const core::matrix4& transform) IRR_OVERRIDE;
+
+		//! Returns the transformation of an instance relative to the node
+		virtual const core::matrix4& getInstanceTransform(u32 index) const IRR_OVERRIDE { return Transforms[index]; }
+
+		//! Sets the color of an instance
+		virtual void setInstanceColor(u32 index, video::SColor color) IRR_OVERRIDE;
+
+		//! Returns the color of an instance
+		virtual video::SColor getInstanceColor(u32 index) const IRR_OVERRIDE { return Colors[index]; }
+
+		//! Returns the number of instances which were not culled when the node was drawn last
+		virtual u32 getVisibleInstanceCount() const IRR_OVERRIDE { return VisibleTransforms.size(); }
+
+	private:
+
+		//! Transforms the box of the mesh into the boxes of the instances
+		void updateInstanceBoxes();
+
+		//! Merges the instance boxes into the box of the node
+		void updateBox() const;
+
+		//! Collects the absolute transformations and colors of the instances in the view frustum
+		void cullInstances();
+
+		IMesh* Mesh;
+		core::array<video::SMaterial> Materials;
+
+		//! Instances, kept packed in separate arrays for culling and drawing
+		core::array<core::matrix4> Transforms;
+		core::array<video::SColor> Colors;
+		core::array<core::aabbox3d<f32> > Boxes;
+
+		//! Number of instances with a color other than white
+		u32 ColoredCount;
+
+		//! Instances drawn in this frame
+		core::array<core::matrix4> VisibleTransforms;
+		core::array<video::SColor> VisibleColors;
+
+		core::aabbox3d<f32> MeshBox;
+		mutable core::aabbox3d<f32> Box;
+		mutable bool BoxDirty;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -0,0 +1,166 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_C_INTERPOLATED_MESH_CACHE_H_INCLUDED
+#define IRR_C_INTERPOLATED_MESH_CACHE_H_INCLUDED
+
+#include "SMesh.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Least recently used cache of interpolated frames of a vertex animated mesh
+	/** Scene nodes sharing an animated mesh often show the same frame, they
+	get the same cached mesh then, so the vertices are interpolated once and
+	not once per node. Frames are identified by the two key frames and the
+	blend between them in the fixed point resolution of the animated mesh.
+	The meshes are created empty and filled by the animated mesh. */
+	class CInterpolatedMeshCache
+	{
+	public:
+
+		//! constructor
+		/** \param size Maximal number of cached frames. */
+		CInterpolatedMeshCache(u32 size=8)
+			: Size(size), Time(0)
+		{
+		}
+
+		//! destructor
+		~CInterpolatedMeshCache()
+		{
+			clear();
+		}
+
+		//! Finds the mesh for a frame
+		/** \param first First key frame.
+		\param second Second key frame.
+		\param blend Blend between the key frames in fixed point.
+		\param version Version of the static vertex data, cached meshes of
+		other versions have to be filled again.
+		\param outMesh Receives the mesh. Replaced meshes keep their buffers.
+		\param outNew Set to true when the static vertex data has to be
+		copied into the mesh, because it is new or has another version.
+		\return True when the mesh has to be interpolated. */
+		bool get(s32 first, s32 second, s32 blend, u32 version, SMesh*& outMesh, bool& outNew)
+		{
+			++Time;
+
+			u32 oldest = 0;
+			for (u32 i=0; i<Entries.size(); ++i)
+			{
+				SEntry& e = Entries[i];
+				if (e.First == first && e.Second == second && e.Blend == blend)
+				{
+					e.LastUsed = Time;
+					outMesh = e.Mesh;
+					outNew = e.Version != version;
+					e.Version = version;
+					return outNew;
+				}
+				if (e.LastUsed < Entries[oldest].LastUsed)
+					oldest = i;
+			}
+
+			if (Entries.size() < Size)
+			{
+				SEntry e;
+				e.Mesh = new SMesh();
+				e.Version = version;
+				oldest = Entries.size();
+				Entries.push_back(e);
+				outNew = true;
+			}
+			else
+			{
+				outNew = Entries[oldest].Version != version;
+			}
+
+			SEntry& e = Entries[oldest];
+			e.First = first;
+			e.Second = second;
+			e.Blend = blend;
+			e.Version = version;
+			e.LastUsed = Time;
+			outMesh = e.Mesh;
+			return true;
+		}
+
+		//! Returns the number of cached meshes
+		u32 getMeshCount() const
+		{
+			return Entries.size();
+		}
+
+		//! Returns a cached mesh
+		SMesh* getMesh(u32 index) const
+		{
+			return Entries[index].Mesh;
+		}
+
+		//! Forgets the frames of all cached meshes
+		/** The meshes stay alive, so meshes returned before are still
+		valid. They are filled again when they are reused. */
+		void invalidate()
+		{
+			for (u32 i=0; i<Entries.size(); ++i)
+			{
+				Entries[i].First = -1;
+				Entries[i].Second = -1;
+				Entries[i].LastUsed = 0;
+			}
+		}
+
+		//! Drops all cached meshes
+		void clear()
+		{
+			for (u32 i=0; i<Entries.size(); ++i)
+				Entries[i].Mesh->drop();
+			Entries.clear();
+		}
+
+		//! Sets a material flag in all cached meshes
+		void setMaterialFlag(video::E_MATERIAL_FLAG flag, bool newvalue)
+		{
+			for (u32 i=0; i<Entries.size(); ++i)
+				Entries[i].Mesh->setMaterialFlag(flag, newvalue);
+		}
+
+		//! Sets the hardware mapping hint of all cached meshes
+		void setHardwareMappingHint(E_HARDWARE_MAPPING newMappingHint, E_BUFFER_TYPE buffer)
+		{
+			for (u32 i=0; i<Entries.size(); ++i)
+				Entries[i].Mesh->setHardwareMappingHint(newMappingHint, buffer);
+		}
+
+		//! Flags all cached meshes as changed
+		void setDirty(E_BUFFER_TYPE buffer)
+		{
+			for (u32 i=0; i<Entries.size(); ++i)
+				Entries[i].Mesh->setDirty(buffer);
+		}
+
+	private:
+
+		struct SEntry
+		{
+			SMesh* Mesh;
+			s32 First;
+			s32 Second;
+			s32 Blend;
+			u32 Version;
+			u32 LastUsed;
+		};
+
+		core::array<SEntry> Entries;
+		u32 Size;
+		u32 Time;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -0,0 +1,415 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+
+#include "CIrrBinaryMeshFileLoader.h"
+#include "SIrrBinaryMesh.h"
+#include "CMeshTextureLoader.h"
+#include "CDynamicMeshBuffer.h"
+#include "ISkinnedMesh.h"
+#include "IVideoDriver.h"
+#include "IReadFile.h"
+#include "SMesh.h"
+#include "SAnimatedMesh.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+core::aabbox3df readBox(const f32* in)
+{
+	return core::aabbox3df(in[0], in[1], in[2], in[3], in[4], in[5]);
+}
+
+u32 padded(u32 size)
+{
+	return (size + 3) & ~3u;
+}
+
+//! corrupt counts must not cause huge allocations, so check them against the file size first
+bool fitsInFile(io::IReadFile* file, u64 bytes)
+{
+	const long remaining = file->getSize() - file->getPos();
+	return remaining >= 0 && bytes <= (u64)remaining;
+}
+
+} // end anonymous namespace
+
+
+//! Constructor
+CIrrBinaryMeshFileLoader::CIrrBinaryMeshFileLoader(ISceneManager* smgr)
+: SceneManager(smgr)
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrBinaryMeshFileLoader");
+	#endif
+
+	TextureLoader = new CMeshTextureLoader( SceneManager->getFileSystem(), SceneManager->getVideoDriver() );
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".irrbm")
+bool CIrrBinaryMeshFileLoader::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension ( filename, "irrbm" );
+}
+
+
+//! creates/loads an animated mesh from the file.
+//! \return Pointer to the created mesh. Returns 0 if loading failed.
+//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+//! See IReferenceCounted::drop() for more information.
+IAnimatedMesh* CIrrBinaryMeshFileLoader::createMesh(io::IReadFile* file)
+{
+	if (!file)
+		return 0;
+#ifdef __BIG_ENDIAN__
+	os::Printer::log("Binary mesh import does not support big-endian systems.", ELL_ERROR);
+	return 0;
+#endif
+
+	SIrrBMHeader header;
+	if (file->read(&header, sizeof(header)) != sizeof(header) ||
+		header.Magic != IRRBM_MAGIC)
+	{
+		os::Printer::log("Not a binary mesh file", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+	if (header.Version != IRRBM_VERSION)
+	{
+		os::Printer::log("Unsupported binary mesh version", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	if ( getMeshTextureLoader() )
+		getMeshTextureLoader()->setMeshFile(file);
+
+	core::array<io::path> textureNames;
+	textureNames.reallocate(header.TextureCount);
+	core::stringc name;
+	for (u32 i=0; i<header.TextureCount; ++i)
+	{
+		if (!readString(file, name))
+			return 0;
+		textureNames.push_back(name);
+	}
+
+	// the mesh is outdated when the files it was converted from changed
+	for (u32 i=0; i<header.DependencyCount; ++i)
+	{
+		SIrrBMDependency dependency;
+		if (!readString(file, name) || !readBlock(file, &dependency, 1, sizeof(dependency)))
+			return 0;
+
+		const SIrrBMDependency current = getIrrBMDependency(SceneManager->getFileSystem(), name);
+		if (current.Size != dependency.Size || current.Hash[0] != dependency.Hash[0] || current.Hash[1] != dependency.Hash[1])
+		{
+			os::Printer::log("Binary mesh is outdated, changed file", name, ELL_INFORMATION);
+			return 0;
+		}
+	}
+
+	core::array<video::ITexture*> textures;
+	textures.reallocate(header.TextureCount);
+	for (u32 i=0; i<textureNames.size(); ++i)
+	{
+		// the names are those the textures had when the mesh was written, so they are often loaded already
+		video::ITexture* texture = SceneManager->getVideoDriver()->findTexture(textureNames[i]);
+		if (!texture && getMeshTextureLoader())
+			texture = getMeshTextureLoader()->getTexture(textureNames[i]);
+		textures.push_back(texture);
+	}
+
+	ISkinnedMesh* skinned = 0;
+	SMesh* mesh = 0;
+	if (header.Flags & EIRRBM_SKINNED)
+	{
+		skinned = SceneManager->createSkinnedMesh();
+		if (!skinned)
+		{
+			os::Printer::log("Skinned meshes are not supported", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+	}
+	else
+		mesh = new SMesh();
+
+	bool ok = true;
+	for (u32 i=0; ok && i<header.BufferCount; ++i)
+	{
+		SIrrBMBuffer buffer;
+		if (!readBlock(file, &buffer, 1, sizeof(buffer)) ||
+			buffer.VertexType > video::EVT_TANGENTS || buffer.IndexType > video::EIT_32BIT)
+		{
+			ok = false;
+			break;
+		}
+
+		const video::E_VERTEX_TYPE vertexType = (video::E_VERTEX_TYPE)buffer.VertexType;
+		const video::E_INDEX_TYPE indexType = (video::E_INDEX_TYPE)buffer.IndexType;
+		const u32 vertexSize = video::getVertexPitchFromType(vertexType);
+		const u32 indexSize = (indexType == video::EIT_16BIT) ? 2 : 4;
+		if (!fitsInFile(file, (u64)buffer.VertexCount * vertexSize + (u64)buffer.IndexCount * indexSize))
+		{
+			ok = false;
+			break;
+		}
+
+		IMeshBuffer* mb;
+		void* vertices;
+		void* indices;
+		if (skinned)
+		{
+			// skinned meshbuffers only have 16 bit indices
+			if (indexType != video::EIT_16BIT)
+			{
+				ok = false;
+				break;
+			}
+
+			SSkinMeshBuffer* skinBuffer = skinned->addMeshBuffer();
+			skinBuffer->VertexType = vertexType;
+			switch (vertexType)
+			{
+				case video::EVT_2TCOORDS:
+					skinBuffer->Vertices_2TCoords.set_used(buffer.VertexCount);
+					break;
+				case video::EVT_TANGENTS:
+					skinBuffer->Vertices_Tangents.set_used(buffer.VertexCount);
+					break;
+				default:
+					skinBuffer->Vertices_Standard.set_used(buffer.VertexCount);
+					break;
+			}
+			skinBuffer->Indices.set_used(buffer.IndexCount);
+			mb = skinBuffer;
+			vertices = skinBuffer->getVertices();
+			indices = skinBuffer->getIndices();
+		}
+		else
+		{
+			CDynamicMeshBuffer* dynamicBuffer = new CDynamicMeshBuffer(vertexType, indexType);
+			mesh->addMeshBuffer(dynamicBuffer);
+			dynamicBuffer->drop();
+			dynamicBuffer->getVertexBuffer().set_used(buffer.VertexCount);
+			dynamicBuffer->getIndexBuffer().set_used(buffer.IndexCount);
+			mb = dynamicBuffer;
+			vertices = dynamicBuffer->getVertexBuffer().pointer();
+			indices = dynamicBuffer->getIndexBuffer().pointer();
+		}
+
+		mb->setPrimitiveType((E_PRIMITIVE_TYPE)buffer.PrimitiveType);
+		mb->setHardwareMappingHint((E_HARDWARE_MAPPING)buffer.MappingHintVertex, EBT_VERTEX);
+		mb->setHardwareMappingHint((E_HARDWARE_MAPPING)buffer.MappingHintIndex, EBT_INDEX);
+
+		// the vertex and index blocks are stored as the meshbuffers keep them in memory
+		ok = readMaterial(file, header.LayerCount, textures, mb->getMaterial()) &&
+			readBlock(file, vertices, buffer.VertexCount, vertexSize) &&
+			readBlock(file, indices, buffer.IndexCount, indexSize);
+		if (ok && ((buffer.IndexCount * indexSize) & 3))
+			file->seek(2, true);
+
+		mb->setBoundingBox(readBox(buffer.BoundingBox));
+	}
+
+	if (skinned)
+	{
+		core::array<ISkinnedMesh::SJoint*>& joints = skinned->getAllJoints();
+		for (u32 i=0; ok && i<header.JointCount; ++i)
+			skinned->addJoint(0);
+
+		for (u32 i=0; ok && i<header.JointCount; ++i)
+		{
+			ISkinnedMesh::SJoint* joint = joints[i];
+
+			SIrrBMJoint j;
+			if (!readBlock(file, &j, 1, sizeof(j)) ||
+				!fitsInFile(file, (u64)j.NameLength + ((u64)j.ChildCount + j.AttachedMeshCount) * 4 +
+					(u64)j.PositionKeyCount * sizeof(ISkinnedMesh::SPositionKey) +
+					(u64)j.ScaleKeyCount * sizeof(ISkinnedMesh::SScaleKey) +
+					(u64)j.RotationKeyCount * sizeof(ISkinnedMesh::SRotationKey)))
+			{
+				ok = false;
+				break;
+			}
+
+			core::array<c8> name;
+			name.set_used(padded(j.NameLength) + 1);
+			core::array<u32> children;
+			children.set_used(j.ChildCount);
+			joint->AttachedMeshes.set_used(j.AttachedMeshCount);
+			joint->PositionKeys.set_used(j.PositionKeyCount);
+			joint->ScaleKeys.set_used(j.ScaleKeyCount);
+			joint->RotationKeys.set_used(j.RotationKeyCount);
+			ok = readBlock(file, name.pointer(), padded(j.NameLength), 1) &&
+				readBlock(file, children.pointer(), j.ChildCount, 4) &&
+				readBlock(file, joint->AttachedMeshes.pointer(), j.AttachedMeshCount, 4) &&
+				readBlock(file, joint->PositionKeys.pointer(), j.PositionKeyCount, sizeof(ISkinnedMesh::SPositionKey)) &&
+				readBlock(file, joint->ScaleKeys.pointer(), j.ScaleKeyCount, sizeof(ISkinnedMesh::SScaleKey)) &&
+				readBlock(file, joint->RotationKeys.pointer(), j.RotationKeyCount, sizeof(ISkinnedMesh::SRotationKey));
+			if (!ok)
+				break;
+
+			name[j.NameLength] = 0;
+			joint->Name = name.const_pointer();
+			joint->LocalMatrix.setM(j.LocalMatrix);
+			joint->GlobalInversedMatrix.setM(j.GlobalInversedMatrix);
+
+			for (u32 k=0; k<j.ChildCount; ++k)
+			{
+				if (children[k] >= header.JointCount)
+				{
+					ok = false;
+					break;
+				}
+				joint->Children.push_back(joints[children[k]]);
+			}
+			for (u32 k=0; ok && k<j.AttachedMeshCount; ++k)
+				ok = joint->AttachedMeshes[k] < header.BufferCount;
+
+			for (u32 k=0; ok && k<j.WeightCount; ++k)
+			{
+				SIrrBMWeight w;
+				ok = readBlock(file, &w, 1, sizeof(w)) && w.Buffer < header.BufferCount &&
+					w.Vertex < skinned->getMeshBuffers()[w.Buffer]->getVertexCount();
+				if (ok)
+				{
+					ISkinnedMesh::SWeight* weight = skinned->addWeight(joint);
+					weight->buffer_id = (u16)w.Buffer;
+					weight->vertex_id = w.Vertex;
+					weight->strength = w.Strength;
+				}
+			}
+		}
+	}
+
+	if (!ok)
+	{
+		os::Printer::log("Binary mesh file is corrupt", file->getFileName(), ELL_ERROR);
+		if (skinned)
+			skinned->drop();
+		else
+			mesh->drop();
+		return 0;
+	}
+
+	if (skinned)
+	{
+		if (header.AnimationSpeed > 0.f)
+			skinned->setAnimationSpeed(header.AnimationSpeed);
+		skinned->finalize();
+		return skinned;
+	}
+
+	mesh->setBoundingBox(readBox(header.BoundingBox));
+	SAnimatedMesh* animatedMesh = new SAnimatedMesh(mesh, (E_ANIMATED_MESH_TYPE)header.MeshType);
+	mesh->drop();
+	return animatedMesh;
+}
+
+
+bool CIrrBinaryMeshFileLoader::readMaterial(io::IReadFile* file, u32 layerCount, const core::array<video::ITexture*>& textures, video::SMaterial& material)
+{
+	SIrrBMMaterial m;
+	if (!readBlock(file, &m, 1, sizeof(m)))
+		return false;
+
+	material.MaterialType = (video::E_MATERIAL_TYPE)m.MaterialType;
+	material.AmbientColor = m.AmbientColor;
+	material.DiffuseColor = m.DiffuseColor;
+	material.EmissiveColor = m.EmissiveColor;
+	material.SpecularColor = m.SpecularColor;
+	material.Shininess = m.Shininess;
+	material.MaterialTypeParam = m.MaterialTypeParam;
+	material.MaterialTypeParam2 = m.MaterialTypeParam2;
+	material.Thickness = m.Thickness;
+	material.AntiAliasing = (u8)m.AntiAliasing;
+	material.ZBuffer = (u8)m.ZBuffer;
+	material.ZWriteEnable = (video::E_ZWRITE)m.ZWriteEnable;
+	material.ColorMask = (u8)m.ColorMask;
+	material.ColorMaterial = (u8)m.ColorMaterial;
+	material.BlendOperation = (video::E_BLEND_OPERATION)m.BlendOperation;
+	material.BlendFactor = m.BlendFactor;
+	material.PolygonOffsetFactor = (u8)m.PolygonOffsetFactor;
+	material.PolygonOffsetDirection = (video::E_POLYGON_OFFSET)m.PolygonOffsetDirection;
+	material.PolygonOffsetDepthBias = m.PolygonOffsetDepthBias;
+	material.PolygonOffsetSlopeScale = m.PolygonOffsetSlopeScale;
+	material.Wireframe = (m.Flags & EIRRBM_WIREFRAME) != 0;
+	material.PointCloud = (m.Flags & EIRRBM_POINTCLOUD) != 0;
+	material.GouraudShading = (m.Flags & EIRRBM_GOURAUD_SHADING) != 0;
+	material.Lighting = (m.Flags & EIRRBM_LIGHTING) != 0;
+	material.BackfaceCulling = (m.Flags & EIRRBM_BACKFACE_CULLING) != 0;
+	material.FrontfaceCulling = (m.Flags & EIRRBM_FRONTFACE_CULLING) != 0;
+	material.FogEnable = (m.Flags & EIRRBM_FOG_ENABLE) != 0;
+	material.NormalizeNormals = (m.Flags & EIRRBM_NORMALIZE_NORMALS) != 0;
+	material.UseMipMaps = (m.Flags & EIRRBM_USE_MIPMAPS) != 0;
+
+	// files written with more texture layers than supported lose the additional ones
+	for (u32 i=0; i<layerCount; ++i)
+	{
+		SIrrBMMaterialLayer l;
+		if (!readBlock(file, &l, 1, sizeof(l)))
+			return false;
+		if (i >= video::MATERIAL_MAX_TEXTURES)
+			continue;
+
+		video::SMaterialLayer& layer = material.TextureLayer[i];
+		layer.Texture = (l.Texture >= 0 && l.Texture < (s32)textures.size()) ? textures[l.Texture] : 0;
+		layer.TextureWrapU = (u8)l.TextureWrapU;
+		layer.TextureWrapV = (u8)l.TextureWrapV;
+		layer.TextureWrapW = (u8)l.TextureWrapW;
+		layer.BilinearFilter = l.BilinearFilter != 0;
+		layer.TrilinearFilter = l.TrilinearFilter != 0;
+		layer.AnisotropicFilter = (u8)l.AnisotropicFilter;
+		layer.LODBias = (s8)l.LODBias;
+		if (l.TextureMatrixUsed)
+		{
+			core::matrix4 matrix;
+			matrix.setM(l.TextureMatrix);
+			layer.setTextureMatrix(matrix);
+		}
+	}
+	return true;
+}
+
+
+bool CIrrBinaryMeshFileLoader::readString(io::IReadFile* file, core::stringc& str)
+{
+	u32 length;
+	if (!readBlock(file, &length, 1, 4) || !fitsInFile(file, length))
+		return false;
+
+	core::array<c8> characters;
+	characters.set_used(padded(length) + 1);
+	if (!readBlock(file, characters.pointer(), padded(length), 1))
+		return false;
+	characters[length] = 0;
+	str = characters.const_pointer();
+	return true;
+}
+
+
+bool CIrrBinaryMeshFileLoader::readBlock(io::IReadFile* file, void* data, u32 count, u32 size)
+{
+	if (!count)
+		return true;
+
+	if (!fitsInFile(file, (u64)count * size))
+		return false;
+
+	return file->read(data, (size_t)count * size) == (size_t)count * size;
+}
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
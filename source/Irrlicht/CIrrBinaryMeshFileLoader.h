@@ -0,0 +1,55 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_C_IRR_BINARY_MESH_FILE_LOADER_H_INCLUDED
+#define IRR_C_IRR_BINARY_MESH_FILE_LOADER_H_INCLUDED
+
+#include "IMeshLoader.h"
+#include "ISceneManager.h"
+
+namespace irr
+{
+namespace video
+{
+	struct SMaterial;
+	class ITexture;
+}
+namespace scene
+{
+
+//! Meshloader for the binary .irrbm files written by CIrrBinaryMeshWriter.
+class CIrrBinaryMeshFileLoader : public IMeshLoader
+{
+public:
+
+	//! Constructor
+	CIrrBinaryMeshFileLoader(ISceneManager* smgr);
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".irrbm")
+	virtual bool isALoadableFileExtension(const io::path& filename) const IRR_OVERRIDE;
+
+	//! creates/loads an animated mesh from the file.
+	//! \return Pointer to the created mesh. Returns 0 if loading failed.
+	//! If you no longer need the mesh, you should call IAnimatedMesh::drop().
+	//! See IReferenceCounted::drop() for more information.
+	virtual IAnimatedMesh* createMesh(io::IReadFile* file) IRR_OVERRIDE;
+
+private:
+
+	//! reads material and texture layers of a meshbuffer
+	bool readMaterial(io::IReadFile* file, u32 layerCount, const core::array<video::ITexture*>& textures, video::SMaterial& material);
+
+	//! reads a string padded to 4 bytes
+	bool readString(io::IReadFile* file, core::stringc& str);
+
+	//! reads a block of count elements of size bytes, fails if the file is too short
+	bool readBlock(io::IReadFile* file, void* data, u32 count, u32 size);
+
+	ISceneManager* SceneManager;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
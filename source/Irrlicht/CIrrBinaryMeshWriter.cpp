@@ -0,0 +1,268 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+
+#include "CIrrBinaryMeshWriter.h"
+#include "SIrrBinaryMesh.h"
+#include "os.h"
+#include "ISkinnedMesh.h"
+#include "IMeshBuffer.h"
+#include "IWriteFile.h"
+#include "ITexture.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+
+//! writes a block, fails when the file takes less
+bool writeBlock(io::IWriteFile* file, const void* data, u32 size)
+{
+	return !size || file->write(data, size) == size;
+}
+
+bool writePadding(io::IWriteFile* file, u32 size)
+{
+	const u32 zero = 0;
+	return !(size & 3) || writeBlock(file, &zero, 4 - (size & 3));
+}
+
+bool writeString(io::IWriteFile* file, const core::stringc& str)
+{
+	const u32 length = str.size();
+	return writeBlock(file, &length, 4) &&
+		writeBlock(file, str.c_str(), length) &&
+		writePadding(file, length);
+}
+
+void writeBox(f32* out, const core::aabbox3df& box)
+{
+	out[0] = box.MinEdge.X;
+	out[1] = box.MinEdge.Y;
+	out[2] = box.MinEdge.Z;
+	out[3] = box.MaxEdge.X;
+	out[4] = box.MaxEdge.Y;
+	out[5] = box.MaxEdge.Z;
+}
+
+s32 getTextureIndex(core::array<video::ITexture*>& textures, video::ITexture* texture)
+{
+	if (!texture)
+		return -1;
+	for (u32 i=0; i<textures.size(); ++i)
+	{
+		if (textures[i] == texture)
+			return (s32)i;
+	}
+	textures.push_back(texture);
+	return (s32)textures.size()-1;
+}
+
+bool writeMaterial(io::IWriteFile* file, const video::SMaterial& material, core::array<video::ITexture*>& textures)
+{
+	SIrrBMMaterial m;
+	m.MaterialType = material.MaterialType;
+	m.AmbientColor = material.AmbientColor.color;
+	m.DiffuseColor = material.DiffuseColor.color;
+	m.EmissiveColor = material.EmissiveColor.color;
+	m.SpecularColor = material.SpecularColor.color;
+	m.Shininess = material.Shininess;
+	m.MaterialTypeParam = material.MaterialTypeParam;
+	m.MaterialTypeParam2 = material.MaterialTypeParam2;
+	m.Thickness = material.Thickness;
+	m.AntiAliasing = material.AntiAliasing;
+	m.ZBuffer = material.ZBuffer;
+	m.ZWriteEnable = material.ZWriteEnable;
+	m.ColorMask = material.ColorMask;
+	m.ColorMaterial = material.ColorMaterial;
+	m.BlendOperation = material.BlendOperation;
+	m.BlendFactor = material.BlendFactor;
+	m.PolygonOffsetFactor = material.PolygonOffsetFactor;
+	m.PolygonOffsetDirection = material.PolygonOffsetDirection;
+	m.PolygonOffsetDepthBias = material.PolygonOffsetDepthBias;
+	m.PolygonOffsetSlopeScale = material.PolygonOffsetSlopeScale;
+	m.Flags = (material.Wireframe ? EIRRBM_WIREFRAME : 0) |
+		(material.PointCloud ? EIRRBM_POINTCLOUD : 0) |
+		(material.GouraudShading ? EIRRBM_GOURAUD_SHADING : 0) |
+		(material.Lighting ? EIRRBM_LIGHTING : 0) |
+		(material.BackfaceCulling ? EIRRBM_BACKFACE_CULLING : 0) |
+		(material.FrontfaceCulling ? EIRRBM_FRONTFACE_CULLING : 0) |
+		(material.FogEnable ? EIRRBM_FOG_ENABLE : 0) |
+		(material.NormalizeNormals ? EIRRBM_NORMALIZE_NORMALS : 0) |
+		(material.UseMipMaps ? EIRRBM_USE_MIPMAPS : 0);
+	if (!writeBlock(file, &m, sizeof(m)))
+		return false;
+
+	for (u32 i=0; i<video::MATERIAL_MAX_TEXTURES; ++i)
+	{
+		const video::SMaterialLayer& layer = material.TextureLayer[i];
+		SIrrBMMaterialLayer l;
+		l.Texture = getTextureIndex(textures, layer.Texture);
+		l.TextureWrapU = layer.TextureWrapU;
+		l.TextureWrapV = layer.TextureWrapV;
+		l.TextureWrapW = layer.TextureWrapW;
+		l.BilinearFilter = layer.BilinearFilter;
+		l.TrilinearFilter = layer.TrilinearFilter;
+		l.AnisotropicFilter = layer.AnisotropicFilter;
+		l.LODBias = layer.LODBias;
+		const core::matrix4& matrix = layer.getTextureMatrix();
+		l.TextureMatrixUsed = matrix.isIdentity() ? 0 : 1;
+		for (u32 j=0; j<16; ++j)
+			l.TextureMatrix[j] = matrix[j];
+		if (!writeBlock(file, &l, sizeof(l)))
+			return false;
+	}
+	return true;
+}
+
+} // end anonymous namespace
+
+
+CIrrBinaryMeshWriter::CIrrBinaryMeshWriter()
+{
+	#ifdef _DEBUG
+	setDebugName("CIrrBinaryMeshWriter");
+	#endif
+}
+
+
+//! Returns the type of the mesh writer
+EMESH_WRITER_TYPE CIrrBinaryMeshWriter::getType() const
+{
+	return EMWT_IRR_BINARY_MESH;
+}
+
+
+//! Adds a file the written meshes were converted from
+void CIrrBinaryMeshWriter::addDependency(const io::path& filename, const SIrrBMDependency& state)
+{
+	DependencyNames.push_back(filename);
+	Dependencies.push_back(state);
+}
+
+
+//! writes a mesh
+bool CIrrBinaryMeshWriter::writeMesh(io::IWriteFile* file, scene::IMesh* mesh, s32 flags)
+{
+	if (!file || !mesh)
+		return false;
+#ifdef __BIG_ENDIAN__
+	os::Printer::log("Binary mesh export does not support big-endian systems.", ELL_ERROR);
+	return false;
+#endif
+
+	ISkinnedMesh* skinned = (mesh->getMeshType() == EAMT_SKINNED) ? static_cast<ISkinnedMesh*>(mesh) : 0;
+
+	// texture names are written before the meshbuffers, so collect them first
+	core::array<video::ITexture*> textures;
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const video::SMaterial& material = mesh->getMeshBuffer(i)->getMaterial();
+		for (u32 j=0; j<video::MATERIAL_MAX_TEXTURES; ++j)
+			getTextureIndex(textures, material.getTexture(j));
+	}
+
+	SIrrBMHeader header;
+	header.Magic = IRRBM_MAGIC;
+	header.Version = IRRBM_VERSION;
+	header.Flags = skinned ? EIRRBM_SKINNED : 0;
+	header.MeshType = mesh->getMeshType();
+	header.BufferCount = mesh->getMeshBufferCount();
+	header.TextureCount = textures.size();
+	header.DependencyCount = Dependencies.size();
+	header.LayerCount = video::MATERIAL_MAX_TEXTURES;
+	header.JointCount = skinned ? skinned->getAllJoints().size() : 0;
+	header.AnimationSpeed = skinned ? skinned->getAnimationSpeed() : 0.f;
+	writeBox(header.BoundingBox, mesh->getBoundingBox());
+	bool ok = writeBlock(file, &header, sizeof(header));
+
+	for (u32 i=0; ok && i<textures.size(); ++i)
+		ok = writeString(file, core::stringc(textures[i]->getName().getPath()));
+
+	for (u32 i=0; ok && i<Dependencies.size(); ++i)
+	{
+		ok = writeString(file, core::stringc(DependencyNames[i])) &&
+			writeBlock(file, &Dependencies[i], sizeof(SIrrBMDependency));
+	}
+
+	for (u32 i=0; ok && i<mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+
+		SIrrBMBuffer buffer;
+		buffer.VertexType = mb->getVertexType();
+		buffer.IndexType = mb->getIndexType();
+		buffer.PrimitiveType = mb->getPrimitiveType();
+		buffer.VertexCount = mb->getVertexCount();
+		buffer.IndexCount = mb->getIndexCount();
+		buffer.MappingHintVertex = mb->getHardwareMappingHint_Vertex();
+		buffer.MappingHintIndex = mb->getHardwareMappingHint_Index();
+		writeBox(buffer.BoundingBox, mb->getBoundingBox());
+		const u32 indexBytes = buffer.IndexCount * (mb->getIndexType() == video::EIT_16BIT ? 2 : 4);
+		ok = writeBlock(file, &buffer, sizeof(buffer)) &&
+			writeMaterial(file, mb->getMaterial(), textures) &&
+			writeBlock(file, mb->getVertices(), buffer.VertexCount * video::getVertexPitchFromType(mb->getVertexType())) &&
+			writeBlock(file, mb->getIndices(), indexBytes) &&
+			writePadding(file, indexBytes);
+	}
+
+	if (skinned)
+	{
+		const core::array<ISkinnedMesh::SJoint*>& joints = skinned->getAllJoints();
+		for (u32 i=0; ok && i<joints.size(); ++i)
+		{
+			const ISkinnedMesh::SJoint* joint = joints[i];
+
+			SIrrBMJoint j;
+			j.NameLength = joint->Name.size();
+			for (u32 k=0; k<16; ++k)
+			{
+				j.LocalMatrix[k] = joint->LocalMatrix[k];
+				j.GlobalInversedMatrix[k] = joint->GlobalInversedMatrix[k];
+			}
+			j.ChildCount = joint->Children.size();
+			j.AttachedMeshCount = joint->AttachedMeshes.size();
+			j.PositionKeyCount = joint->PositionKeys.size();
+			j.ScaleKeyCount = joint->ScaleKeys.size();
+			j.RotationKeyCount = joint->RotationKeys.size();
+			j.WeightCount = joint->Weights.size();
+			ok = writeBlock(file, &j, sizeof(j)) &&
+				writeBlock(file, joint->Name.c_str(), j.NameLength) &&
+				writePadding(file, j.NameLength);
+
+			for (u32 k=0; ok && k<joint->Children.size(); ++k)
+			{
+				const u32 child = (u32)joints.linear_search(joint->Children[k]);
+				ok = writeBlock(file, &child, 4);
+			}
+			ok = ok && writeBlock(file, joint->AttachedMeshes.const_pointer(), j.AttachedMeshCount * 4) &&
+				writeBlock(file, joint->PositionKeys.const_pointer(), j.PositionKeyCount * sizeof(ISkinnedMesh::SPositionKey)) &&
+				writeBlock(file, joint->ScaleKeys.const_pointer(), j.ScaleKeyCount * sizeof(ISkinnedMesh::SScaleKey)) &&
+				writeBlock(file, joint->RotationKeys.const_pointer(), j.RotationKeyCount * sizeof(ISkinnedMesh::SRotationKey));
+
+			for (u32 k=0; ok && k<joint->Weights.size(); ++k)
+			{
+				SIrrBMWeight w;
+				w.Buffer = joint->Weights[k].buffer_id;
+				w.Vertex = joint->Weights[k].vertex_id;
+				w.Strength = joint->Weights[k].strength;
+				ok = writeBlock(file, &w, sizeof(w));
+			}
+		}
+	}
+
+	if (!ok)
+		os::Printer::log("Could not write binary mesh file", file->getFileName(), ELL_ERROR);
+	return ok;
+}
+
+} // end namespace
+} // end namespace
+
+#endif // _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
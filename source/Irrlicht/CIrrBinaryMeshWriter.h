@@ -0,0 +1,46 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_C_IRR_BINARY_MESH_WRITER_H_INCLUDED
+#define IRR_C_IRR_BINARY_MESH_WRITER_H_INCLUDED
+
+#include "IMeshWriter.h"
+#include "SIrrBinaryMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! class to write meshes in the binary .irrbm format
+/** Writes static meshes and skinned meshes with their joints and
+animation keys. Vertices and indices are stored as they are in memory,
+so CIrrBinaryMeshFileLoader can read them into the meshbuffers without
+parsing. */
+class CIrrBinaryMeshWriter : public IMeshWriter
+{
+public:
+
+	CIrrBinaryMeshWriter();
+
+	//! Returns the type of the mesh writer
+	virtual EMESH_WRITER_TYPE getType() const IRR_OVERRIDE;
+
+	//! Adds a file the written meshes were converted from
+	/** The loader rejects the binary mesh when the file changed. */
+	void addDependency(const io::path& filename, const SIrrBMDependency& state);
+
+	//! writes a mesh
+	/** \return False when the file took less than the whole mesh. */
+	virtual bool writeMesh(io::IWriteFile* file, scene::IMesh* mesh, s32 flags=EMWF_NONE) IRR_OVERRIDE;
+
+private:
+
+	core::array<io::path> DependencyNames;
+	core::array<SIrrBMDependency> Dependencies;
+};
+
+} // end namespace
+} // end namespace
+
+#endif
@@ -20,6 +20,7 @@
 #include "Keycodes.h"
 #include "COSOperator.h"
 #include "CColorConverter.h"
+#include "CImage.h"
 #include "SIrrCreationParameters.h"
 #include "IGUISpriteBank.h"
 #include <X11/XKBlib.h>
@@ -91,6 +92,9 @@ CIrrDeviceLinux::CIrrDeviceLinux(const SIrrlichtCreationParameters& param)
 	: CIrrDeviceStub(param),
 #ifdef _IRR_COMPILE_WITH_X11_
 	XDisplay(0), VisualInfo(0), Screennr(0), XWindow(0), StdHints(0), SoftwareImage(0),
+#ifdef _IRR_LINUX_X11_SHM_
+	ShmImage(0), ShmCompletionType(0), UseShm(false), ShmPending(false),
+#endif
 	XInputMethod(0), XInputContext(0),
 	HasNetWM(false),
 #ifdef _IRR_COMPILE_WITH_OPENGL_
@@ -210,8 +214,7 @@ CIrrDeviceLinux::~CIrrDeviceLinux()
 		// Reset fullscreen resolution change
 		switchToFullscreen(true);
 
-		if (SoftwareImage)
-			XDestroyImage(SoftwareImage);
+		destroySoftwareImage();
 
 		if (!ExternalWindow)
 		{
@@ -252,6 +255,158 @@ int IrrPrintXError(Display *display, XErrorEvent *event)
 #endif
 
 
+#if defined(_IRR_COMPILE_WITH_X11_) && defined(_IRR_LINUX_X11_SHM_)
+namespace
+{
+	bool ShmAttachFailed = false;
+
+	// XShmAttach fails asynchronously, for example for remote displays
+	int IrrShmAttachError(Display *display, XErrorEvent *event)
+	{
+		ShmAttachFailed = true;
+		return 0;
+	}
+
+	bool ShmPutFailed = false;
+
+	// XShmPutImage fails asynchronously too, for example when the window is gone
+	int IrrShmPutError(Display *display, XErrorEvent *event)
+	{
+		ShmPutFailed = true;
+		return 0;
+	}
+
+	Bool IrrIsShmCompletion(Display *display, XEvent *event, XPointer completionType)
+	{
+		return event->type == *(int*)completionType;
+	}
+}
+#endif
+
+
+#ifdef _IRR_COMPILE_WITH_X11_
+void CIrrDeviceLinux::createSoftwareImage()
+{
+#ifdef _IRR_LINUX_X11_SHM_
+	if (UseShm)
+	{
+		SoftwareImage = XShmCreateImage(XDisplay,
+			VisualInfo->visual, VisualInfo->depth,
+			ZPixmap, 0, &ShmInfo, Width, Height);
+
+		if (SoftwareImage)
+		{
+			ShmInfo.shmaddr = (char*)-1;
+			ShmInfo.shmid = shmget(IPC_PRIVATE, SoftwareImage->bytes_per_line * SoftwareImage->height, IPC_CREAT | 0600);
+			if (ShmInfo.shmid != -1)
+			{
+				ShmInfo.shmaddr = (char*) shmat(ShmInfo.shmid, 0, 0);
+				ShmInfo.readOnly = False;
+
+				if (ShmInfo.shmaddr != (char*)-1)
+				{
+					ShmAttachFailed = false;
+					XErrorHandler oldHandler = XSetErrorHandler(IrrShmAttachError);
+					const Status attached = XShmAttach(XDisplay, &ShmInfo);
+					XSync(XDisplay, False);
+					XSetErrorHandler(oldHandler);
+					if (!attached)
+						ShmAttachFailed = true;
+				}
+
+				// the segment is released once both sides detached
+				shmctl(ShmInfo.shmid, IPC_RMID, 0);
+			}
+
+			if (ShmInfo.shmaddr != (char*)-1 && !ShmAttachFailed)
+			{
+				SoftwareImage->data = ShmInfo.shmaddr;
+
+				// the drivers can render straight into images of their format
+				if (SoftwareImage->bits_per_pixel == 32 && SoftwareImage->byte_order == LSBFirst &&
+					VisualInfo->red_mask == 0xff0000 && VisualInfo->blue_mask == 0xff &&
+					SoftwareImage->bytes_per_line == (int)Width * 4)
+				{
+					ShmImage = new video::CImage(video::ECF_A8R8G8B8,
+						core::dimension2d<u32>(Width, Height), ShmInfo.shmaddr, true, false);
+				}
+				return;
+			}
+
+			if (ShmInfo.shmaddr != (char*)-1)
+				shmdt(ShmInfo.shmaddr);
+			XDestroyImage(SoftwareImage);
+			SoftwareImage = 0;
+		}
+
+		os::Printer::log("Could not use MIT-SHM, falling back to XPutImage.", ELL_INFORMATION);
+		UseShm = false;
+	}
+#endif
+
+	SoftwareImage = XCreateImage(XDisplay,
+		VisualInfo->visual, VisualInfo->depth,
+		ZPixmap, 0, 0, Width, Height,
+		BitmapPad(XDisplay), 0);
+
+	// use malloc because X will free it later on
+	if (SoftwareImage)
+		SoftwareImage->data = (char*) malloc(SoftwareImage->bytes_per_line * SoftwareImage->height * sizeof(char));
+}
+
+
+void CIrrDeviceLinux::destroySoftwareImage()
+{
+	if (!SoftwareImage)
+		return;
+
+#ifdef _IRR_LINUX_X11_SHM_
+	if (UseShm)
+	{
+		waitForShmCompletion();
+		if (ShmImage)
+		{
+			ShmImage->drop();
+			ShmImage = 0;
+		}
+		XShmDetach(XDisplay, &ShmInfo);
+		shmdt(ShmInfo.shmaddr);
+		// shared memory is not freed by X
+		SoftwareImage->data = 0;
+	}
+#endif
+
+	XDestroyImage(SoftwareImage);
+	SoftwareImage = 0;
+}
+
+
+void CIrrDeviceLinux::waitForShmCompletion()
+{
+#ifdef _IRR_LINUX_X11_SHM_
+	// run() may have received it already
+	if (!ShmPending)
+		return;
+
+	XEvent event;
+	if (!XCheckIfEvent(XDisplay, &event, IrrIsShmCompletion, (XPointer)&ShmCompletionType))
+	{
+		// The server sends the event when it processed the XShmPutImage, so
+		// after a round trip it is queued. Otherwise the put failed, for
+		// example because the window is gone, and no event will come.
+		ShmPutFailed = false;
+		XErrorHandler oldHandler = XSetErrorHandler(IrrShmPutError);
+		XSync(XDisplay, False);
+		XSetErrorHandler(oldHandler);
+		if (!XCheckIfEvent(XDisplay, &event, IrrIsShmCompletion, (XPointer)&ShmCompletionType) && ShmPutFailed)
+			os::Printer::log("Could not show the shared memory image.", ELL_WARNING);
+	}
+	ShmPending = false;
+#endif
+}
+#endif
+
+
 bool CIrrDeviceLinux::switchToFullscreen(bool reset)
 {
 	if (!CreationParams.Fullscreen)
@@ -573,14 +728,12 @@ bool CIrrDeviceLinux::createWindow()
 
 	if (CreationParams.DriverType == video::EDT_SOFTWARE || CreationParams.DriverType == video::EDT_BURNINGSVIDEO)
 	{
-		SoftwareImage = XCreateImage(XDisplay,
-			VisualInfo->visual, VisualInfo->depth,
-			ZPixmap, 0, 0, Width, Height,
-			BitmapPad(XDisplay), 0);
-
-		// use malloc because X will free it later on
-		if (SoftwareImage)
-			SoftwareImage->data = (char*) malloc(SoftwareImage->bytes_per_line * SoftwareImage->height * sizeof(char));
+#ifdef _IRR_LINUX_X11_SHM_
+		UseShm = XShmQueryExtension(XDisplay);
+		if (UseShm)
+			ShmCompletionType = XShmGetEventBase(XDisplay) + ShmCompletion;
+#endif
+		createSoftwareImage();
 	}
 
 	initXAtoms();
@@ -805,16 +958,8 @@ bool CIrrDeviceLinux::run()
 					// resize image data
 					if (SoftwareImage)
 					{
-						XDestroyImage(SoftwareImage);
-
-						SoftwareImage = XCreateImage(XDisplay,
-							VisualInfo->visual, VisualInfo->depth,
-							ZPixmap, 0, 0, Width, Height,
-							BitmapPad(XDisplay), 0);
-
-						// use malloc because X will free it later on
-						if (SoftwareImage)
-							SoftwareImage->data = (char*) malloc(SoftwareImage->bytes_per_line * SoftwareImage->height * sizeof(char));
+						destroySoftwareImage();
+						createSoftwareImage();
 					}
 
 					if (VideoDriver)
@@ -1103,6 +1248,10 @@ bool CIrrDeviceLinux::run()
 #endif
 
 			default:
+#ifdef _IRR_LINUX_X11_SHM_
+				if (UseShm && event.type == ShmCompletionType)
+					ShmPending = false;
+#endif
 				break;
 			} // end switch
 
@@ -1194,29 +1343,63 @@ bool CIrrDeviceLinux::present(video::IImage* image, void* windowId, core::rect<s
 			return false;
 	}
 
+	// the server may still read the shared image of the last frame
+	waitForShmCompletion();
+
 	u8* srcdata = reinterpret_cast<u8*>(image->getData());
 	u8* destData = reinterpret_cast<u8*>(SoftwareImage->data);
 
 	const u32 destheight = SoftwareImage->height;
-	const u32 srcheight = core::min_(image->getDimension().Height, destheight);
-	const u32 srcPitch = image->getPitch();
-	for (u32 y=0; y!=srcheight; ++y)
+
+	// images from getPresentImage() are shown without copying
+	if (srcdata != destData)
 	{
-		video::CColorConverter::convert_viaFormat(srcdata,image->getColorFormat(), minWidth, destData, destColor);
-		srcdata+=srcPitch;
-		destData+=destPitch;
+		const u32 srcheight = core::min_(image->getDimension().Height, destheight);
+		const u32 srcPitch = image->getPitch();
+		for (u32 y=0; y!=srcheight; ++y)
+		{
+			video::CColorConverter::convert_viaFormat(srcdata,image->getColorFormat(), minWidth, destData, destColor);
+			srcdata+=srcPitch;
+			destData+=destPitch;
+		}
 	}
 
 	GC gc = DefaultGC(XDisplay, DefaultScreen(XDisplay));
 	Window myWindow=XWindow;
 	if (windowId)
 		myWindow = reinterpret_cast<Window>(windowId);
+#ifdef _IRR_LINUX_X11_SHM_
+	if (UseShm)
+	{
+		// The server reads the pixels directly from our memory, so the
+		// next frame waits for the ShmCompletion event before writing it.
+		XShmPutImage(XDisplay, myWindow, gc, SoftwareImage, 0, 0, 0, 0, destwidth, destheight, True);
+		XFlush(XDisplay);
+		ShmPending = true;
+	}
+	else
+#endif
 	XPutImage(XDisplay, myWindow, gc, SoftwareImage, 0, 0, 0, 0, destwidth, destheight);
 #endif
 	return true;
 }
 
 
+//! returns the shared memory image when the software drivers can render into it
+video::IImage* CIrrDeviceLinux::getPresentImage(video::ECOLOR_FORMAT format, const core::dimension2d<u32>& size)
+{
+#if defined(_IRR_COMPILE_WITH_X11_) && defined(_IRR_LINUX_X11_SHM_)
+	if (!UseShm || !ShmImage || ShmImage->getColorFormat() != format || ShmImage->getDimension() != size)
+		return 0;
+
+	waitForShmCompletion();
+	return ShmImage;
+#else
+	return 0;
+#endif
+}
+
+
 //! notifies the device that it should close itself
 void CIrrDeviceLinux::closeDevice()
 {
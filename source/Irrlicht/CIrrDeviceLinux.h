@@ -41,6 +41,12 @@
 #include <X11/extensions/XInput2.h>
 #endif
 
+#ifdef _IRR_LINUX_X11_SHM_
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#endif
+
 #else
 #define KeySym s32
 #endif
@@ -86,6 +92,9 @@ namespace irr
 		//! presents a surface in the client area
 		virtual bool present(video::IImage* surface, void* windowId=0, core::rect<s32>* src=0 ) IRR_OVERRIDE;
 
+		//! returns the shared memory image when the software drivers can render into it
+		virtual video::IImage* getPresentImage(video::ECOLOR_FORMAT format, const core::dimension2d<u32>& size) IRR_OVERRIDE;
+
 		//! notifies the device that it should close itself
 		virtual void closeDevice() IRR_OVERRIDE;
 
@@ -167,6 +176,13 @@ namespace irr
 		bool createInputContext();
 		void destroyInputContext();
 		EKEY_CODE getKeyCode(XEvent &event);
+
+		//! (Re-)create the image used to present the software drivers in the current window size
+		void createSoftwareImage();
+		void destroySoftwareImage();
+
+		//! Waits until the X server has read the shared memory image of the last present()
+		void waitForShmCompletion();
 #endif
 
 		//! Implementation of the linux cursor control
@@ -450,6 +466,15 @@ namespace irr
 		XSetWindowAttributes WndAttributes;
 		XSizeHints* StdHints;
 		XImage* SoftwareImage;
+		#ifdef _IRR_LINUX_X11_SHM_
+		XShmSegmentInfo ShmInfo;
+		//! The shared memory of SoftwareImage in the format of the software drivers
+		video::IImage* ShmImage;
+		int ShmCompletionType;
+		bool UseShm;
+		//! An XShmPutImage was sent and its ShmCompletion event not yet received
+		bool ShmPending;
+		#endif
 		XIM XInputMethod;
 		XIC XInputContext;
 		bool HasNetWM;
@@ -0,0 +1,239 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CLODMeshSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CLODMeshSceneNode::CLODMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& rotation,
+			const core::vector3df& scale)
+	: ILODMeshSceneNode(parent, mgr, id, position, rotation, scale),
+	Hysteresis(0.1f), ScreenSize(0.f), CurrentLevel(0), LevelCounted(true)
+{
+	#ifdef _DEBUG
+	setDebugName("CLODMeshSceneNode");
+	#endif
+
+	SLevel level;
+	level.Mesh = mesh;
+	level.ScreenSize = 0.f;
+	level.PrimitiveCount = getPrimitiveCount(mesh);
+	Levels.push_back(level);
+
+	if (mesh)
+	{
+		mesh->grab();
+		Box = mesh->getBoundingBox();
+
+		Materials.reallocate(mesh->getMeshBufferCount());
+		for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* mb = mesh->getMeshBuffer(i);
+			Materials.push_back(mb ? mb->getMaterial() : video::SMaterial());
+		}
+	}
+}
+
+
+//! destructor
+CLODMeshSceneNode::~CLODMeshSceneNode()
+{
+	for (u32 i=0; i<Levels.size(); ++i)
+	{
+		if (Levels[i].Mesh)
+			Levels[i].Mesh->drop();
+	}
+}
+
+
+//! chooses the level and registers the node for the passes of its materials
+void CLODMeshSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Levels[0].Mesh)
+	{
+		Box = Levels[0].Mesh->getBoundingBox(); // in case the mesh was modified
+
+		// only get coarser when the size is clearly below the border of the
+		// next level and only finer when clearly above the border of this one
+		ScreenSize = calculateScreenSize();
+		while (CurrentLevel+1 < Levels.size() &&
+			ScreenSize < Levels[CurrentLevel+1].ScreenSize * (1.f - Hysteresis))
+			++CurrentLevel;
+		while (CurrentLevel > 0 &&
+			ScreenSize >= Levels[CurrentLevel].ScreenSize * (1.f + Hysteresis))
+			--CurrentLevel;
+
+		if (Levels[CurrentLevel].Mesh)
+		{
+			video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+			u32 transparentCount = 0;
+			u32 solidCount = 0;
+			for (u32 i=0; i<Materials.size(); ++i)
+			{
+				if (driver->needsTransparentRenderPass(Materials[i]))
+					++transparentCount;
+				else
+					++solidCount;
+			}
+
+			if (solidCount)
+				SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+
+			if (transparentCount)
+				SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+
+			if (DebugDataVisible)
+				SceneManager->registerNodeForRendering(this, ESNRP_SHADOW);
+
+			LevelCounted = false;
+		}
+
+		ISceneNode::OnRegisterSceneNode();
+	}
+}
+
+
+//! renders the node.
+void CLODMeshSceneNode::render()
+{
+	IMesh* mesh = Levels[CurrentLevel].Mesh;
+	if (!mesh)
+		return;
+
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	const E_SCENE_NODE_RENDER_PASS renderPass = SceneManager->getSceneNodeRenderPass();
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	if (renderPass == ESNRP_SHADOW)
+	{
+		// for debug purposes only
+		video::SMaterial m;
+		m.Lighting = false;
+		m.AntiAliasing = 0;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & EDS_BBOX)
+			driver->draw3DBox(Box, video::SColor(255,255,255,255));
+
+		if (DebugDataVisible & EDS_BBOX_BUFFERS)
+		{
+			for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+				driver->draw3DBox(mesh->getMeshBuffer(i)->getBoundingBox(), video::SColor(255,190,128,128));
+		}
+		return;
+	}
+
+	if (!LevelCounted)
+	{
+		const u32 primitives = Levels[CurrentLevel].PrimitiveCount;
+		driver->countLODLevel(CurrentLevel,
+			Levels[0].PrimitiveCount > primitives ? Levels[0].PrimitiveCount - primitives : 0);
+		LevelCounted = true;
+	}
+
+	const u32 count = core::min_(Materials.size(), mesh->getMeshBufferCount());
+	for (u32 i=0; i<count; ++i)
+	{
+		// only the buffers of the current pass, all without a scene manager pass
+		const bool transparent = driver->needsTransparentRenderPass(Materials[i]);
+		if ((transparent && renderPass == ESNRP_SOLID) ||
+			(!transparent && renderPass == ESNRP_TRANSPARENT))
+			continue;
+
+		driver->setMaterial(Materials[i]);
+		driver->drawMeshBuffer(mesh->getMeshBuffer(i));
+	}
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CLODMeshSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! Adds a less detailed level
+bool CLODMeshSceneNode::addLevel(IMesh* mesh, f32 screenSize)
+{
+	const SLevel& last = Levels.getLast();
+	if (screenSize <= 0.f || (Levels.size() > 1 && screenSize >= last.ScreenSize))
+		return false;
+
+	if (mesh)
+		mesh->grab();
+
+	SLevel level;
+	level.Mesh = mesh;
+	level.ScreenSize = screenSize;
+	level.PrimitiveCount = getPrimitiveCount(mesh);
+	Levels.push_back(level);
+	return true;
+}
+
+
+//! Removes all levels except level 0
+void CLODMeshSceneNode::removeLevels()
+{
+	for (u32 i=1; i<Levels.size(); ++i)
+	{
+		if (Levels[i].Mesh)
+			Levels[i].Mesh->drop();
+	}
+	Levels.set_used(1);
+	CurrentLevel = 0;
+}
+
+
+//! Projects the bounding sphere of the node with the active camera
+f32 CLODMeshSceneNode::calculateScreenSize() const
+{
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (!camera)
+		return FLT_MAX;
+
+	const core::aabbox3d<f32> box = getTransformedBoundingBox();
+	const f32 radius = box.getExtent().getLength() * 0.5f;
+
+	// the projection scales by the height of the view volume, either
+	// at distance 1 or for all distances of an orthogonal projection
+	const f32 scale = camera->getProjectionMatrix()[5];
+	if (camera->isOrthogonal())
+		return radius * core::abs_(scale);
+
+	const f32 distance = box.getCenter().getDistanceFrom(camera->getAbsolutePosition());
+	if (distance <= radius)
+		return FLT_MAX;
+
+	return radius * core::abs_(scale) / distance;
+}
+
+
+//! Returns the number of triangles of a mesh
+u32 CLODMeshSceneNode::getPrimitiveCount(const IMesh* mesh)
+{
+	u32 count = 0;
+	if (mesh)
+	{
+		for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+			count += mesh->getMeshBuffer(i)->getPrimitiveCount();
+	}
+	return count;
+}
+
+
+} // end namespace scene
+} // end namespace irr
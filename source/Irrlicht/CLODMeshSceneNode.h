@@ -0,0 +1,103 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_C_LOD_MESH_SCENE_NODE_H_INCLUDED
+#define IRR_C_LOD_MESH_SCENE_NODE_H_INCLUDED
+
+#include "ILODMeshSceneNode.h"
+#include "IMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	class CLODMeshSceneNode : public ILODMeshSceneNode
+	{
+	public:
+
+		//! constructor
+		/** \param mesh The most detailed mesh, level 0. */
+		CLODMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+		//! destructor
+		virtual ~CLODMeshSceneNode();
+
+		//! chooses the level and registers the node for the passes of its materials
+		virtual void OnRegisterSceneNode() IRR_OVERRIDE;
+
+		//! renders the node.
+		virtual void render() IRR_OVERRIDE;
+
+		//! returns the axis aligned bounding box of level 0
+		virtual const core::aabbox3d<f32>& getBoundingBox() const IRR_OVERRIDE { return Box; }
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) IRR_OVERRIDE;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const IRR_OVERRIDE { return Materials.size(); }
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const IRR_OVERRIDE { return ESNT_LOD_MESH; }
+
+		//! Adds a less detailed level
+		virtual bool addLevel(IMesh* mesh, f32 screenSize) IRR_OVERRIDE;
+
+		//! Removes all levels except level 0
+		virtual void removeLevels() IRR_OVERRIDE;
+
+		//! Returns the number of levels, including level 0
+		virtual u32 getLevelCount() const IRR_OVERRIDE { return Levels.size(); }
+
+		//! Returns the mesh of a level
+		virtual IMesh* getLevelMesh(u32 level) const IRR_OVERRIDE { return Levels[level].Mesh; }
+
+		//! Returns the screen size below which a level is drawn
+		virtual f32 getLevelScreenSize(u32 level) const IRR_OVERRIDE { return Levels[level].ScreenSize; }
+
+		//! Sets how far the screen size has to pass the border of a level before it changes
+		virtual void setHysteresis(f32 hysteresis) IRR_OVERRIDE { Hysteresis = hysteresis; }
+
+		//! Returns the hysteresis of the level changes
+		virtual f32 getHysteresis() const IRR_OVERRIDE { return Hysteresis; }
+
+		//! Returns the level chosen when the node was registered last
+		virtual u32 getCurrentLevel() const IRR_OVERRIDE { return CurrentLevel; }
+
+		//! Returns the screen size of the node calculated when the node was registered last
+		virtual f32 getScreenSize() const IRR_OVERRIDE { return ScreenSize; }
+
+	private:
+
+		struct SLevel
+		{
+			IMesh* Mesh;
+			f32 ScreenSize;
+			u32 PrimitiveCount;
+		};
+
+		//! Projects the bounding sphere of the node with the active camera
+		f32 calculateScreenSize() const;
+
+		//! Returns the number of triangles of a mesh
+		static u32 getPrimitiveCount(const IMesh* mesh);
+
+		core::array<SLevel> Levels;
+		core::array<video::SMaterial> Materials;
+		core::aabbox3d<f32> Box;
+		f32 Hysteresis;
+		f32 ScreenSize;
+		u32 CurrentLevel;
+
+		//! The drawn level is counted by the first render pass of a frame only
+		bool LevelCounted;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -5,6 +5,7 @@
 #include "CMeshManipulator.h"
 #include "SMesh.h"
 #include "CMeshBuffer.h"
+#include "CDynamicMeshBuffer.h"
 #include "SAnimatedMesh.h"
 #include "os.h"
 #include "irrMap.h"
@@ -2056,6 +2057,470 @@ IMesh* CMeshManipulator::createForsythOptimizedMesh(const IMesh *mesh) const
 	return newmesh;
 }
 
+
+namespace
+{
+
+//! Squared distance to a set of weighted planes, see Garland and Heckbert,
+//! Surface Simplification Using Quadric Error Metrics
+struct SQuadric
+{
+	SQuadric() : A00(0), A01(0), A02(0), A11(0), A12(0), A22(0),
+		B0(0), B1(0), B2(0), C(0), Weight(0) {}
+
+	//! Adds the plane through point with the unit normal n
+	void addPlane(const core::vector3df& n, const core::vector3df& point, f64 weight)
+	{
+		const f64 d = -(f64)n.dotProduct(point);
+		A00 += weight*n.X*n.X; A01 += weight*n.X*n.Y; A02 += weight*n.X*n.Z;
+		A11 += weight*n.Y*n.Y; A12 += weight*n.Y*n.Z; A22 += weight*n.Z*n.Z;
+		B0 += weight*n.X*d; B1 += weight*n.Y*d; B2 += weight*n.Z*d;
+		C += weight*d*d;
+		Weight += weight;
+	}
+
+	SQuadric& operator+=(const SQuadric& other)
+	{
+		A00 += other.A00; A01 += other.A01; A02 += other.A02;
+		A11 += other.A11; A12 += other.A12; A22 += other.A22;
+		B0 += other.B0; B1 += other.B1; B2 += other.B2;
+		C += other.C;
+		Weight += other.Weight;
+		return *this;
+	}
+
+	//! Weighted mean of the squared distances of p to the planes
+	f64 getError(const core::vector3df& p) const
+	{
+		const f64 x = p.X, y = p.Y, z = p.Z;
+		const f64 error = A00*x*x + 2.0*A01*x*y + 2.0*A02*x*z + A11*y*y + 2.0*A12*y*z + A22*z*z
+			+ 2.0*(B0*x + B1*y + B2*z) + C;
+		return Weight > 0.0 ? core::abs_(error) / Weight : 0.0;
+	}
+
+	f64 A00, A01, A02, A11, A12, A22;
+	f64 B0, B1, B2;
+	f64 C;
+	f64 Weight;
+};
+
+//! Collapse of the vertex From onto the vertex To
+struct SCollapse
+{
+	bool operator<(const SCollapse& other) const
+	{
+		return Error < other.Error;
+	}
+
+	f32 Error;
+	u32 From;
+	u32 To;
+};
+
+//! Vertex sorted by position to find vertices at the same place
+struct SPositionVertex
+{
+	bool operator<(const SPositionVertex& other) const
+	{
+		if (Pos.X != other.Pos.X)
+			return Pos.X < other.Pos.X;
+		if (Pos.Y != other.Pos.Y)
+			return Pos.Y < other.Pos.Y;
+		return Pos.Z < other.Pos.Z;
+	}
+
+	core::vector3df Pos;
+	u32 Index;
+};
+
+//! Vertex sorted by all its data to find vertices which are the same
+struct SDataVertex
+{
+	bool operator<(const SDataVertex& other) const
+	{
+		return memcmp(Data, other.Data, Pitch) < 0;
+	}
+
+	const u8* Data;
+	u32 Pitch;
+	u32 Index;
+};
+
+enum E_SIMPLIFY_VERTEX
+{
+	ESV_INTERIOR = 0,
+	//! On an edge used by only one triangle, only moved along such edges
+	ESV_BORDER,
+	//! Shares its position with other vertices, which have other normals
+	//! or texture coordinates, never moved to avoid cracks
+	ESV_LOCKED
+};
+
+inline u64 getEdgeKey(u32 a, u32 b)
+{
+	return a < b ? ((u64)a << 32) | b : ((u64)b << 32) | a;
+}
+
+//! Returns true when moving From onto To turns a remaining triangle around
+bool collapseFlipsTriangle(const core::array<u32>& indices, const core::array<u32>& triangleStart,
+	const core::array<u32>& triangles, const core::array<core::vector3df>& positions,
+	const core::array<u32>& positionIds, u32 from, u32 to)
+{
+	const u32 toId = positionIds[to];
+	for (u32 t=triangleStart[from]; t<triangleStart[from+1]; ++t)
+	{
+		const u32* tri = &indices[triangles[t]*3];
+		if (positionIds[tri[0]] == toId || positionIds[tri[1]] == toId || positionIds[tri[2]] == toId)
+			continue;
+
+		// the other two vertices in winding order
+		const u32 k = tri[0] == from ? 0 : (tri[1] == from ? 1 : 2);
+		const core::vector3df& b = positions[tri[(k+1)%3]];
+		const core::vector3df& c = positions[tri[(k+2)%3]];
+		const core::vector3df before = (b - positions[from]).crossProduct(c - positions[from]);
+		const core::vector3df after = (b - positions[to]).crossProduct(c - positions[to]);
+		if (before.dotProduct(after) <= 0.f)
+			return true;
+	}
+	return false;
+}
+
+//! Collapses edges of a triangle list until it has at most targetIndexCount indices
+void simplifyTriangles(core::array<u32>& indices, const core::array<core::vector3df>& positions,
+	u32 targetIndexCount, f32 maxError)
+{
+	const u32 vertexCount = positions.size();
+
+	// used vertices at the same place share one position id for finding
+	// neighbours, they differ in normals or texture coordinates and are seams
+	core::array<u32> positionIds;
+	positionIds.set_used(vertexCount);
+	core::array<u8> kinds;
+	kinds.set_used(vertexCount);
+	{
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			positionIds[i] = i;
+			kinds[i] = ESV_INTERIOR;
+		}
+		core::array<u8> used;
+		used.set_used(vertexCount);
+		memset(used.pointer(), 0, vertexCount);
+		for (u32 i=0; i<indices.size(); ++i)
+			used[indices[i]] = 1;
+
+		core::array<SPositionVertex> sorted;
+		sorted.reallocate(vertexCount);
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			if (!used[i])
+				continue;
+			SPositionVertex v;
+			v.Pos = positions[i];
+			v.Index = i;
+			sorted.push_back(v);
+		}
+		sorted.sort();
+		for (u32 i=1; i<sorted.size(); ++i)
+		{
+			if (sorted[i].Pos == sorted[i-1].Pos)
+			{
+				positionIds[sorted[i].Index] = positionIds[sorted[i-1].Index];
+				kinds[sorted[i].Index] = ESV_LOCKED;
+				kinds[sorted[i-1].Index] = ESV_LOCKED;
+			}
+		}
+	}
+
+	// edges used by one triangle only are borders
+	core::array<u64> borderEdges;
+	{
+		core::array<u64> edges;
+		edges.reallocate(indices.size());
+		for (u32 i=0; i<indices.size(); i+=3)
+		{
+			const u32 a = positionIds[indices[i]];
+			const u32 b = positionIds[indices[i+1]];
+			const u32 c = positionIds[indices[i+2]];
+			edges.push_back(getEdgeKey(a, b));
+			edges.push_back(getEdgeKey(b, c));
+			edges.push_back(getEdgeKey(c, a));
+		}
+		edges.sort();
+		for (u32 i=0; i<edges.size(); )
+		{
+			u32 j = i+1;
+			while (j<edges.size() && edges[j] == edges[i])
+				++j;
+			if (j == i+1)
+				borderEdges.push_back(edges[i]);
+			i = j;
+		}
+		for (u32 i=0; i<borderEdges.size(); ++i)
+		{
+			const u32 a = (u32)(borderEdges[i] >> 32);
+			const u32 b = (u32)(borderEdges[i] & 0xffffffff);
+			if (kinds[a] == ESV_INTERIOR)
+				kinds[a] = ESV_BORDER;
+			if (kinds[b] == ESV_INTERIOR)
+				kinds[b] = ESV_BORDER;
+		}
+	}
+
+	// planes of the triangles around each vertex, weighted by area, and
+	// planes perpendicular to the borders to keep their shape
+	core::array<SQuadric> quadrics;
+	quadrics.set_used(vertexCount);
+	for (u32 i=0; i<vertexCount; ++i)
+		quadrics[i] = SQuadric();
+	for (u32 i=0; i<indices.size(); i+=3)
+	{
+		const core::vector3df& p0 = positions[indices[i]];
+		core::vector3df normal = (positions[indices[i+1]] - p0).crossProduct(positions[indices[i+2]] - p0);
+		const f32 area = normal.getLength();
+		if (area <= 0.f)
+			continue;
+		normal /= area;
+
+		for (u32 k=0; k<3; ++k)
+		{
+			const u32 a = indices[i+k];
+			const u32 b = indices[i+(k+1)%3];
+			quadrics[a].addPlane(normal, p0, area * 0.5);
+
+			if (borderEdges.binary_search(getEdgeKey(positionIds[a], positionIds[b])) >= 0)
+			{
+				const core::vector3df edge = positions[b] - positions[a];
+				const core::vector3df border = edge.crossProduct(normal).normalize();
+				const f64 weight = edge.getLengthSQ();
+				quadrics[a].addPlane(border, positions[a], weight);
+				quadrics[b].addPlane(border, positions[a], weight);
+			}
+		}
+	}
+
+	const f32 maxSquaredError = maxError > 0.f ? maxError*maxError : FLT_MAX;
+	core::array<u32> triangleStart;
+	core::array<u32> triangles;
+	core::array<SCollapse> collapses;
+	core::array<u32> remap;
+	core::array<u8> touched;
+
+	// collapse the cheapest edges in passes, each vertex once per pass
+	while (indices.size() > targetIndexCount)
+	{
+		// triangles around each vertex
+		triangleStart.set_used(vertexCount+1);
+		for (u32 i=0; i<=vertexCount; ++i)
+			triangleStart[i] = 0;
+		for (u32 i=0; i<indices.size(); ++i)
+			++triangleStart[indices[i]+1];
+		for (u32 i=0; i<vertexCount; ++i)
+			triangleStart[i+1] += triangleStart[i];
+		triangles.set_used(indices.size());
+		remap.set_used(vertexCount);
+		for (u32 i=0; i<vertexCount; ++i)
+			remap[i] = triangleStart[i];
+		for (u32 i=0; i<indices.size(); ++i)
+			triangles[remap[indices[i]]++] = i/3;
+
+		// cheapest collapse of each vertex
+		collapses.set_used(0);
+		for (u32 v=0; v<vertexCount; ++v)
+		{
+			if (kinds[v] == ESV_LOCKED || triangleStart[v] == triangleStart[v+1])
+				continue;
+
+			SCollapse best;
+			best.Error = FLT_MAX;
+			for (u32 t=triangleStart[v]; t<triangleStart[v+1]; ++t)
+			{
+				const u32* tri = &indices[triangles[t]*3];
+				for (u32 k=0; k<3; ++k)
+				{
+					const u32 to = tri[k];
+					if (to == v)
+						continue;
+					if (kinds[v] == ESV_BORDER && borderEdges.binary_search(getEdgeKey(v, positionIds[to])) < 0)
+						continue;
+
+					const f32 error = (f32)quadrics[v].getError(positions[to]);
+					if (error < best.Error)
+					{
+						best.Error = error;
+						best.From = v;
+						best.To = to;
+					}
+				}
+			}
+			if (best.Error < FLT_MAX && best.Error <= maxSquaredError)
+				collapses.push_back(best);
+		}
+		if (collapses.empty())
+			break;
+		collapses.sort();
+
+		for (u32 i=0; i<vertexCount; ++i)
+			remap[i] = i;
+		touched.set_used(vertexCount);
+		memset(touched.pointer(), 0, vertexCount);
+
+		u32 indexCount = indices.size();
+		u32 collapsed = 0;
+		for (u32 c=0; c<collapses.size() && indexCount > targetIndexCount; ++c)
+		{
+			const u32 from = collapses[c].From;
+			const u32 to = collapses[c].To;
+			if (touched[from] || touched[to])
+				continue;
+			if (collapseFlipsTriangle(indices, triangleStart, triangles, positions, positionIds, from, to))
+				continue;
+
+			remap[from] = to;
+			quadrics[to] += quadrics[from];
+			++collapsed;
+
+			// the triangles around the vertex change, their vertices wait for the next pass
+			for (u32 t=triangleStart[from]; t<triangleStart[from+1]; ++t)
+			{
+				const u32* tri = &indices[triangles[t]*3];
+				touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+				if (positionIds[tri[0]] == positionIds[to] || positionIds[tri[1]] == positionIds[to]
+					|| positionIds[tri[2]] == positionIds[to])
+					indexCount -= 3;
+			}
+		}
+		if (!collapsed)
+			break;
+
+		// remove the triangles which lost an edge
+		u32 used = 0;
+		for (u32 i=0; i<indices.size(); i+=3)
+		{
+			const u32 a = remap[indices[i]];
+			const u32 b = remap[indices[i+1]];
+			const u32 c = remap[indices[i+2]];
+			if (positionIds[a] == positionIds[b] || positionIds[b] == positionIds[c] || positionIds[c] == positionIds[a])
+				continue;
+			indices[used++] = a;
+			indices[used++] = b;
+			indices[used++] = c;
+		}
+		indices.set_used(used);
+	}
+}
+
+} // end anonymous namespace
+
+
+//! Creates a copy of a mesh with less triangles
+IMesh* CMeshManipulator::createSimplifiedMesh(const IMesh* mesh, f32 ratio, f32 maxError) const
+{
+	if (!mesh)
+		return 0;
+
+	SMesh* newMesh = new SMesh();
+	ratio = core::clamp(ratio, 0.f, 1.f);
+
+	core::array<u32> indices;
+	core::array<core::vector3df> positions;
+	core::array<u32> newIndex;
+	core::array<u8> vertices;
+	core::array<SDataVertex> sorted;
+
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		const u32 vertexCount = mb->getVertexCount();
+		const u32 indexCount = mb->getIndexCount();
+
+		if (mb->getPrimitiveType() != EPT_TRIANGLES || ratio >= 1.f || indexCount < 3)
+		{
+			IMeshBuffer* clone = mb->createClone();
+			newMesh->addMeshBuffer(clone);
+			clone->drop();
+			continue;
+		}
+
+		indices.set_used(indexCount - indexCount % 3);
+		if (mb->getIndexType() == video::EIT_16BIT)
+		{
+			const u16* ind = mb->getIndices();
+			for (u32 i=0; i<indices.size(); ++i)
+				indices[i] = ind[i];
+		}
+		else
+		{
+			const u32* ind = reinterpret_cast<const u32*>(mb->getIndices());
+			for (u32 i=0; i<indices.size(); ++i)
+				indices[i] = ind[i];
+		}
+
+		// meshes like md2 repeat the vertices for each triangle, use only one of them
+		const u32 pitch = video::getVertexPitchFromType(mb->getVertexType());
+		const u8* source = static_cast<const u8*>(mb->getVertices());
+		sorted.set_used(0);
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			SDataVertex v;
+			v.Data = source + i * pitch;
+			v.Pitch = pitch;
+			v.Index = i;
+			sorted.push_back(v);
+		}
+		sorted.sort();
+		newIndex.set_used(vertexCount);
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			if (i > 0 && memcmp(sorted[i].Data, sorted[i-1].Data, pitch) == 0)
+				newIndex[sorted[i].Index] = newIndex[sorted[i-1].Index];
+			else
+				newIndex[sorted[i].Index] = sorted[i].Index;
+		}
+		for (u32 i=0; i<indices.size(); ++i)
+			indices[i] = newIndex[indices[i]];
+
+		positions.set_used(vertexCount);
+		for (u32 i=0; i<vertexCount; ++i)
+			positions[i] = mb->getPosition(i);
+
+		const u32 targetIndexCount = core::floor32(indices.size() / 3 * ratio) * 3;
+		simplifyTriangles(indices, positions, targetIndexCount, maxError);
+
+		// copy the vertices which are still used, in their old order
+		for (u32 i=0; i<vertexCount; ++i)
+			newIndex[i] = 0xffffffff;
+		for (u32 i=0; i<indices.size(); ++i)
+			newIndex[indices[i]] = 0;
+
+		vertices.set_used(vertexCount * pitch);
+		u32 newVertexCount = 0;
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			if (newIndex[i] == 0xffffffff)
+				continue;
+			newIndex[i] = newVertexCount;
+			memcpy(&vertices[newVertexCount * pitch], source + i * pitch, pitch);
+			++newVertexCount;
+		}
+		for (u32 i=0; i<indices.size(); ++i)
+			indices[i] = newIndex[indices[i]];
+
+		CDynamicMeshBuffer* buffer = new CDynamicMeshBuffer(mb->getVertexType(),
+			newVertexCount > 65536 ? video::EIT_32BIT : video::EIT_16BIT);
+		buffer->Material = mb->getMaterial();
+		buffer->append(mb->getVertexType(), vertices.const_pointer(), newVertexCount,
+			video::EIT_32BIT, indices.const_pointer(), indices.size(), true);
+		buffer->setHardwareMappingHint(mb->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+		buffer->setHardwareMappingHint(mb->getHardwareMappingHint_Index(), EBT_INDEX);
+		newMesh->addMeshBuffer(buffer);
+		buffer->drop();
+	}
+
+	newMesh->recalculateBoundingBox();
+	return newMesh;
+}
+
 } // end namespace scene
 } // end namespace irr
 
@@ -87,6 +87,9 @@ public:
 	//! create a mesh optimized for the vertex cache
 	virtual IMesh* createForsythOptimizedMesh(const scene::IMesh *mesh) const IRR_OVERRIDE;
 
+	//! Creates a copy of a mesh with less triangles
+	virtual IMesh* createSimplifiedMesh(const IMesh* mesh, f32 ratio, f32 maxError=0.f) const IRR_OVERRIDE;
+
 	//! Optimizes the mesh using an algorithm tuned for heightmaps
 	virtual void heightmapOptimizeMesh(IMesh * const m, const f32 tolerance = core::ROUNDING_ERROR_f32) const IRR_OVERRIDE;
 
@@ -3,14 +3,58 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CMetaTriangleSelector.h"
+#include "ISceneNode.h"
 
 namespace irr
 {
 namespace scene
 {
 
+namespace
+{
+	// Maximal number of selectors in a leaf of the hierarchy
+	const u32 LEAF_SIZE = 4;
+
+	//! Returns the line parameter at which a line starts to intersect a box
+	/** \param box Box to test.
+	\param start Start of the line.
+	\param dir Vector from the start to the end of the line.
+	\param outEntry Receives the parameter between 0 and 1.
+	\return True when the line hits the box. */
+	bool getLineEntry(const core::aabbox3df& box, const core::vector3df& start,
+			const core::vector3df& dir, f32& outEntry)
+	{
+		f32 entry = 0.f;
+		f32 exit = 1.f;
+		for (u32 i=0; i<3; ++i)
+		{
+			const f32 s = (&start.X)[i];
+			const f32 d = (&dir.X)[i];
+			const f32 lo = (&box.MinEdge.X)[i];
+			const f32 hi = (&box.MaxEdge.X)[i];
+			if (core::iszero(d))
+			{
+				if (s < lo || s > hi)
+					return false;
+				continue;
+			}
+			f32 t0 = (lo - s) / d;
+			f32 t1 = (hi - s) / d;
+			if (t0 > t1)
+				core::swap(t0, t1);
+			entry = core::max_(entry, t0);
+			exit = core::min_(exit, t1);
+			if (entry > exit)
+				return false;
+		}
+		outEntry = entry;
+		return true;
+	}
+}
+
 //! constructor
 CMetaTriangleSelector::CMetaTriangleSelector()
+	: HierarchyDirty(true)
 {
 	#ifdef _DEBUG
 	setDebugName("CMetaTriangleSelector");
@@ -74,66 +118,403 @@ void CMetaTriangleSelector::getTriangles(core::triangle3df* triangles, s32 array
 		const core::matrix4* transform, bool useNodeTransform, 
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const
 {
+	core::aabbox3df worldBox(box);
+	if (!useNodeTransform || !getWorldQuery(worldBox, transform))
+	{
+		getTrianglesBruteForce(&box, 0, triangles, arraySize, outTriangleCount,
+			transform, useNodeTransform, outTriangleInfo);
+		return;
+	}
+
+	getTrianglesInBox(worldBox, &box, 0, triangles, arraySize, outTriangleCount,
+		transform, outTriangleInfo);
+}
+
+
+//! Gets all triangles which have or may have contact with a 3d line.
+void CMetaTriangleSelector::getTriangles(core::triangle3df* triangles, s32 arraySize,
+		s32& outTriangleCount, const core::line3d<f32>& line,
+		const core::matrix4* transform, bool useNodeTransform, 
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const
+{
+	// the selectors only check the box around the line
+	core::aabbox3df worldBox(line.start);
+	worldBox.addInternalPoint(line.end);
+	if (!useNodeTransform || !getWorldQuery(worldBox, transform))
+	{
+		getTrianglesBruteForce(0, &line, triangles, arraySize, outTriangleCount,
+			transform, useNodeTransform, outTriangleInfo);
+		return;
+	}
+
+	getTrianglesInBox(worldBox, 0, &line, triangles, arraySize, outTriangleCount,
+		transform, outTriangleInfo);
+}
+
+
+//! Gets the triangles which may contain the closest contact with a 3d line.
+void CMetaTriangleSelector::getTrianglesForClosestHit(core::triangle3df* triangles, s32 arraySize,
+		s32& outTriangleCount, const core::line3d<f32>& line,
+		const core::matrix4* transform, bool useNodeTransform,
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const
+{
+	core::matrix4 inverse;
+	if (!useNodeTransform || (transform && !transform->getInverse(inverse)))
+	{
+		getTrianglesBruteForce(0, &line, triangles, arraySize, outTriangleCount,
+			transform, useNodeTransform, outTriangleInfo);
+		return;
+	}
+
+	updateHierarchy();
+
+	core::line3df worldLine(line);
+	if (transform)
+	{
+		inverse.transformVect(worldLine.start);
+		inverse.transformVect(worldLine.end);
+	}
+	const core::vector3df worldDir = worldLine.getVector();
+	const core::vector3df dir = line.getVector();
+
 	s32 outWritten = 0;
-	irr::u32 outTriangleInfoSize = outTriangleInfo ? outTriangleInfo->size() : 0;
-	for (u32 i=0; i<TriangleSelectors.size(); ++i)
+	// line parameter of the closest hit found so far
+	f32 closest = 1.f;
+	core::vector3df hit;
+
+	// selectors which are not in the hierarchy first, their hits allow to
+	// skip more of it
+	for (u32 i=0; i<Dynamic.size() && outWritten<arraySize; ++i)
 	{
-		s32 t = 0;
-		TriangleSelectors[i]->getTriangles(triangles + outWritten,
-				arraySize - outWritten, t, box, transform, useNodeTransform, outTriangleInfo);
+		const s32 first = outWritten;
+		appendTriangles(Dynamic[i], 0, &line, true, triangles, arraySize,
+			outWritten, transform, useNodeTransform, outTriangleInfo);
+		for (s32 t=first; t<outWritten; ++t)
+		{
+			if (triangles[t].getIntersectionWithLimitedLine(line, hit))
+				closest = core::min_(closest, dir.dotProduct(hit - line.start) / dir.getLengthSQ());
+		}
+	}
 
-		if ( outTriangleInfo )
+	// front to back through the hierarchy, skipping boxes behind the closest hit
+	f32 entry;
+	Stack.set_used(0);
+	if (!Nodes.empty() && getLineEntry(Nodes[0].Box, worldLine.start, worldDir, entry))
+		Stack.push_back(0);
+
+	while (!Stack.empty() && outWritten<arraySize)
+	{
+		const u32 index = Stack.getLast();
+		Stack.erase(Stack.size()-1);
+		const SBVHNode& node = Nodes[index];
+
+		if (getLineEntry(node.Box, worldLine.start, worldDir, entry) && entry <= closest)
 		{
-			irr::u32 newTriangleInfoSize = outTriangleInfo->size();
-			for ( u32 ti=outTriangleInfoSize; ti<newTriangleInfoSize; ++ti )
+			if (node.Count)
 			{
-				(*outTriangleInfo)[ti].RangeStart += outWritten;
+				for (u32 c=node.Index; c<node.Index+node.Count && outWritten<arraySize; ++c)
+				{
+					if (!getLineEntry(Children[c].Box, worldLine.start, worldDir, entry) || entry > closest)
+						continue;
+
+					const s32 first = outWritten;
+					appendTriangles(Children[c].Selector, 0, &line, true, triangles, arraySize,
+						outWritten, transform, useNodeTransform, outTriangleInfo);
+					for (s32 t=first; t<outWritten; ++t)
+					{
+						if (triangles[t].getIntersectionWithLimitedLine(line, hit))
+							closest = core::min_(closest, dir.dotProduct(hit - line.start) / dir.getLengthSQ());
+					}
+				}
+			}
+			else
+			{
+				// the node which is closer is visited first
+				const u32 a = index + 1;
+				const u32 b = node.Index;
+				f32 entryA = 2.f;
+				f32 entryB = 2.f;
+				getLineEntry(Nodes[a].Box, worldLine.start, worldDir, entryA);
+				getLineEntry(Nodes[b].Box, worldLine.start, worldDir, entryB);
+				if (entryA <= entryB)
+				{
+					Stack.push_back(b);
+					Stack.push_back(a);
+				}
+				else
+				{
+					Stack.push_back(a);
+					Stack.push_back(b);
+				}
 			}
-			outTriangleInfoSize = newTriangleInfoSize;
 		}
+	}
 
-		outWritten += t;
-		if (outWritten==arraySize)
-			break;
+	outTriangleCount = outWritten;
+}
+
+
+//! Transforms a query box into world space
+bool CMetaTriangleSelector::getWorldQuery(core::aabbox3df& box, const core::matrix4* transform) const
+{
+	if (!transform)
+		return true;
+
+	core::matrix4 inverse;
+	if (!transform->getInverse(inverse))
+		return false;
+	inverse.transformBoxEx(box);
+	return true;
+}
+
+
+//! Appends the triangles of a selector overlapping a box or line
+void CMetaTriangleSelector::appendTriangles(const ITriangleSelector* selector,
+		const core::aabbox3df* box, const core::line3df* line, bool closestHit,
+		core::triangle3df* triangles, s32 arraySize, s32& outWritten,
+		const core::matrix4* transform, bool useNodeTransform,
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const
+{
+	const u32 outTriangleInfoSize = outTriangleInfo ? outTriangleInfo->size() : 0;
+
+	s32 t = 0;
+	if (box)
+		selector->getTriangles(triangles + outWritten, arraySize - outWritten, t,
+			*box, transform, useNodeTransform, outTriangleInfo);
+	else if (closestHit)
+		selector->getTrianglesForClosestHit(triangles + outWritten, arraySize - outWritten, t,
+			*line, transform, useNodeTransform, outTriangleInfo);
+	else
+		selector->getTriangles(triangles + outWritten, arraySize - outWritten, t,
+			*line, transform, useNodeTransform, outTriangleInfo);
+
+	if ( outTriangleInfo )
+	{
+		for ( u32 ti=outTriangleInfoSize; ti<outTriangleInfo->size(); ++ti )
+		{
+			(*outTriangleInfo)[ti].RangeStart += outWritten;
+		}
+	}
+
+	outWritten += t;
+}
+
+
+//! Appends the triangles of all selectors overlapping a box or line
+void CMetaTriangleSelector::getTrianglesBruteForce(const core::aabbox3df* box,
+		const core::line3df* line, core::triangle3df* triangles, s32 arraySize,
+		s32& outTriangleCount, const core::matrix4* transform, bool useNodeTransform,
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const
+{
+	s32 outWritten = 0;
+	for (u32 i=0; i<TriangleSelectors.size() && outWritten<arraySize; ++i)
+	{
+		appendTriangles(TriangleSelectors[i], box, line, false, triangles, arraySize,
+			outWritten, transform, useNodeTransform, outTriangleInfo);
 	}
 
 	outTriangleCount = outWritten;
 }
 
 
-//! Gets all triangles which have or may have contact with a 3d line.
-void CMetaTriangleSelector::getTriangles(core::triangle3df* triangles, s32 arraySize,
-		s32& outTriangleCount, const core::line3d<f32>& line,
-		const core::matrix4* transform, bool useNodeTransform, 
+//! Appends the triangles of the selectors whose boxes overlap a box in world space
+void CMetaTriangleSelector::getTrianglesInBox(const core::aabbox3df& worldBox,
+		const core::aabbox3df* box, const core::line3df* line,
+		core::triangle3df* triangles, s32 arraySize, s32& outTriangleCount,
+		const core::matrix4* transform,
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const
 {
+	updateHierarchy();
+
 	s32 outWritten = 0;
-	irr::u32 outTriangleInfoSize = outTriangleInfo ? outTriangleInfo->size() : 0;
-	for (u32 i=0; i<TriangleSelectors.size(); ++i)
+	for (u32 i=0; i<Dynamic.size() && outWritten<arraySize; ++i)
 	{
-		s32 t = 0;
-		TriangleSelectors[i]->getTriangles(triangles + outWritten,
-				arraySize - outWritten, t, line, transform, useNodeTransform, outTriangleInfo);
+		appendTriangles(Dynamic[i], box, line, false, triangles, arraySize,
+			outWritten, transform, true, outTriangleInfo);
+	}
 
-		if ( outTriangleInfo )
+	Stack.set_used(0);
+	if (!Nodes.empty())
+		Stack.push_back(0);
+
+	while (!Stack.empty() && outWritten<arraySize)
+	{
+		const u32 index = Stack.getLast();
+		Stack.erase(Stack.size()-1);
+		const SBVHNode& node = Nodes[index];
+		if (!node.Box.intersectsWithBox(worldBox))
+			continue;
+
+		if (node.Count)
 		{
-			irr::u32 newTriangleInfoSize = outTriangleInfo->size();
-			for ( u32 ti=outTriangleInfoSize; ti<newTriangleInfoSize; ++ti )
+			for (u32 c=node.Index; c<node.Index+node.Count && outWritten<arraySize; ++c)
 			{
-				(*outTriangleInfo)[ti].RangeStart += outWritten;
+				if (Children[c].Box.intersectsWithBox(worldBox))
+					appendTriangles(Children[c].Selector, box, line, false, triangles, arraySize,
+						outWritten, transform, true, outTriangleInfo);
 			}
-			outTriangleInfoSize = newTriangleInfoSize;
 		}
-
-		outWritten += t;
-		if (outWritten==arraySize)
-			break;
+		else
+		{
+			Stack.push_back(node.Index);
+			Stack.push_back(index+1);
+		}
 	}
 
 	outTriangleCount = outWritten;
 }
 
 
+//! Rebuilds the hierarchy after selectors were added or removed and refits it when nodes moved
+void CMetaTriangleSelector::updateHierarchy() const
+{
+	if (HierarchyDirty)
+	{
+		HierarchyDirty = false;
+		Children.set_used(0);
+		Dynamic.set_used(0);
+		Nodes.set_used(0);
+
+		for (u32 i=0; i<TriangleSelectors.size(); ++i)
+		{
+			const ITriangleSelector* selector = TriangleSelectors[i];
+			const ISceneNode* node = selector->getSceneNodeForTriangle(0);
+			const s32 count = selector->getTriangleCount();
+
+			// Only selectors for nodes whose triangles don't change are
+			// in the hierarchy, nested meta selectors and those of animated
+			// or terrain nodes are always queried.
+			bool fixed = selector->getSelectorCount() == 1 && selector->getSelector(0) == selector;
+			if (fixed && node)
+			{
+				const ESCENE_NODE_TYPE type = node->getType();
+				fixed = type == ESNT_MESH || type == ESNT_OCTREE || type == ESNT_CUBE || type == ESNT_SPHERE;
+			}
+			if (!fixed)
+			{
+				Dynamic.push_back(selector);
+				continue;
+			}
+			if (count <= 0)
+				continue;
+
+			SChild child;
+			child.Selector = selector;
+			child.Node = node;
+			child.Key = 0.f;
+
+			Scratch.set_used(count);
+			s32 written = 0;
+			selector->getTriangles(Scratch.pointer(), count, written, 0, false);
+			child.LocalBox.reset(Scratch[0].pointA);
+			for (s32 t=0; t<written; ++t)
+			{
+				child.LocalBox.addInternalPoint(Scratch[t].pointA);
+				child.LocalBox.addInternalPoint(Scratch[t].pointB);
+				child.LocalBox.addInternalPoint(Scratch[t].pointC);
+			}
+			updateChildBox(child);
+			Children.push_back(child);
+		}
+		Scratch.clear();
+
+		if (!Children.empty())
+			buildNode(0, Children.size());
+		return;
+	}
+
+	bool moved = false;
+	for (u32 i=0; i<Children.size(); ++i)
+	{
+		SChild& child = Children[i];
+		if (child.Node && child.Node->getAbsoluteTransformation() != child.Transform)
+		{
+			updateChildBox(child);
+			moved = true;
+		}
+	}
+	if (!moved)
+		return;
+
+	// inner nodes have larger indices than their parents
+	for (u32 i=Nodes.size(); i>0; --i)
+	{
+		SBVHNode& node = Nodes[i-1];
+		if (node.Count)
+		{
+			node.Box = Children[node.Index].Box;
+			for (u32 c=node.Index+1; c<node.Index+node.Count; ++c)
+				node.Box.addInternalBox(Children[c].Box);
+		}
+		else
+		{
+			node.Box = Nodes[i].Box;
+			node.Box.addInternalBox(Nodes[node.Index].Box);
+		}
+	}
+}
+
+
+//! Builds the hierarchy node for Children[first, first+count), returns its index
+u32 CMetaTriangleSelector::buildNode(u32 first, u32 count) const
+{
+	const u32 index = Nodes.size();
+	Nodes.push_back(SBVHNode());
+
+	core::aabbox3df box(Children[first].Box);
+	core::aabbox3df centers(Children[first].Box.getCenter());
+	for (u32 i=first+1; i<first+count; ++i)
+	{
+		box.addInternalBox(Children[i].Box);
+		centers.addInternalPoint(Children[i].Box.getCenter());
+	}
+
+	if (count <= LEAF_SIZE)
+	{
+		Nodes[index].Box = box;
+		Nodes[index].Index = first;
+		Nodes[index].Count = count;
+		return index;
+	}
+
+	// split at the median of the box centers along the longest axis
+	const core::vector3df extent = centers.getExtent();
+	const u32 axis = (extent.X >= extent.Y && extent.X >= extent.Z) ? 0 : (extent.Y >= extent.Z ? 1 : 2);
+	for (u32 i=first; i<first+count; ++i)
+	{
+		const core::vector3df center = Children[i].Box.getCenter();
+		Children[i].Key = (&center.X)[axis];
+	}
+	core::heapsort(&Children[first], (s32)count);
+
+	const u32 half = count / 2;
+	buildNode(first, half);
+	const u32 second = buildNode(first+half, count-half);
+
+	Nodes[index].Box = box;
+	Nodes[index].Index = second;
+	Nodes[index].Count = 0;
+	return index;
+}
+
+
+//! Transforms the local box of a child by the transformation of its node
+void CMetaTriangleSelector::updateChildBox(SChild& child) const
+{
+	child.Box = child.LocalBox;
+	if (child.Node)
+	{
+		child.Transform = child.Node->getAbsoluteTransformation();
+		child.Transform.transformBoxEx(child.Box);
+	}
+
+	// a little larger, so rounding doesn't miss triangles on the border
+	const core::vector3df pad(child.Box.getExtent() * 0.0001f + core::vector3df(core::ROUNDING_ERROR_f32));
+	child.Box.MinEdge -= pad;
+	child.Box.MaxEdge += pad;
+}
+
+
 //! Adds a triangle selector to the collection of triangle selectors
 //! in this metaTriangleSelector.
 void CMetaTriangleSelector::addTriangleSelector(ITriangleSelector* toAdd)
@@ -143,6 +524,7 @@ void CMetaTriangleSelector::addTriangleSelector(ITriangleSelector* toAdd)
 
 	TriangleSelectors.push_back(toAdd);
 	toAdd->grab();
+	HierarchyDirty = true;
 }
 
 
@@ -155,6 +537,7 @@ bool CMetaTriangleSelector::removeTriangleSelector(ITriangleSelector* toRemove)
 		{
 			TriangleSelectors[i]->drop();
 			TriangleSelectors.erase(i);
+			HierarchyDirty = true;
 			return true;
 		}
 	}
@@ -170,6 +553,7 @@ void CMetaTriangleSelector::removeAllTriangleSelectors()
 		TriangleSelectors[i]->drop();
 
 	TriangleSelectors.clear();
+	HierarchyDirty = true;
 }
 
 
@@ -44,6 +44,12 @@ public:
 		const core::matrix4* transform,	bool useNodeTransform, 
 		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const IRR_OVERRIDE;
 
+	//! Gets the triangles which may contain the closest contact with a 3d line.
+	virtual void getTrianglesForClosestHit(core::triangle3df* triangles, s32 arraySize,
+		s32& outTriangleCount, const core::line3d<f32>& line,
+		const core::matrix4* transform, bool useNodeTransform,
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const IRR_OVERRIDE;
+
 	//! Adds a triangle selector to the collection of triangle selectors
 	//! in this metaTriangleSelector.
 	virtual void addTriangleSelector(ITriangleSelector* toAdd) IRR_OVERRIDE;
@@ -68,7 +74,77 @@ public:
 
 private:
 
+	//! A selector in the hierarchy with its bounds in world space
+	struct SChild
+	{
+		bool operator<(const SChild& other) const
+		{
+			return Key < other.Key;
+		}
+
+		const ITriangleSelector* Selector;
+		//! Node transforming the triangles, the box is updated when it moves
+		const ISceneNode* Node;
+		//! Transformation of the node when the box was computed
+		core::matrix4 Transform;
+		//! Bounds of the triangles without the node transformation
+		core::aabbox3df LocalBox;
+		core::aabbox3df Box;
+		//! Sort key used while building the hierarchy
+		f32 Key;
+	};
+
+	//! Node of the bounding volume hierarchy
+	struct SBVHNode
+	{
+		core::aabbox3df Box;
+		//! First child for leafs, index of the second node for inner nodes
+		u32 Index;
+		//! Number of children for leafs, 0 for inner nodes whose first node follows directly
+		u32 Count;
+	};
+
+	//! Rebuilds the hierarchy after selectors were added or removed and
+	//! refits it when nodes moved
+	void updateHierarchy() const;
+
+	//! Builds the hierarchy node for Children[first, first+count), returns its index
+	u32 buildNode(u32 first, u32 count) const;
+
+	//! Transforms the local box of a child by the transformation of its node
+	void updateChildBox(SChild& child) const;
+
+	//! Transforms a query box or line into world space
+	bool getWorldQuery(core::aabbox3df& box, const core::matrix4* transform) const;
+
+	//! Appends the triangles of a selector overlapping a box or line
+	void appendTriangles(const ITriangleSelector* selector, const core::aabbox3df* box,
+		const core::line3df* line, bool closestHit, core::triangle3df* triangles,
+		s32 arraySize, s32& outWritten, const core::matrix4* transform, bool useNodeTransform,
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const;
+
+	//! Appends the triangles of all selectors overlapping a box or line
+	void getTrianglesBruteForce(const core::aabbox3df* box, const core::line3df* line,
+		core::triangle3df* triangles, s32 arraySize, s32& outTriangleCount,
+		const core::matrix4* transform, bool useNodeTransform,
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const;
+
+	//! Appends the triangles of the selectors whose boxes overlap a box in world space
+	void getTrianglesInBox(const core::aabbox3df& worldBox, const core::aabbox3df* box,
+		const core::line3df* line, core::triangle3df* triangles, s32 arraySize,
+		s32& outTriangleCount, const core::matrix4* transform,
+		irr::core::array<SCollisionTriangleRange>* outTriangleInfo) const;
+
 	core::array<ITriangleSelector*> TriangleSelectors;
+
+	// Bounding volume hierarchy over the selectors of nodes with fixed
+	// triangles, those of other nodes are queried always.
+	mutable core::array<SChild> Children;
+	mutable core::array<SBVHNode> Nodes;
+	mutable core::array<const ITriangleSelector*> Dynamic;
+	mutable core::array<u32> Stack;
+	mutable core::array<core::triangle3df> Scratch;
+	mutable bool HierarchyDirty;
 };
 
 } // end namespace scene
@@ -321,6 +321,7 @@ void CNullDriver::deleteAllTextures()
 bool CNullDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clearDepth, u8 clearStencil, const SExposedVideoData& videoData, core::rect<s32>* sourceRect)
 {
 	PrimitivesDrawn = 0;
+	FrameStats.reset();
 	return true;
 }
 
@@ -329,6 +330,7 @@ bool CNullDriver::endScene()
 	FPSCounter.registerFrame(os::Timer::getRealTime(), PrimitivesDrawn);
 	updateAllHardwareBuffers();
 	updateAllOcclusionQueries();
+	LastFrameStats = FrameStats;
 	return true;
 }
 
@@ -370,6 +372,7 @@ const core::matrix4& CNullDriver::getTransform(E_TRANSFORMATION_STATE state) con
 //! sets a material
 void CNullDriver::setMaterial(const SMaterial& material)
 {
+	++FrameStats.MaterialChanges;
 }
 
 
@@ -788,6 +791,8 @@ void CNullDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 	if ((iType==EIT_16BIT) && (vertexCount>65536))
 		os::Printer::log("Too many vertices for 16bit index type, render artifacts may occur.");
 	PrimitivesDrawn += primitiveCount;
+	++FrameStats.DrawCalls;
+	FrameStats.Primitives += primitiveCount;
 }
 
 
@@ -797,6 +802,8 @@ void CNullDriver::draw2DVertexPrimitiveList(const void* vertices, u32 vertexCoun
 	if ((iType==EIT_16BIT) && (vertexCount>65536))
 		os::Printer::log("Too many vertices for 16bit index type, render artifacts may occur.");
 	PrimitivesDrawn += primitiveCount;
+	++FrameStats.DrawCalls;
+	FrameStats.Primitives += primitiveCount;
 }
 
 
@@ -883,6 +890,8 @@ void CNullDriver::draw2DImageBatch(const video::ITexture* texture,
 {
 	core::position2d<s32> target(pos);
 
+	++FrameStats.Draw2DBatches;
+
 	for (u32 i=0; i<indices.size(); ++i)
 	{
 		draw2DImage(texture, target, sourceRects[indices[i]],
@@ -903,6 +912,8 @@ void CNullDriver::draw2DImageBatch(const video::ITexture* texture,
 {
 	const irr::u32 drawCount = core::min_<u32>(positions.size(), sourceRects.size());
 
+	++FrameStats.Draw2DBatches;
+
 	for (u32 i=0; i<drawCount; ++i)
 	{
 		draw2DImage(texture, positions[i], sourceRects[i],
@@ -929,6 +940,7 @@ void CNullDriver::draw2DImage(const video::ITexture* texture, const core::positi
 				const core::rect<s32>* clipRect, SColor color,
 				bool useAlphaChannelOfTexture)
 {
+	++FrameStats.DrawCalls;
 }
 
 
@@ -1044,6 +1056,21 @@ u32 CNullDriver::getPrimitiveCountDrawn( u32 param ) const
 }
 
 
+//! Returns counters describing the cost of a frame.
+const SFrameStats& CNullDriver::getFrameStats(bool currentFrame) const
+{
+	return currentFrame ? FrameStats : LastFrameStats;
+}
+
+
+//! Counts a mesh drawn with a level of detail in the counters of the frame.
+void CNullDriver::countLODLevel(u32 level, u32 primitivesSaved)
+{
+	++FrameStats.LODLevels[core::min_(level, FRAME_STATS_MAX_LOD_LEVELS-1)];
+	FrameStats.LODPrimitivesSaved += primitivesSaved;
+}
+
+
 
 //! Sets the dynamic ambient light color. The default color is
 //! (0,0,0,0) which means it is dark.
@@ -1690,6 +1717,18 @@ IImage* CNullDriver::createImage(IImage* imageToCopy, const core::position2d<s32
 }
 
 
+//! Creates a software image by resampling another image.
+IImage* CNullDriver::createImage(IImage* imageToScale, const core::dimension2d<u32>& size, E_RESAMPLE_FILTER filter)
+{
+	if (!imageToScale || !CColorConverter::canConvertFormat(imageToScale->getColorFormat(), ECF_A8R8G8B8))
+		return 0;
+
+	IImage* image = new CImage(imageToScale->getColorFormat(), size);
+	imageToScale->copyToScalingFiltered(image, filter);
+	return image;
+}
+
+
 //! Creates a software image from part of a texture.
 IImage* CNullDriver::createImage(ITexture* texture, const core::position2d<s32>& pos, const core::dimension2d<u32>& size)
 {
@@ -1773,6 +1812,61 @@ void CNullDriver::drawMeshBuffer(const scene::IMeshBuffer* mb)
 }
 
 
+//! Draws copies of a mesh buffer with one call
+void CNullDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+	const core::matrix4* transforms, u32 instanceCount, const SColor* colors)
+{
+	if (!mb || !transforms || !instanceCount)
+		return;
+
+	const u32 primitiveCount = mb->getPrimitiveCount() * instanceCount;
+	PrimitivesDrawn += primitiveCount;
+	++FrameStats.DrawCalls;
+	FrameStats.Primitives += primitiveCount;
+	FrameStats.Instances += instanceCount;
+}
+
+
+//! Draws the instances of drawMeshBufferInstanced with one drawMeshBuffer call each
+void CNullDriver::drawInstancesOneByOne(const scene::IMeshBuffer* mb,
+	const core::matrix4* transforms, u32 instanceCount, const SColor* colors)
+{
+	if (!mb || !transforms || !instanceCount)
+		return;
+
+	const core::matrix4 world = getTransform(ETS_WORLD);
+	const u32 pitch = getVertexPitchFromType(mb->getVertexType());
+	const u32 vertexCount = mb->getVertexCount();
+
+	for (u32 i=0; i<instanceCount; ++i)
+	{
+		setTransform(ETS_WORLD, transforms[i]);
+
+		if (!colors || colors[i].color == 0xffffffff)
+		{
+			drawMeshBuffer(mb);
+			continue;
+		}
+
+		// all vertex types start with a S3DVertex
+		InstanceVertices.set_used(vertexCount * pitch);
+		memcpy(InstanceVertices.pointer(), mb->getVertices(), vertexCount * pitch);
+		const SColor& c = colors[i];
+		for (u32 v=0; v<vertexCount; ++v)
+		{
+			SColor& vc = reinterpret_cast<S3DVertex*>(InstanceVertices.pointer() + v * pitch)->Color;
+			vc.set(vc.getAlpha() * c.getAlpha() / 255, vc.getRed() * c.getRed() / 255,
+				vc.getGreen() * c.getGreen() / 255, vc.getBlue() * c.getBlue() / 255);
+		}
+		drawVertexPrimitiveList(InstanceVertices.const_pointer(), vertexCount, mb->getIndices(),
+			mb->getPrimitiveCount(), mb->getVertexType(), mb->getPrimitiveType(), mb->getIndexType());
+	}
+
+	setTransform(ETS_WORLD, world);
+	FrameStats.Instances += instanceCount;
+}
+
+
 //! Draws the normals of a mesh buffer
 void CNullDriver::drawMeshBufferNormals(const scene::IMeshBuffer* mb, f32 length, SColor color)
 {
@@ -1797,31 +1891,58 @@ CNullDriver::SHWBufferLink *CNullDriver::getBufferLink(const scene::IMeshBuffer*
 		return 0;
 
 	//search for hardware links
-	core::map< const scene::IMeshBuffer*,SHWBufferLink* >::Node* node = HWBufferMap.find(mb);
-	if (node)
-		return node->getValue();
+	SHWBufferLink* link = findHardwareBuffer(mb);
+	if (link)
+		return link;
 
 	return createHardwareBuffer(mb); //no hardware links, and mesh wants one, create it
 }
 
 
+//! Adds a link created by createHardwareBuffer to HWBufferLinks
+void CNullDriver::registerHardwareBuffer(SHWBufferLink *HWBuffer)
+{
+	HWBuffer->Index = HWBufferLinks.size();
+	HWBufferLinks.push_back(HWBuffer);
+	HWBuffer->MeshBuffer->setHWBufferHandle(HWBuffer->Index);
+}
+
+
+//! Returns the hardware buffer link of a meshbuffer, or 0
+CNullDriver::SHWBufferLink *CNullDriver::findHardwareBuffer(const scene::IMeshBuffer* mb) const
+{
+	if (!mb)
+		return 0;
+
+	const u32 handle = mb->getHWBufferHandle();
+	if (handle < HWBufferLinks.size() && HWBufferLinks[handle]->MeshBuffer == mb)
+		return HWBufferLinks[handle];
+
+	// the handle belongs to the links of another driver, which may also have
+	// reset it, or to a copied meshbuffer
+	for (u32 i=0; i<HWBufferLinks.size(); ++i)
+	{
+		if (HWBufferLinks[i]->MeshBuffer == mb)
+		{
+			mb->setHWBufferHandle(i);
+			return HWBufferLinks[i];
+		}
+	}
+	return 0;
+}
+
+
 //! Update all hardware buffers, remove unused ones
 void CNullDriver::updateAllHardwareBuffers()
 {
-	core::map<const scene::IMeshBuffer*,SHWBufferLink*>::ParentFirstIterator Iterator=HWBufferMap.getParentFirstIterator();
-
-	for (;!Iterator.atEnd();Iterator++)
+	// backwards, deleting moves the last link into the gap
+	for (s32 i=HWBufferLinks.size()-1; i>=0; --i)
 	{
-		SHWBufferLink *Link=Iterator.getNode()->getValue();
+		SHWBufferLink *Link=HWBufferLinks[i];
 
 		Link->LastUsed++;
 		if (Link->LastUsed>20000 || Link->MeshBuffer->getReferenceCount() == 1)
-		{
 			deleteHardwareBuffer(Link);
-
-			// todo: needs better fix
-			Iterator = HWBufferMap.getParentFirstIterator();
-		}
 	}
 }
 
@@ -1830,7 +1951,24 @@ void CNullDriver::deleteHardwareBuffer(SHWBufferLink *HWBuffer)
 {
 	if (!HWBuffer)
 		return;
-	HWBufferMap.remove(HWBuffer->MeshBuffer);
+
+	const u32 index = HWBuffer->Index;
+	if (index < HWBufferLinks.size() && HWBufferLinks[index] == HWBuffer)
+	{
+		if (HWBuffer->MeshBuffer->getHWBufferHandle() == index)
+			HWBuffer->MeshBuffer->setHWBufferHandle(0xffffffff);
+
+		// move the last link into the gap
+		const u32 last = HWBufferLinks.size()-1;
+		if (index != last)
+		{
+			HWBufferLinks[index] = HWBufferLinks[last];
+			HWBufferLinks[index]->Index = index;
+			if (HWBufferLinks[index]->MeshBuffer->getHWBufferHandle() == last)
+				HWBufferLinks[index]->MeshBuffer->setHWBufferHandle(index);
+		}
+		HWBufferLinks.erase(last);
+	}
 	delete HWBuffer;
 }
 
@@ -1838,17 +1976,15 @@ void CNullDriver::deleteHardwareBuffer(SHWBufferLink *HWBuffer)
 //! Remove hardware buffer
 void CNullDriver::removeHardwareBuffer(const scene::IMeshBuffer* mb)
 {
-	core::map<const scene::IMeshBuffer*,SHWBufferLink*>::Node* node = HWBufferMap.find(mb);
-	if (node)
-		deleteHardwareBuffer(node->getValue());
+	deleteHardwareBuffer(findHardwareBuffer(mb));
 }
 
 
 //! Remove all hardware buffers
 void CNullDriver::removeAllHardwareBuffers()
 {
-	while (HWBufferMap.size())
-		deleteHardwareBuffer(HWBufferMap.getRoot()->getValue());
+	while (HWBufferLinks.size())
+		deleteHardwareBuffer(HWBufferLinks.getLast());
 }
 
 
@@ -1883,7 +2019,7 @@ void CNullDriver::addOcclusionQuery(scene::ISceneNode* node, const scene::IMesh*
 	}
 
 	//search for query
-	s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	s32 index = findOcclusionQuery(node);
 	if (index != -1)
 	{
 		if (OcclusionQueries[index].Mesh != mesh)
@@ -1895,6 +2031,7 @@ void CNullDriver::addOcclusionQuery(scene::ISceneNode* node, const scene::IMesh*
 	}
 	else
 	{
+		node->setOcclusionQueryHandle(OcclusionQueries.size());
 		OcclusionQueries.push_back(SOccQuery(node, mesh));
 		node->setAutomaticCulling(node->getAutomaticCulling() | scene::EAC_OCC_QUERY);
 	}
@@ -1905,11 +2042,20 @@ void CNullDriver::addOcclusionQuery(scene::ISceneNode* node, const scene::IMesh*
 void CNullDriver::removeOcclusionQuery(scene::ISceneNode* node)
 {
 	//search for query
-	s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	s32 index = findOcclusionQuery(node);
 	if (index != -1)
 	{
 		node->setAutomaticCulling(node->getAutomaticCulling() & ~scene::EAC_OCC_QUERY);
-		OcclusionQueries.erase(index);
+		node->setOcclusionQueryHandle(0xffffffff);
+
+		// move the last query into the gap
+		const u32 last = OcclusionQueries.size()-1;
+		if ((u32)index != last)
+		{
+			OcclusionQueries[index] = OcclusionQueries[last];
+			OcclusionQueries[index].Node->setOcclusionQueryHandle(index);
+		}
+		OcclusionQueries.erase(last);
 	}
 }
 
@@ -1924,35 +2070,65 @@ void CNullDriver::removeAllOcclusionQueries()
 }
 
 
+//! Returns the index of the query of a node, or -1
+s32 CNullDriver::findOcclusionQuery(const scene::ISceneNode* node) const
+{
+	if (!node)
+		return -1;
+
+	const u32 handle = node->getOcclusionQueryHandle();
+	if (handle < OcclusionQueries.size() && OcclusionQueries[handle].Node == node)
+		return (s32)handle;
+
+	// the handle belongs to the queries of another driver
+	if (handle != 0xffffffff)
+		return OcclusionQueries.linear_search(node);
+	return -1;
+}
+
+
+//! Draws the mesh of a query, the material is already set for invisible queries
+void CNullDriver::runOcclusionQueryAt(u32 index, bool visible)
+{
+	SOccQuery& query = OcclusionQueries[index];
+	query.Run=0;
+	beginOcclusionQuery(query);
+	setTransform(video::ETS_WORLD, query.Node->getAbsoluteTransformation());
+	const scene::IMesh* mesh = query.Mesh;
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		if (visible)
+			setMaterial(mesh->getMeshBuffer(i)->getMaterial());
+		drawMeshBuffer(mesh->getMeshBuffer(i));
+	}
+	endOcclusionQuery(query);
+}
+
+
+//! Material for occlusion queries which are not rendered visible
+static SMaterial invisibleQueryMaterial()
+{
+	SMaterial mat;
+	mat.Lighting=false;
+	mat.AntiAliasing=0;
+	mat.ColorMask=ECP_NONE;
+	mat.GouraudShading=false;
+	mat.ZWriteEnable=EZW_OFF;
+	return mat;
+}
+
+
 //! Run occlusion query. Draws mesh stored in query.
 /** If the mesh shall be rendered visible, use
 flag to enable the proper material setting. */
 void CNullDriver::runOcclusionQuery(scene::ISceneNode* node, bool visible)
 {
-	if(!node)
-		return;
-	s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	const s32 index = findOcclusionQuery(node);
 	if (index==-1)
 		return;
-	OcclusionQueries[index].Run=0;
 	if (!visible)
-	{
-		SMaterial mat;
-		mat.Lighting=false;
-		mat.AntiAliasing=0;
-		mat.ColorMask=ECP_NONE;
-		mat.GouraudShading=false;
-		mat.ZWriteEnable=EZW_OFF;
-		setMaterial(mat);
-	}
-	setTransform(video::ETS_WORLD, node->getAbsoluteTransformation());
-	const scene::IMesh* mesh = OcclusionQueries[index].Mesh;
-	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
-	{
-		if (visible)
-			setMaterial(mesh->getMeshBuffer(i)->getMaterial());
-		drawMeshBuffer(mesh->getMeshBuffer(i));
-	}
+		setMaterial(invisibleQueryMaterial());
+	runOcclusionQueryAt(index, visible);
 }
 
 
@@ -1961,8 +2137,13 @@ void CNullDriver::runOcclusionQuery(scene::ISceneNode* node, bool visible)
 overrideMaterial to disable the color and depth buffer. */
 void CNullDriver::runAllOcclusionQueries(bool visible)
 {
+	if (OcclusionQueries.empty())
+		return;
+	// same material for all invisible queries
+	if (!visible)
+		setMaterial(invisibleQueryMaterial());
 	for (u32 i=0; i<OcclusionQueries.size(); ++i)
-		runOcclusionQuery(OcclusionQueries[i].Node, visible);
+		runOcclusionQueryAt(i, visible);
 }
 
 
@@ -1971,6 +2152,11 @@ void CNullDriver::runAllOcclusionQueries(bool visible)
 Update might not occur in this case, though */
 void CNullDriver::updateOcclusionQuery(scene::ISceneNode* node, bool block)
 {
+	const s32 index = findOcclusionQuery(node);
+	// not yet started
+	if (index==-1 || OcclusionQueries[index].Run==u32(~0))
+		return;
+	fetchOcclusionQueryResult(OcclusionQueries[index], block);
 }
 
 
@@ -1979,14 +2165,17 @@ void CNullDriver::updateOcclusionQuery(scene::ISceneNode* node, bool block)
 Update might not occur in this case, though */
 void CNullDriver::updateAllOcclusionQueries(bool block)
 {
-	for (u32 i=0; i<OcclusionQueries.size(); ++i)
+	// backwards, removed queries are replaced by the last one
+	for (u32 i=OcclusionQueries.size(); i>0; )
 	{
-		if (OcclusionQueries[i].Run==u32(~0))
+		--i;
+		SOccQuery& query = OcclusionQueries[i];
+		if (query.Run==u32(~0))
 			continue;
-		updateOcclusionQuery(OcclusionQueries[i].Node, block);
-		++OcclusionQueries[i].Run;
-		if (OcclusionQueries[i].Run>1000)
-			removeOcclusionQuery(OcclusionQueries[i].Node);
+		fetchOcclusionQueryResult(query, block);
+		++query.Run;
+		if (query.Run>1000)
+			removeOcclusionQuery(query.Node);
 	}
 }
 
@@ -1997,7 +2186,8 @@ The value is a safe approximation, i.e. can be larger then the
 actual value of pixels. */
 u32 CNullDriver::getOcclusionQueryResult(const scene::ISceneNode* node) const
 {
-	return ~0;
+	const s32 index = findOcclusionQuery(node);
+	return index < 0 ? ~0 : OcclusionQueries[index].Result;
 }
 
 
@@ -241,7 +241,7 @@ namespace video
 		virtual const core::dimension2d<u32>& getScreenSize() const IRR_OVERRIDE;
 
 		//! get current render target
-		IRenderTarget* getCurrentRenderTarget() const;
+		virtual IRenderTarget* getCurrentRenderTarget() const IRR_OVERRIDE;
 
 		//! get render target size
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const IRR_OVERRIDE;
@@ -253,6 +253,16 @@ namespace video
 		//! very useful method for statistics.
 		virtual u32 getPrimitiveCountDrawn( u32 param = 0 ) const IRR_OVERRIDE;
 
+		//! Returns counters describing the cost of a frame.
+		virtual const SFrameStats& getFrameStats(bool currentFrame=false) const IRR_OVERRIDE;
+
+		//! Counts a mesh drawn with a level of detail in the counters of the frame.
+		virtual void countLODLevel(u32 level, u32 primitivesSaved) IRR_OVERRIDE;
+
+		//! Only used by the engine internally.
+		/** Counters of the frame currently rendered, for helpers of the drivers. */
+		SFrameStats& getCurrentFrameStats() { return FrameStats; }
+
 		//! deletes all dynamic lights there are
 		virtual void deleteAllDynamicLights() IRR_OVERRIDE;
 
@@ -370,6 +380,10 @@ namespace video
 				const core::position2d<s32>& pos,
 				const core::dimension2d<u32>& size) IRR_OVERRIDE;
 
+		//! Creates a software image by resampling another image.
+		virtual IImage* createImage(IImage* imageToScale, const core::dimension2d<u32>& size,
+				E_RESAMPLE_FILTER filter) IRR_OVERRIDE;
+
 		//! Creates a software image from part of a texture.
 		virtual IImage* createImage(ITexture* texture,
 				const core::position2d<s32>& pos,
@@ -378,6 +392,11 @@ namespace video
 		//! Draws a mesh buffer
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb) IRR_OVERRIDE;
 
+		//! Draws copies of a mesh buffer with one call
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const core::matrix4* transforms, u32 instanceCount,
+			const SColor* colors=0) IRR_OVERRIDE;
+
 		//! Draws the normals of a mesh buffer
 		virtual void drawMeshBufferNormals(const scene::IMeshBuffer* mb, f32 length=10.f,
 			SColor color=0xffffffff) IRR_OVERRIDE;
@@ -393,7 +412,7 @@ namespace video
 		{
 			SHWBufferLink(const scene::IMeshBuffer *_MeshBuffer)
 				:MeshBuffer(_MeshBuffer),
-				ChangedID_Vertex(0),ChangedID_Index(0),LastUsed(0),
+				ChangedID_Vertex(0),ChangedID_Index(0),LastUsed(0),Index(0xffffffff),
 				Mapped_Vertex(scene::EHM_NEVER),Mapped_Index(scene::EHM_NEVER)
 			{
 				if (MeshBuffer)
@@ -410,6 +429,8 @@ namespace video
 			u32 ChangedID_Vertex;
 			u32 ChangedID_Index;
 			u32 LastUsed;
+			//! Position in HWBufferLinks
+			u32 Index;
 			scene::E_HARDWARE_MAPPING Mapped_Vertex;
 			scene::E_HARDWARE_MAPPING Mapped_Index;
 		};
@@ -429,6 +450,21 @@ namespace video
 		//! Create hardware buffer from mesh (only some drivers can)
 		virtual SHWBufferLink *createHardwareBuffer(const scene::IMeshBuffer* mb) {return 0;}
 
+		//! Adds a link created by createHardwareBuffer to HWBufferLinks
+		void registerHardwareBuffer(SHWBufferLink *HWBuffer);
+
+		//! Returns the hardware buffer link of a meshbuffer, or 0
+		SHWBufferLink *findHardwareBuffer(const scene::IMeshBuffer* mb) const;
+
+		//! Draws the instances of drawMeshBufferInstanced with one drawMeshBuffer call each
+		/** For drivers which can't draw instances at once. Colored instances
+		are drawn from a copy of the vertices. */
+		void drawInstancesOneByOne(const scene::IMeshBuffer* mb,
+			const core::matrix4* transforms, u32 instanceCount, const SColor* colors);
+
+		//! Vertices of colored instances in drawInstancesOneByOne
+		core::array<u8> InstanceVertices;
+
 	public:
 		//! Remove hardware buffer
 		virtual void removeHardwareBuffer(const scene::IMeshBuffer* mb) IRR_OVERRIDE;
@@ -791,7 +827,7 @@ namespace video
 
 		struct SOccQuery
 		{
-			SOccQuery(scene::ISceneNode* node, const scene::IMesh* mesh=0) : Node(node), Mesh(mesh), PID(0), Result(0xffffffff), Run(0xffffffff)
+			SOccQuery(scene::ISceneNode* node, const scene::IMesh* mesh=0) : Node(node), Mesh(mesh), PID(0), Result(0xffffffff), PendingResult(0xffffffff), Run(0xffffffff)
 			{
 				if (Node)
 					Node->grab();
@@ -799,7 +835,7 @@ namespace video
 					Mesh->grab();
 			}
 
-			SOccQuery(const SOccQuery& other) : Node(other.Node), Mesh(other.Mesh), PID(other.PID), Result(other.Result), Run(other.Run)
+			SOccQuery(const SOccQuery& other) : Node(other.Node), Mesh(other.Mesh), PID(other.PID), Result(other.Result), PendingResult(other.PendingResult), Run(other.Run)
 			{
 				if (Node)
 					Node->grab();
@@ -817,15 +853,20 @@ namespace video
 
 			SOccQuery& operator=(const SOccQuery& other)
 			{
+				if (other.Node)
+					other.Node->grab();
+				if (other.Mesh)
+					other.Mesh->grab();
+				if (Node)
+					Node->drop();
+				if (Mesh)
+					Mesh->drop();
 				Node=other.Node;
 				Mesh=other.Mesh;
 				PID=other.PID;
 				Result=other.Result;
+				PendingResult=other.PendingResult;
 				Run=other.Run;
-				if (Node)
-					Node->grab();
-				if (Mesh)
-					Mesh->grab();
 				return *this;
 			}
 
@@ -847,10 +888,28 @@ namespace video
 				unsigned int UID;
 			};
 			u32 Result;
+			//! Result of the last run until it is fetched, for drivers counting the samples themselves
+			u32 PendingResult;
 			u32 Run;
 		};
+		//! Queries are kept packed, each node stores the index of its query
 		core::array<SOccQuery> OcclusionQueries;
 
+		//! Returns the index of the query of a node, or -1
+		s32 findOcclusionQuery(const scene::ISceneNode* node) const;
+
+		//! Draws the mesh of a query, the material is already set for invisible queries
+		void runOcclusionQueryAt(u32 index, bool visible);
+
+		//! Called before the mesh of a query is drawn
+		virtual void beginOcclusionQuery(SOccQuery& query) {}
+
+		//! Called after the mesh of a query is drawn
+		virtual void endOcclusionQuery(SOccQuery& query) {}
+
+		//! Retrieves the result of a query which has been run
+		virtual void fetchOcclusionQueryResult(SOccQuery& query, bool block) {}
+
 		core::array<IRenderTarget*> RenderTargets;
 
 		// Shared objects used with simplified IVideoDriver::setRenderTarget method with ITexture* param.
@@ -865,8 +924,8 @@ namespace video
 		core::array<SLight> Lights;
 		core::array<SMaterialRenderer> MaterialRenderers;
 
-		//core::array<SHWBufferLink*> HWBufferLinks;
-		core::map< const scene::IMeshBuffer* , SHWBufferLink* > HWBufferMap;
+		//! Links are kept packed, each meshbuffer stores the index of its link
+		core::array<SHWBufferLink*> HWBufferLinks;
 
 		io::IFileSystem* FileSystem;
 
@@ -880,6 +939,11 @@ namespace video
 		CFPSCounter FPSCounter;
 
 		u32 PrimitivesDrawn;
+
+		//! Counters of the frame in progress and of the last completed frame
+		SFrameStats FrameStats;
+		SFrameStats LastFrameStats;
+
 		u32 MinVertexCountForVBO;
 
 		u32 TextureCreationFlags;
@@ -212,7 +212,6 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 
 		case 'f':               // face
 		{
-			c8 vertexWord[WORD_BUFFER_LENGTH]; // for retrieving vertex data
 			video::S3DVertex v;
 			// Assign vertex color from currently active material's diffuse color
 			if (mtlChanged)
@@ -230,15 +229,15 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 			// get all vertices data in this face (current line of obj file)
 			IVertexBuffer& mbVertexBuffer = currMtl->Meshbuffer->getVertexBuffer();
 			IIndexBuffer& mbIndexBuffer = currMtl->Meshbuffer->getIndexBuffer();
-			const core::stringc wordBuffer = copyLine(bufPtr, bufEnd);
-			const c8* linePtr = wordBuffer.c_str();
-			const c8* const endPtr = linePtr+wordBuffer.size();
+			const c8* endPtr = bufPtr;
+			while (endPtr != bufEnd && *endPtr != '\n' && *endPtr != '\r')
+				++endPtr;
 
 			faceCorners.set_used(0); // fast clear
 
 			// read in all vertices
-			linePtr = goNextWord(linePtr, endPtr);
-			while (0 != linePtr[0])
+			const c8* linePtr = goNextWord(bufPtr, endPtr);
+			while (linePtr != endPtr)
 			{
 				// Array to communicate with retrieveVertexIndices()
 				// sends the buffer sizes and gets the actual indices
@@ -247,14 +246,16 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 				Idx[0] = Idx[1] = Idx[2] = -1;
 
 				// read in next vertex's data
-				u32 wlength = copyWord(vertexWord, linePtr, WORD_BUFFER_LENGTH, endPtr);
+				const c8* wordEnd = linePtr;
+				while (wordEnd != endPtr && !core::isspace(*wordEnd))
+					++wordEnd;
 				// this function will also convert obj's 1-based index to c++'s 0-based index
-				retrieveVertexIndices(vertexWord, Idx, vertexWord+wlength+1, vertexBuffer.size(), textureCoordBuffer.size(), normalsBuffer.size());
+				retrieveVertexIndices(linePtr, Idx, wordEnd, vertexBuffer.size(), textureCoordBuffer.size(), normalsBuffer.size());
 				if ( Idx[0] >= 0 && Idx[0] < (irr::s32)vertexBuffer.size() )
 					v.Pos = vertexBuffer[Idx[0]];
 				else
 				{
-					os::Printer::log("Invalid vertex index in this line", wordBuffer.c_str(), ELL_ERROR);
+					os::Printer::log("Invalid vertex index in this line", copyLine(bufPtr, bufEnd).c_str(), ELL_ERROR);
 					delete [] buf;
 					cleanUp();
 					return 0;
@@ -271,23 +272,18 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 					currMtl->RecalculateNormals=true;
 				}
 
-				int vertLocation;
-				core::map<video::S3DVertex, int>::Node* n = currMtl->VertMap.find(v);
-				if (n)
-				{
-					vertLocation = n->getValue();
-				}
-				else
+				// the color is the same for all vertices of a material, so the indices identify the vertex
+				int vertLocation = currMtl->VertMap.findOrInsert(Idx, (s32)mbVertexBuffer.size());
+				if (vertLocation < 0)
 				{
 					mbVertexBuffer.push_back(v);
 					vertLocation = mbVertexBuffer.size() -1;
-					currMtl->VertMap.insert(v, vertLocation);
 				}
 
 				faceCorners.push_back(vertLocation);
 
 				// go to next vertex
-				linePtr = goNextWord(linePtr, endPtr);
+				linePtr = goFirstWord(wordEnd, endPtr);
 			}
 
 			// triangulate the face
@@ -313,7 +309,7 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 			}
 			else
 			{
-				os::Printer::log("Too few vertices in this line", wordBuffer.c_str());
+				os::Printer::log("Too few vertices in this line", copyLine(bufPtr, bufEnd).c_str());
 			}
 		}
 		break;
@@ -750,17 +746,16 @@ const c8* COBJMeshFileLoader::readColor(const c8* bufPtr, video::SColor& color,
 
 
 //! Read 3d vector of floats
+/** The numbers are converted in place, fast_atof stops at the space after
+each word and the file buffer is null-terminated. */
 const c8* COBJMeshFileLoader::readVec3(const c8* bufPtr, core::vector3df& vec, const c8* const bufEnd)
 {
-	const u32 WORD_BUFFER_LENGTH = 256;
-	c8 wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.X=-core::fast_atof(wordBuffer); // change handedness
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Y=core::fast_atof(wordBuffer);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Z=core::fast_atof(wordBuffer);
+	bufPtr = goNextWord(bufPtr, bufEnd, false);
+	vec.X=-core::fast_atof(bufPtr); // change handedness
+	bufPtr = goNextWord(bufPtr, bufEnd, false);
+	vec.Y=core::fast_atof(bufPtr);
+	bufPtr = goNextWord(bufPtr, bufEnd, false);
+	vec.Z=core::fast_atof(bufPtr);
 	return bufPtr;
 }
 
@@ -768,13 +763,10 @@ const c8* COBJMeshFileLoader::readVec3(const c8* bufPtr, core::vector3df& vec, c
 //! Read 2d vector of floats
 const c8* COBJMeshFileLoader::readUV(const c8* bufPtr, core::vector2df& vec, const c8* const bufEnd)
 {
-	const u32 WORD_BUFFER_LENGTH = 256;
-	c8 wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.X=core::fast_atof(wordBuffer);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Y=1-core::fast_atof(wordBuffer); // change handedness
+	bufPtr = goNextWord(bufPtr, bufEnd, false);
+	vec.X=core::fast_atof(bufPtr);
+	bufPtr = goNextWord(bufPtr, bufEnd, false);
+	vec.Y=1-core::fast_atof(bufPtr); // change handedness
 	return bufPtr;
 }
 
@@ -916,21 +908,23 @@ const c8* COBJMeshFileLoader::goAndCopyNextWord(c8* outBuf, const c8* inBuf, u32
 }
 
 
-bool COBJMeshFileLoader::retrieveVertexIndices(c8* vertexData, s32* idx, const c8* bufEnd, u32 vbsize, u32 vtsize, u32 vnsize)
+bool COBJMeshFileLoader::retrieveVertexIndices(const c8* vertexData, s32* idx, const c8* bufEnd, u32 vbsize, u32 vtsize, u32 vnsize)
 {
 	c8 word[16] = "";
 	const c8* p = goFirstWord(vertexData, bufEnd);
 	u32 idxType = 0;	// 0 = posIdx, 1 = texcoordIdx, 2 = normalIdx
 
 	u32 i = 0;
-	while ( p != bufEnd )
+	while ( true )
 	{
-		if ( ( core::isdigit(*p)) || (*p == '-') )
+		const bool end = ( p == bufEnd ) || ( *p == ' ' ) || ( *p == '\0' );
+		if ( !end && ( ( core::isdigit(*p)) || (*p == '-') ) )
 		{
 			// build up the number
-			word[i++] = *p;
+			if ( i < sizeof(word) - 1 )
+				word[i++] = *p;
 		}
-		else if ( *p == '/' || *p == ' ' || *p == '\0' )
+		else if ( end || *p == '/' )
 		{
 			// number is completed. Convert and store it
 			word[i] = '\0';
@@ -959,7 +953,7 @@ bool COBJMeshFileLoader::retrieveVertexIndices(c8* vertexData, s32* idx, const c
 			i = 0;
 
 			// go to the next kind of index type
-			if (*p == '/')
+			if (!end)
 			{
 				if ( ++idxType > 2 )
 				{
@@ -985,6 +979,50 @@ bool COBJMeshFileLoader::retrieveVertexIndices(c8* vertexData, s32* idx, const c
 }
 
 
+s32 COBJMeshFileLoader::SVertexHash::findOrInsert(const s32* idx, s32 newVertex)
+{
+	if ((Count + 1) * 2 > Slots.size())
+		grow();
+
+	const u32 mask = Slots.size() - 1;
+	for (u32 slot = slotOf(idx); ; slot = (slot + 1) & mask)
+	{
+		const s32 vertex = Slots[slot];
+		if (vertex < 0)
+		{
+			Slots[slot] = newVertex;
+			Keys.push_back(idx[0]);
+			Keys.push_back(idx[1]);
+			Keys.push_back(idx[2]);
+			++Count;
+			return -1;
+		}
+
+		const s32* key = &Keys[vertex * 3];
+		if (key[0] == idx[0] && key[1] == idx[1] && key[2] == idx[2])
+			return vertex;
+	}
+}
+
+
+void COBJMeshFileLoader::SVertexHash::grow()
+{
+	const u32 size = core::max_(Slots.size() * 2, 1024u);
+	Slots.set_used(size);
+	for (u32 i = 0; i < size; ++i)
+		Slots[i] = -1;
+
+	const u32 mask = size - 1;
+	for (u32 vertex = 0; vertex < Count; ++vertex)
+	{
+		u32 slot = slotOf(&Keys[vertex * 3]);
+		while (Slots[slot] >= 0)
+			slot = (slot + 1) & mask;
+		Slots[slot] = (s32)vertex;
+	}
+}
+
+
 void COBJMeshFileLoader::cleanUp()
 {
 	for (u32 i=0; i < Materials.size(); ++i )
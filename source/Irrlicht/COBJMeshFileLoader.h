@@ -10,7 +10,6 @@
 #include "ISceneManager.h"
 #include "irrString.h"
 #include "CDynamicMeshBuffer.h"
-#include "irrMap.h"
 
 namespace irr
 {
@@ -40,6 +39,31 @@ public:
 
 private:
 
+	//! Maps the obj index triplets (position, texcoord, normal) of face corners to meshbuffer vertices
+	/** Open addressing with linear probing. Corners with the same triplet
+	share a vertex, vertices are numbered in order of insertion. */
+	struct SVertexHash
+	{
+		SVertexHash() : Count(0) {}
+
+		//! Returns the vertex of the triplet or -1 if it's new, in which case newVertex is stored for it
+		s32 findOrInsert(const s32* idx, s32 newVertex);
+
+	private:
+		u32 slotOf(const s32* idx) const
+		{
+			return ((u32)idx[0] * 73856093u ^ (u32)idx[1] * 19349663u ^ (u32)idx[2] * 83492791u) & (Slots.size() - 1);
+		}
+
+		void grow();
+
+		//! vertex per slot, -1 for empty slots
+		core::array<s32> Slots;
+		//! 3 indices per vertex
+		core::array<s32> Keys;
+		u32 Count;
+	};
+
 	struct SObjMtl
 	{
 		SObjMtl(E_INDEX_TYPE_HINT typeHint) 
@@ -63,7 +87,7 @@ private:
 			Meshbuffer->Material = o.Meshbuffer->Material;
 		}
 
-		core::map<video::S3DVertex, int> VertMap;
+		SVertexHash VertMap;
 		irr::video::E_INDEX_TYPE IndexType;
 		scene::CDynamicMeshBuffer *Meshbuffer;
 		core::stringc Name;
@@ -108,7 +132,8 @@ private:
 	// reads and convert to integer the vertex indices in a line of obj file's face statement
 	// -1 for the index if it doesn't exist
 	// indices are changed to 0-based index instead of 1-based from the obj file
-	bool retrieveVertexIndices(c8* vertexData, s32* idx, const c8* bufEnd, u32 vbsize, u32 vtsize, u32 vnsize);
+	// the vertex data ends at bufEnd and is read in place
+	bool retrieveVertexIndices(const c8* vertexData, s32* idx, const c8* bufEnd, u32 vbsize, u32 vtsize, u32 vnsize);
 
 	void cleanUp();
 
@@ -0,0 +1,396 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "COcclusionCuller.h"
+#include "IMeshBuffer.h"
+#include "irrMath.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	// tiles are TILE_SIZE*TILE_SIZE pixels
+	const u32 TILE_SHIFT = 3;
+	const u32 TILE_SIZE = 1 << TILE_SHIFT;
+
+	//! Returns the first pixel at or after a coordinate, clamped to [0,size]
+	inline u32 clampedCeil(f32 v, u32 size)
+	{
+		if (v <= 0.f)
+			return 0;
+		if (v >= (f32)size)
+			return size;
+		return (u32)core::ceil32(v);
+	}
+
+	//! Returns the pixel containing a coordinate, clamped to [0,size]
+	inline u32 clampedFloor(f32 v, u32 size)
+	{
+		if (v <= 0.f)
+			return 0;
+		if (v >= (f32)size)
+			return size;
+		return (u32)core::floor32(v);
+	}
+}
+
+
+//! constructor
+COcclusionCuller::COcclusionCuller(u32 width, u32 height)
+	: NearZ(-1.f), Empty(true)
+{
+	// whole tiles only
+	TilesX = core::max_(1u, (width + TILE_SIZE - 1) >> TILE_SHIFT);
+	TilesY = core::max_(1u, (height + TILE_SIZE - 1) >> TILE_SHIFT);
+	Width = TilesX << TILE_SHIFT;
+	Height = TilesY << TILE_SHIFT;
+
+	Depth.set_used(Width*Height);
+	TileDepth.set_used(TilesX*TilesY);
+}
+
+
+//! Clears the depth buffer and sets the camera for the next occluders
+void COcclusionCuller::begin(const core::matrix4& view, const core::matrix4& projection, f32 nearValue)
+{
+	ViewProjection.setbyproduct_nocheck(projection, view);
+
+	// depth of the near plane, the projection may map it to -1 or 0
+	f32 p[4];
+	projection.transformVect(p, core::vector3df(0.f, 0.f, nearValue));
+	if (p[3] <= 0.f)
+		projection.transformVect(p, core::vector3df(0.f, 0.f, -nearValue));
+	NearZ = (p[3] > 0.f) ? p[2] / p[3] : -1.f;
+
+	f32* depth = Depth.pointer();
+	for (u32 i=0; i<Depth.size(); ++i)
+		depth[i] = FLT_MAX;
+	Empty = true;
+}
+
+
+//! Rasterizes the triangles of an occluder mesh
+void COcclusionCuller::drawMesh(const IMesh* mesh, const core::matrix4& world)
+{
+	if (!mesh)
+		return;
+
+	const core::matrix4 mat(ViewProjection * world);
+
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		if (!mb || mb->getPrimitiveType() != EPT_TRIANGLES)
+			continue;
+
+		// positions are the first member of all vertex types
+		const u32 vertexCount = mb->getVertexCount();
+		const u32 pitch = video::getVertexPitchFromType(mb->getVertexType());
+		const u8* vertices = static_cast<const u8*>(mb->getVertices());
+		Transformed.set_used(vertexCount*4);
+		f32* transformed = Transformed.pointer();
+		for (u32 i=0; i<vertexCount; ++i)
+			mat.transformVect(transformed+i*4, *reinterpret_cast<const core::vector3df*>(vertices+i*pitch));
+
+		const u32 indexCount = mb->getIndexCount() - mb->getIndexCount() % 3;
+		if (mb->getIndexType() == video::EIT_16BIT)
+		{
+			const u16* indices = mb->getIndices();
+			for (u32 i=0; i<indexCount; i+=3)
+				if (indices[i] < vertexCount && indices[i+1] < vertexCount && indices[i+2] < vertexCount)
+					drawTriangle(transformed+indices[i]*4, transformed+indices[i+1]*4, transformed+indices[i+2]*4);
+		}
+		else
+		{
+			const u32* indices = reinterpret_cast<const u32*>(mb->getIndices());
+			for (u32 i=0; i<indexCount; i+=3)
+				if (indices[i] < vertexCount && indices[i+1] < vertexCount && indices[i+2] < vertexCount)
+					drawTriangle(transformed+indices[i]*4, transformed+indices[i+1]*4, transformed+indices[i+2]*4);
+		}
+	}
+}
+
+
+//! Rasterizes a triangle given in clip space, clipped at the near plane
+void COcclusionCuller::drawTriangle(const f32* a, const f32* b, const f32* c)
+{
+	const f32* in[3] = { a, b, c };
+	f32 clipped[4][4];
+	u32 count = 0;
+
+	for (u32 i=0; i<3; ++i)
+	{
+		const f32* p = in[i];
+		const f32* q = in[i == 2 ? 0 : i+1];
+		const f32 dp = nearDistance(p);
+		const f32 dq = nearDistance(q);
+
+		if (dp >= 0.f)
+		{
+			for (u32 j=0; j<4; ++j)
+				clipped[count][j] = p[j];
+			++count;
+		}
+		if ((dp >= 0.f) != (dq >= 0.f))
+		{
+			const f32 t = dp / (dp - dq);
+			for (u32 j=0; j<4; ++j)
+				clipped[count][j] = p[j] + (q[j] - p[j]) * t;
+			++count;
+		}
+	}
+
+	if (count < 3)
+		return;
+
+	core::vector3df screen[4];
+	for (u32 i=0; i<count; ++i)
+	{
+		if (clipped[i][3] <= 0.f)
+			return;
+		const f32 iw = core::reciprocal(clipped[i][3]);
+		screen[i].X = (clipped[i][0] * iw * 0.5f + 0.5f) * Width;
+		screen[i].Y = (0.5f - clipped[i][1] * iw * 0.5f) * Height;
+		screen[i].Z = clipped[i][2] * iw;
+	}
+
+	for (u32 i=2; i<count; ++i)
+		rasterize(screen[0], screen[i-1], screen[i]);
+	Empty = false;
+}
+
+
+//! Rasterizes a triangle given in pixel coordinates and depth
+/** Pixels are covered when their center is inside the triangle. The depth
+is a plane equation evaluated at the pixel centers. end() shrinks the
+coverage, so pixels only partly covered don't hide anything. */
+void COcclusionCuller::rasterize(const core::vector3df& a, const core::vector3df& b, const core::vector3df& c)
+{
+	// sort by y
+	const core::vector3df* v0 = &a;
+	const core::vector3df* v1 = &b;
+	const core::vector3df* v2 = &c;
+	if (v1->Y < v0->Y)
+		core::swap(v0, v1);
+	if (v2->Y < v1->Y)
+		core::swap(v1, v2);
+	if (v1->Y < v0->Y)
+		core::swap(v0, v1);
+
+	const f32 dx1 = v1->X - v0->X;
+	const f32 dy1 = v1->Y - v0->Y;
+	const f32 dz1 = v1->Z - v0->Z;
+	const f32 dx2 = v2->X - v0->X;
+	const f32 dy2 = v2->Y - v0->Y;
+	const f32 dz2 = v2->Z - v0->Z;
+	const f32 area = dx1*dy2 - dx2*dy1;
+	if (core::iszero(area))
+		return;
+
+	const f32 dzdx = (dz1*dy2 - dz2*dy1) / area;
+	const f32 dzdy = (dx1*dz2 - dx2*dz1) / area;
+
+	const u32 yStart = clampedCeil(v0->Y - 0.5f, Height);
+	const u32 yEnd = clampedCeil(v2->Y - 0.5f, Height);
+
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+	static const f32 steps[4] = { 0.f, 1.f, 2.f, 3.f };
+	const core::simd::f32x4 stepZ = core::simd::mul(core::simd::splat(dzdx), core::simd::load(steps));
+	const core::simd::f32x4 stepZ4 = core::simd::splat(dzdx*4.f);
+#endif
+
+	for (u32 y=yStart; y<yEnd; ++y)
+	{
+		const f32 yc = y + 0.5f;
+
+		// x on the long edge and on the current short edge
+		f32 xa = v0->X + dx2 * (yc - v0->Y) / dy2;
+		f32 xb;
+		if (yc < v1->Y)
+			xb = v0->X + dx1 * (yc - v0->Y) / dy1;
+		else
+			xb = v1->X + (v2->X - v1->X) * (yc - v1->Y) / (v2->Y - v1->Y);
+		if (xb < xa)
+			core::swap(xa, xb);
+
+		u32 x = clampedCeil(xa - 0.5f, Width);
+		const u32 xEnd = clampedCeil(xb - 0.5f, Width);
+		if (x >= xEnd)
+			continue;
+
+		f32* row = Depth.pointer() + y*Width;
+		f32 z = v0->Z + dzdx * (x + 0.5f - v0->X) + dzdy * (yc - v0->Y);
+
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+		if (x + 4 <= xEnd)
+		{
+			const u32 xStart = x;
+			core::simd::f32x4 z4 = core::simd::add(core::simd::splat(z), stepZ);
+			for (; x+4 <= xEnd; x+=4)
+			{
+				core::simd::store(row+x, core::simd::minimum(core::simd::load(row+x), z4));
+				z4 = core::simd::add(z4, stepZ4);
+			}
+			z += dzdx * (x - xStart);
+		}
+#endif
+		for (; x<xEnd; ++x)
+		{
+			if (z < row[x])
+				row[x] = z;
+			z += dzdx;
+		}
+	}
+}
+
+
+//! Shrinks the occluders by a pixel and updates the tile depths
+/** Each pixel gets the farthest depth of its 3x3 neighbourhood. A pixel
+whose center is covered but which is crossed by an occluder edge has a
+neighbour center beyond that edge, so it becomes uncovered unless another
+occluder continues there. Edges shared by the triangles of an occluder mesh
+are covered on both sides and don't shrink. The farthest neighbour depth also bounds the depth across the whole
+pixel, not only at its center. */
+void COcclusionCuller::end()
+{
+	if (Empty)
+		return;
+
+	// farthest depth of each pixel and its left and right neighbours
+	RowDepth.set_used(Width*Height);
+	for (u32 y=0; y<Height; ++y)
+	{
+		const f32* src = Depth.const_pointer() + y*Width;
+		f32* dst = RowDepth.pointer() + y*Width;
+		dst[0] = core::max_(src[0], src[1]);
+		u32 x = 1;
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+		for (; x+4 < Width; x+=4)
+			core::simd::store(dst+x, core::simd::maximum(core::simd::maximum(core::simd::load(src+x-1), core::simd::load(src+x)), core::simd::load(src+x+1)));
+#endif
+		for (; x+1 < Width; ++x)
+			dst[x] = core::max_(src[x-1], src[x], src[x+1]);
+		dst[Width-1] = core::max_(src[Width-2], src[Width-1]);
+	}
+
+	// and of the rows above and below, the rows are whole tiles wide
+	for (u32 y=0; y<Height; ++y)
+	{
+		const f32* above = RowDepth.const_pointer() + (y ? y-1 : y)*Width;
+		const f32* row = RowDepth.const_pointer() + y*Width;
+		const f32* below = RowDepth.const_pointer() + (y+1 < Height ? y+1 : y)*Width;
+		f32* dst = Depth.pointer() + y*Width;
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+		for (u32 x=0; x<Width; x+=4)
+			core::simd::store(dst+x, core::simd::maximum(core::simd::maximum(core::simd::load(above+x), core::simd::load(row+x)), core::simd::load(below+x)));
+#else
+		for (u32 x=0; x<Width; ++x)
+			dst[x] = core::max_(above[x], row[x], below[x]);
+#endif
+	}
+
+	for (u32 ty=0; ty<TilesY; ++ty)
+	{
+		for (u32 tx=0; tx<TilesX; ++tx)
+		{
+			const f32* tile = Depth.const_pointer() + (ty << TILE_SHIFT) * Width + (tx << TILE_SHIFT);
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+			core::simd::f32x4 m = core::simd::load(tile);
+			for (u32 y=0; y<TILE_SIZE; ++y)
+			{
+				const f32* row = tile + y*Width;
+				for (u32 x=0; x<TILE_SIZE; x+=4)
+					m = core::simd::maximum(m, core::simd::load(row+x));
+			}
+			f32 lanes[4];
+			core::simd::store(lanes, m);
+			TileDepth[ty*TilesX + tx] = core::max_(core::max_(lanes[0], lanes[1]), core::max_(lanes[2], lanes[3]));
+#else
+			f32 m = tile[0];
+			for (u32 y=0; y<TILE_SIZE; ++y)
+			{
+				const f32* row = tile + y*Width;
+				for (u32 x=0; x<TILE_SIZE; ++x)
+					m = core::max_(m, row[x]);
+			}
+			TileDepth[ty*TilesX + tx] = m;
+#endif
+		}
+	}
+}
+
+
+//! Discards all occluders, no box is occluded until the next begin()
+void COcclusionCuller::clear()
+{
+	Empty = true;
+}
+
+
+//! Returns true when the box is completely hidden behind occluders
+bool COcclusionCuller::isOccluded(const core::aabbox3df& box, const core::matrix4& world) const
+{
+	if (Empty)
+		return false;
+
+	const core::matrix4 mat(ViewProjection * world);
+	core::vector3df edges[8];
+	box.getEdges(edges);
+
+	f32 minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+	f32 maxX = -FLT_MAX, maxY = -FLT_MAX;
+	for (u32 i=0; i<8; ++i)
+	{
+		f32 p[4];
+		mat.transformVect(p, edges[i]);
+		if (nearDistance(p) <= 0.f || p[3] <= 0.f)
+			return false;
+
+		const f32 iw = core::reciprocal(p[3]);
+		const f32 x = (p[0] * iw * 0.5f + 0.5f) * Width;
+		const f32 y = (0.5f - p[1] * iw * 0.5f) * Height;
+		minX = core::min_(minX, x);
+		maxX = core::max_(maxX, x);
+		minY = core::min_(minY, y);
+		maxY = core::max_(maxY, y);
+		minZ = core::min_(minZ, p[2] * iw);
+	}
+
+	// all pixels touched by the projected box
+	const u32 x0 = clampedFloor(minX, Width);
+	const u32 x1 = clampedCeil(maxX, Width);
+	const u32 y0 = clampedFloor(minY, Height);
+	const u32 y1 = clampedCeil(maxY, Height);
+	if (x0 >= x1 || y0 >= y1)
+		return false;
+
+	for (u32 ty=y0 >> TILE_SHIFT; ty<=(y1-1) >> TILE_SHIFT; ++ty)
+	{
+		for (u32 tx=x0 >> TILE_SHIFT; tx<=(x1-1) >> TILE_SHIFT; ++tx)
+		{
+			// all occluders in this tile are in front of the box
+			if (TileDepth[ty*TilesX + tx] < minZ)
+				continue;
+
+			const u32 px0 = core::max_(x0, tx << TILE_SHIFT);
+			const u32 px1 = core::min_(x1, (tx+1) << TILE_SHIFT);
+			const u32 py0 = core::max_(y0, ty << TILE_SHIFT);
+			const u32 py1 = core::min_(y1, (ty+1) << TILE_SHIFT);
+			for (u32 y=py0; y<py1; ++y)
+			{
+				const f32* row = Depth.const_pointer() + y*Width;
+				for (u32 x=px0; x<px1; ++x)
+					if (row[x] >= minZ)
+						return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+} // end namespace scene
+} // end namespace irr
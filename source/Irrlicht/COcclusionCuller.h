@@ -0,0 +1,87 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_C_OCCLUSION_CULLER_H_INCLUDED
+#define IRR_C_OCCLUSION_CULLER_H_INCLUDED
+
+#include "IMesh.h"
+#include "matrix4.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Software occlusion culling with a low resolution depth buffer
+	/** Occluder meshes are rasterized into a small depth buffer at the start
+	of a frame. The buffer is split into tiles which remember their farthest
+	depth, so most bounding box tests are done per tile and only tiles
+	partially covered by occluders are tested per pixel. Depth values are
+	normalized device z, so any projection matrix can be used. Occluders are
+	shrunk by a pixel, so the culling is conservative at their edges. */
+	class COcclusionCuller
+	{
+	public:
+
+		//! constructor
+		COcclusionCuller(u32 width=256, u32 height=128);
+
+		//! Clears the depth buffer and sets the camera for the next occluders
+		/** \param view View matrix of the camera.
+		\param projection Projection matrix of the camera.
+		\param nearValue Distance of the near clipping plane. */
+		void begin(const core::matrix4& view, const core::matrix4& projection, f32 nearValue);
+
+		//! Rasterizes the triangles of an occluder mesh
+		void drawMesh(const IMesh* mesh, const core::matrix4& world);
+
+		//! Shrinks the occluders by a pixel and updates the tile depths
+		/** Must be called after the occluders are drawn. Only pixels
+		completely covered by occluders hide boxes. */
+		void end();
+
+		//! Discards all occluders, no box is occluded until the next begin()
+		void clear();
+
+		//! Returns true when the box is completely hidden behind occluders
+		/** Boxes crossing the near plane or completely outside of the
+		screen are reported as visible, the frustum culling handles them. */
+		bool isOccluded(const core::aabbox3df& box, const core::matrix4& world) const;
+
+		//! Returns the depth buffer for debugging, width*height values
+		const f32* getDepthBuffer() const { return Depth.const_pointer(); }
+
+	private:
+
+		//! Rasterizes a triangle given in clip space, clipped at the near plane
+		void drawTriangle(const f32* a, const f32* b, const f32* c);
+
+		//! Rasterizes a triangle given in pixel coordinates and depth
+		void rasterize(const core::vector3df& a, const core::vector3df& b, const core::vector3df& c);
+
+		//! Distance of a clip space vertex in front of the near plane
+		f32 nearDistance(const f32* v) const
+		{
+			return v[2] - NearZ*v[3];
+		}
+
+		core::array<f32> Depth;
+		// depth buffer after the horizontal pass of shrinking the occluders
+		core::array<f32> RowDepth;
+		core::array<f32> TileDepth;
+		core::array<f32> Transformed;
+		core::matrix4 ViewProjection;
+		u32 Width;
+		u32 Height;
+		u32 TilesX;
+		u32 TilesY;
+		// depth of the near plane in normalized device coordinates
+		f32 NearZ;
+		bool Empty;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -107,6 +107,7 @@ class COpenGLCoreCacheHandler
 #endif
 
 							glBindTexture(curTextureType, static_cast<const TOpenGLTexture*>(texture)->getOpenGLTextureName());
+							++CacheHandler.Driver->getCurrentFrameStats().TextureBinds;
 						}
 						else
 						{
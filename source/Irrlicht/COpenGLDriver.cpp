@@ -467,6 +467,9 @@ bool COpenGLDriver::updateVertexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 
 	extGlBindBuffer(GL_ARRAY_BUFFER, 0);
 
+	++FrameStats.HardwareBufferUploads;
+	FrameStats.HardwareBufferUploadBytes += vertexCount * vertexSize;
+
 	return (!testGLError(__LINE__));
 #else
 	return false;
@@ -541,6 +544,9 @@ bool COpenGLDriver::updateIndexHardwareBuffer(SHWBufferLink_opengl *HWBuffer)
 
 	extGlBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
+	++FrameStats.HardwareBufferUploads;
+	FrameStats.HardwareBufferUploadBytes += indexCount * indexSize;
+
 	return (!testGLError(__LINE__));
 #else
 	return false;
@@ -593,8 +599,8 @@ COpenGLDriver::SHWBufferLink *COpenGLDriver::createHardwareBuffer(const scene::I
 
 	SHWBufferLink_opengl *HWBuffer=new SHWBufferLink_opengl(mb);
 
-	//add to map
-	HWBufferMap.insert(HWBuffer->MeshBuffer, HWBuffer);
+	//add to links
+	registerHardwareBuffer(HWBuffer);
 
 	HWBuffer->ChangedID_Vertex=HWBuffer->MeshBuffer->getChangedID_Vertex();
 	HWBuffer->ChangedID_Index=HWBuffer->MeshBuffer->getChangedID_Index();
@@ -689,7 +695,7 @@ void COpenGLDriver::addOcclusionQuery(scene::ISceneNode* node,
 		return;
 
 	CNullDriver::addOcclusionQuery(node, mesh);
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	const s32 index = findOcclusionQuery(node);
 	if ((index != -1) && (OcclusionQueries[index].UID == 0))
 		extGlGenQueries(1, reinterpret_cast<GLuint*>(&OcclusionQueries[index].UID));
 }
@@ -698,7 +704,7 @@ void COpenGLDriver::addOcclusionQuery(scene::ISceneNode* node,
 //! Remove occlusion query.
 void COpenGLDriver::removeOcclusionQuery(scene::ISceneNode* node)
 {
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
+	const s32 index = findOcclusionQuery(node);
 	if (index != -1)
 	{
 		if (OcclusionQueries[index].UID != 0)
@@ -708,88 +714,66 @@ void COpenGLDriver::removeOcclusionQuery(scene::ISceneNode* node)
 }
 
 
-//! Run occlusion query. Draws mesh stored in query.
-/** If the mesh shall not be rendered visible, use
-overrideMaterial to disable the color and depth buffer. */
-void COpenGLDriver::runOcclusionQuery(scene::ISceneNode* node, bool visible)
+//! Starts counting the samples of a query
+void COpenGLDriver::beginOcclusionQuery(SOccQuery& query)
 {
-	if (!node)
-		return;
-
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
-	if (index != -1)
-	{
-		if (OcclusionQueries[index].UID)
-			extGlBeginQuery(
+	if (query.UID)
+		extGlBeginQuery(
 #ifdef GL_ARB_occlusion_query
-				GL_SAMPLES_PASSED_ARB,
+			GL_SAMPLES_PASSED_ARB,
 #else
-				0,
+			0,
 #endif
-				OcclusionQueries[index].UID);
-		CNullDriver::runOcclusionQuery(node,visible);
-		if (OcclusionQueries[index].UID)
-			extGlEndQuery(
+			query.UID);
+}
+
+
+//! Stops counting the samples of a query
+void COpenGLDriver::endOcclusionQuery(SOccQuery& query)
+{
+	if (query.UID)
+		extGlEndQuery(
 #ifdef GL_ARB_occlusion_query
-				GL_SAMPLES_PASSED_ARB);
+			GL_SAMPLES_PASSED_ARB);
 #else
-				0);
+			0);
 #endif
-		testGLError(__LINE__);
-	}
+	testGLError(__LINE__);
 }
 
 
-//! Update occlusion query. Retrieves results from GPU.
+//! Retrieves the result of a query from the GPU.
 /** If the query shall not block, set the flag to false.
 Update might not occur in this case, though */
-void COpenGLDriver::updateOcclusionQuery(scene::ISceneNode* node, bool block)
+void COpenGLDriver::fetchOcclusionQueryResult(SOccQuery& query, bool block)
 {
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
-	if (index != -1)
-	{
-		// not yet started
-		if (OcclusionQueries[index].Run==u32(~0))
-			return;
-		GLint available = block?GL_TRUE:GL_FALSE;
-		if (!block)
-			extGlGetQueryObjectiv(OcclusionQueries[index].UID,
+	GLint available = block?GL_TRUE:GL_FALSE;
+	if (!block)
+		extGlGetQueryObjectiv(query.UID,
 #ifdef GL_ARB_occlusion_query
-						GL_QUERY_RESULT_AVAILABLE_ARB,
+					GL_QUERY_RESULT_AVAILABLE_ARB,
 #elif defined(GL_NV_occlusion_query)
-						GL_PIXEL_COUNT_AVAILABLE_NV,
+					GL_PIXEL_COUNT_AVAILABLE_NV,
 #else
-						0,
+					0,
 #endif
-						&available);
-		testGLError(__LINE__);
-		if (available==GL_TRUE)
-		{
-			extGlGetQueryObjectiv(OcclusionQueries[index].UID,
+					&available);
+	testGLError(__LINE__);
+	if (available==GL_TRUE)
+	{
+		extGlGetQueryObjectiv(query.UID,
 #ifdef GL_ARB_occlusion_query
-						GL_QUERY_RESULT_ARB,
+					GL_QUERY_RESULT_ARB,
 #elif defined(GL_NV_occlusion_query)
-						GL_PIXEL_COUNT_NV,
+					GL_PIXEL_COUNT_NV,
 #else
-						0,
+					0,
 #endif
-						&available);
-			if (queryFeature(EVDF_OCCLUSION_QUERY))
-				OcclusionQueries[index].Result = available;
-		}
-		testGLError(__LINE__);
+					&available);
+		if (queryFeature(EVDF_OCCLUSION_QUERY))
+			query.Result = available;
 	}
-}
-
-
-//! Return query result.
-/** Return value is the number of visible pixels/fragments.
-The value is a safe approximation, i.e. can be larger than the
-actual value of pixels. */
-u32 COpenGLDriver::getOcclusionQueryResult(const scene::ISceneNode* node) const
-{
-	const s32 index = OcclusionQueries.linear_search(node);
-	return index < 0 ? ~0 : OcclusionQueries[index].Result;
+	testGLError(__LINE__);
 }
 
 
@@ -810,6 +794,14 @@ static inline const GLvoid * buffer_offset(const size_t offset)
 }
 
 
+//! Draws copies of a mesh buffer, one after the other
+void COpenGLDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+	const core::matrix4* transforms, u32 instanceCount, const SColor* colors)
+{
+	drawInstancesOneByOne(mb, transforms, instanceCount, colors);
+}
+
+
 //! draws a vertex primitive list
 void COpenGLDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 		const void* indexList, u32 primitiveCount,
@@ -1350,6 +1342,7 @@ void COpenGLDriver::draw2DImage(const video::ITexture* texture, const core::posi
 		glColorPointer(colorSize, GL_UNSIGNED_BYTE, 0, &ColorBuffer[0]);
 	}
 
+	++FrameStats.DrawCalls;
 	glDrawElements(GL_TRIANGLE_FAN, 4, GL_UNSIGNED_SHORT, Quad2DIndices);
 }
 
@@ -1434,6 +1427,7 @@ void COpenGLDriver::draw2DImage(const video::ITexture* texture, const core::rect
 		glColorPointer(colorSize, GL_UNSIGNED_BYTE, 0, &ColorBuffer[0]);
 	}
 
+	++FrameStats.DrawCalls;
 	glDrawElements(GL_TRIANGLE_FAN, 4, GL_UNSIGNED_SHORT, Quad2DIndices);
 
 	if (clipRect)
@@ -1544,6 +1538,7 @@ void COpenGLDriver::draw2DImageQuad(const video::ITexture* texture, u32 layer, b
 		glTexCoordPointer(2, GL_FLOAT, sizeof(core::vector2df), texcoordData);
 	}
 
+	++FrameStats.DrawCalls;
 	glDrawElements(GL_TRIANGLE_FAN, 4, GL_UNSIGNED_SHORT, Quad2DIndices);
 }
 
@@ -1560,6 +1555,8 @@ void COpenGLDriver::draw2DImageBatch(const video::ITexture* texture,
 	if (!texture)
 		return;
 
+	++FrameStats.Draw2DBatches;
+
 	const u32 drawCount = core::min_<u32>(positions.size(), sourceRects.size());
 
 	const core::dimension2d<u32>& ss = texture->getOriginalSize();
@@ -1701,6 +1698,7 @@ void COpenGLDriver::draw2DImageBatch(const video::ITexture* texture,
 		Quad2DVertices[2].TCoords = core::vector2df(tcoords.LowerRightCorner.X, tcoords.LowerRightCorner.Y);
 		Quad2DVertices[3].TCoords = core::vector2df(tcoords.UpperLeftCorner.X, tcoords.LowerRightCorner.Y);
 
+		++FrameStats.DrawCalls;
 		glDrawElements(GL_TRIANGLE_FAN, 4, GL_UNSIGNED_SHORT, Quad2DIndices);
 	}
 }
@@ -1722,6 +1720,8 @@ void COpenGLDriver::draw2DImageBatch(const video::ITexture* texture,
 	if (!texture)
 		return;
 
+	++FrameStats.Draw2DBatches;
+
 	disableTextures(1);
 	if (!CacheHandler->getTextureCache().set(0, texture))
 		return;
@@ -1793,6 +1793,7 @@ void COpenGLDriver::draw2DImageBatch(const video::ITexture* texture,
 		Quad2DVertices[2].TCoords = core::vector2df(tcoords.LowerRightCorner.X, tcoords.LowerRightCorner.Y);
 		Quad2DVertices[3].TCoords = core::vector2df(tcoords.UpperLeftCorner.X, tcoords.LowerRightCorner.Y);
 
+		++FrameStats.DrawCalls;
 		glDrawElements(GL_TRIANGLE_FAN, 4, GL_UNSIGNED_SHORT, Quad2DIndices);
 
 		targetPos.X += sourceRects[currentIndex].getWidth();
@@ -1874,6 +1875,7 @@ void COpenGLDriver::draw2DRectangle(const core::rect<s32>& position,
 		glColorPointer(colorSize, GL_UNSIGNED_BYTE, 0, &ColorBuffer[0]);
 	}
 
+	++FrameStats.DrawCalls;
 	glDrawElements(GL_TRIANGLE_FAN, 4, GL_UNSIGNED_SHORT, Quad2DIndices);
 }
 
@@ -1917,6 +1919,7 @@ void COpenGLDriver::draw2DLine(const core::position2d<s32>& start,
 			glColorPointer(colorSize, GL_UNSIGNED_BYTE, 0, &ColorBuffer[0]);
 		}
 
+		++FrameStats.DrawCalls;
 		glDrawElements(GL_LINES, 2, GL_UNSIGNED_SHORT, Quad2DIndices);
 	}
 }
@@ -1955,6 +1958,7 @@ void COpenGLDriver::drawPixel(u32 x, u32 y, const SColor &color)
 		glColorPointer(colorSize, GL_UNSIGNED_BYTE, 0, &ColorBuffer[0]);
 	}
 
+	++FrameStats.DrawCalls;
 	glDrawArrays(GL_POINTS, 0, 1);
 }
 
@@ -2114,6 +2118,8 @@ void COpenGLDriver::setRenderStates3DMode()
 
 	if (ResetRenderStates || LastMaterial != Material)
 	{
+		++FrameStats.MaterialChanges;
+
 		// unset old material
 
 		if (LastMaterial.MaterialType != Material.MaterialType &&
@@ -3453,6 +3459,7 @@ void COpenGLDriver::drawStencilShadow(bool clearStencilBuffer, video::SColor lef
 		glColorPointer(colorSize, GL_UNSIGNED_BYTE, 0, &ColorBuffer[0]);
 	}
 
+	++FrameStats.DrawCalls;
 	glDrawElements(GL_TRIANGLE_FAN, 4, GL_UNSIGNED_SHORT, Quad2DIndices);
 
 	if (clearStencilBuffer)
@@ -3564,6 +3571,7 @@ void COpenGLDriver::draw3DBox( const core::aabbox3d<f32>& box, SColor color )
 		glColorPointer(colorSize, GL_UNSIGNED_BYTE, 0, &ColorBuffer[0]);
 	}
 
+	++FrameStats.DrawCalls;
 	glDrawArrays(GL_LINES, 0, 24);
 }
 
@@ -3600,6 +3608,7 @@ void COpenGLDriver::draw3DLine(const core::vector3df& start,
 		glColorPointer(colorSize, GL_UNSIGNED_BYTE, 0, &ColorBuffer[0]);
 	}
 
+	++FrameStats.DrawCalls;
 	glDrawElements(GL_LINES, 2, GL_UNSIGNED_SHORT, Quad2DIndices);
 }
 
@@ -3928,6 +3937,7 @@ bool COpenGLDriver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag, SCol
 	}
 
 	clearBuffers(clearFlag, clearColor, clearDepth, clearStencil);
+	++FrameStats.RenderTargetSwitches;
 
 	return true;
 }
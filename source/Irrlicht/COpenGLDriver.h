@@ -96,22 +96,6 @@ namespace video
 		//! Remove occlusion query.
 		virtual void removeOcclusionQuery(scene::ISceneNode* node) IRR_OVERRIDE;
 
-		//! Run occlusion query. Draws mesh stored in query.
-		/** If the mesh shall not be rendered visible, use
-		overrideMaterial to disable the color and depth buffer. */
-		virtual void runOcclusionQuery(scene::ISceneNode* node, bool visible=false) IRR_OVERRIDE;
-
-		//! Update occlusion query. Retrieves results from GPU.
-		/** If the query shall not block, set the flag to false.
-		Update might not occur in this case, though */
-		virtual void updateOcclusionQuery(scene::ISceneNode* node, bool block=true) IRR_OVERRIDE;
-
-		//! Return query result.
-		/** Return value is the number of visible pixels/fragments.
-		The value is a safe approximation, i.e. can be larger then the
-		actual value of pixels. */
-		virtual u32 getOcclusionQueryResult(const scene::ISceneNode* node) const IRR_OVERRIDE;
-
 		//! Create render target.
 		virtual IRenderTarget* addRenderTarget() IRR_OVERRIDE;
 
@@ -120,6 +104,11 @@ namespace video
 				const void* indexList, u32 primitiveCount,
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType) IRR_OVERRIDE;
 
+		//! Draws copies of a mesh buffer, one after the other
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const core::matrix4* transforms, u32 instanceCount,
+			const SColor* colors=0) IRR_OVERRIDE;
+
 		//! draws a vertex primitive list in 2d
 		virtual void draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount,
 				const void* indexList, u32 primitiveCount,
@@ -423,6 +412,17 @@ namespace video
 
 		COpenGLCacheHandler* getCacheHandler() const;
 
+	protected:
+
+		//! Starts counting the samples of a query
+		virtual void beginOcclusionQuery(SOccQuery& query) IRR_OVERRIDE;
+
+		//! Stops counting the samples of a query
+		virtual void endOcclusionQuery(SOccQuery& query) IRR_OVERRIDE;
+
+		//! Retrieves the result of a query which has been run
+		virtual void fetchOcclusionQueryResult(SOccQuery& query, bool block) IRR_OVERRIDE;
+
 	private:
 
 		bool updateVertexHardwareBuffer(SHWBufferLink_opengl *HWBuffer);
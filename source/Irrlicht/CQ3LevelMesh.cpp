@@ -11,6 +11,8 @@
 #include "irrString.h"
 #include "IQ3Shader.h"
 #include "IFileList.h"
+#include "SViewFrustum.h"
+#include "irrMap.h"
 
 //#define TJUNCTION_SOLVER_ROUND
 //#define TJUNCTION_SOLVER_0125
@@ -29,8 +31,8 @@ CQ3LevelMesh::CQ3LevelMesh(io::IFileSystem* fs, scene::ISceneManager* smgr,
 	Vertices(0), NumVertices(0), Faces(0), NumFaces(0), Models(0), NumModels(0),
 	Planes(0), NumPlanes(0), Nodes(0), NumNodes(0), Leafs(0), NumLeafs(0),
 	LeafFaces(0), NumLeafFaces(0), MeshVerts(0), NumMeshVerts(0),
-	Brushes(0), NumBrushes(0), BrushEntities(0), FileSystem(fs),
-	SceneManager(smgr), FramesPerSecond(25.f)
+	Brushes(0), NumBrushes(0), BytesPerCluster(0), VisitedID(0),
+	BrushEntities(0), FileSystem(fs), SceneManager(smgr), FramesPerSecond(25.f)
 {
 	#ifdef _DEBUG
 	IReferenceCounted::setDebugName("CQ3LevelMesh");
@@ -160,6 +162,7 @@ bool CQ3LevelMesh::loadFile(io::IReadFile* file)
 
 	cleanMeshes();
 	calcBoundingBoxes();
+	constructVisibility();
 	cleanLoader();
 
 	return true;
@@ -312,7 +315,24 @@ void CQ3LevelMesh::loadFaces(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumPlanes = l->length / sizeof(tBSPPlane);
+	if ( !NumPlanes )
+		return;
+	Planes = new tBSPPlane[NumPlanes];
+
+	file->seek( l->offset );
+	file->read( Planes, NumPlanes * sizeof(tBSPPlane) );
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumPlanes; i++)
+		{
+			Planes[i].vNormal[0] = os::Byteswap::byteswap(Planes[i].vNormal[0]);
+			Planes[i].vNormal[1] = os::Byteswap::byteswap(Planes[i].vNormal[1]);
+			Planes[i].vNormal[2] = os::Byteswap::byteswap(Planes[i].vNormal[2]);
+			Planes[i].d = os::Byteswap::byteswap(Planes[i].d);
+		}
+	}
 }
 
 
@@ -320,7 +340,23 @@ void CQ3LevelMesh::loadPlanes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumNodes = l->length / sizeof(tBSPNode);
+	if ( !NumNodes )
+		return;
+	Nodes = new tBSPNode[NumNodes];
+
+	file->seek( l->offset );
+	file->read( Nodes, NumNodes * sizeof(tBSPNode) );
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumNodes; i++)
+		{
+			Nodes[i].plane = os::Byteswap::byteswap(Nodes[i].plane);
+			Nodes[i].front = os::Byteswap::byteswap(Nodes[i].front);
+			Nodes[i].back = os::Byteswap::byteswap(Nodes[i].back);
+		}
+	}
 }
 
 
@@ -328,7 +364,28 @@ void CQ3LevelMesh::loadNodes(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafs = l->length / sizeof(tBSPLeaf);
+	if ( !NumLeafs )
+		return;
+	Leafs = new tBSPLeaf[NumLeafs];
+
+	file->seek( l->offset );
+	file->read( Leafs, NumLeafs * sizeof(tBSPLeaf) );
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumLeafs; i++)
+		{
+			Leafs[i].cluster = os::Byteswap::byteswap(Leafs[i].cluster);
+			for ( s32 g = 0; g < 3; ++g )
+			{
+				Leafs[i].mins[g] = os::Byteswap::byteswap(Leafs[i].mins[g]);
+				Leafs[i].maxs[g] = os::Byteswap::byteswap(Leafs[i].maxs[g]);
+			}
+			Leafs[i].leafface = os::Byteswap::byteswap(Leafs[i].leafface);
+			Leafs[i].numOfLeafFaces = os::Byteswap::byteswap(Leafs[i].numOfLeafFaces);
+		}
+	}
 }
 
 
@@ -336,15 +393,53 @@ void CQ3LevelMesh::loadLeafs(tBSPLump* l, io::IReadFile* file)
 */
 void CQ3LevelMesh::loadLeafFaces(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	NumLeafFaces = l->length / sizeof(s32);
+	if ( !NumLeafFaces )
+		return;
+	LeafFaces = new s32[NumLeafFaces];
+
+	file->seek( l->offset );
+	file->read( LeafFaces, NumLeafFaces * sizeof(s32) );
+
+	if ( LoadParam.swapHeader )
+	{
+		for ( s32 i = 0; i < NumLeafFaces; i++)
+			LeafFaces[i] = os::Byteswap::byteswap(LeafFaces[i]);
+	}
 }
 
 
 /*!
+	the cluster bitsets are kept after loading
 */
 void CQ3LevelMesh::loadVisData(tBSPLump* l, io::IReadFile* file)
 {
-	// ignore
+	VisClusters.clear();
+	BytesPerCluster = 0;
+
+	if ( l->length < (s32) (2 * sizeof(s32)) )
+		return;
+
+	s32 numOfClusters;
+	s32 bytesPerCluster;
+	file->seek( l->offset );
+	file->read( &numOfClusters, sizeof(s32) );
+	file->read( &bytesPerCluster, sizeof(s32) );
+
+	if ( LoadParam.swapHeader )
+	{
+		numOfClusters = os::Byteswap::byteswap(numOfClusters);
+		bytesPerCluster = os::Byteswap::byteswap(bytesPerCluster);
+	}
+
+	const s32 size = numOfClusters * bytesPerCluster;
+	if ( numOfClusters <= 0 || bytesPerCluster <= 0 ||
+		size > l->length - (s32) (2 * sizeof(s32)) )
+		return;
+
+	VisClusters.set_used( size );
+	file->read( VisClusters.pointer(), size );
+	BytesPerCluster = bytesPerCluster;
 }
 
 
@@ -963,6 +1058,9 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 			}
 
 
+			// remember where the faces of the level geometry are for the visibility
+			const u32 firstIndex = buffer->getIndexCount();
+
 			switch(Faces[i].type)
 			{
 				case 4: // billboards
@@ -1016,6 +1114,13 @@ scene::SMesh** CQ3LevelMesh::buildMesh(s32 num)
 					break;
 
 			} // end switch
+
+			if ( 0 == num && item[g].index == E_Q3_MESH_GEOMETRY && i < (s32)FaceRanges.size() )
+			{
+				FaceRanges[i].Buffer = buffer;
+				FaceRanges[i].FirstIndex = firstIndex;
+				FaceRanges[i].IndexCount = buffer->getIndexCount() - firstIndex;
+			}
 		}
 	}
 
@@ -1052,6 +1157,11 @@ void CQ3LevelMesh::constructMesh()
 
 	s32 i, j;
 
+	FaceRanges.clear();
+	FaceRanges.reallocate(NumFaces);
+	for (i = 0; i < NumFaces; i++)
+		FaceRanges.push_back(SFaceRange());
+
 	// First the main level
 	SMesh **tmp = buildMesh(0);
 
@@ -1489,6 +1599,181 @@ IMesh* CQ3LevelMesh::getBrushEntityMesh(quake3::IEntity &ent) const
 }
 
 
+/*!
+	keeps the BSP tree and the face ranges of the level geometry for
+	the visibility queries, must be called before cleanLoader
+*/
+void CQ3LevelMesh::constructVisibility()
+{
+	VisNodes.clear();
+	VisLeafs.clear();
+	VisLeafFaces.clear();
+
+	// cleanMeshes might have removed mesh buffers
+	core::map<IMeshBuffer*, s32> bufferIndex;
+	const SMesh* geometry = Mesh[E_Q3_MESH_GEOMETRY];
+	u32 i;
+	for ( i = 0; i < geometry->MeshBuffers.size(); ++i )
+		bufferIndex.insert( geometry->MeshBuffers[i], (s32) i );
+
+	for ( i = 0; i < FaceRanges.size(); ++i )
+	{
+		SFaceRange& range = FaceRanges[i];
+		core::map<IMeshBuffer*, s32>::Node* node = range.Buffer ? bufferIndex.find( range.Buffer ) : 0;
+		range.MeshBuffer = node && range.IndexCount ? node->getValue() : -1;
+		range.Buffer = 0;
+	}
+
+	FaceVisited.set_used( FaceRanges.size() );
+	for ( i = 0; i < FaceVisited.size(); ++i )
+		FaceVisited[i] = 0;
+	VisitedID = 0;
+
+	if ( !Planes || !Nodes || !Leafs )
+		return;
+
+	// the tree has to be valid, node children always have higher indices
+	VisNodes.reallocate( NumNodes );
+	for ( s32 n = 0; n < NumNodes; ++n )
+	{
+		const tBSPNode& source = Nodes[n];
+		if ( source.plane < 0 || source.plane >= NumPlanes ||
+			( source.front >= 0 && ( source.front <= n || source.front >= NumNodes ) ) ||
+			( source.back >= 0 && ( source.back <= n || source.back >= NumNodes ) ) ||
+			-(source.front + 1) >= NumLeafs || -(source.back + 1) >= NumLeafs )
+		{
+			os::Printer::log("quake3::constructVisibility invalid BSP tree, visibility disabled", LevelName, ELL_WARNING);
+			VisNodes.clear();
+			return;
+		}
+
+		const tBSPPlane& plane = Planes[source.plane];
+		SNode node;
+		node.Plane.setPlane( core::vector3df( plane.vNormal[0], plane.vNormal[2], plane.vNormal[1] ), -plane.d );
+		node.Front = source.front;
+		node.Back = source.back;
+		VisNodes.push_back( node );
+	}
+
+	VisLeafs.reallocate( NumLeafs );
+	for ( s32 l = 0; l < NumLeafs; ++l )
+	{
+		const tBSPLeaf& source = Leafs[l];
+		SLeaf leaf;
+		leaf.Box.MinEdge.set( (f32) source.mins[0], (f32) source.mins[2], (f32) source.mins[1] );
+		leaf.Box.MaxEdge.set( (f32) source.maxs[0], (f32) source.maxs[2], (f32) source.maxs[1] );
+		leaf.Box.repair();
+		leaf.Cluster = source.cluster;
+		leaf.FirstFace = source.leafface;
+		leaf.FaceCount = source.numOfLeafFaces;
+		if ( leaf.FirstFace < 0 || leaf.FaceCount < 0 || leaf.FirstFace + leaf.FaceCount > NumLeafFaces )
+			leaf.FaceCount = 0;
+		VisLeafs.push_back( leaf );
+	}
+
+	VisLeafFaces.reallocate( NumLeafFaces );
+	for ( s32 f = 0; f < NumLeafFaces; ++f )
+		VisLeafFaces.push_back( LeafFaces[f] );
+}
+
+
+//! returns the BSP leaf containing a position, or -1
+s32 CQ3LevelMesh::getLeafAt(const core::vector3df& pos) const
+{
+	if ( VisNodes.empty() )
+		return -1;
+
+	s32 index = 0;
+	while ( index >= 0 )
+	{
+		const SNode& node = VisNodes[index];
+		index = node.Plane.getDistanceTo( pos ) >= 0.f ? node.Front : node.Back;
+	}
+
+	return -(index + 1);
+}
+
+
+//! Returns the visibility cluster of the BSP leaf containing a position
+s32 CQ3LevelMesh::getClusterAt(const core::vector3df& pos) const
+{
+	const s32 leaf = getLeafAt( pos );
+	return leaf >= 0 ? VisLeafs[leaf].Cluster : -1;
+}
+
+
+//! Collects the faces of the level geometry potentially visible from a position
+bool CQ3LevelMesh::getVisibleFaces(const core::vector3df& pos, const SViewFrustum* frustum,
+	core::array<u32>& faces) const
+{
+	faces.set_used(0);
+
+	const s32 cluster = getClusterAt( pos );
+	if ( cluster < 0 || VisClusters.empty() )
+		return false;
+
+	const u32 clusterOffset = (u32) cluster * BytesPerCluster;
+	if ( clusterOffset + BytesPerCluster > VisClusters.size() )
+		return false;
+	const u8* visible = VisClusters.const_pointer() + clusterOffset;
+
+	// faces are shared by several leafs, add them only once
+	if ( ++VisitedID == 0 )
+	{
+		for ( u32 i = 0; i < FaceVisited.size(); ++i )
+			FaceVisited[i] = 0;
+		VisitedID = 1;
+	}
+
+	for ( u32 l = 0; l < VisLeafs.size(); ++l )
+	{
+		const SLeaf& leaf = VisLeafs[l];
+		if ( leaf.Cluster < 0 || leaf.FaceCount == 0 ||
+			(leaf.Cluster >> 3) >= BytesPerCluster ||
+			0 == ( visible[leaf.Cluster >> 3] & ( 1 << ( leaf.Cluster & 7 ) ) ) )
+			continue;
+
+		if ( frustum )
+		{
+			u32 p;
+			for ( p = 0; p < SViewFrustum::VF_PLANE_COUNT; ++p )
+			{
+				if ( leaf.Box.classifyPlaneRelation( frustum->planes[p] ) == core::ISREL3D_FRONT )
+					break;
+			}
+			if ( p != SViewFrustum::VF_PLANE_COUNT )
+				continue;
+		}
+
+		for ( s32 f = leaf.FirstFace; f < leaf.FirstFace + leaf.FaceCount; ++f )
+		{
+			const s32 face = VisLeafFaces[f];
+			if ( face < 0 || face >= (s32) FaceRanges.size() || FaceVisited[face] == VisitedID )
+				continue;
+
+			FaceVisited[face] = VisitedID;
+			if ( FaceRanges[face].MeshBuffer >= 0 )
+				faces.push_back( (u32) face );
+		}
+	}
+
+	return true;
+}
+
+
+//! Returns where the triangles of a face are stored in the level geometry
+bool CQ3LevelMesh::getFaceRange(u32 face, u32& meshBuffer, u32& firstIndex, u32& indexCount) const
+{
+	if ( face >= FaceRanges.size() || FaceRanges[face].MeshBuffer < 0 )
+		return false;
+
+	meshBuffer = (u32) FaceRanges[face].MeshBuffer;
+	firstIndex = FaceRanges[face].FirstIndex;
+	indexCount = FaceRanges[face].IndexCount;
+	return true;
+}
+
+
 /*!
 */
 const IShader * CQ3LevelMesh::getShader(u32 index) const
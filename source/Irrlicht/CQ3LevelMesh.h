@@ -88,6 +88,16 @@ namespace scene
 		//! returns the requested brush entity
 		virtual IMesh* getBrushEntityMesh(quake3::IEntity &ent) const IRR_OVERRIDE;
 
+		//! Returns the visibility cluster of the BSP leaf containing a position
+		virtual s32 getClusterAt(const core::vector3df& pos) const IRR_OVERRIDE;
+
+		//! Collects the faces of the level geometry potentially visible from a position
+		virtual bool getVisibleFaces(const core::vector3df& pos, const SViewFrustum* frustum,
+			core::array<u32>& faces) const IRR_OVERRIDE;
+
+		//! Returns where the triangles of a face are stored in the level geometry
+		virtual bool getFaceRange(u32 face, u32& meshBuffer, u32& firstIndex, u32& indexCount) const IRR_OVERRIDE;
+
 		//Link to held meshes? ...
 
 
@@ -409,6 +419,44 @@ namespace scene
 		tBSPBrush* Brushes;
 		s32 NumBrushes;
 
+		// BSP tree and visibility which are kept after loading
+		struct SNode
+		{
+			core::plane3df Plane;
+			s32 Front;	// child node, or -(leaf+1)
+			s32 Back;
+		};
+
+		struct SLeaf
+		{
+			core::aabbox3df Box;
+			s32 Cluster;
+			s32 FirstFace;	// index into VisLeafFaces
+			s32 FaceCount;
+		};
+
+		struct SFaceRange
+		{
+			SFaceRange() : Buffer(0), MeshBuffer(-1), FirstIndex(0), IndexCount(0) {}
+
+			IMeshBuffer* Buffer;	// only used while loading
+			s32 MeshBuffer;
+			u32 FirstIndex;
+			u32 IndexCount;
+		};
+
+		core::array<SNode> VisNodes;
+		core::array<SLeaf> VisLeafs;
+		core::array<s32> VisLeafFaces;
+		core::array<u8> VisClusters;
+		s32 BytesPerCluster;
+		core::array<SFaceRange> FaceRanges;
+		mutable core::array<u32> FaceVisited;
+		mutable u32 VisitedID;
+
+		void constructVisibility();
+		s32 getLeafAt(const core::vector3df& pos) const;
+
 		scene::SMesh** BrushEntities;
 
 		scene::SMesh* Mesh[quake3::E_Q3_MESH_SIZE];
@@ -0,0 +1,218 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+
+#include "CQ3LevelSceneNode.h"
+#include "ISceneManager.h"
+#include "IVideoDriver.h"
+#include "ICameraSceneNode.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+
+//! constructor
+CQ3LevelSceneNode::CQ3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent,
+					ISceneManager* mgr, s32 id)
+	: ISceneNode(parent, mgr, id), LevelMesh(mesh), Mesh(0),
+	LastCluster(-1), LastFrustumCulled(false), AllVisible(true), PassCount(0)
+{
+#ifdef _DEBUG
+	setDebugName("CQ3LevelSceneNode");
+#endif
+
+	if (LevelMesh)
+	{
+		LevelMesh->grab();
+		Mesh = LevelMesh->getMesh(quake3::E_Q3_MESH_GEOMETRY);
+	}
+
+	if (Mesh)
+	{
+		Box = Mesh->getBoundingBox();
+		for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+			Materials.push_back(Mesh->getMeshBuffer(i)->getMaterial());
+		VisibleIndices.reallocate(Mesh->getMeshBufferCount());
+		for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+			VisibleIndices.push_back(core::array<u16>());
+	}
+}
+
+
+//! destructor
+CQ3LevelSceneNode::~CQ3LevelSceneNode()
+{
+	if (LevelMesh)
+		LevelMesh->drop();
+}
+
+
+void CQ3LevelSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Mesh)
+	{
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		PassCount = 0;
+		u32 transparentCount = 0;
+		u32 solidCount = 0;
+
+		for (u32 i=0; i<Materials.size(); ++i)
+		{
+			if (driver->needsTransparentRenderPass(Materials[i]))
+				++transparentCount;
+			else
+				++solidCount;
+
+			if (solidCount && transparentCount)
+				break;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! collects the indices of the visible faces per mesh buffer
+void CQ3LevelSceneNode::updateVisibleFaces(const core::vector3df& cameraPos, const SViewFrustum* frustum)
+{
+	const s32 cluster = LevelMesh->getClusterAt(cameraPos);
+
+	// without frustum culling the faces only change with the cluster
+	if (!frustum && !LastFrustumCulled && cluster == LastCluster)
+		return;
+
+	LastCluster = cluster;
+	LastFrustumCulled = frustum != 0;
+
+	u32 i;
+	for (i=0; i<VisibleIndices.size(); ++i)
+		VisibleIndices[i].set_used(0);
+
+	AllVisible = !LevelMesh->getVisibleFaces(cameraPos, frustum, VisibleFaces);
+	if (AllVisible)
+		return;
+
+	for (i=0; i<VisibleFaces.size(); ++i)
+	{
+		u32 buffer, first, count;
+		if (!LevelMesh->getFaceRange(VisibleFaces[i], buffer, first, count) ||
+			buffer >= VisibleIndices.size())
+			continue;
+
+		const IMeshBuffer* mb = Mesh->getMeshBuffer(buffer);
+		if (mb->getIndexType() != video::EIT_16BIT || first + count > mb->getIndexCount())
+			continue;
+
+		const u16* indices = mb->getIndices() + first;
+		core::array<u16>& visible = VisibleIndices[buffer];
+		for (u32 j=0; j<count; ++j)
+			visible.push_back(indices[j]);
+	}
+}
+
+
+//! renders the node.
+void CQ3LevelSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	ICameraSceneNode* camera = SceneManager->getActiveCamera();
+
+	if (!driver || !camera || !Mesh)
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+	++PassCount;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	// the visible faces are only collected in the first pass of the frame
+	if (PassCount == 1)
+	{
+		core::vector3df cameraPos = camera->getAbsolutePosition();
+		SViewFrustum frust = *camera->getViewFrustum();
+
+		if (!AbsoluteTransformation.isIdentity())
+		{
+			core::matrix4 invTrans(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE);
+			invTrans.transformVect(cameraPos);
+			frust.transform(invTrans);
+		}
+
+		const bool cullFrustum = (AutomaticCullingState & (EAC_FRUSTUM_BOX | EAC_FRUSTUM_SPHERE)) != 0;
+		updateVisibleFaces(cameraPos, cullFrustum ? &frust : 0);
+	}
+
+	for (u32 i=0; i<Materials.size(); ++i)
+	{
+		if (driver->needsTransparentRenderPass(Materials[i]) != isTransparentPass)
+			continue;
+
+		const IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+		if (AllVisible || mb->getIndexType() != video::EIT_16BIT)
+		{
+			driver->setMaterial(Materials[i]);
+			driver->drawMeshBuffer(mb);
+			continue;
+		}
+
+		const core::array<u16>& visible = VisibleIndices[i];
+		if (visible.empty())
+			continue;
+
+		driver->setMaterial(Materials[i]);
+		driver->drawVertexPrimitiveList(mb->getVertices(), mb->getVertexCount(),
+			visible.const_pointer(), visible.size() / 3,
+			mb->getVertexType(), EPT_TRIANGLES, video::EIT_16BIT);
+	}
+
+	if (DebugDataVisible & scene::EDS_BBOX && PassCount == 1)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		driver->setMaterial(m);
+		driver->draw3DBox(Box, video::SColor(255,255,255,255));
+	}
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CQ3LevelSceneNode::getBoundingBox() const
+{
+	return Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CQ3LevelSceneNode::getMaterial(u32 i)
+{
+	if ( i >= Materials.size() )
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CQ3LevelSceneNode::getMaterialCount() const
+{
+	return Materials.size();
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BSP_LOADER_
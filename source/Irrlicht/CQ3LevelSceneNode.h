@@ -0,0 +1,68 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_C_Q3_LEVEL_SCENE_NODE_H_INCLUDED
+#define IRR_C_Q3_LEVEL_SCENE_NODE_H_INCLUDED
+
+#include "ISceneNode.h"
+#include "IQ3LevelMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Scene node drawing the geometry of a Quake 3 level with BSP/PVS culling
+	/** Only the faces in clusters potentially visible from the leaf of
+	the camera are drawn. With automatic culling enabled the bounding boxes
+	of the BSP leafs are also tested against the view frustum. */
+	class CQ3LevelSceneNode : public ISceneNode
+	{
+	public:
+
+		//! constructor
+		CQ3LevelSceneNode(IQ3LevelMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id);
+
+		//! destructor
+		virtual ~CQ3LevelSceneNode();
+
+		virtual void OnRegisterSceneNode() IRR_OVERRIDE;
+
+		//! renders the node.
+		virtual void render() IRR_OVERRIDE;
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const IRR_OVERRIDE;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) IRR_OVERRIDE;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const IRR_OVERRIDE;
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const IRR_OVERRIDE { return ESNT_Q3_LEVEL; }
+
+	private:
+
+		//! collects the indices of the visible faces per mesh buffer
+		void updateVisibleFaces(const core::vector3df& cameraPos, const SViewFrustum* frustum);
+
+		IQ3LevelMesh* LevelMesh;
+		IMesh* Mesh;
+		core::aabbox3d<f32> Box;
+		core::array<video::SMaterial> Materials;
+
+		// visible indices for each mesh buffer
+		core::array< core::array<u16> > VisibleIndices;
+		core::array<u32> VisibleFaces;
+		s32 LastCluster;
+		bool LastFrustumCulled;
+		bool AllVisible;
+		u32 PassCount;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
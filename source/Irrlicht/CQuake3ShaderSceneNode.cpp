@@ -27,6 +27,119 @@ namespace scene
 // who, if not you..
 using namespace quake3;
 
+namespace
+{
+	// lookup tables for the periodic wave functions, like the quake3 engine has
+	const u32 WAVE_TABLE_SIZE = 1024;
+
+	struct SWaveTables
+	{
+		SWaveTables()
+		{
+			for ( u32 i = 0; i != WAVE_TABLE_SIZE; ++i )
+			{
+				const f32 x = (f32) i / (f32) WAVE_TABLE_SIZE;
+				Table[0][i] = sinf ( x * core::PI * 2.f );
+				Table[1][i] = cosf ( x * core::PI * 2.f );
+				Table[2][i] = x < 0.5f ? 1.f : -1.f;
+				Table[3][i] = x < 0.5f ? ( 4.f * x ) - 1.f : ( -4.f * x ) + 3.f;
+				Table[4][i] = x;
+				Table[5][i] = 1.f - x;
+			}
+		}
+
+		f32 Table[6][WAVE_TABLE_SIZE];
+	};
+
+	//! Evaluates a modifier function for many vertices with different phases
+	/** Same result as SModifierFunction::evaluate, but the periodic functions
+	are looked up in a table instead of being calculated per vertex. */
+	struct SWaveFunction
+	{
+		SWaveFunction ( const SModifierFunction &function, f32 dt )
+			: Function ( function ), Table ( 0 ), Dt ( dt ), Offset ( dt + function.phase )
+		{
+			static const SWaveTables tables;
+
+			if ( function.func >= SINUS && function.func <= SAWTOOTH_INVERSE )
+				Table = tables.Table [ function.func - SINUS ];
+		}
+
+		//! value of the wave function without base and amplitude
+		f32 wave ( f32 phase ) const
+		{
+			if ( 0 == Table )
+			{
+				SModifierFunction f ( Function );
+				f.phase += phase;
+				f.base = 0.f;
+				f.amp = 1.f;
+				return f.evaluate ( Dt );
+			}
+
+			const f32 x = core::fract ( ( Offset + phase ) * Function.frequency );
+			return Table [ (u32) ( x * (f32) WAVE_TABLE_SIZE ) & ( WAVE_TABLE_SIZE - 1 ) ];
+		}
+
+		f32 operator() ( f32 phase ) const
+		{
+			return Function.base + wave ( phase ) * Function.amp;
+		}
+
+		const SModifierFunction &Function;
+		const f32 *Table;
+		f32 Dt;
+		f32 Offset;
+	};
+
+	//! Collects the bounding box of the deformed vertex positions
+	/** Keeps both edges in vectors, so each vertex costs one minimum and
+	one maximum instead of the 6 compares of aabbox3d::addInternalPoint. */
+	struct SBoxBuilder
+	{
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+		SBoxBuilder ()
+			: MinEdge ( core::simd::splat ( FLT_MAX ) ), MaxEdge ( core::simd::splat ( -FLT_MAX ) ) {}
+
+		void add ( const video::S3DVertex &v )
+		{
+			// the 4th lane reads Normal.X, it is never stored
+			const core::simd::f32x4 p = core::simd::load ( &v.Pos.X );
+			MinEdge = core::simd::minimum ( MinEdge, p );
+			MaxEdge = core::simd::maximum ( MaxEdge, p );
+		}
+
+		void get ( core::aabbox3df &box ) const
+		{
+			f32 tmp[4];
+			core::simd::store ( tmp, MinEdge );
+			box.MinEdge.set ( tmp[0], tmp[1], tmp[2] );
+			core::simd::store ( tmp, MaxEdge );
+			box.MaxEdge.set ( tmp[0], tmp[1], tmp[2] );
+		}
+
+		core::simd::f32x4 MinEdge;
+		core::simd::f32x4 MaxEdge;
+#else
+		SBoxBuilder ()
+			: Box ( FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX ) {}
+
+		void add ( const video::S3DVertex &v )
+		{
+			Box.addInternalPoint ( v.Pos );
+		}
+
+		void get ( core::aabbox3df &box ) const
+		{
+			box = Box;
+		}
+
+		core::aabbox3df Box;
+#endif
+	};
+
+} // end anonymous namespace
+
 /*!
 */
 CQuake3ShaderSceneNode::CQuake3ShaderSceneNode(
@@ -37,7 +150,8 @@ CQuake3ShaderSceneNode::CQuake3ShaderSceneNode(
 		core::vector3df(0.f, 0.f, 0.f),
 		core::vector3df(0.f, 0.f, 0.f),
 		core::vector3df(1.f, 1.f, 1.f)),
-	Shader(shader), Mesh(0), Shadow(0), Original(0), MeshBuffer(0), TimeAbs(0.f)
+	Shader(shader), Mesh(0), Shadow(0), Original(0), MeshBuffer(0), TimeAbs(0.f),
+	RenderStage(ESNRP_SOLID)
 {
 	#ifdef _DEBUG
 		core::stringc dName = "CQuake3ShaderSceneNode ";
@@ -67,7 +181,10 @@ CQuake3ShaderSceneNode::CQuake3ShaderSceneNode(
 	// load all Textures in all stages
 	loadTextures( fileSystem );
 
-	setAutomaticCulling( scene::EAC_OFF );
+	RenderStage = getRenderStage();
+
+	// the vertex deformers only run for visible nodes
+	setAutomaticCulling( calculateCullingBox() ? scene::EAC_BOX : scene::EAC_OFF );
 }
 
 
@@ -229,7 +346,7 @@ void CQuake3ShaderSceneNode::OnRegisterSceneNode()
 {
 	if ( isVisible() )
 	{
-		SceneManager->registerNodeForRendering(this, getRenderStage() );
+		SceneManager->registerNodeForRendering(this, RenderStage );
 	}
 	ISceneNode::OnRegisterSceneNode();
 }
@@ -297,6 +414,86 @@ E_SCENE_NODE_RENDER_PASS CQuake3ShaderSceneNode::getRenderStage() const
 }
 
 
+/*
+	box around the vertices for all states of the vertex deformers.
+	returns false if the deformation can't be bounded
+*/
+bool CQuake3ShaderSceneNode::calculateCullingBox()
+{
+	CullingBox = MeshBuffer->getBoundingBox();
+
+	static const c8 * const deformList[] =
+	{
+		"wave","move","bulge","normal","autosprite","autosprite2"
+	};
+
+	f32 margin = 0.f;
+	for ( u32 stage = 1; stage < Shader->VarGroup->VariableGroup.size(); ++stage )
+	{
+		const SVarGroup *group = Shader->getGroup( stage );
+		for ( u32 g = 0; g != group->Variable.size(); ++g )
+		{
+			const SVariable &v = group->Variable[g];
+			if ( v.name != "deformvertexes" )
+				continue;
+
+			SModifierFunction function;
+			u32 pos = 0;
+			switch ( isEqual( v.content, pos, deformList, 6 ) )
+			{
+				case 0:
+					// deformvertexes wave <div> <func> <base> <amplitude> <phase> <freq>
+					getAsFloat( v.content, pos );
+					getModifierFunc( function, v.content, pos );
+					margin += core::abs_( function.base ) + core::abs_( function.amp );
+					break;
+				case 1:
+				{
+					// deformvertexes move <x> <y> <z> <func> <base> <amplitude> <phase> <freq>
+					core::vector3df dir;
+					dir.X = getAsFloat( v.content, pos );
+					dir.Z = getAsFloat( v.content, pos );
+					dir.Y = getAsFloat( v.content, pos );
+					getModifierFunc( function, v.content, pos );
+					margin += dir.getLength() * ( core::abs_( function.base ) + core::abs_( function.amp ) );
+				} break;
+				case 2:
+				{
+					// deformvertexes bulge <bulgeWidth> <bulgeHeight> <bulgeSpeed>
+					const f32 width = getAsFloat( v.content, pos );
+					const f32 height = getAsFloat( v.content, pos );
+					margin += core::abs_( width ) + core::abs_( height );
+				} break;
+				case 3:
+					// only changes the normals
+					break;
+				case 4:
+				case 5:
+				{
+					// quads rotate around their center
+					const video::S3DVertex2TCoords *vin = Original->Vertices.const_pointer();
+					const u32 vsize = Original->Vertices.size() & ~3;
+					for ( u32 i = 0; i < vsize; i += 4 )
+					{
+						const core::vector3df center = 0.25f * ( vin[i+0].Pos + vin[i+1].Pos + vin[i+2].Pos + vin[i+3].Pos ) - MeshOffset;
+						f32 radius = 0.f;
+						for ( u32 k = 0; k < 4; ++k )
+							radius = core::max_( radius, (f32) vin[i+k].Pos.getDistanceFrom( center + MeshOffset ) );
+						CullingBox.addInternalBox( core::aabbox3df( center - core::vector3df( radius ), center + core::vector3df( radius ) ) );
+					}
+				} break;
+				default:
+					return false;
+			}
+		}
+	}
+
+	CullingBox.MinEdge -= core::vector3df( margin );
+	CullingBox.MaxEdge += core::vector3df( margin );
+	return true;
+}
+
+
 /*
 	render in multipass technique
 */
@@ -550,8 +747,9 @@ void CQuake3ShaderSceneNode::deformvertexes_wave( f32 dt, SModifierFunction &fun
 {
 	function.wave = core::reciprocal( function.wave );
 
-	const f32 phase = function.phase;
+	const SWaveFunction wave ( function, dt );
 
+	SBoxBuilder box;
 	const u32 vsize = Original->Vertices.size();
 	for ( u32 i = 0; i != vsize; ++i )
 	{
@@ -561,20 +759,16 @@ void CQuake3ShaderSceneNode::deformvertexes_wave( f32 dt, SModifierFunction &fun
 		if ( 0 == function.count )
 			dst.Pos = src.Pos - MeshOffset;
 
-		const f32 wavephase = (dst.Pos.X + dst.Pos.Y + dst.Pos.Z) * function.wave;
-		function.phase = phase + wavephase;
-
-		const f32 f = function.evaluate( dt );
+		const f32 f = wave ( (dst.Pos.X + dst.Pos.Y + dst.Pos.Z) * function.wave );
 
 		dst.Pos.X += f * src.Normal.X;
 		dst.Pos.Y += f * src.Normal.Y;
 		dst.Pos.Z += f * src.Normal.Z;
 
-		if ( i == 0 )
-			MeshBuffer->BoundingBox.reset ( dst.Pos );
-		else
-			MeshBuffer->BoundingBox.addInternalPoint ( dst.Pos );
+		box.add ( dst );
 	}
+	if ( vsize )
+		box.get ( MeshBuffer->BoundingBox );
 	function.count = 1;
 }
 
@@ -604,6 +798,7 @@ void CQuake3ShaderSceneNode::deformvertexes_move( f32 dt, SModifierFunction &fun
 	function.wave = core::reciprocal( function.wave );
 	const f32 f = function.evaluate( dt );
 
+	SBoxBuilder box;
 	const u32 vsize = Original->Vertices.size();
 	for ( u32 i = 0; i != vsize; ++i )
 	{
@@ -617,11 +812,10 @@ void CQuake3ShaderSceneNode::deformvertexes_move( f32 dt, SModifierFunction &fun
 		dst.Pos.Y += f * function.y;
 		dst.Pos.Z += f * function.z;
 
-		if ( i == 0 )
-			MeshBuffer->BoundingBox.reset ( dst.Pos );
-		else
-			MeshBuffer->BoundingBox.addInternalPoint ( dst.Pos );
+		box.add ( dst );
 	}
+	if ( vsize )
+		box.get ( MeshBuffer->BoundingBox );
 	function.count = 1;
 
 }
@@ -640,21 +834,21 @@ void CQuake3ShaderSceneNode::deformvertexes_move( f32 dt, SModifierFunction &fun
 void CQuake3ShaderSceneNode::deformvertexes_normal( f32 dt, SModifierFunction &function )
 {
 	function.func = SINUS;
+	function.phase = 0.f;
+
+	const SWaveFunction wave ( function, dt );
+
 	const u32 vsize = Original->Vertices.size();
 	for ( u32 i = 0; i != vsize; ++i )
 	{
 		const video::S3DVertex2TCoords &src = Original->Vertices[i];
 		video::S3DVertex &dst = MeshBuffer->Vertices[i];
 
-		function.base = atan2f ( src.Pos.X, src.Pos.Y );
-		function.phase = src.Pos.X + src.Pos.Z;
-
-		const f32 lat = function.evaluate( dt );
+		const f32 lat = atan2f ( src.Pos.X, src.Pos.Y ) +
+			wave.wave ( src.Pos.X + src.Pos.Z ) * function.amp;
 
-		function.base = src.Normal.Y;
-		function.phase = src.Normal.Z + src.Normal.X;
-
-		const f32 lng = function.evaluate( dt );
+		const f32 lng = src.Normal.Y +
+			wave.wave ( src.Normal.Z + src.Normal.X ) * function.amp;
 
 		dst.Normal.X = cosf ( lat ) * sinf ( lng );
 		dst.Normal.Y = sinf ( lat ) * sinf ( lng );
@@ -714,18 +908,17 @@ void CQuake3ShaderSceneNode::deformvertexes_bulge( f32 dt, SModifierFunction &fu
 	function.wave = core::reciprocal( function.bulgewidth );
 
 	dt *= function.bulgespeed * 0.1f;
-	const f32 phase = function.phase;
 
+	const SWaveFunction wave ( function, dt );
+
+	SBoxBuilder box;
 	const u32 vsize = Original->Vertices.size();
 	for ( u32 i = 0; i != vsize; ++i )
 	{
 		const video::S3DVertex2TCoords &src = Original->Vertices[i];
 		video::S3DVertex &dst = MeshBuffer->Vertices[i];
 
-		const f32 wavephase = (Original->Vertices[i].TCoords.X ) * function.wave;
-		function.phase = phase + wavephase;
-
-		const f32 f = function.evaluate( dt );
+		const f32 f = wave ( src.TCoords.X * function.wave );
 
 		if ( 0 == function.count )
 			dst.Pos = src.Pos - MeshOffset;
@@ -734,11 +927,10 @@ void CQuake3ShaderSceneNode::deformvertexes_bulge( f32 dt, SModifierFunction &fu
 		dst.Pos.Y += f * src.Normal.Y;
 		dst.Pos.Z += f * src.Normal.Z;
 
-		if ( i == 0 )
-			MeshBuffer->BoundingBox.reset ( dst.Pos );
-		else
-			MeshBuffer->BoundingBox.addInternalPoint ( dst.Pos );
+		box.add ( dst );
 	}
+	if ( vsize )
+		box.get ( MeshBuffer->BoundingBox );
 
 	function.count = 1;
 }
@@ -846,117 +1038,132 @@ void CQuake3ShaderSceneNode::deformvertexes_autosprite2( f32 dt, SModifierFuncti
 }
 
 /*
-	Generate Vertex Color
+	Generate Vertex Color and Alpha
+	rgbgen and alphagen are applied in one pass over the vertices
 */
-void CQuake3ShaderSceneNode::vertextransform_rgbgen( f32 dt, SModifierFunction &function )
+void CQuake3ShaderSceneNode::vertextransform_color( f32 dt, SModifierFunction &function )
 {
+	enum eSource
+	{
+		KEEP,
+		CONST,
+		FROM_VERTEX,
+		SPECULAR
+	};
+
 	u32 i;
 	const u32 vsize = Original->Vertices.size();
 
+	// rgbgen, also sets the alpha
+	eSource rgbSource = CONST;
+	video::SColor rgb ( 0xFFFFFFFF );
+
 	switch ( function.rgbgen )
 	{
 		case IDENTITY:
 			//rgbgen identity
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color.set(0xFFFFFFFF);
 			break;
 
 		case IDENTITYLIGHTING:
 			// rgbgen identitylighting TODO: overbright
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color.set(0xFF7F7F7F);
+			rgb.set ( 0xFF7F7F7F );
 			break;
 
 		case EXACTVERTEX:
 			// alphagen exactvertex TODO lighting
 		case VERTEX:
 			// rgbgen vertex
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color=Original->Vertices[i].Color;
+			rgbSource = FROM_VERTEX;
 			break;
 		case WAVE:
 		{
 			// rgbGen wave <func> <base> <amp> <phase> <freq>
 			f32 f = function.evaluate( dt ) * 255.f;
 			s32 value = core::clamp( core::floor32(f), 0, 255 );
-			value = 0xFF000000 | value << 16 | value << 8 | value;
-
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color.set(value);
+			rgb.set ( 0xFF000000 | value << 16 | value << 8 | value );
 		} break;
 		case CONSTANT:
 		{
 			//rgbgen const ( x y z )
 			video::SColorf cf( function.x, function.y, function.z );
-			video::SColor col = cf.toSColor();
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color=col;
+			rgb = cf.toSColor();
 		} break;
 		default:
+			rgbSource = KEEP;
 			break;
 	}
-}
 
-/*
-	Generate Vertex Color, Alpha
-*/
-void CQuake3ShaderSceneNode::vertextransform_alphagen( f32 dt, SModifierFunction &function )
-{
-	u32 i;
-	const u32 vsize = Original->Vertices.size();
+	// alphagen
+	eSource alphaSource = CONST;
+	u32 alpha = 0xFF;
+	const f32 *m = 0;
 
 	switch ( function.alphagen )
 	{
 		case IDENTITY:
 			//alphagen identity
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color.setAlpha ( 0xFF );
 			break;
 
 		case EXACTVERTEX:
 			// alphagen exactvertex TODO lighting
 		case VERTEX:
 			// alphagen vertex
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color.setAlpha ( Original->Vertices[i].Color.getAlpha() );
+			alphaSource = FROM_VERTEX;
 			break;
 		case CONSTANT:
-		{
 			// alphagen const
-			u32 a = (u32) ( function.x * 255.f );
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color.setAlpha ( a );
-		} break;
+			alpha = (u32) ( function.x * 255.f );
+			break;
 
 		case LIGHTINGSPECULAR:
-		{
 			// alphagen lightingspecular TODO!!!
-			const SViewFrustum *frustum = SceneManager->getActiveCamera()->getViewFrustum();
-			const core::matrix4 &view = frustum->getTransform ( video::ETS_VIEW );
-
-			const f32 *m = view.pointer();
-
-			for ( i = 0; i != vsize; ++i )
-			{
-				const core::vector3df &n = Original->Vertices[i].Normal;
-				MeshBuffer->Vertices[i].Color.setAlpha ((u32)( 128.f *(1.f+(n.X*m[0]+n.Y*m[1]+n.Z*m[2]))));
-			}
-
-		} break;
-
+			alphaSource = SPECULAR;
+			m = SceneManager->getActiveCamera()->getViewFrustum()->getTransform ( video::ETS_VIEW ).pointer();
+			break;
 
 		case WAVE:
 		{
 			// alphagen wave
 			f32 f = function.evaluate( dt ) * 255.f;
-			s32 value = core::clamp( core::floor32(f), 0, 255 );
-
-			for ( i = 0; i != vsize; ++i )
-				MeshBuffer->Vertices[i].Color.setAlpha ( value );
+			alpha = core::clamp( core::floor32(f), 0, 255 );
 		} break;
 		default:
+			alphaSource = KEEP;
 			break;
 	}
+
+	if ( rgbSource == KEEP && alphaSource == KEEP )
+		return;
+
+	video::S3DVertex *dst = MeshBuffer->Vertices.pointer();
+	const video::S3DVertex2TCoords *src = Original->Vertices.const_pointer();
+
+	for ( i = 0; i != vsize; ++i )
+	{
+		video::SColor &color = dst[i].Color;
+
+		if ( rgbSource == CONST )
+			color = rgb;
+		else if ( rgbSource == FROM_VERTEX )
+			color = src[i].Color;
+
+		switch ( alphaSource )
+		{
+			case CONST:
+				color.setAlpha ( alpha );
+				break;
+			case FROM_VERTEX:
+				color.setAlpha ( src[i].Color.getAlpha() );
+				break;
+			case SPECULAR:
+			{
+				const core::vector3df &n = src[i].Normal;
+				color.setAlpha ((u32)( 128.f *(1.f+(n.X*m[0]+n.Y*m[1]+n.Z*m[2]))));
+			} break;
+			default:
+				break;
+		}
+	}
 }
 
 
@@ -976,17 +1183,14 @@ void CQuake3ShaderSceneNode::vertextransform_tcgen( f32 dt, SModifierFunction &f
 		{
 			function.wave = core::reciprocal( function.phase );
 
-			const f32 phase = function.phase;
+			const SWaveFunction wave ( function, dt );
 
 			for ( i = 0; i != vsize; ++i )
 			{
 				const video::S3DVertex2TCoords &src = Original->Vertices[i];
 				video::S3DVertex &dst = MeshBuffer->Vertices[i];
 
-				const f32 wavephase = (src.Pos.X + src.Pos.Y + src.Pos.Z) * function.wave;
-				function.phase = phase + wavephase;
-
-				const f32 f = function.evaluate( dt );
+				const f32 f = wave ( (src.Pos.X + src.Pos.Y + src.Pos.Z) * function.wave );
 
 				dst.TCoords.X = src.TCoords.X + f * src.Normal.X;
 				dst.TCoords.Y = src.TCoords.Y + f * src.Normal.Y;
@@ -1344,8 +1548,7 @@ void CQuake3ShaderSceneNode::animate( u32 stage,core::matrix4 &texture )
 
 	} // group
 
-	vertextransform_rgbgen( TimeAbs, function );
-	vertextransform_alphagen( TimeAbs, function );
+	vertextransform_color( TimeAbs, function );
 	vertextransform_tcgen( TimeAbs, function );
 }
 
@@ -1358,7 +1561,7 @@ void CQuake3ShaderSceneNode::OnAnimate(u32 timeMs)
 
 const core::aabbox3d<f32>& CQuake3ShaderSceneNode::getBoundingBox() const
 {
-	return MeshBuffer->getBoundingBox();
+	return CullingBox;
 }
 
 
@@ -95,8 +95,7 @@ private:
 	void deformvertexes_normal ( f32 dt, quake3::SModifierFunction &function );
 
 	void vertextransform_tcgen ( f32 dt, quake3::SModifierFunction &function );
-	void vertextransform_rgbgen ( f32 dt, quake3::SModifierFunction &function );
-	void vertextransform_alphagen ( f32 dt, quake3::SModifierFunction &function );
+	void vertextransform_color ( f32 dt, quake3::SModifierFunction &function );
 
 	void transformtex ( const core::matrix4 &m, const u32 clamp );
 
@@ -105,6 +104,11 @@ private:
 	void animate( u32 stage, core::matrix4 &texture );
 
 	E_SCENE_NODE_RENDER_PASS getRenderStage() const;
+	E_SCENE_NODE_RENDER_PASS RenderStage;
+
+	// box around all deformed vertices, used for culling
+	bool calculateCullingBox();
+	core::aabbox3df CullingBox;
 
 };
 
@@ -351,7 +351,7 @@ bool CSceneCollisionManager::getCollisionPoint(SCollisionHit& hitResult, const c
 
 	s32 cnt = 0;
 	irr::core::array<SCollisionTriangleRange> outTriangleInfo;
-	selector->getTriangles(Triangles.pointer(), totalcnt, cnt, ray, 0, true, &outTriangleInfo);
+	selector->getTrianglesForClosestHit(Triangles.pointer(), totalcnt, cnt, ray, 0, true, &outTriangleInfo);
 
 	const core::vector3df linevect = ray.getVector().normalize();
 	core::vector3df intersection;
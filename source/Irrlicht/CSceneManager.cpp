@@ -5,10 +5,12 @@
 #include "IrrCompileConfig.h"
 #include "CSceneManager.h"
 #include "IVideoDriver.h"
+#include "IMeshManipulator.h"
 #include "IFileSystem.h"
 #include "SAnimatedMesh.h"
 #include "SOverrideMaterial.h"
 #include "CMeshCache.h"
+#include "COcclusionCuller.h"
 #include "IXMLWriter.h"
 #include "ISceneUserDataSerializer.h"
 #include "IGUIEnvironment.h"
@@ -30,6 +32,10 @@
 #include "CIrrMeshFileLoader.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+#include "CIrrBinaryMeshFileLoader.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_BSP_LOADER_
 #include "CBSPMeshFileLoader.h"
 #endif
@@ -138,6 +144,10 @@
 #include "CB3DMeshWriter.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+#include "CIrrBinaryMeshWriter.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_CUBE_SCENENODE_
 #include "CCubeSceneNode.h"
 #endif // _IRR_COMPILE_WITH_CUBE_SCENENODE_
@@ -154,6 +164,9 @@
 #include "CBillboardSceneNode.h"
 #endif // _IRR_COMPILE_WITH_BILLBOARD_SCENENODE_
 #include "CMeshSceneNode.h"
+#include "CInstancedMeshSceneNode.h"
+#include "CStaticBatchSceneNode.h"
+#include "CLODMeshSceneNode.h"
 #include "CSkyBoxSceneNode.h"
 #ifdef _IRR_COMPILE_WITH_SKYDOME_SCENENODE_
 #include "CSkyDomeSceneNode.h"
@@ -179,6 +192,7 @@
 #include "CEmptySceneNode.h"
 #include "CTextSceneNode.h"
 #include "CQuake3ShaderSceneNode.h"
+#include "CQ3LevelSceneNode.h"
 #include "CVolumeLightSceneNode.h"
 
 #include "CDefaultSceneNodeFactory.h"
@@ -219,7 +233,7 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 : ISceneNode(0, 0), Driver(driver), FileSystem(fs), GUIEnvironment(gui),
 	CursorControl(cursorControl), CollisionManager(0),
 	ActiveCamera(0), ShadowColor(150,0,0,0), AmbientLight(0,0,0,0), Parameters(0),
-	MeshCache(cache), CurrentRenderPass(ESNRP_NONE), LightManager(0),
+	MeshCache(cache), CurrentRenderPass(ESNRP_NONE), LightManager(0), OcclusionCuller(0),
 	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
 {
 	#ifdef _DEBUG
@@ -330,6 +344,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	#ifdef _IRR_COMPILE_WITH_B3D_LOADER_
 	MeshLoaderList.push_back(new CB3DMeshFileLoader(this));
 	#endif
+	#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_
+	MeshLoaderList.push_back(new CIrrBinaryMeshFileLoader(this));
+	#endif
 
 	// scene loaders
 	#ifdef _IRR_COMPILE_WITH_IRR_SCENE_LOADER_
@@ -418,6 +435,9 @@ CSceneManager::~CSceneManager()
 	if (LightManager)
 		LightManager->drop();
 
+	removeAllOccluders();
+	delete OcclusionCuller;
+
 	// remove all nodes and animators before dropping the driver
 	// as render targets may be destroyed twice
 
@@ -468,11 +488,113 @@ IAnimatedMesh* CSceneManager::getMesh(io::IReadFile* file)
 	return msh;
 }
 
+#if defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_) && defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_)
+namespace
+{
+	//! Archive without files, which records the names of the files opened while it is the first archive
+	class CFileOpenRecorder : public io::IFileArchive
+	{
+	public:
+		CFileOpenRecorder(io::IFileSystem* fs)
+			: FileList(fs->createEmptyFileList("", true, true))
+		{
+		}
+
+		~CFileOpenRecorder()
+		{
+			FileList->drop();
+		}
+
+		virtual io::IReadFile* createAndOpenFile(const io::path& filename) IRR_OVERRIDE
+		{
+			if (Names.linear_search(filename) < 0)
+				Names.push_back(filename);
+			return 0;
+		}
+
+		virtual io::IReadFile* createAndOpenFile(u32 index) IRR_OVERRIDE
+		{
+			return 0;
+		}
+
+		virtual const io::IFileList* getFileList() const IRR_OVERRIDE
+		{
+			return FileList;
+		}
+
+		virtual const io::path& getArchiveName() const IRR_OVERRIDE
+		{
+			return ArchiveName;
+		}
+
+		core::array<io::path> Names;
+
+	private:
+		io::IFileList* FileList;
+		io::path ArchiveName;
+	};
+}
+#endif
+
 // load and create a mesh which we know already isn't in the cache and put it in there
 IAnimatedMesh* CSceneManager::getUncachedMesh(io::IReadFile* file, const io::path& filename, const io::path& cachename)
 {
 	IAnimatedMesh* msh = 0;
 
+	// a binary conversion of the same file contents is faster to load
+	core::array<u8> data;
+	const io::path binaryName = getBinaryMeshCacheName(file, filename, data);
+	if (!binaryName.empty())
+	{
+		io::IReadFile* binaryFile = FileSystem->createAndOpenFile(binaryName);
+		if (binaryFile)
+		{
+			msh = createMeshFromFile(binaryFile, binaryName);
+			binaryFile->drop();
+		}
+	}
+
+	if (!msh)
+	{
+		if (binaryName.empty())
+			msh = createMeshFromFile(file, filename);
+#if defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_) && defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_)
+		else
+		{
+			// the loaders parse the contents read for the hash instead of reading the file again
+			io::IReadFile* memoryFile = FileSystem->createMemoryReadFile(data.const_pointer(), data.size(), file->getFileName());
+
+			// other files the loaders open, like material libraries, become dependencies of the conversion
+			CFileOpenRecorder* recorder = new CFileOpenRecorder(FileSystem);
+			FileSystem->addFileArchive(recorder);
+			FileSystem->moveFileArchive(FileSystem->getFileArchiveCount()-1, -(s32)FileSystem->getFileArchiveCount());
+			msh = createMeshFromFile(memoryFile, filename);
+			FileSystem->removeFileArchive(recorder);
+			memoryFile->drop();
+
+			if (msh)
+				writeBinaryMeshCache(msh, binaryName, recorder->Names);
+			recorder->drop();
+		}
+#endif
+	}
+
+	if (!msh)
+		os::Printer::log("Could not load mesh, file format seems to be unsupported", filename, ELL_ERROR);
+	else
+	{
+		MeshCache->addMesh(cachename, msh);
+		msh->drop();
+		os::Printer::log("Loaded mesh", filename, ELL_DEBUG);
+	}
+
+	return msh;
+}
+
+
+// creates a mesh with the first loader accepting the file
+IAnimatedMesh* CSceneManager::createMeshFromFile(io::IReadFile* file, const io::path& filename)
+{
 	// iterate the list in reverse order so user-added loaders can override the built-in ones
 	s32 count = MeshLoaderList.size();
 	for (s32 i=count-1; i>=0; --i)
@@ -481,22 +603,86 @@ IAnimatedMesh* CSceneManager::getUncachedMesh(io::IReadFile* file, const io::pat
 		{
 			// reset file to avoid side effects of previous calls to createMesh
 			file->seek(0);
-			msh = MeshLoaderList[i]->createMesh(file);
+			IAnimatedMesh* msh = MeshLoaderList[i]->createMesh(file);
 			if (msh)
-			{
-				MeshCache->addMesh(cachename, msh);
-				msh->drop();
-				break;
-			}
+				return msh;
 		}
 	}
+	return 0;
+}
 
-	if (!msh)
-		os::Printer::log("Could not load mesh, file format seems to be unsupported", filename, ELL_ERROR);
-	else
-		os::Printer::log("Loaded mesh", filename, ELL_DEBUG);
 
-	return msh;
+// returns the name of the binary conversion of the file in the BINARY_MESH_CACHE_PATH, if set
+io::path CSceneManager::getBinaryMeshCacheName(io::IReadFile* file, const io::path& filename, core::array<u8>& outData)
+{
+#if defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_LOADER_) && defined(_IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_)
+	const io::path cachePath = getParameters()->getAttributeAsString(BINARY_MESH_CACHE_PATH);
+	if (cachePath.empty() || core::hasFileExtension(filename, "irrbm"))
+		return io::path();
+
+	const long size = file->getSize();
+	if (size <= 0)
+		return io::path();
+
+	outData.set_used((u32)size);
+	file->seek(0);
+	if (file->read(outData.pointer(), (size_t)size) != (size_t)size)
+		return io::path();
+
+	u32 hash[2];
+	hashIrrBMData(outData.const_pointer(), outData.size(), hash);
+
+	c8 name[32];
+	snprintf_irr(name, 32, "/%08x%08x.irrbm", hash[0], hash[1]);
+	return cachePath + name;
+#else
+	return io::path();
+#endif
+}
+
+
+// writes the binary conversion of a mesh loaded from another format
+void CSceneManager::writeBinaryMeshCache(IAnimatedMesh* msh, const io::path& binaryName, const core::array<io::path>& dependencies)
+{
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+	// morph target animations and quake 3 levels can't be stored
+	if ((msh->getMeshType() != EAMT_SKINNED && msh->getFrameCount() > 1) ||
+		msh->getMeshType() == EAMT_BSP || msh->getMeshBufferCount() == 0)
+		return;
+
+	// textures are loaded by name with the binary mesh, so only other files are checked
+	core::array<io::path> textures;
+	for (u32 i=0; i<msh->getMeshBufferCount(); ++i)
+	{
+		const video::SMaterial& material = msh->getMeshBuffer(i)->getMaterial();
+		for (u32 j=0; j<video::MATERIAL_MAX_TEXTURES; ++j)
+		{
+			if (material.getTexture(j))
+				textures.push_back(material.getTexture(j)->getName().getPath());
+		}
+	}
+
+	CIrrBinaryMeshWriter* writer = new CIrrBinaryMeshWriter();
+	for (u32 i=0; i<dependencies.size(); ++i)
+	{
+		if (textures.linear_search(FileSystem->getAbsolutePath(dependencies[i])) < 0)
+			writer->addDependency(dependencies[i], getIrrBMDependency(FileSystem, dependencies[i]));
+	}
+
+	io::IWriteFile* file = FileSystem->createAndWriteFile(binaryName);
+	if (file)
+	{
+		// a partly written file is rejected by the loader and written again on the next load
+		if (writer->writeMesh(file, msh))
+			os::Printer::log("Wrote binary mesh cache", binaryName, ELL_DEBUG);
+		else
+			os::Printer::log("Could not write binary mesh cache", binaryName, ELL_WARNING);
+		file->drop();
+	}
+	else
+		os::Printer::log("Could not write binary mesh cache", binaryName, ELL_WARNING);
+	writer->drop();
+#endif
 }
 
 //! returns the video driver
@@ -589,6 +775,27 @@ IMeshSceneNode* CSceneManager::addQuake3SceneNode(const IMeshBuffer* meshBuffer,
 }
 
 
+//! Adds a scene node drawing the BSP and PVS culled geometry of a quake3 level
+ISceneNode* CSceneManager::addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+					ISceneNode* parent, s32 id)
+{
+#ifdef _IRR_COMPILE_WITH_BSP_LOADER_
+	if (!mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	CQ3LevelSceneNode* node = new CQ3LevelSceneNode(mesh, parent, this, id);
+	node->drop();
+
+	return node;
+#else
+	return 0;
+#endif
+}
+
+
 //! adds Volume Lighting Scene Node.
 //! the returned pointer must not be dropped.
 IVolumeLightSceneNode* CSceneManager::addVolumeLightSceneNode(
@@ -666,6 +873,80 @@ IMeshSceneNode* CSceneManager::addMeshSceneNode(IMesh* mesh, ISceneNode* parent,
 }
 
 
+//! adds a scene node for rendering many instances of a static mesh
+//! the returned pointer must not be dropped.
+IInstancedMeshSceneNode* CSceneManager::addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, s32 id,
+	const core::vector3df& position, const core::vector3df& rotation,
+	const core::vector3df& scale)
+{
+	if (!mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	IInstancedMeshSceneNode* node = new CInstancedMeshSceneNode(mesh, parent, this, id, position, rotation, scale);
+	node->drop();
+
+	return node;
+}
+
+
+//! adds a scene node drawing the merged geometry of static mesh scene nodes
+//! the returned pointer must not be dropped.
+IStaticBatchSceneNode* CSceneManager::addStaticBatchSceneNode(ISceneNode* parent, s32 id, f32 clusterSize)
+{
+	if (!parent)
+		parent = this;
+
+	IStaticBatchSceneNode* node = new CStaticBatchSceneNode(clusterSize, parent, this, id);
+	node->drop();
+
+	return node;
+}
+
+
+//! adds a scene node drawing less detailed versions of a mesh when it gets smaller on the screen
+//! the returned pointer must not be dropped.
+ILODMeshSceneNode* CSceneManager::addLODMeshSceneNode(IMesh* mesh, ISceneNode* parent, s32 id,
+	u32 levelCount, f32 reduction, const core::vector3df& position,
+	const core::vector3df& rotation, const core::vector3df& scale)
+{
+	if (!mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	ILODMeshSceneNode* node = new CLODMeshSceneNode(mesh, parent, this, id, position, rotation, scale);
+	node->drop();
+
+	// all details down to a quarter of the screen height, below that the
+	// triangles shrink with the screen area of the node
+	u32 lastPrimitives = 0;
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+		lastPrimitives += mesh->getMeshBuffer(i)->getPrimitiveCount();
+
+	for (u32 level=1; level<levelCount; ++level)
+	{
+		IMesh* simplified = getMeshManipulator()->createSimplifiedMesh(mesh, powf(reduction, (f32)level));
+
+		u32 primitives = 0;
+		for (u32 i=0; i<simplified->getMeshBufferCount(); ++i)
+			primitives += simplified->getMeshBuffer(i)->getPrimitiveCount();
+
+		if (primitives < lastPrimitives)
+		{
+			node->addLevel(simplified, 0.25f * powf(reduction, 0.5f * (level-1)));
+			lastPrimitives = primitives;
+		}
+		simplified->drop();
+	}
+
+	return node;
+}
+
+
 //! Adds a scene node for rendering a animated water surface mesh.
 ISceneNode* CSceneManager::addWaterSurfaceSceneNode(IMesh* mesh, f32 waveHeight, f32 waveSpeed, f32 waveLength,
 	ISceneNode* parent, s32 id, const core::vector3df& position,
@@ -1309,10 +1590,126 @@ bool CSceneManager::isCulled(const ISceneNode* node) const
 		}
 	}
 
+	// hidden behind occluders ?
+	if (!result && (node->getAutomaticCulling() & scene::EAC_OCC_CPU) && OcclusionCuller)
+	{
+		result = OcclusionCuller->isOccluded(node->getBoundingBox(), node->getAbsoluteTransformation());
+	}
+
 	return result;
 }
 
 
+//! Returns the mesh rasterized for an occluder without an own mesh
+static const IMesh* getOccluderMesh(ISceneNode* node)
+{
+	switch (node->getType())
+	{
+	case ESNT_MESH:
+	case ESNT_CUBE:
+	case ESNT_SPHERE:
+	case ESNT_OCTREE:
+		return static_cast<IMeshSceneNode*>(node)->getMesh();
+	case ESNT_ANIMATED_MESH:
+		{
+			IAnimatedMesh* mesh = static_cast<IAnimatedMeshSceneNode*>(node)->getMesh();
+			return mesh ? mesh->getMesh(0) : 0;
+		}
+	default:
+		return 0;
+	}
+}
+
+
+//! Adds a node which hides other nodes for the software occlusion culling
+void CSceneManager::addOccluder(ISceneNode* node, const IMesh* mesh)
+{
+	if (!node || (!mesh && !getOccluderMesh(node)))
+		return;
+
+	removeOccluder(node);
+
+	SOccluder occluder;
+	occluder.Node = node;
+	occluder.Mesh = mesh;
+	node->grab();
+	if (mesh)
+		mesh->grab();
+	Occluders.push_back(occluder);
+
+	if (!OcclusionCuller)
+		OcclusionCuller = new COcclusionCuller();
+}
+
+
+//! Removes an occluder added with addOccluder()
+void CSceneManager::removeOccluder(ISceneNode* node)
+{
+	for (u32 i=0; i<Occluders.size(); ++i)
+	{
+		if (Occluders[i].Node == node)
+		{
+			Occluders[i].Node->drop();
+			if (Occluders[i].Mesh)
+				Occluders[i].Mesh->drop();
+			Occluders.erase(i);
+			return;
+		}
+	}
+}
+
+
+//! Removes all occluders
+void CSceneManager::removeAllOccluders()
+{
+	for (u32 i=0; i<Occluders.size(); ++i)
+	{
+		Occluders[i].Node->drop();
+		if (Occluders[i].Mesh)
+			Occluders[i].Mesh->drop();
+	}
+	Occluders.clear();
+	if (OcclusionCuller)
+		OcclusionCuller->clear();
+}
+
+
+//! rasterizes the occluders for the active camera
+void CSceneManager::drawOccluders()
+{
+	if (!OcclusionCuller)
+		return;
+
+	if (!ActiveCamera || Occluders.empty())
+	{
+		OcclusionCuller->clear();
+		return;
+	}
+
+	OcclusionCuller->begin(ActiveCamera->getViewMatrix(), ActiveCamera->getProjectionMatrix(), ActiveCamera->getNearValue());
+	for (u32 i=0; i<Occluders.size(); ++i)
+	{
+		ISceneNode* node = Occluders[i].Node;
+
+		// occluders removed from the scene with ISceneNode::remove() are released here
+		const ISceneNode* root = node;
+		while (root->getParent())
+			root = root->getParent();
+		if (root != this)
+		{
+			removeOccluder(node);
+			--i;
+			continue;
+		}
+
+		if (!node->isTrulyVisible())
+			continue;
+		OcclusionCuller->drawMesh(Occluders[i].Mesh ? Occluders[i].Mesh : getOccluderMesh(node), node->getAbsoluteTransformation());
+	}
+	OcclusionCuller->end();
+}
+
+
 //! registers a node for rendering it at a specific time.
 u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDER_PASS pass)
 {
@@ -1500,6 +1897,9 @@ void CSceneManager::drawAll()
 	}
 	IRR_PROFILE(getProfiler().stop(EPID_SM_RENDER_CAMERAS));
 
+	// the occluders are needed when the nodes are culled during registration
+	drawOccluders();
+
 	// let all nodes register themselves
 	OnRegisterSceneNode();
 
@@ -2173,6 +2573,7 @@ bool CSceneManager::postEventFromUser(const SEvent& event)
 //! Removes all children of this scene node
 void CSceneManager::removeAll()
 {
+	removeAllOccluders();
 	ISceneNode::removeAll();
 	setActiveCamera(0);
 	// Make sure the driver is reset, might need a more complex method at some point
@@ -2783,6 +3184,13 @@ IMeshWriter* CSceneManager::createMeshWriter(EMESH_WRITER_TYPE type)
 #else
 		return 0;
 #endif
+
+	case EMWT_IRR_BINARY_MESH:
+#ifdef _IRR_COMPILE_WITH_IRR_BINARY_MESH_WRITER_
+		return new CIrrBinaryMeshWriter();
+#else
+		return 0;
+#endif
 	}
 
 	return 0;
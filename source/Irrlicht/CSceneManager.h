@@ -28,6 +28,8 @@ namespace scene
 	/*!
 		The Scene Manager manages scene nodes, mesh resources, cameras and all the other stuff.
 	*/
+	class COcclusionCuller;
+
 	class CSceneManager : public ISceneManager, public ISceneNode
 	{
 	public:
@@ -97,6 +99,26 @@ namespace scene
 			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero=false) IRR_OVERRIDE;
 
+		//! adds a scene node for rendering many instances of a static mesh
+		//! the returned pointer must not be dropped.
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f)) IRR_OVERRIDE;
+
+		//! adds a scene node drawing the merged geometry of static mesh scene nodes
+		//! the returned pointer must not be dropped.
+		virtual IStaticBatchSceneNode* addStaticBatchSceneNode(ISceneNode* parent=0, s32 id=-1,
+			f32 clusterSize=128.f) IRR_OVERRIDE;
+
+		//! adds a scene node drawing less detailed versions of a mesh when it gets smaller on the screen
+		//! the returned pointer must not be dropped.
+		virtual ILODMeshSceneNode* addLODMeshSceneNode(IMesh* mesh, ISceneNode* parent=0, s32 id=-1,
+			u32 levelCount=4, f32 reduction=0.5f,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f)) IRR_OVERRIDE;
+
 		//! Adds a scene node for rendering a animated water surface mesh.
 		virtual ISceneNode* addWaterSurfaceSceneNode(IMesh* mesh, f32 waveHeight, f32 waveSpeed, f32 wlength, ISceneNode* parent=0, s32 id=-1,
 			const core::vector3df& position = core::vector3df(0,0,0),
@@ -206,6 +228,10 @@ namespace scene
 		virtual IMeshSceneNode* addQuake3SceneNode(const IMeshBuffer* meshBuffer, const quake3::IShader * shader,
 			ISceneNode* parent=0, s32 id=-1) IRR_OVERRIDE;
 
+		//! Adds a scene node drawing the BSP and PVS culled geometry of a quake3 level
+		virtual ISceneNode* addQuake3LevelSceneNode(IQ3LevelMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1) IRR_OVERRIDE;
+
 
 		//! Adds a Hill Plane mesh to the mesh pool. The mesh is
 		//! generated on the fly and looks like a plane with some hills
@@ -547,11 +573,32 @@ namespace scene
 		//! returns if node is culled
 		virtual bool isCulled(const ISceneNode* node) const IRR_OVERRIDE;
 
+		//! Adds a node which hides other nodes for the software occlusion culling
+		virtual void addOccluder(ISceneNode* node, const IMesh* mesh=0) IRR_OVERRIDE;
+
+		//! Removes an occluder added with addOccluder()
+		virtual void removeOccluder(ISceneNode* node) IRR_OVERRIDE;
+
+		//! Removes all occluders
+		virtual void removeAllOccluders() IRR_OVERRIDE;
+
 	private:
 
+		//! rasterizes the occluders for the active camera
+		void drawOccluders();
+
 		// load and create a mesh which we know already isn't in the cache and put it in there
 		IAnimatedMesh* getUncachedMesh(io::IReadFile* file, const io::path& filename, const io::path& cachename);
 
+		//! creates a mesh with the first loader accepting the file, without adding it to the mesh cache
+		IAnimatedMesh* createMeshFromFile(io::IReadFile* file, const io::path& filename);
+
+		//! name of the binary conversion of the file when BINARY_MESH_CACHE_PATH is set, else empty, reads the file into outData
+		io::path getBinaryMeshCacheName(io::IReadFile* file, const io::path& filename, core::array<u8>& outData);
+
+		//! writes a loaded mesh as binary conversion, which is outdated when one of the dependencies changes
+		void writeBinaryMeshCache(IAnimatedMesh* msh, const io::path& binaryName, const core::array<io::path>& dependencies);
+
 		//! clears the deletion list
 		void clearDeletionList();
 
@@ -683,6 +730,15 @@ namespace scene
 		//! over the scene lighting and rendering.
 		ILightManager* LightManager;
 
+		//! node and optional mesh of an occluder, both grabbed
+		struct SOccluder
+		{
+			ISceneNode* Node;
+			const IMesh* Mesh;
+		};
+		core::array<SOccluder> Occluders;
+		COcclusionCuller* OcclusionCuller;
+
 		//! constants for reading and writing XML.
 		//! Not made static due to portability problems.
 		const core::stringw IRR_XML_FORMAT_SCENE;
@@ -201,6 +201,9 @@ bool CSoftwareDriver::setActiveTexture(u32 stage, video::ITexture* texture)
 		return false;
 	}
 
+	if (Texture != texture)
+		++FrameStats.TextureBinds;
+
 	if (Texture)
 		Texture->drop();
 
@@ -217,6 +220,9 @@ bool CSoftwareDriver::setActiveTexture(u32 stage, video::ITexture* texture)
 //! sets a material
 void CSoftwareDriver::setMaterial(const SMaterial& material)
 {
+	if (Material != material)
+		++FrameStats.MaterialChanges;
+
 	Material = material;
 	OverrideMaterial.apply(Material);
 
@@ -271,6 +277,7 @@ bool CSoftwareDriver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag, SC
 
 	CSoftwareRenderTarget* renderTarget = static_cast<CSoftwareRenderTarget*>(target);
 	RenderTargetTexture = (renderTarget) ? renderTarget->getTexture() : 0;
+	CurrentRenderTarget = target;
 
 	if (RenderTargetTexture)
 	{
@@ -283,6 +290,7 @@ bool CSoftwareDriver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag, SC
 	}
 
 	clearBuffers(clearFlag, clearColor, clearDepth, clearStencil);
+	++FrameStats.RenderTargetSwitches;
 
 	return true;
 }
@@ -335,6 +343,14 @@ void CSoftwareDriver::setViewPort(const core::rect<s32>& area, bool clipToRender
 }
 
 
+//! Draws copies of a mesh buffer, one after the other
+void CSoftwareDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+	const core::matrix4* transforms, u32 instanceCount, const SColor* colors)
+{
+	drawInstancesOneByOne(mb, transforms, instanceCount, colors);
+}
+
+
 void CSoftwareDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 				const void* indexList, u32 primitiveCount,
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
@@ -805,6 +821,7 @@ void CSoftwareDriver::draw2DImage(const video::ITexture* texture, const core::po
 			return;
 		}
 
+		++FrameStats.DrawCalls;
 		if (useAlphaChannelOfTexture)
 			((CSoftwareTexture*)texture)->getImage()->copyToWithAlpha(
 				RenderTargetSurface, destPos, sourceRect, color, clipRect);
@@ -538,7 +538,7 @@ burning_namespace_start
 //! constructor
 CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters& params, io::IFileSystem* io, video::IImagePresenter* presenter)
 	: CNullDriver(io, params.WindowSize), BackBuffer(0), Presenter(presenter),
-	WindowId(0), SceneSourceRect(0),
+	BackBufferShared(false), WindowId(0), SceneSourceRect(0),
 	RenderTargetTexture(0), RenderTargetSurface(0), CurrentShader(0),
 	DepthBuffer(0), StencilBuffer(0)
 {
@@ -681,6 +681,7 @@ CBurningVideoDriver::CBurningVideoDriver(const irr::SIrrlichtCreationParameters&
 	// select the right renderer
 	setMaterial(Material.org);
 	samples_passed = 0;
+	InstanceColor = 0xFFFFFFFF;
 }
 
 
@@ -986,12 +987,46 @@ bool CBurningVideoDriver::beginScene(u16 clearFlag, SColor clearColor, f32 clear
 	WindowId = videoData.D3D9.HWnd;
 	SceneSourceRect = sourceRect;
 
+	selectBackBuffer();
 	clearBuffers(clearFlag, clearColor, clearDepth, clearStencil);
 
 	//memset ( TransformationFlag, 0, sizeof ( TransformationFlag ) );
 	return true;
 }
 
+//! renders into the image of the presenter when it has the format and size of the back buffer
+void CBurningVideoDriver::selectBackBuffer()
+{
+	if (!Presenter || !BackBuffer)
+		return;
+
+	// waits until the presenter has shown the last frame
+	IImage* shared = Presenter->getPresentImage(BackBuffer->getColorFormat(), BackBuffer->getDimension());
+	if (shared == BackBuffer || (!shared && !BackBufferShared))
+		return;
+
+	const bool resetRT = (RenderTargetSurface == BackBuffer);
+	const core::dimension2d<u32> size = BackBuffer->getDimension();
+	BackBuffer->drop();
+
+	if (shared)
+	{
+		// the presenter is a device creating a CImage
+		BackBuffer = (CImage*)shared;
+		BackBuffer->grab();
+	}
+	else
+	{
+		// the shared image was released, e.g. by a resized window
+		BackBuffer = new CImage(SOFTWARE_DRIVER_2_RENDERTARGET_COLOR_FORMAT, size);
+	}
+	BackBufferShared = shared != 0;
+
+	if (resetRT)
+		setRenderTargetImage2(BackBuffer);
+}
+
+
 bool CBurningVideoDriver::endScene()
 {
 	CNullDriver::endScene();
@@ -1052,6 +1087,7 @@ bool CBurningVideoDriver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag
 #else
 	RenderTargetTexture = target ? ((CSoftwareRenderTarget2*)target)->Textures[0] : 0;
 #endif
+	CurrentRenderTarget = target;
 
 	if (RenderTargetTexture)
 	{
@@ -1066,6 +1102,7 @@ bool CBurningVideoDriver::setRenderTargetEx(IRenderTarget* target, u16 clearFlag
 	}
 
 	clearBuffers(clearFlag, clearColor, clearDepth, clearStencil);
+	++FrameStats.RenderTargetSwitches;
 
 	return true;
 }
@@ -1096,9 +1133,12 @@ void CBurningVideoDriver::setRenderTargetImage2(video::IImage* color, video::IIm
 	RatioRenderTargetScreen.x = ScreenSize.Width ? (f32)RenderTargetSize.Width / ScreenSize.Width : 1.f;
 	RatioRenderTargetScreen.y = ScreenSize.Height ? (f32)RenderTargetSize.Height / ScreenSize.Height : 1.f;
 
-	int not_changed = current == RenderTargetSize;
-	burning_setbit(TransformationFlag[0][ETS_PROJECTION], not_changed, ETF_VALID);
-	burning_setbit(TransformationFlag[1][ETS_PROJECTION], not_changed, ETF_VALID);
+	// only invalidate, a projection not rebuilt since the last size change stays invalid
+	if (current != RenderTargetSize)
+	{
+		burning_setbit(TransformationFlag[0][ETS_PROJECTION], 0, ETF_VALID);
+		burning_setbit(TransformationFlag[1][ETS_PROJECTION], 0, ETF_VALID);
+	}
 
 	setViewPort(core::recti(RenderTargetSize));
 
@@ -1836,6 +1876,9 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 dest
 	const S3DVertex* base = ((S3DVertex*)source);
 	const core::matrix4* matrix = Transformation[TransformationStack];
 
+	// the color of the instance drawn by drawMeshBufferInstanced
+	const u32 vertexColor = InstanceColor == 0xFFFFFFFF ? base->Color.color : PixelMul32_2(base->Color.color, InstanceColor);
+
 	if (Material.VertexShader == BVT_Fix) goto fftransform;
 
 	{
@@ -1845,7 +1888,7 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex, const u32 dest
 		// Vertex program attribute inputs:
 		sVec4 gl_Vertex(base->Pos.X, base->Pos.Y, base->Pos.Z, 1.f);
 		sVec4 gl_Normal(base->Normal.X, base->Normal.Y, base->Normal.Z, 1.f);
-		sVec4 gl_Color; gl_Color.setA8R8G8B8(base->Color.color);
+		sVec4 gl_Color; gl_Color.setA8R8G8B8(vertexColor);
 
 		// Irrlicht TCoords and TCoords2 must be contiguous memory. baseTCoord has no 4 byte aligned start address!
 		sVec4 gl_MultiTexCoord[4];
@@ -2184,14 +2227,14 @@ fftransform:
 #if defined (SOFTWARE_DRIVER_2_LIGHTING)
 	if (EyeSpace.TL_Flag & TL_LIGHT)
 	{
-		lightVertex_eye(dest, base->Color.color);
+		lightVertex_eye(dest, vertexColor);
 	}
 	else
 	{
-		dest->Color[0].setA8R8G8B8(base->Color.color);
+		dest->Color[0].setA8R8G8B8(vertexColor);
 	}
 #else
-	dest->Color[0].setA8R8G8B8(base->Color.color);
+	dest->Color[0].setA8R8G8B8(vertexColor);
 #endif
 #endif
 
@@ -2752,22 +2795,9 @@ int CBurningVideoDriver::VertexCache_reset(const void* vertices, u32 vertexCount
 }
 
 
-//! draws a vertex primitive list
-void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
-	const void* indexList, u32 primitiveCount,
-	E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
-
+//! calculates the matrices needed to draw with the current world transformation
+void CBurningVideoDriver::transform_calc_draw()
 {
-	if (!checkPrimitiveCount(primitiveCount))
-		return;
-
-	CNullDriver::drawVertexPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
-
-	if (VertexCache_reset(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType))
-		return;
-
-	pushShader(pType, 1);
-
 	//Matrices needed for this primitive
 	transform_calc(ETS_MODEL_VIEW_PROJ);
 	if ((EyeSpace.TL_Flag & (TL_TEXTURE_TRANSFORM | TL_FOG | TL_LIGHT)) ||
@@ -2803,12 +2833,12 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 		}
 
 	}
+}
 
-	if ((u32)Material.org.MaterialType < MaterialRenderers.size())
-	{
-		MaterialRenderers[Material.org.MaterialType].Renderer->OnRender(this, (video::E_VERTEX_TYPE)VertexShader.vType);
-	}
 
+//! transforms, clips and rasterizes the primitives set by VertexCache_reset
+void CBurningVideoDriver::VertexCache_draw(u32 primitiveCount)
+{
 	s4DVertexPair* face[4];
 
 	u32 vOut;
@@ -3065,6 +3095,86 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 	}
 
 	this->samples_passed += CurrentShader->fragment_draw_count;
+}
+
+
+//! draws a vertex primitive list
+void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
+	const void* indexList, u32 primitiveCount,
+	E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType)
+
+{
+	if (!checkPrimitiveCount(primitiveCount))
+		return;
+
+	CNullDriver::drawVertexPrimitiveList(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType);
+
+	if (VertexCache_reset(vertices, vertexCount, indexList, primitiveCount, vType, pType, iType))
+		return;
+
+	pushShader(pType, 1);
+
+	transform_calc_draw();
+
+	if ((u32)Material.org.MaterialType < MaterialRenderers.size())
+	{
+		MaterialRenderers[Material.org.MaterialType].Renderer->OnRender(this, (video::E_VERTEX_TYPE)VertexShader.vType);
+	}
+
+	VertexCache_draw(primitiveCount);
+
+	//release texture
+	for (u32 m = 0; m < VertexShader.vSize[VertexShader.vType].TexSize; ++m)
+	{
+		CurrentShader->setTextureParam(m, 0, 0);
+	}
+}
+
+
+//! Draws copies of a mesh buffer with one call
+void CBurningVideoDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+	const core::matrix4* transforms, u32 instanceCount, const SColor* colors)
+{
+	if (!mb || !transforms || !instanceCount)
+		return;
+
+	const u32 primitiveCount = mb->getPrimitiveCount();
+	if (!checkPrimitiveCount(primitiveCount))
+		return;
+
+	CNullDriver::drawMeshBufferInstanced(mb, transforms, instanceCount, colors);
+
+	const void* indices = mb->getIndices();
+	if (VertexCache_reset(mb->getVertices(), mb->getVertexCount(), indices, primitiveCount,
+		mb->getVertexType(), mb->getPrimitiveType(), mb->getIndexType()))
+		return;
+
+	// vertex format, shader and view projection are shared by all instances
+	pushShader(mb->getPrimitiveType(), 1);
+
+	const core::matrix4 world = getTransform(ETS_WORLD);
+	for (u32 i = 0; i < instanceCount; ++i)
+	{
+		setTransform(ETS_WORLD, transforms[i]);
+		transform_calc_draw();
+		InstanceColor = colors ? colors[i].color : 0xFFFFFFFF;
+
+		if ((u32)Material.org.MaterialType < MaterialRenderers.size())
+		{
+			MaterialRenderers[Material.org.MaterialType].Renderer->OnRender(this, (video::E_VERTEX_TYPE)VertexShader.vType);
+		}
+
+		// the cached vertices were transformed for the previous instance
+		if (i)
+		{
+			VertexShader.setIndices(indices, mb->getIndexType());
+			VertexShader.set_info_miss();
+		}
+
+		VertexCache_draw(primitiveCount);
+	}
+	InstanceColor = 0xFFFFFFFF;
+	setTransform(ETS_WORLD, world);
 
 	//release texture
 	for (u32 m = 0; m < VertexShader.vSize[VertexShader.vType].TexSize; ++m)
@@ -3264,6 +3374,17 @@ void CBurningVideoDriver::setMaterial(const SMaterial& material)
 		// unset old material
 		u32 shaderid_old = (u32)Material.lastMaterial.MaterialType;
 
+		if (Material.resetRenderStates || in != Material.lastMaterial)
+			++FrameStats.MaterialChanges;
+
+		// textures are bound per material, the shaders only select their mipmap per primitive
+		for (u32 i = 0; i < BURNING_MATERIAL_MAX_TEXTURES; ++i)
+		{
+			const ITexture* tex = in.TextureLayer[i].Texture;
+			if (tex && (Material.resetRenderStates || tex != Material.lastMaterial.TextureLayer[i].Texture))
+				++FrameStats.TextureBinds;
+		}
+
 		if (shaderid != shaderid_old && shaderid_old < MaterialRenderers.size())
 		{
 			MaterialRenderers[shaderid_old].Renderer->OnUnsetMaterial();
@@ -3803,6 +3924,7 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture, const core
 			return;
 		}
 
+		++FrameStats.DrawCalls;
 		if (useAlphaChannelOfTexture)
 			((CSoftwareTexture2*)texture)->getImage()->copyToWithAlpha(
 				RenderTargetSurface, destPos, sourceRect, color, clipRect);
@@ -3832,6 +3954,7 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture,
 		eBlitter op = useAlphaChannelOfTexture ?
 			(argb == 0xFFFFFFFF ? BLITTER_TEXTURE_ALPHA_BLEND : BLITTER_TEXTURE_ALPHA_COLOR_BLEND) : BLITTER_TEXTURE;
 
+		++FrameStats.DrawCalls;
 		StretchBlit(op, RenderTargetSurface, clipRect, &destRect,
 			((CSoftwareTexture2*)texture)->getImage(), &sourceRect, &texture->getOriginalSize(), argb
 		);
@@ -4253,6 +4376,7 @@ void CBurningVideoDriver::OnResize(const core::dimension2d<u32>& size)
 		if (BackBuffer)
 			BackBuffer->drop();
 		BackBuffer = new CImage(SOFTWARE_DRIVER_2_RENDERTARGET_COLOR_FORMAT, realSize);
+		BackBufferShared = false;
 
 		if (resetRT)
 			setRenderTargetImage2(BackBuffer);
@@ -4438,6 +4562,17 @@ void CBurningVideoDriver::clearBuffers(u16 flag, SColor color, f32 depth, u8 ste
 	if ((flag & ECBF_COLOR) && RenderTargetSurface) image_fill(RenderTargetSurface, color, Interlaced);
 	if ((flag & ECBF_DEPTH) && DepthBuffer) DepthBuffer->clear(depth, Interlaced);
 	if ((flag & ECBF_STENCIL) && StencilBuffer) StencilBuffer->clear(stencil, Interlaced);
+
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	// full clears are only recorded, the tiles are written when drawn to
+	if (Interlaced.bypass)
+	{
+		if ((flag & ECBF_DEPTH) && DepthBuffer)
+			FrameStats.ClearTilesDeferred += ((CDepthBuffer*)DepthBuffer)->getClearTileCount();
+		if ((flag & ECBF_STENCIL) && StencilBuffer)
+			FrameStats.ClearTilesDeferred += ((CStencilBuffer*)StencilBuffer)->getClearTileCount();
+	}
+#endif
 }
 
 #if 0
@@ -4590,6 +4725,10 @@ void CBurningVideoDriver::drawStencilShadow(bool clearStencilBuffer, video::SCol
 	const tVideoSample alpha = extractAlpha(leftUpEdge.color) >> (bit32 ? 0 : 3);
 	const tVideoSample src = bit32 ? leftUpEdge.color : video::A8R8G8B8toA1R5G5B5(leftUpEdge.color);
 
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	FrameStats.ClearTilesResolved += ((CStencilBuffer*)StencilBuffer)->resolveClear();
+#endif
+
 	interlace_scanline_data line;
 	for (line.y = 0; line.y < h; line.y += SOFTWARE_DRIVER_2_STEP_Y)
 	{
@@ -4785,45 +4924,29 @@ IVideoDriver* CBurningVideoDriver::getVideoDriver()
 }
 
 
-//! Run occlusion query. Draws mesh stored in query.
-/** If the mesh shall not be rendered visible, use
-overrideMaterial to disable the color and depth buffer. */
-void CBurningVideoDriver::runOcclusionQuery(scene::ISceneNode* node, bool visible)
+//! Starts counting the samples of a query
+void CBurningVideoDriver::beginOcclusionQuery(SOccQuery& query)
 {
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
-	if (index != -1)
-	{
-		//extGlBeginQuery(GL_SAMPLES_PASSED_ARB, OcclusionQueries[index].UID);
-		samples_passed = 0;
-		CNullDriver::runOcclusionQuery(node, visible);
-		//extGlEndQuery(GL_SAMPLES_PASSED_ARB);
-	}
+	samples_passed = 0;
 }
 
 
-//! Update occlusion query. Retrieves results from GPU.
-/** If the query shall not block, set the flag to false.
-Update might not occur in this case, though */
-void CBurningVideoDriver::updateOcclusionQuery(scene::ISceneNode* node, bool block)
+//! Stops counting the samples of a query
+/** The software rasterizer has the result right away. It is kept in the
+query until the next update, so every query gets its own count. */
+void CBurningVideoDriver::endOcclusionQuery(SOccQuery& query)
 {
-	const s32 index = OcclusionQueries.linear_search(SOccQuery(node));
-	if (index < 0) return;
-
-	OcclusionQueries[index].Result = samples_passed;
-
+	query.PendingResult = samples_passed;
 }
 
 
-//! Return query result.
-/** Return value is the number of visible pixels/fragments.
-The value is a safe approximation, i.e. can be larger than the
-actual value of pixels. */
-u32 CBurningVideoDriver::getOcclusionQueryResult(const scene::ISceneNode* node) const
+//! Retrieves the result of a query which has been run
+void CBurningVideoDriver::fetchOcclusionQueryResult(SOccQuery& query, bool block)
 {
-	const s32 index = OcclusionQueries.linear_search(node);
-	return index < 0 ? ~0 : OcclusionQueries[index].Result;
+	query.Result = query.PendingResult;
 }
 
+
 burning_namespace_end
 
 #endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
@@ -35,22 +35,6 @@ namespace video
 		//! Create render target.
 		virtual IRenderTarget* addRenderTarget() IRR_OVERRIDE;
 
-		//! Run occlusion query. Draws mesh stored in query.
-		/** If the mesh shall not be rendered visible, use
-		overrideMaterial to disable the color and depth buffer. */
-		virtual void runOcclusionQuery(scene::ISceneNode* node, bool visible = false) IRR_OVERRIDE;
-
-		//! Update occlusion query. Retrieves results from GPU.
-		/** If the query shall not block, set the flag to false.
-		Update might not occur in this case, though */
-		virtual void updateOcclusionQuery(scene::ISceneNode* node, bool block = true) IRR_OVERRIDE;
-
-		//! Return query result.
-		/** Return value is the number of visible pixels/fragments.
-		The value is a safe approximation, i.e. can be larger then the
-		actual value of pixels. */
-		virtual u32 getOcclusionQueryResult(const scene::ISceneNode* node) const IRR_OVERRIDE;
-
 		//! sets transformation
 		virtual void setTransform(E_TRANSFORMATION_STATE state, const core::matrix4& mat) IRR_OVERRIDE;
 
@@ -114,6 +98,11 @@ namespace video
 				const void* indexList, u32 primitiveCount,
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType) IRR_OVERRIDE;
 
+		//! Draws copies of a mesh buffer with one call
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+			const core::matrix4* transforms, u32 instanceCount,
+			const SColor* colors=0) IRR_OVERRIDE;
+
 		//! draws a vertex primitive list in 2d
 		virtual void draw2DVertexPrimitiveList(const void* vertices, u32 vertexCount,
 			const void* indexList, u32 primitiveCount,
@@ -321,6 +310,15 @@ namespace video
 
 	protected:
 
+		//! Starts counting the samples of a query
+		virtual void beginOcclusionQuery(SOccQuery& query) IRR_OVERRIDE;
+
+		//! Stops counting the samples of a query
+		virtual void endOcclusionQuery(SOccQuery& query) IRR_OVERRIDE;
+
+		//! Retrieves the result of a query which has been run
+		virtual void fetchOcclusionQueryResult(SOccQuery& query, bool block) IRR_OVERRIDE;
+
 		void saveBuffer();
 
 		//! sets a render target
@@ -335,6 +333,12 @@ namespace video
 		video::CImage* BackBuffer;
 		video::IImagePresenter* Presenter;
 
+		//! BackBuffer is the image of the presenter, which is shown without copying
+		bool BackBufferShared;
+
+		//! renders into the image of the presenter when it has the format and size of the back buffer
+		void selectBackBuffer();
+
 		void* WindowId;
 		core::rect<s32>* SceneSourceRect;
 
@@ -400,6 +404,9 @@ namespace video
 		f32 Transformation_ETS_CLIPSCALE[2][4];
 		void transform_calc(E_TRANSFORMATION_STATE_BURNING_VIDEO state);
 
+		//! calculates the matrices needed to draw with the current world transformation
+		void transform_calc_draw();
+
 		//core::recti ViewPort;
 		AbsRectangle Scissor;
 
@@ -413,6 +420,12 @@ namespace video
 		//void VertexCache_get (s4DVertexPair* face[4] );
 
 		void VertexCache_map_source_format();
+
+		//! transforms, clips and rasterizes the primitives set by VertexCache_reset
+		void VertexCache_draw(u32 primitiveCount);
+
+		//! color of the instance drawn by drawMeshBufferInstanced, multiplied with the vertex colors
+		u32 InstanceColor;
 		//s4DVertexPair* VertexCache_getVertex ( const u32 sourceIndex ) const;
 
 		// culling & clipping
@@ -17,6 +17,9 @@ burning_namespace_start
 //! stretches srcRect src to dstRect dst, applying a sliding window box filter in linear color space (sRGB->linear->sRGB)
 void Resample_subSampling(eBlitter op, video::IImage* dst, const core::rect<s32>* dstRect, const video::IImage* src, const core::rect<s32>* srcRect, size_t flags);
 
+//! fills mipmap levels from level 0 with a 2x2 box filter. returns the number of levels done
+static size_t Resample_mipChain(CImage* const* mip, size_t count, size_t flags);
+
 //nearest pow of 2 ( 257 will be 256 not 512 )
 static inline core::dimension2d<u32> getOptimalSize(const core::dimension2d<u32>& original,
 	const u32 allowNonPowerOfTwo, const u32 maxSize
@@ -215,22 +218,10 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* data)
 {
 	size_t i;
 
-	// release
-	for (i = 1; i < array_size(MipMap); ++i)
-	{
-		if (MipMap[i])
-		{
-			MipMap[i]->drop();
-			MipMap[i] = 0;
-		}
-	}
-
 	core::dimension2d<u32> newSize;
 
 	if (HasMipMaps && ((Flags & GEN_MIPMAP_AUTO) || 0 == data))
 	{
-		const IImage* mip0 = original_mip0 ? original_mip0 : MipMap[0];
-
 		//need memory also if autogen mipmap disabled
 		for (i = 1; i < array_size(MipMap); ++i)
 		{
@@ -241,17 +232,49 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* data)
 			if (upperDim == newSize)
 				break;
 
-			MipMap[i] = new CImage(ColorFormat, newSize);
+			// keep the levels of a previous regeneration (lock/unlock, render targets)
+			if (MipMap[i] && MipMap[i]->getDimension() != newSize)
+			{
+				MipMap[i]->drop();
+				MipMap[i] = 0;
+			}
+			if (!MipMap[i])
+				MipMap[i] = new CImage(ColorFormat, newSize);
 #if defined(IRRLICHT_sRGB)
 			MipMap[i]->set_sRGB(MipMap[i - 1]->get_sRGB());
 #endif
 			//MipMap[i]->fill ( 0xFFFF4040 );
-			//MipMap[i-1]->copyToScalingBoxFilter( MipMap[i], 0, false );
-			Resample_subSampling(BLITTER_TEXTURE, MipMap[i], 0, mip0, 0, Flags);
 		}
+		const size_t levels = i;
+
+		// release unused levels
+		for (; i < array_size(MipMap); ++i)
+		{
+			if (MipMap[i])
+			{
+				MipMap[i]->drop();
+				MipMap[i] = 0;
+			}
+		}
+
+		// a rescaled image is filtered from the original image to not lose detail
+		const IImage* mip0 = original_mip0 ? original_mip0 : MipMap[0];
+		i = original_mip0 ? 1 : Resample_mipChain(MipMap, levels, Flags);
+		for (; i < levels; ++i)
+			Resample_subSampling(BLITTER_TEXTURE, MipMap[i], 0, mip0, 0, Flags);
 	}
 	else if (HasMipMaps && data)
 	{
+		// release
+		for (i = 1; i < array_size(MipMap); ++i)
+		{
+			if (MipMap[i])
+			{
+				MipMap[i]->drop();
+				MipMap[i] = 0;
+			}
+		}
+
 		//deactivated outside mipdata until TA knows how to handle this.
 
 		//query mipmap dimension
@@ -828,6 +851,191 @@ void Resample_subSampling(eBlitter op, video::IImage* dst, const core::rect<s32>
 #undef ft
 }
 
+//! reads a texel of a mipmap level as A8R8G8B8
+static inline u32 mipChain_read(const u8* p, const video::ECOLOR_FORMAT format)
+{
+	return format == video::ECF_A8R8G8B8 ? *(const u32*)p : video::A1R5G5B5toA8R8G8B8(*(const u16*)p);
+}
+
+//! adds the color of a texel to sum, in linear color space like Resample_subSampling
+static inline void mipChain_add(f32* sum, const u32 bgra, const int sRGB)
+{
+	if (sRGB)
+	{
+		sum[0] += srgb_8bit_to_linear_float[(bgra) & 0xFF];
+		sum[1] += srgb_8bit_to_linear_float[(bgra >> 8) & 0xFF];
+		sum[2] += srgb_8bit_to_linear_float[(bgra >> 16) & 0xFF];
+	}
+	else
+	{
+		sum[0] += (f32)((bgra) & 0xFF);
+		sum[1] += (f32)((bgra >> 8) & 0xFF);
+		sum[2] += (f32)((bgra >> 16) & 0xFF);
+	}
+	sum[3] += (f32)((bgra >> 24) & 0xFF);
+}
+
+//! writes a linear color to a texel, rounded like Resample_subSampling
+static inline void mipChain_write(u8* p, const video::ECOLOR_FORMAT format, const f32* color, const int sRGB)
+{
+	u32 bgra;
+	if (sRGB)
+	{
+		bgra = linear_to_srgb_8bit(color[0]) |
+			linear_to_srgb_8bit(color[1]) << 8 |
+			linear_to_srgb_8bit(color[2]) << 16 |
+			(u32)(color[3]) << 24;
+	}
+	else
+	{
+		bgra = core::s32_clamp((int)floor(color[0] + 0.5f), 0, 255) |
+			core::s32_clamp((int)floor(color[1] + 0.5f), 0, 255) << 8 |
+			core::s32_clamp((int)floor(color[2] + 0.5f), 0, 255) << 16 |
+			core::s32_clamp((int)floor(color[3] + 0.5f), 0, 255) << 24;
+	}
+
+	if (format == video::ECF_A8R8G8B8)
+		*(u32*)p = bgra;
+	else
+		*(u16*)p = video::A8R8G8B8toA1R5G5B5(bgra);
+}
+
+//! fills the mipmap levels 1 to count-1 from level 0 with a 2x2 box filter
+/** Each level is filtered from the unrounded linear colors of the level above. So
+a texel is the average of the level 0 texels under it, like filtering level 0 with
+Resample_subSampling, and 16 bit levels are not requantized from each other.
+Returns the number of levels done, it stops at the first level which doesn't halve
+(or keep a clamped side of) the level above. */
+static size_t Resample_mipChain(CImage* const* mip, size_t count, size_t flags)
+{
+	const video::ECOLOR_FORMAT format = mip[0]->getColorFormat();
+	if ((format != video::ECF_A8R8G8B8 && format != video::ECF_A1R5G5B5) || !mip[0]->getData())
+		return 1;
+
+#if defined(IRRLICHT_sRGB)
+	const int src_sRGB = mip[0]->get_sRGB();
+#else
+	//assuming sRGB as default
+	const int src_sRGB = (flags & CSoftwareTexture2::IMAGE_IS_LINEAR) ? 0 : 1;
+	const int dst_sRGB = (flags & CSoftwareTexture2::TEXTURE_IS_LINEAR) ? 0 : 1;
+#endif
+
+	//linear colors of the last level, 4 floats per texel. later levels are filtered in place.
+	core::array<f32> linear;
+
+	size_t i;
+	for (i = 1; i < count; ++i)
+	{
+		const core::dimension2du& sd = mip[i - 1]->getDimension();
+		const core::dimension2du& dd = mip[i]->getDimension();
+		if ((sd.Width != dd.Width * 2 && sd.Width != dd.Width) || (sd.Height != dd.Height * 2 && sd.Height != dd.Height) ||
+			mip[i]->getColorFormat() != format || !mip[i]->getData())
+			break;
+
+		//a side which is not halved reads the same texel twice
+		const u32 stepX = sd.Width != dd.Width ? 1 : 0;
+		const u32 stepY = sd.Height != dd.Height ? 1 : 0;
+		const f32 rs = 1.f / (f32)((stepX + 1) * (stepY + 1));
+
+		if (1 == i)
+		{
+			linear.set_used(dd.Width * dd.Height * 4);
+
+			const u8* srcData = (const u8*)mip[0]->getData();
+			const u32 srcPitch = mip[0]->getPitch();
+			const u32 bpp = mip[0]->getBytesPerPixel();
+
+			//adds up in the order of Resample_subSampling, the sum of linear textures is exact
+			f32* d = linear.pointer();
+			for (u32 dy = 0; dy != dd.Height; ++dy)
+			{
+				const u8* s = srcData + (dy << stepY) * srcPitch;
+				for (u32 dx = 0; dx != dd.Width; ++dx, d += 4)
+				{
+					const u8* t = s + (dx << stepX) * bpp;
+					d[0] = d[1] = d[2] = d[3] = 0.f;
+					mipChain_add(d, mipChain_read(t, format), src_sRGB);
+					if (stepX)
+						mipChain_add(d, mipChain_read(t + bpp, format), src_sRGB);
+					if (stepY)
+					{
+						mipChain_add(d, mipChain_read(t + srcPitch, format), src_sRGB);
+						if (stepX)
+							mipChain_add(d, mipChain_read(t + srcPitch + bpp, format), src_sRGB);
+					}
+					d[0] *= rs;
+					d[1] *= rs;
+					d[2] *= rs;
+					d[3] *= rs;
+				}
+			}
+		}
+		else
+		{
+			//a destination texel is never behind the source texels of the texels after it
+			f32* data = linear.pointer();
+			const u32 srcRow = sd.Width * 4;
+			const u32 offX = stepX * 4;
+			const u32 offY = stepY * srcRow;
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+			const core::simd::f32x4 scale = core::simd::splat(rs);
+#endif
+			f32* d = data;
+			for (u32 dy = 0; dy != dd.Height; ++dy)
+			{
+				const f32* s = data + (dy << stepY) * srcRow;
+				for (u32 dx = 0; dx != dd.Width; ++dx, d += 4)
+				{
+					const f32* t = s + (dx << stepX) * 4;
+#if defined(_IRR_COMPILE_WITH_SSE_) || defined(_IRR_COMPILE_WITH_NEON_)
+					//the 4 channels of a texel are one vector
+					core::simd::f32x4 sum = core::simd::load(t);
+					if (stepX)
+						sum = core::simd::add(sum, core::simd::load(t + offX));
+					if (stepY)
+					{
+						sum = core::simd::add(sum, core::simd::load(t + offY));
+						if (stepX)
+							sum = core::simd::add(sum, core::simd::load(t + offY + offX));
+					}
+					core::simd::store(d, core::simd::mul(sum, scale));
+#else
+					f32 sum[4] = { t[0], t[1], t[2], t[3] };
+					for (u32 c = 0; c != 4; ++c)
+					{
+						if (stepX)
+							sum[c] += t[offX + c];
+						if (stepY)
+						{
+							sum[c] += t[offY + c];
+							if (stepX)
+								sum[c] += t[offY + offX + c];
+						}
+						d[c] = sum[c] * rs;
+					}
+#endif
+				}
+			}
+		}
+
+		//write the level
+#if defined(IRRLICHT_sRGB)
+		const int dst_sRGB = mip[i]->get_sRGB();
+#endif
+		u8* dstData = (u8*)mip[i]->getData();
+		const u32 dstPitch = mip[i]->getPitch();
+		const u32 dstBpp = mip[i]->getBytesPerPixel();
+		const f32* c = linear.const_pointer();
+		for (u32 dy = 0; dy != dd.Height; ++dy)
+		{
+			u8* d = dstData + dy * dstPitch;
+			for (u32 dx = 0; dx != dd.Width; ++dx, d += dstBpp, c += 4)
+				mipChain_write(d, format, c, dst_sRGB);
+		}
+	}
+	return i;
+}
+
 burning_namespace_end
 
 #endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
@@ -0,0 +1,493 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CStaticBatchSceneNode.h"
+#include "IMeshSceneNode.h"
+#include "IMetaTriangleSelector.h"
+#include "IMeshManipulator.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "SViewFrustum.h"
+#include <string.h>
+
+namespace irr
+{
+namespace scene
+{
+
+//! Updates the absolute transformation of a node and of its parents
+static void updateAbsolutePositions(ISceneNode* node)
+{
+	if (node->getParent())
+		updateAbsolutePositions(node->getParent());
+	node->updateAbsolutePosition();
+}
+
+
+//! constructor
+CStaticBatchSceneNode::CStaticBatchSceneNode(f32 clusterSize, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& rotation,
+			const core::vector3df& scale)
+	: IStaticBatchSceneNode(parent, mgr, id, position, rotation, scale),
+	ClusterSize(clusterSize > 0.f ? clusterSize : 1.f), Selector(0),
+	Box(core::vector3df(0.f, 0.f, 0.f)), Removed(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CStaticBatchSceneNode");
+	#endif
+
+	Selector = SceneManager->createMetaTriangleSelector();
+	setTriangleSelector(Selector);
+}
+
+
+//! destructor
+CStaticBatchSceneNode::~CStaticBatchSceneNode()
+{
+	removeAllNodes();
+	if (Selector)
+		Selector->drop();
+}
+
+
+//! culls the clusters and registers the node for the passes of their materials
+void CStaticBatchSceneNode::OnRegisterSceneNode()
+{
+	// removed nodes are taken out of the clusters once per frame
+	compactClusters();
+
+	if (IsVisible && !Clusters.empty())
+	{
+		cullClusters();
+
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		u32 transparentCount = 0;
+		u32 solidCount = 0;
+		for (u32 i=0; i<VisibleClusters.size(); ++i)
+		{
+			if (driver->needsTransparentRenderPass(Materials[VisibleClusters[i].MaterialIndex]))
+				++transparentCount;
+			else
+				++solidCount;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, ESNRP_TRANSPARENT);
+
+		if (DebugDataVisible)
+			SceneManager->registerNodeForRendering(this, ESNRP_SHADOW);
+
+		ISceneNode::OnRegisterSceneNode();
+	}
+}
+
+
+//! renders the node.
+void CStaticBatchSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	const E_SCENE_NODE_RENDER_PASS renderPass = SceneManager->getSceneNodeRenderPass();
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+	if (renderPass == ESNRP_SHADOW)
+	{
+		// for debug purposes only
+		video::SMaterial m;
+		m.Lighting = false;
+		m.AntiAliasing = 0;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & EDS_BBOX)
+			driver->draw3DBox(Box, video::SColor(255,255,255,255));
+
+		if (DebugDataVisible & EDS_BBOX_BUFFERS)
+		{
+			for (u32 i=0; i<VisibleClusters.size(); ++i)
+				driver->draw3DBox(Clusters[VisibleClusters[i].Cluster]->Buffer->getBoundingBox(),
+					video::SColor(255,190,128,128));
+		}
+		return;
+	}
+
+	// visible clusters are sorted by material, each material is set once
+	u32 materialIndex = 0xffffffff;
+	bool skip = false;
+	for (u32 i=0; i<VisibleClusters.size(); ++i)
+	{
+		if (VisibleClusters[i].MaterialIndex != materialIndex)
+		{
+			materialIndex = VisibleClusters[i].MaterialIndex;
+			const video::SMaterial& material = Materials[materialIndex];
+			const bool transparent = driver->needsTransparentRenderPass(material);
+			skip = (transparent && renderPass == ESNRP_SOLID) ||
+				(!transparent && renderPass == ESNRP_TRANSPARENT);
+			if (!skip)
+				driver->setMaterial(material);
+		}
+
+		if (!skip)
+			driver->drawMeshBuffer(Clusters[VisibleClusters[i].Cluster]->Buffer);
+	}
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CStaticBatchSceneNode::getMaterial(u32 i)
+{
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! Copies the geometry of a mesh scene node into the batch and hides the node
+bool CStaticBatchSceneNode::addNode(IMeshSceneNode* node)
+{
+	if (!node || findNode(node) >= 0)
+		return false;
+
+	IMesh* mesh = node->getMesh();
+	if (!mesh)
+		return false;
+
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		if (mb->getPrimitiveType() != EPT_TRIANGLES || mb->getVertexCount() > 65536)
+			return false;
+	}
+
+	// the geometry is copied into the space of the batch, the nodes may
+	// not have been animated yet
+	updateAbsolutePositions(this);
+	updateAbsolutePositions(node);
+	core::matrix4 transform;
+	transform.setbyproduct(core::matrix4(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE),
+		node->getAbsoluteTransformation());
+
+	// clustered by the grid cell of the center of the node
+	core::aabbox3d<f32> box(mesh->getBoundingBox());
+	transform.transformBoxEx(box);
+	const core::vector3df center = box.getCenter() / ClusterSize;
+	const s32 x = core::floor32(center.X);
+	const s32 y = core::floor32(center.Y);
+	const s32 z = core::floor32(center.Z);
+
+	const IMeshManipulator* manipulator = SceneManager->getMeshManipulator();
+	const bool transformed = !transform.isIdentity();
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		if (!mb->getIndexCount())
+			continue;
+
+		const video::SMaterial& material = node->getMaterial(i);
+		u32 materialIndex = 0;
+		for (; materialIndex<Materials.size(); ++materialIndex)
+		{
+			if (Materials[materialIndex] == material)
+				break;
+		}
+		if (materialIndex == Materials.size())
+			Materials.push_back(material);
+
+		SCluster* cluster = getCluster(x, y, z, materialIndex, mb->getVertexType(), mb->getVertexCount());
+
+		SRange range;
+		range.Node = node;
+		range.VertexStart = cluster->Buffer->getVertexCount();
+		range.VertexCount = mb->getVertexCount();
+		range.IndexStart = cluster->Buffer->getIndexCount();
+		range.IndexCount = mb->getIndexCount();
+		cluster->Ranges.push_back(range);
+
+		if (transformed)
+		{
+			IMeshBuffer* copy = mb->createClone();
+			manipulator->transform(copy, transform, 1, true);
+			cluster->Buffer->append(copy);
+			copy->drop();
+		}
+		else
+			cluster->Buffer->append(mb);
+	}
+
+	SNode entry;
+	entry.Node = node;
+	entry.Selector = node->getTriangleSelector();
+	if (entry.Selector)
+		entry.Selector->grab();
+	else
+		entry.Selector = SceneManager->createTriangleSelector(mesh, node, true);
+	Selector->addTriangleSelector(entry.Selector);
+
+	node->grab();
+	node->setVisible(false);
+	Nodes.push_back(entry);
+
+	updateBox();
+	return true;
+}
+
+
+//! Adds all visible mesh scene nodes below a node
+u32 CStaticBatchSceneNode::addNodes(ISceneNode* root, s32 idBitMask)
+{
+	if (!root)
+		return 0;
+
+	u32 added = 0;
+	const ISceneNodeList& children = root->getChildren();
+	ISceneNodeList::ConstIterator it = children.begin();
+	for (; it != children.end(); ++it)
+	{
+		ISceneNode* current = *it;
+		if (current == this || !current->isVisible())
+			continue;
+
+		if (current->getType() == ESNT_MESH &&
+			(idBitMask == 0 || (current->getID() & idBitMask)) &&
+			addNode(static_cast<IMeshSceneNode*>(current)))
+			++added;
+
+		added += addNodes(current, idBitMask);
+	}
+
+	return added;
+}
+
+
+//! Removes the geometry of a node from the batch and shows the node again
+bool CStaticBatchSceneNode::removeNode(IMeshSceneNode* node)
+{
+	const s32 index = findNode(node);
+	if (index < 0)
+		return false;
+
+	// the geometry is removed by the next compactClusters(), so removing
+	// many nodes moves the geometry of each cluster only once
+	for (u32 c=0; c<Clusters.size(); ++c)
+	{
+		SCluster* cluster = Clusters[c];
+		for (u32 r=0; r<cluster->Ranges.size(); ++r)
+		{
+			if (cluster->Ranges[r].Node == node)
+			{
+				cluster->Ranges[r].Node = 0;
+				cluster->Removed = true;
+				Removed = true;
+			}
+		}
+	}
+
+	Selector->removeTriangleSelector(Nodes[index].Selector);
+	Nodes[index].Selector->drop();
+	Nodes.erase(index);
+
+	node->setVisible(true);
+	node->drop();
+	return true;
+}
+
+
+//! Removes all nodes from the batch and shows them again
+void CStaticBatchSceneNode::removeAllNodes()
+{
+	for (u32 i=0; i<Clusters.size(); ++i)
+	{
+		Clusters[i]->Buffer->drop();
+		delete Clusters[i];
+	}
+	Clusters.clear();
+	VisibleClusters.clear();
+	Materials.clear();
+	Removed = false;
+
+	if (Selector)
+		Selector->removeAllTriangleSelectors();
+	for (u32 i=0; i<Nodes.size(); ++i)
+	{
+		Nodes[i].Selector->drop();
+		Nodes[i].Node->setVisible(true);
+		Nodes[i].Node->drop();
+	}
+	Nodes.clear();
+
+	updateBox();
+}
+
+
+//! Returns the index of a batched node or -1
+s32 CStaticBatchSceneNode::findNode(const IMeshSceneNode* node) const
+{
+	for (u32 i=0; i<Nodes.size(); ++i)
+	{
+		if (Nodes[i].Node == node)
+			return (s32)i;
+	}
+	return -1;
+}
+
+
+//! Returns a cluster with room for the vertices, creates it if needed
+CStaticBatchSceneNode::SCluster* CStaticBatchSceneNode::getCluster(s32 x, s32 y, s32 z,
+	u32 materialIndex, video::E_VERTEX_TYPE vertexType, u32 vertexCount)
+{
+	// latest clusters first, nodes are usually added cell by cell
+	for (u32 i=Clusters.size(); i>0; --i)
+	{
+		SCluster* cluster = Clusters[i-1];
+		if (cluster->CellX == x && cluster->CellY == y && cluster->CellZ == z &&
+			cluster->MaterialIndex == materialIndex &&
+			cluster->Buffer->getVertexType() == vertexType &&
+			cluster->Buffer->getVertexCount() + vertexCount <= 65536)
+			return cluster;
+	}
+
+	SCluster* cluster = new SCluster();
+	cluster->Buffer = new CDynamicMeshBuffer(vertexType, video::EIT_16BIT);
+	cluster->Buffer->setHardwareMappingHint(EHM_STATIC);
+	cluster->Buffer->getMaterial() = Materials[materialIndex];
+	cluster->CellX = x;
+	cluster->CellY = y;
+	cluster->CellZ = z;
+	cluster->MaterialIndex = materialIndex;
+	cluster->Removed = false;
+	Clusters.push_back(cluster);
+	return cluster;
+}
+
+
+//! Removes the geometry of removed nodes from the clusters
+/** The remaining ranges of a cluster move to the front in one pass. */
+void CStaticBatchSceneNode::compactClusters()
+{
+	if (!Removed)
+		return;
+	Removed = false;
+
+	u32 kept = 0;
+	for (u32 c=0; c<Clusters.size(); ++c)
+	{
+		SCluster* cluster = Clusters[c];
+		if (cluster->Removed)
+		{
+			IVertexBuffer& vertices = cluster->Buffer->getVertexBuffer();
+			IIndexBuffer& indices = cluster->Buffer->getIndexBuffer();
+			const u32 stride = vertices.stride();
+			u8* data = static_cast<u8*>(vertices.getData());
+
+			// ranges are in the order of their vertices and indices
+			u32 vertexEnd = 0;
+			u32 indexEnd = 0;
+			u32 ranges = 0;
+			for (u32 r=0; r<cluster->Ranges.size(); ++r)
+			{
+				SRange range = cluster->Ranges[r];
+				if (!range.Node)
+					continue;
+
+				if (range.VertexStart != vertexEnd)
+				{
+					memmove(data + vertexEnd*stride, data + range.VertexStart*stride, range.VertexCount*stride);
+					const u32 shift = range.VertexStart - vertexEnd;
+					for (u32 i=0; i<range.IndexCount; ++i)
+						indices.setValue(indexEnd + i, indices[range.IndexStart + i] - shift);
+					range.VertexStart = vertexEnd;
+					range.IndexStart = indexEnd;
+				}
+				vertexEnd += range.VertexCount;
+				indexEnd += range.IndexCount;
+				cluster->Ranges[ranges++] = range;
+			}
+			cluster->Ranges.set_used(ranges);
+			vertices.set_used(vertexEnd);
+			indices.set_used(indexEnd);
+			cluster->Removed = false;
+
+			if (ranges)
+			{
+				cluster->Buffer->recalculateBoundingBox();
+				cluster->Buffer->setDirty();
+			}
+		}
+
+		if (cluster->Ranges.empty())
+		{
+			cluster->Buffer->drop();
+			delete cluster;
+		}
+		else
+			Clusters[kept++] = cluster;
+	}
+	Clusters.set_used(kept);
+	VisibleClusters.clear();
+
+	updateBox();
+}
+
+
+//! Merges the boxes of the clusters into the box of the node
+void CStaticBatchSceneNode::updateBox()
+{
+	if (Clusters.empty())
+	{
+		Box.reset(0.f, 0.f, 0.f);
+		return;
+	}
+
+	Box = Clusters[0]->Buffer->getBoundingBox();
+	for (u32 i=1; i<Clusters.size(); ++i)
+		Box.addInternalBox(Clusters[i]->Buffer->getBoundingBox());
+}
+
+
+//! Collects the clusters in the view frustum sorted by material
+void CStaticBatchSceneNode::cullClusters()
+{
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	const bool cull = camera && AutomaticCullingState != EAC_OFF;
+
+	// the frustum in the space of the node, the clusters are in that space
+	SViewFrustum frustum;
+	if (cull)
+	{
+		frustum = *camera->getViewFrustum();
+		frustum.transform(core::matrix4(AbsoluteTransformation, core::matrix4::EM4CONST_INVERSE));
+	}
+
+	VisibleClusters.set_used(0);
+	for (u32 i=0; i<Clusters.size(); ++i)
+	{
+		if (cull)
+		{
+			const core::aabbox3d<f32>& box = Clusters[i]->Buffer->getBoundingBox();
+			u32 p = 0;
+			for (; p<SViewFrustum::VF_PLANE_COUNT; ++p)
+			{
+				if (box.classifyPlaneRelation(frustum.planes[p]) == core::ISREL3D_FRONT)
+					break;
+			}
+			if (p != SViewFrustum::VF_PLANE_COUNT)
+				continue;
+		}
+
+		SVisibleCluster visible;
+		visible.MaterialIndex = Clusters[i]->MaterialIndex;
+		visible.Cluster = i;
+		VisibleClusters.push_back(visible);
+	}
+
+	VisibleClusters.sort();
+}
+
+
+} // end namespace scene
+} // end namespace irr
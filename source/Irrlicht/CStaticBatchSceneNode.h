@@ -0,0 +1,145 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_C_STATIC_BATCH_SCENE_NODE_H_INCLUDED
+#define IRR_C_STATIC_BATCH_SCENE_NODE_H_INCLUDED
+
+#include "IStaticBatchSceneNode.h"
+#include "CDynamicMeshBuffer.h"
+
+namespace irr
+{
+namespace scene
+{
+	class IMetaTriangleSelector;
+
+	class CStaticBatchSceneNode : public IStaticBatchSceneNode
+	{
+	public:
+
+		//! constructor
+		/** \param clusterSize Edge length of the grid cells by which the
+		geometry is clustered. */
+		CStaticBatchSceneNode(f32 clusterSize, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+		//! destructor
+		virtual ~CStaticBatchSceneNode();
+
+		//! culls the clusters and registers the node for the passes of their materials
+		virtual void OnRegisterSceneNode() IRR_OVERRIDE;
+
+		//! renders the node.
+		virtual void render() IRR_OVERRIDE;
+
+		//! returns the axis aligned bounding box of all clusters
+		virtual const core::aabbox3d<f32>& getBoundingBox() const IRR_OVERRIDE { return Box; }
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i) IRR_OVERRIDE;
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const IRR_OVERRIDE { return Materials.size(); }
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const IRR_OVERRIDE { return ESNT_STATIC_BATCH; }
+
+		//! Copies the geometry of a mesh scene node into the batch and hides the node
+		virtual bool addNode(IMeshSceneNode* node) IRR_OVERRIDE;
+
+		//! Adds all visible mesh scene nodes below a node
+		virtual u32 addNodes(ISceneNode* root, s32 idBitMask=0) IRR_OVERRIDE;
+
+		//! Removes the geometry of a node from the batch and shows the node again
+		virtual bool removeNode(IMeshSceneNode* node) IRR_OVERRIDE;
+
+		//! Removes all nodes from the batch and shows them again
+		virtual void removeAllNodes() IRR_OVERRIDE;
+
+		//! Returns the number of batched nodes
+		virtual u32 getNodeCount() const IRR_OVERRIDE { return Nodes.size(); }
+
+		//! Returns a batched node
+		virtual IMeshSceneNode* getNode(u32 index) const IRR_OVERRIDE { return Nodes[index].Node; }
+
+		//! Returns the number of clusters, each is a meshbuffer of one material
+		virtual u32 getClusterCount() const IRR_OVERRIDE { return Clusters.size(); }
+
+		//! Returns the number of clusters which were not culled when the node was drawn last
+		virtual u32 getVisibleClusterCount() const IRR_OVERRIDE { return VisibleClusters.size(); }
+
+	private:
+
+		//! Vertices and indices of a batched node in a cluster
+		struct SRange
+		{
+			//! 0 after the node was removed, until the cluster is compacted
+			IMeshSceneNode* Node;
+			u32 VertexStart;
+			u32 VertexCount;
+			u32 IndexStart;
+			u32 IndexCount;
+		};
+
+		//! Geometry of one material in one grid cell
+		struct SCluster
+		{
+			CDynamicMeshBuffer* Buffer;
+			s32 CellX, CellY, CellZ;
+			u32 MaterialIndex;
+			core::array<SRange> Ranges;
+			//! Some ranges were removed
+			bool Removed;
+		};
+
+		struct SNode
+		{
+			IMeshSceneNode* Node;
+			//! Selector of the node added to the selector of the batch
+			ITriangleSelector* Selector;
+		};
+
+		struct SVisibleCluster
+		{
+			u32 MaterialIndex;
+			u32 Cluster;
+
+			bool operator<(const SVisibleCluster& other) const
+			{
+				return MaterialIndex < other.MaterialIndex;
+			}
+		};
+
+		//! Returns the index of a batched node or -1
+		s32 findNode(const IMeshSceneNode* node) const;
+
+		//! Returns a cluster with room for the vertices, creates it if needed
+		SCluster* getCluster(s32 x, s32 y, s32 z, u32 materialIndex,
+			video::E_VERTEX_TYPE vertexType, u32 vertexCount);
+
+		//! Removes the geometry of removed nodes from the clusters
+		void compactClusters();
+
+		//! Merges the boxes of the clusters into the box of the node
+		void updateBox();
+
+		//! Collects the clusters in the view frustum sorted by material
+		void cullClusters();
+
+		f32 ClusterSize;
+		core::array<SNode> Nodes;
+		core::array<SCluster*> Clusters;
+		core::array<video::SMaterial> Materials;
+		core::array<SVisibleCluster> VisibleClusters;
+		IMetaTriangleSelector* Selector;
+		core::aabbox3d<f32> Box;
+		//! Some clusters have removed ranges
+		bool Removed;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
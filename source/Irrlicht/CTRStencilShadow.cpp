@@ -85,6 +85,7 @@ public:
 
 	//! draws an indexed triangle list
 	virtual void drawTriangle(const s4DVertex* burning_restrict a, const s4DVertex* burning_restrict b, const s4DVertex* burning_restrict c) IRR_OVERRIDE;
+	virtual bool useStencil() const IRR_OVERRIDE { return true; }
 
 private:
 	void fragmentShader();
@@ -85,6 +85,7 @@ namespace video
 
 		//! draws an indexed triangle list
 		virtual void drawTriangle(const s4DVertex* burning_restrict a, const s4DVertex* burning_restrict b, const s4DVertex* burning_restrict c) IRR_OVERRIDE;
+		virtual bool canHierarchicalZ() IRR_OVERRIDE { return true; }
 		virtual void OnSetMaterialBurning(const SBurningShaderMaterial& material) IRR_OVERRIDE;
 
 private:
@@ -297,6 +298,14 @@ void CTRTextureBlend::fragment_dst_color_src_alpha ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = 	FIX_POINT_F32_MUL;
 
@@ -482,6 +491,14 @@ void CTRTextureBlend::fragment_src_color_src_alpha ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = 	FIX_POINT_F32_MUL;
 
@@ -677,6 +694,14 @@ void CTRTextureBlend::fragment_one_one_minus_src_alpha()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = FIX_POINT_F32_MUL;
 
@@ -878,6 +903,14 @@ void CTRTextureBlend::fragment_one_minus_dst_alpha_one ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = FIX_POINT_F32_MUL;
 
@@ -1078,6 +1111,14 @@ void CTRTextureBlend::fragment_src_alpha_one ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = FIX_POINT_F32_MUL;
 
@@ -1308,6 +1349,14 @@ void CTRTextureBlend::fragment_src_alpha_one_minus_src_alpha()
 	z = (fp24*)DepthBuffer->lock() + (line.y * RenderTarget->getDimension().Width) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = FIX_POINT_F32_MUL;
 
@@ -1462,6 +1511,14 @@ void CTRTextureBlend::fragment_dst_color_one_minus_dst_alpha ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = FIX_POINT_F32_MUL;
 
@@ -1661,6 +1718,14 @@ void CTRTextureBlend::fragment_dst_color_zero ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = FIX_POINT_F32_MUL;
 
@@ -1858,6 +1923,14 @@ void CTRTextureBlend::fragment_dst_color_one ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = FIX_POINT_F32_MUL;
 
@@ -2058,6 +2131,14 @@ void CTRTextureBlend::fragment_zero_one_minus_scr_color ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 iw = FIX_POINT_F32_MUL;
 
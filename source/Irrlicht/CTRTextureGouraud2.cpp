@@ -103,6 +103,7 @@ public:
 
 	//! draws an indexed triangle list
 	virtual void drawTriangle(const s4DVertex* burning_restrict a, const s4DVertex* burning_restrict b, const s4DVertex* burning_restrict c) IRR_OVERRIDE;
+	virtual bool canHierarchicalZ() IRR_OVERRIDE { return true; }
 	virtual bool canWireFrame () IRR_OVERRIDE { return true; }
 
 
@@ -230,6 +231,14 @@ void CTRTextureGouraud2::fragmentShader ()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 
 	f32 inversew = FIX_POINT_F32_MUL;
 
@@ -86,6 +86,7 @@ public:
 
 	//! draws an indexed triangle list
 	virtual void drawTriangle(const s4DVertex* burning_restrict a, const s4DVertex* burning_restrict b, const s4DVertex* burning_restrict c) IRR_OVERRIDE;
+	virtual bool canHierarchicalZ() IRR_OVERRIDE { return fragmentShader != &CTRTextureGouraudAlphaNoZ::fragment_point_noz; }
 	virtual void OnSetMaterialBurning(const SBurningShaderMaterial& material) IRR_OVERRIDE;
 
 private:
@@ -229,6 +230,11 @@ void CTRTextureGouraudAlphaNoZ::fragment_linear()
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+
 
 	f32 inversew = FIX_POINT_F32_MUL;
 
@@ -449,6 +455,11 @@ void CTRTextureGouraudAlphaNoZ::fragment_linear_alpharef()
 	z = (fp24*)DepthBuffer->lock() + (line.y * RenderTarget->getDimension().Width) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+
 
 	f32 inversew = FIX_POINT_F32_MUL;
 
@@ -79,6 +79,7 @@ public:
 
 	//! draws an indexed triangle list
 	virtual void drawTriangle(const s4DVertex* burning_restrict a, const s4DVertex* burning_restrict b, const s4DVertex* burning_restrict c) IRR_OVERRIDE;
+	virtual bool canHierarchicalZ() IRR_OVERRIDE { return true; }
 
 private:
 
@@ -128,6 +129,15 @@ void CTRTextureLightMap2_M4::fragment_linear_mag()
 	// search z-buffer for first not occulled pixel
 	i = ( line.y * RenderTarget->getDimension().Width ) + xStart;
 	z = (fp24*) DepthBuffer->lock() + i;
+
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 	dst = (tVideoSample*)RenderTarget->getData() + i;
 
 	// subTexel
@@ -280,6 +290,14 @@ void CTRTextureLightMap2_M4::fragment_nearest_min()
 	// search z-buffer for first not occulled pixel
 	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 	// subTexel
 	const f32 subPixel = ( (f32) xStart ) - line.x[0];
 
@@ -185,6 +185,15 @@ void CTRTextureWire2::renderLine(const s4DVertex* a, const s4DVertex* b) const
 	z = (fp24*)((u8*)DepthBuffer->lock() + (aposy * pitch1) + (aposx << 2));
 #endif
 
+	resolve_clear(core::min_(aposx, bposx), core::min_(aposy, bposy), core::max_(aposx, bposx), core::max_(aposy, bposy));
+
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z) && defined(WRITE_W)
+	// writes without depth test can move the depth of the hierarchical z tiles farther
+	if (depth_pass && depth_write)
+		DepthBuffer->setWrittenFarther(core::min_(aposx, bposx), core::min_(aposy, bposy),
+			core::max_(aposx, bposx), core::max_(aposy, bposy), core::min_(a->Pos.w, b->Pos.w));
+#endif
+
 	c = dx << 1;
 	m = dy << 1;
 
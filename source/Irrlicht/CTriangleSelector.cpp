@@ -286,12 +286,9 @@ void CTriangleSelector::getTriangles(core::triangle3df* triangles,
 	else
 		mat.makeIdentity();
 
-	for (u32 i=0; i<cnt; ++i)
-	{
-		mat.transformVect( triangles[i].pointA, Triangles[i].pointA );
-		mat.transformVect( triangles[i].pointB, Triangles[i].pointB );
-		mat.transformVect( triangles[i].pointC, Triangles[i].pointC );
-	}
+	// triangles are stored as three consecutive vectors
+	if (cnt)
+		mat.transformVectArray(&triangles[0].pointA, &Triangles[0].pointA, cnt*3);
 
 	if ( outTriangleInfo )
 	{
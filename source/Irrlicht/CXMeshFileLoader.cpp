@@ -485,14 +485,14 @@ bool CXMeshFileLoader::parseFile()
 //! Parses the next Data object in the file
 bool CXMeshFileLoader::parseDataObject()
 {
-	core::stringc objectName = getNextToken();
+	SXToken objectName = getNextToken();
 
 	if (objectName.size() == 0)
 		return false;
 
 	// parse specific object
 #ifdef _XREADER_DEBUG
-	os::Printer::log("debug DataObject", objectName.c_str(), ELL_DEBUG);
+	os::Printer::log("debug DataObject", objectName.str().c_str(), ELL_DEBUG);
 #endif
 
 	if (objectName == "template")
@@ -513,7 +513,13 @@ bool CXMeshFileLoader::parseDataObject()
 		//mesh->Buffer=AnimatedMesh->addMeshBuffer();
 		Meshes.push_back(mesh);
 
-		return parseDataObjectMesh(*mesh);
+		if (!parseDataObjectMesh(*mesh))
+		{
+			// the arrays of a broken mesh don't fit together
+			removeLastMesh();
+			return false;
+		}
+		return true;
 	}
 	else
 	if (objectName == "AnimationSet")
@@ -530,7 +536,7 @@ bool CXMeshFileLoader::parseDataObject()
 	{
 		// template materials now available thanks to joeWright
 		TemplateMaterials.push_back(SXTemplateMaterial());
-		TemplateMaterials.getLast().Name = getNextToken();
+		TemplateMaterials.getLast().Name = getNextToken().str();
 		return parseDataObjectMaterial(TemplateMaterials.getLast().Material);
 	}
 	else
@@ -540,12 +546,25 @@ bool CXMeshFileLoader::parseDataObject()
 		return true;
 	}
 
-	os::Printer::log("Unknown data object in animation of .x file", objectName.c_str(), ELL_WARNING);
+	os::Printer::log("Unknown data object in animation of .x file", objectName.str().c_str(), ELL_WARNING);
 
 	return parseUnknownDataObject();
 }
 
 
+void CXMeshFileLoader::removeLastMesh()
+{
+	SXMesh* mesh = Meshes.getLast();
+
+	// the weights were appended to their joints in this order
+	for (u32 j=mesh->WeightJoint.size(); j>0; --j)
+		AnimatedMesh->getAllJoints()[mesh->WeightJoint[j-1]]->Weights.erase(mesh->WeightNum[j-1]);
+
+	delete mesh;
+	Meshes.erase(Meshes.size()-1);
+}
+
+
 bool CXMeshFileLoader::parseDataObjectTemplate()
 {
 #ifdef _XREADER_DEBUG
@@ -569,7 +588,7 @@ bool CXMeshFileLoader::parseDataObjectTemplate()
 	// read and ignore data members
 	while(true)
 	{
-		core::stringc s = getNextToken();
+		const SXToken s = getNextToken();
 
 		if (s == "}")
 			break;
@@ -643,10 +662,10 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in frame:", objectName.c_str(), ELL_DEBUG);
+		os::Printer::log("debug DataObject in frame:", objectName.str().c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName.size() == 0)
@@ -692,11 +711,14 @@ bool CXMeshFileLoader::parseDataObjectFrame(CSkinnedMesh::SJoint *Parent)
 			Meshes.push_back(mesh);
 
 			if (!parseDataObjectMesh(*mesh))
+			{
+				removeLastMesh();
 				return false;
+			}
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in frame in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in frame in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -764,9 +786,12 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 	irr::video::S3DVertex vertex;	// set_used doesn't call constructor, so we initalize it explicit here
 	vertex.Color = 0xFFFFFFFF;
 	for (u32 n=0; n<nVertices; ++n)
-	{
-		readVector3(vertex.Pos);
 		mesh.Vertices[n] = vertex;
+	if (nVertices && !readFloats(&mesh.Vertices[0].Pos.X, nVertices, 3, sizeof(video::S3DVertex)))
+	{
+		os::Printer::log("Unexpected end of Mesh Vertex Array found in x file", ELL_WARNING);
+		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		return false;
 	}
 
 	if (!checkForTwoFollowingSemicolons())
@@ -803,8 +828,12 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			mesh.Indices.set_used(mesh.Indices.size() + ((triangles-1)*3));
 			mesh.IndexCountPerFace[k] = (u16)(triangles * 3);
 
-			for (u32 f=0; f<fcnt; ++f)
-				polygonfaces[f] = readInt();
+			if (!readInts(polygonfaces.pointer(), fcnt))
+			{
+				os::Printer::log("Unexpected end of Mesh Face Array found in x file", ELL_WARNING);
+				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				return false;
+			}
 
 			for (u32 jk=0; jk<triangles; ++jk)
 			{
@@ -817,13 +846,27 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			mesh.Indices[currentIndex++] = readInt();
-			mesh.Indices[currentIndex++] = readInt();
-			mesh.Indices[currentIndex++] = readInt();
+			if (!readInts(&mesh.Indices[currentIndex], 3))
+			{
+				os::Printer::log("Unexpected end of Mesh Face Array found in x file", ELL_WARNING);
+				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				return false;
+			}
+			currentIndex += 3;
 			mesh.IndexCountPerFace[k] = 3;
 		}
 	}
 
+	for (u32 k=0; k<mesh.Indices.size(); ++k)
+	{
+		if (mesh.Indices[k] >= nVertices)
+		{
+			os::Printer::log("Out of range vertex index found in Mesh Face Array in x file", ELL_WARNING);
+			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			return false;
+		}
+	}
+
 	if (!checkForTwoFollowingSemicolons())
 	{
 		os::Printer::log("No finishing semicolon in Mesh Face Array found in x file", ELL_WARNING);
@@ -834,7 +877,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -849,7 +892,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 
 #ifdef _XREADER_DEBUG
-		os::Printer::log("debug DataObject in mesh", objectName.c_str(), ELL_DEBUG);
+		os::Printer::log("debug DataObject in mesh", objectName.str().c_str(), ELL_DEBUG);
 #endif
 
 		if (objectName == "MeshNormals")
@@ -1008,8 +1051,13 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			}
 			const u32 datasize = readInt();
 			u32* data = new u32[datasize];
-			for (j=0; j<datasize; ++j)
-				data[j]=readInt();
+			if (!readInts(data, datasize))
+			{
+				os::Printer::log("Unexpected end of DeclData found in x file", ELL_WARNING);
+				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				delete [] data;
+				return false;
+			}
 
 			if (!checkForOneFollowingSemicolons())
 			{
@@ -1050,8 +1098,13 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 			const u32 dataformat = readInt();
 			const u32 datasize = readInt();
 			u32* data = new u32[datasize];
-			for (u32 j=0; j<datasize; ++j)
-				data[j]=readInt();
+			if (!readInts(data, datasize))
+			{
+				os::Printer::log("Unexpected end of FVFData found in x file", ELL_WARNING);
+				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				delete [] data;
+				return false;
+			}
 			if (dataformat&0x102) // 2nd uv set
 			{
 				mesh.TCoords2.reallocate(mesh.Vertices.size());
@@ -1092,7 +1145,7 @@ bool CXMeshFileLoader::parseDataObjectMesh(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in mesh in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in mesh in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1168,13 +1221,20 @@ bool CXMeshFileLoader::parseDataObjectSkinWeights(SXMesh &mesh)
 		CSkinnedMesh::SWeight *weight=AnimatedMesh->addWeight(joint);
 
 		weight->buffer_id=0;
-		weight->vertex_id=readInt();
 	}
 
-	// read vertex weights
-
-	for (i=jointStart; i<jointStart+nWeights; ++i)
-		joint->Weights[i].strength = readFloat();
+	if (nWeights)
+	{
+		CSkinnedMesh::SWeight& first = joint->Weights[jointStart];
+		// read vertex indices and weights
+		if (!readInts(&first.vertex_id, nWeights, 1, sizeof(CSkinnedMesh::SWeight)) ||
+			!readFloats(&first.strength, nWeights, 1, sizeof(CSkinnedMesh::SWeight)))
+		{
+			os::Printer::log("Unexpected end of Skin Weights found in x file", ELL_WARNING);
+			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+			return false;
+		}
+	}
 
 	// read matrix offset
 
@@ -1252,8 +1312,12 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 	normals.set_used(nNormals);
 
 	// read normals
-	for (u32 i=0; i<nNormals; ++i)
-		readVector3(normals[i]);
+	if (nNormals && !readFloats(&normals[0].X, nNormals*3))
+	{
+		os::Printer::log("Unexpected end of Mesh Normals Array found in x file", ELL_WARNING);
+		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		return false;
+	}
 
 	if (!checkForTwoFollowingSemicolons())
 	{
@@ -1275,7 +1339,7 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 		u32 triangles = fcnt - 2;
 		u32 indexcount = triangles * 3;
 
-		if (indexcount != mesh.IndexCountPerFace[k])
+		if (k >= mesh.IndexCountPerFace.size() || indexcount != mesh.IndexCountPerFace[k])
 		{
 			os::Printer::log("Not matching normal and face index count found in x file", ELL_WARNING);
 			os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
@@ -1285,18 +1349,36 @@ bool CXMeshFileLoader::parseDataObjectMeshNormals(SXMesh &mesh)
 		if (indexcount == 3)
 		{
 			// default, only one triangle in this face
-			for (u32 h=0; h<3; ++h)
+			u32 normalnum[3];
+			if (!readInts(normalnum, 3) ||
+				normalnum[0] >= nNormals || normalnum[1] >= nNormals || normalnum[2] >= nNormals)
 			{
-				const u32 normalnum = readInt();
-				mesh.Vertices[mesh.Indices[normalidx++]].Normal.set(normals[normalnum]);
+				os::Printer::log("Invalid Mesh Face Normals Array found in x file", ELL_WARNING);
+				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				return false;
 			}
+			for (u32 h=0; h<3; ++h)
+				mesh.Vertices[mesh.Indices[normalidx++]].Normal.set(normals[normalnum[h]]);
 		}
 		else
 		{
 			polygonfaces.set_used(fcnt);
 			// multiple triangles in this face
+			if (!readInts(polygonfaces.pointer(), fcnt))
+			{
+				os::Printer::log("Unexpected end of Mesh Face Normals Array found in x file", ELL_WARNING);
+				os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+				return false;
+			}
 			for (u32 h=0; h<fcnt; ++h)
-				polygonfaces[h] = readInt();
+			{
+				if (polygonfaces[h] >= nNormals)
+				{
+					os::Printer::log("Invalid Mesh Face Normals Array found in x file", ELL_WARNING);
+					os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+					return false;
+				}
+			}
 
 			for (u32 jk=0; jk<triangles; ++jk)
 			{
@@ -1338,8 +1420,18 @@ bool CXMeshFileLoader::parseDataObjectMeshTextureCoords(SXMesh &mesh)
 	}
 
 	const u32 nCoords = readInt();
-	for (u32 i=0; i<nCoords; ++i)
-		readVector2(mesh.Vertices[i].TCoords);
+	if (nCoords > mesh.Vertices.size())
+	{
+		os::Printer::log("More Mesh Texture Coordinates than vertices found in x file", ELL_WARNING);
+		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		return false;
+	}
+	if (nCoords && !readFloats(&mesh.Vertices[0].TCoords.X, nCoords, 2, sizeof(video::S3DVertex)))
+	{
+		os::Printer::log("Unexpected end of Mesh Texture Coordinates Array found in x file", ELL_WARNING);
+		os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+		return false;
+	}
 
 	if (!checkForTwoFollowingSemicolons())
 	{
@@ -1453,7 +1545,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -1472,7 +1564,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 			// template materials now available thanks to joeWright
 			objectName = getNextToken();
 			for (u32 i=0; i<TemplateMaterials.size(); ++i)
-				if (TemplateMaterials[i].Name == objectName)
+				if (objectName == TemplateMaterials[i].Name.c_str())
 					mesh.Materials.push_back(TemplateMaterials[i].Material);
 			getNextToken(); // skip }
 		}
@@ -1490,7 +1582,7 @@ bool CXMeshFileLoader::parseDataObjectMeshMaterialList(SXMesh &mesh)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material list in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in material list in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1528,7 +1620,7 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 	int textureLayer=0;
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -1570,7 +1662,7 @@ bool CXMeshFileLoader::parseDataObjectMaterial(video::SMaterial& material)
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in material in .x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in material in .x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1598,7 +1690,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -1619,7 +1711,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationSet()
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation set in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation set in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1682,7 +1774,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 
 	while(true)
 	{
-		core::stringc objectName = getNextToken();
+		SXToken objectName = getNextToken();
 
 		if (objectName.size() == 0)
 		{
@@ -1712,7 +1804,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		if (objectName == "{")
 		{
 			// read frame name
-			FrameName = getNextToken();
+			FrameName = getNextToken().str();
 
 			if (!checkForClosingBrace())
 			{
@@ -1723,7 +1815,7 @@ bool CXMeshFileLoader::parseDataObjectAnimation()
 		}
 		else
 		{
-			os::Printer::log("Unknown data object in animation in x file", objectName.c_str(), ELL_WARNING);
+			os::Printer::log("Unknown data object in animation in x file", objectName.str().c_str(), ELL_WARNING);
 			if (!parseUnknownDataObject())
 				return false;
 		}
@@ -1832,10 +1924,13 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 					return false;
 				}
 
-				f32 W = -readFloat();
-				f32 X = -readFloat();
-				f32 Y = -readFloat();
-				f32 Z = -readFloat();
+				f32 wxyz[4];
+				if (!readFloats(wxyz, 4))
+				{
+					os::Printer::log("Unexpected end of quaternion animation key in x file", ELL_WARNING);
+					os::Printer::log("Line", core::stringc(Line).c_str(), ELL_WARNING);
+					return false;
+				}
 
 				if (!checkForTwoFollowingSemicolons())
 				{
@@ -1845,7 +1940,7 @@ bool CXMeshFileLoader::parseDataObjectAnimationKey(ISkinnedMesh::SJoint *joint)
 
 				ISkinnedMesh::SRotationKey *key=AnimatedMesh->addRotationKey(joint);
 				key->frame=time;
-				key->rotation.set(X,Y,Z,W);
+				key->rotation.set(-wxyz[1],-wxyz[2],-wxyz[3],-wxyz[0]);
 				key->rotation.normalize();
 			}
 			break;
@@ -1991,7 +2086,7 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 	// find opening delimiter
 	while(true)
 	{
-		core::stringc t = getNextToken();
+		const SXToken t = getNextToken();
 
 		if (t.size() == 0)
 			return false;
@@ -2006,7 +2101,7 @@ bool CXMeshFileLoader::parseUnknownDataObject()
 
 	while(counter)
 	{
-		core::stringc t = getNextToken();
+		const SXToken t = getNextToken();
 
 		if (t.size() == 0)
 			return false;
@@ -2069,11 +2164,11 @@ bool CXMeshFileLoader::checkForTwoFollowingSemicolons()
 //! if there is one
 bool CXMeshFileLoader::readHeadOfDataObject(core::stringc* outname)
 {
-	core::stringc nameOrBrace = getNextToken();
+	const SXToken nameOrBrace = getNextToken();
 	if (nameOrBrace != "{")
 	{
 		if (outname)
-			(*outname) = nameOrBrace;
+			(*outname) = nameOrBrace.str();
 
 		if (getNextToken() != "{")
 			return false;
@@ -2083,11 +2178,9 @@ bool CXMeshFileLoader::readHeadOfDataObject(core::stringc* outname)
 }
 
 
-//! returns next parseable token. Returns empty string if no token there
-core::stringc CXMeshFileLoader::getNextToken()
+//! returns next parseable token. Returns empty token if no token there
+CXMeshFileLoader::SXToken CXMeshFileLoader::getNextToken()
 {
-	core::stringc s;
-
 	// process binary-formatted file
 	if (BinaryFormat)
 	{
@@ -2102,81 +2195,91 @@ core::stringc CXMeshFileLoader::getNextToken()
 			case 1:
 				// name token
 				len = readBinDWord();
-				s = core::stringc(P, len);
+				if (len > (u32)(End-P))
+					break;
 				P += len;
-				return s;
+				return SXToken(P-len, len);
 			case 2:
 				// string token
 				len = readBinDWord();
-				s = core::stringc(P, len);
+				if (len+2 > (u32)(End-P))
+					break;
 				P += (len + 2);
-				return s;
+				return SXToken(P-len-2, len);
 			case 3:
 				// integer token
+				if (End-P < 4)
+					break;
 				P += 4;
-				return "<integer>";
+				return SXToken("<integer>");
 			case 5:
 				// GUID token
+				if (End-P < 16)
+					break;
 				P += 16;
-				return "<guid>";
+				return SXToken("<guid>");
 			case 6:
 				len = readBinDWord();
+				if (len > (u32)(End-P)/4)
+					break;
 				P += (len * 4);
-				return "<int_list>";
+				return SXToken("<int_list>");
 			case 7:
 				len = readBinDWord();
+				if (len > (u32)(End-P)/FloatSize)
+					break;
 				P += (len * FloatSize);
-				return "<flt_list>";
+				return SXToken("<flt_list>");
 			case 0x0a:
-				return "{";
+				return SXToken("{");
 			case 0x0b:
-				return "}";
+				return SXToken("}");
 			case 0x0c:
-				return "(";
+				return SXToken("(");
 			case 0x0d:
-				return ")";
+				return SXToken(")");
 			case 0x0e:
-				return "[";
+				return SXToken("[");
 			case 0x0f:
-				return "]";
+				return SXToken("]");
 			case 0x10:
-				return "<";
+				return SXToken("<");
 			case 0x11:
-				return ">";
+				return SXToken(">");
 			case 0x12:
-				return ".";
+				return SXToken(".");
 			case 0x13:
-				return ",";
+				return SXToken(",");
 			case 0x14:
-				return ";";
+				return SXToken(";");
 			case 0x1f:
-				return "template";
+				return SXToken("template");
 			case 0x28:
-				return "WORD";
+				return SXToken("WORD");
 			case 0x29:
-				return "DWORD";
+				return SXToken("DWORD");
 			case 0x2a:
-				return "FLOAT";
+				return SXToken("FLOAT");
 			case 0x2b:
-				return "DOUBLE";
+				return SXToken("DOUBLE");
 			case 0x2c:
-				return "CHAR";
+				return SXToken("CHAR");
 			case 0x2d:
-				return "UCHAR";
+				return SXToken("UCHAR");
 			case 0x2e:
-				return "SWORD";
+				return SXToken("SWORD");
 			case 0x2f:
-				return "SDWORD";
+				return SXToken("SDWORD");
 			case 0x30:
-				return "void";
+				return SXToken("void");
 			case 0x31:
-				return "string";
+				return SXToken("string");
 			case 0x32:
-				return "unicode";
+				return SXToken("unicode");
 			case 0x33:
-				return "cstring";
+				return SXToken("cstring");
 			case 0x34:
-				return "array";
+				return SXToken("array");
 		}
 	}
 	// process text-formatted file
@@ -2184,26 +2287,21 @@ core::stringc CXMeshFileLoader::getNextToken()
 	{
 		findNextNoneWhiteSpace();
 
-		if (P >= End)
-			return s;
-
+		const c8* start = P;
 		while((P < End) && !core::isspace(P[0]))
 		{
 			// either keep token delimiters when already holding a token, or return if first valid char
 			if (P[0]==';' || P[0]=='}' || P[0]=='{' || P[0]==',')
 			{
-				if (!s.size())
-				{
-					s.append(P[0]);
+				if (P == start)
 					++P;
-				}
 				break; // stop for delimiter
 			}
-			s.append(P[0]);
 			++P;
 		}
+		return SXToken(start, (u32)(P - start));
 	}
-	return s;
+	return SXToken();
 }
 
 
@@ -2259,7 +2357,7 @@ bool CXMeshFileLoader::getNextTokenAsString(core::stringc& out)
 {
 	if (BinaryFormat)
 	{
-		out=getNextToken();
+		out=getNextToken().str();
 		return true;
 	}
 	findNextNoneWhiteSpace();
@@ -2271,11 +2369,10 @@ bool CXMeshFileLoader::getNextTokenAsString(core::stringc& out)
 		return false;
 	++P;
 
+	const c8* start = P;
 	while(P < End && P[0]!='"')
-	{
-		out.append(P[0]);
 		++P;
-	}
+	out = core::stringc(start, (u32)(P - start));
 
 	if ( P[1] != ';' || P[0] != '"')
 		return false;
@@ -2306,8 +2403,11 @@ void CXMeshFileLoader::readUntilEndOfLine()
 
 u16 CXMeshFileLoader::readBinWord()
 {
-	if (P>=End)
+	if (End-P < 2)
+	{
+		P = End;
 		return 0;
+	}
 #ifdef __BIG_ENDIAN__
 	const u16 tmp = os::Byteswap::byteswap(*(u16 *)P);
 #else
@@ -2320,8 +2420,11 @@ u16 CXMeshFileLoader::readBinWord()
 
 u32 CXMeshFileLoader::readBinDWord()
 {
-	if (P>=End)
+	if (End-P < 4)
+	{
+		P = End;
 		return 0;
+	}
 #ifdef __BIG_ENDIAN__
 	const u32 tmp = os::Byteswap::byteswap(*(u32 *)P);
 #else
@@ -2368,6 +2471,11 @@ f32 CXMeshFileLoader::readFloat()
 				BinaryNumCount = 1; // single int
 		}
 		--BinaryNumCount;
+		if ((u32)(End-P) < (u32)FloatSize)
+		{
+			P = End;
+			return 0.f;
+		}
 		if (FloatSize == 8)
 		{
 #ifdef __BIG_ENDIAN__
@@ -2400,22 +2508,145 @@ f32 CXMeshFileLoader::readFloat()
 }
 
 
+//! reads count groups of size ints, the groups are stride bytes apart
+/** Integer lists of binary files are copied in one go as far as they
+reach, text files are parsed number by number. Returns false if the file
+ends before all numbers are read, the missing numbers are set to 0. */
+bool CXMeshFileLoader::readInts(u32* out, u32 count, u32 size, u32 stride)
+{
+	// consecutive groups are one large group
+	if (stride == size*sizeof(u32))
+	{
+		size *= count;
+		count = (size != 0);
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		u32 j=0;
+		while (j<size)
+		{
+			if (!BinaryFormat)
+			{
+				out[j++] = readInt();
+				continue;
+			}
+
+			if (!BinaryNumCount)
+			{
+				if (readBinWord() == 0x06) // 0x06 or 0x03
+					BinaryNumCount = readBinDWord();
+				else
+					BinaryNumCount = 1; // single int
+			}
+			const u32 n = core::min_(size-j, BinaryNumCount);
+			if (n > (u32)(End-P)/sizeof(u32))
+			{
+				// the rest of a truncated list is zero, like a single read at the end
+				for (; i<count; ++i)
+				{
+					for (; j<size; ++j)
+						out[j] = 0;
+					j = 0;
+					out = (u32*)((c8*)out + stride);
+				}
+				BinaryNumCount = 0;
+				P = End;
+				return false;
+			}
+#ifdef __BIG_ENDIAN__
+			for (u32 k=0; k<n; ++k)
+				out[j+k] = readInt();
+#else
+			memcpy(out+j, P, n*sizeof(u32));
+			P += n*sizeof(u32);
+			BinaryNumCount -= n;
+#endif
+			j += n;
+		}
+		out = (u32*)((c8*)out + stride);
+	}
+	return true;
+}
+
+
+//! reads count groups of size floats, the groups are stride bytes apart
+/** Float lists of binary files with 32 bit floats are copied in one go as
+far as they reach, all other formats are read number by number. Returns
+false if the file ends before all numbers are read, the missing numbers are
+set to 0. */
+bool CXMeshFileLoader::readFloats(f32* out, u32 count, u32 size, u32 stride)
+{
+	// consecutive groups are one large group
+	if (stride == size*sizeof(f32))
+	{
+		size *= count;
+		count = (size != 0);
+	}
+
+	for (u32 i=0; i<count; ++i)
+	{
+		u32 j=0;
+		while (j<size)
+		{
+			if (!BinaryFormat)
+			{
+				out[j++] = readFloat();
+				continue;
+			}
+
+			if (!BinaryNumCount)
+			{
+				if (readBinWord() == 0x07) // 0x07 or 0x42
+					BinaryNumCount = readBinDWord();
+				else
+					BinaryNumCount = 1; // single float
+			}
+			const u32 n = core::min_(size-j, BinaryNumCount);
+			if (n > (u32)(End-P)/FloatSize)
+			{
+				// the rest of a truncated list is zero, like a single read at the end
+				for (; i<count; ++i)
+				{
+					for (; j<size; ++j)
+						out[j] = 0;
+					j = 0;
+					out = (f32*)((c8*)out + stride);
+				}
+				BinaryNumCount = 0;
+				P = End;
+				return false;
+			}
+#ifndef __BIG_ENDIAN__
+			if (FloatSize == 4)
+			{
+				memcpy(out+j, P, n*sizeof(f32));
+				P += n*sizeof(f32);
+				BinaryNumCount -= n;
+			}
+			else
+#endif
+			for (u32 k=0; k<n; ++k)
+				out[j+k] = readFloat();
+			j += n;
+		}
+		out = (f32*)((c8*)out + stride);
+	}
+	return true;
+}
+
+
 // read 2-dimensional vector. Stops at semicolon after second value for text file format
 bool CXMeshFileLoader::readVector2(core::vector2df& vec)
 {
-	vec.X = readFloat();
-	vec.Y = readFloat();
-	return true;
+	return readFloats(&vec.X, 2);
 }
 
 
 // read 3-dimensional vector. Stops at semicolon after third value for text file format
 bool CXMeshFileLoader::readVector3(core::vector3df& vec)
 {
-	vec.X = readFloat();
-	vec.Y = readFloat();
-	vec.Z = readFloat();
-	return true;
+	return readFloats(&vec.X, 3);
 }
 
 
@@ -2447,8 +2678,8 @@ bool CXMeshFileLoader::readRGBA(video::SColor& color)
 // read matrix from list of floats
 bool CXMeshFileLoader::readMatrix(core::matrix4& mat)
 {
-	for (u32 i=0; i<16; ++i)
-		mat[i] = readFloat();
+	if (!readFloats(mat.pointer(), 16))
+		return false;
 	return checkForOneFollowingSemicolons();
 }
 
@@ -86,6 +86,40 @@ public:
 
 private:
 
+	//! Token pointing into the file buffer, the characters are not copied
+	struct SXToken
+	{
+		SXToken() : Start(0), Length(0) {}
+		SXToken(const c8* start, u32 length) : Start(start), Length(length) {}
+		explicit SXToken(const c8* text) : Start(text), Length((u32)strlen(text)) {}
+
+		u32 size() const { return Length; }
+
+		bool operator==(const c8* other) const
+		{
+			return (strncmp(Start, other, Length) == 0) && (other[Length] == 0);
+		}
+
+		bool operator!=(const c8* other) const
+		{
+			return !(*this == other);
+		}
+
+		bool equals_ignore_case(const c8* other) const
+		{
+			for (u32 i=0; i<Length; ++i)
+				if (!other[i] || core::locale_lower(Start[i]) != core::locale_lower(other[i]))
+					return false;
+			return other[Length] == 0;
+		}
+
+		//! Copies the characters, only needed for names which are kept
+		core::stringc str() const { return core::stringc(Start, Length); }
+
+		const c8* Start;
+		u32 Length;
+	};
+
 	bool load(io::IReadFile* file);
 
 	bool readFileIntoMemory(io::IReadFile* file);
@@ -102,6 +136,9 @@ private:
 
 	bool parseDataObjectMesh(SXMesh &mesh);
 
+	//! removes the last mesh and its skin weights after it failed to parse
+	void removeLastMesh();
+
 	bool parseDataObjectSkinWeights(SXMesh &mesh);
 
 	bool parseDataObjectSkinMeshHeader(SXMesh &mesh);
@@ -135,8 +172,8 @@ private:
 	// and ignores comments
 	void findNextNoneWhiteSpaceNumber();
 
-	//! returns next parseable token. Returns empty string if no token there
-	core::stringc getNextToken();
+	//! returns next parseable token. Returns empty token if no token there
+	SXToken getNextToken();
 
 	//! reads header of dataobject including the opening brace.
 	//! returns false if error happened, and writes name of object
@@ -161,6 +198,10 @@ private:
 	u32 readBinDWord();
 	u32 readInt();
 	f32 readFloat();
+	//! reads count groups of size ints, the groups are stride bytes apart
+	bool readInts(u32* out, u32 count, u32 size=1, u32 stride=sizeof(u32));
+	//! reads count groups of size floats, the groups are stride bytes apart
+	bool readFloats(f32* out, u32 count, u32 size=1, u32 stride=sizeof(f32));
 	bool readVector2(core::vector2df& vec);
 	bool readVector3(core::vector3df& vec);
 	bool readMatrix(core::matrix4& mat);
@@ -264,6 +264,8 @@ void IBurningShader::drawLine(const s4DVertex* a, const s4DVertex* b)
 	else c.Pos.x = b->Pos.x;
 	if (d.y < 2.f) { c.Pos.y = b->Pos.y + 1.f; if (c.Pos.y > h) c.Pos.y = h; EdgeTestPass |= edge_test_first_line; }
 
+	resolve_clear((s32)floorf(a->Pos.x), (s32)floorf(core::min_(a->Pos.y, b->Pos.y, c.Pos.y)),
+		(s32)ceilf(c.Pos.x), (s32)ceilf(core::max_(a->Pos.y, b->Pos.y, c.Pos.y)));
 	drawTriangle(a, b, &c);
 	EdgeTestPass &= ~edge_test_first_line;
 
@@ -273,10 +275,61 @@ void IBurningShader::drawPoint(const s4DVertex* a)
 {
 }
 
+//! hierarchical z test of the current scanline, true if all its pixels would fail the depth test
+bool IBurningShader::hiz_span_hidden(const s32 xStart, const s32 dx)
+{
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+	// w is interpolated linear on the scanline, so the pixels are between both ends
+	SFrameStats& stats = Driver->getCurrentFrameStats();
+	if (DepthBuffer->isHidden(xStart, line.y, xStart + dx, line.y, core::max_(line.w[0], line.w[1]), false, stats))
+	{
+		stats.HiZSpansRejected += 1;
+		return true;
+	}
+#endif
+	return false;
+}
+
+//! writes deferred clears of the depth and stencil buffer to the tiles of an inclusive pixel rectangle
+void IBurningShader::resolve_clear(const s32 x0, const s32 y0, const s32 x1, const s32 y1) const
+{
+#if defined(SOFTWARE_DRIVER_2_DEFERRED_CLEAR)
+	u32 resolved = 0;
+	if (DepthBuffer)
+		resolved += DepthBuffer->resolveClear(x0, y0, x1, y1);
+	if (Stencil && useStencil())
+		resolved += Stencil->resolveClear(x0, y0, x1, y1);
+	if (resolved)
+		Driver->getCurrentFrameStats().ClearTilesResolved += resolved;
+#endif
+}
+
 void IBurningShader::drawWireFrameTriangle(s4DVertex* a, s4DVertex* b, s4DVertex* c)
 {
 	if (EdgeTestPass & edge_test_pass)
 	{
+		// pixel bounding box
+		const s32 x0 = (s32)floorf(core::min_(a->Pos.x, b->Pos.x, c->Pos.x));
+		const s32 y0 = (s32)floorf(core::min_(a->Pos.y, b->Pos.y, c->Pos.y));
+		const s32 x1 = (s32)ceilf(core::max_(a->Pos.x, b->Pos.x, c->Pos.x));
+		const s32 y1 = (s32)ceilf(core::max_(a->Pos.y, b->Pos.y, c->Pos.y));
+
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+		// reject triangles behind all depth tiles of their bounding box
+		if (DepthBuffer && canHierarchicalZ())
+		{
+			const fp24 w = core::max_(a->Pos.w, b->Pos.w, c->Pos.w);
+
+			SFrameStats& stats = Driver->getCurrentFrameStats();
+			if (DepthBuffer->isHidden(x0, y0, x1, y1, w, true, stats))
+			{
+				stats.HiZTrianglesRejected += 1;
+				return;
+			}
+		}
+#endif
+		// rejected triangles leave deferred clears pending
+		resolve_clear(x0, y0, x1, y1);
 		drawTriangle(a, b, c);
 	}
 	else if (EdgeTestPass & edge_test_point)
@@ -313,6 +313,15 @@ public:
 	virtual bool canWireFrame() { return false; }
 	virtual bool canPointCloud() { return false; }
 
+	//! true if the fragments for the current material only pass the depth test for w >= z
+	/** Triangles hidden behind the hierarchical z tiles are then rejected
+	before rasterizing them. */
+	virtual bool canHierarchicalZ() { return false; }
+
+	//! true if the fragments access the stencil buffer
+	/** Deferred clears of the stencil buffer are only written for them. */
+	virtual bool useStencil() const { return false; }
+
 	void setStencilOp(eBurningStencilOp sfail, eBurningStencilOp dpfail, eBurningStencilOp dppass);
 
 	//IShaderConstantSetCallBack
@@ -411,6 +420,20 @@ protected:
 	s32 getShaderConstantID(EBurningUniformFlags program, const c8* name);
 	bool setShaderConstantID(EBurningUniformFlags flags, s32 index, const void* data, size_t u32_count);
 
+	//! hierarchical z test of the current scanline, true if all its pixels would fail the depth test
+	bool hiz_span_hidden(const s32 xStart, const s32 dx);
+
+	//! hierarchical z, the depth of the current scanline was written
+	void hiz_span_written(const s32 xStart, const s32 dx)
+	{
+#if defined(SOFTWARE_DRIVER_2_HIERARCHICAL_Z)
+		DepthBuffer->setWritten(line.y, xStart, xStart + dx);
+#endif
+	}
+
+	//! writes deferred clears of the depth and stencil buffer to the tiles of an inclusive pixel rectangle
+	void resolve_clear(const s32 x0, const s32 y0, const s32 x1, const s32 y1) const;
+
 	video::CImage* RenderTarget;
 	CDepthBuffer* DepthBuffer;
 	CStencilBuffer* Stencil;
@@ -27,6 +27,16 @@ namespace video
 		virtual ~IImagePresenter() {};
 		//! presents a surface in the client area
 		virtual bool present(video::IImage* surface, void* windowId=0, core::rect<s32>* src=0 ) = 0;
+
+		//! returns an image which present() shows without copying, or 0 if there is none
+		/** A driver rendering into this image instead of its own back buffer
+		saves the copy in present(). The image is only returned when it has
+		the requested format and size, and after the last presented frame was
+		read from it, so it can be written until the next present(). It stays
+		the same image until the window is resized.
+		\param format Color format the driver renders in.
+		\param size Size of the back buffer of the driver. */
+		virtual video::IImage* getPresentImage(video::ECOLOR_FORMAT format, const core::dimension2d<u32>& size) { return 0; }
 	};
 
 } // end namespace video
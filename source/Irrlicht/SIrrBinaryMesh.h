@@ -0,0 +1,207 @@
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef IRR_S_IRR_BINARY_MESH_H_INCLUDED
+#define IRR_S_IRR_BINARY_MESH_H_INCLUDED
+
+#include "irrTypes.h"
+#include "irrArray.h"
+#include "IFileSystem.h"
+#include "IReadFile.h"
+
+namespace irr
+{
+namespace scene
+{
+
+/*
+	Layout of .irrbm files, all values little endian and 4 byte aligned:
+
+	SIrrBMHeader
+	TextureCount times: u32 length, characters padded to 4 bytes
+	DependencyCount times: u32 length, characters padded to 4 bytes, SIrrBMDependency
+	BufferCount times:
+		SIrrBMBuffer
+		SIrrBMMaterial
+		SIrrBMHeader::LayerCount times SIrrBMMaterialLayer
+		vertices as in memory (S3DVertex, S3DVertex2TCoords or S3DVertexTangents)
+		indices as in memory (u16 or u32), padded to 4 bytes
+	JointCount times (skinned meshes only):
+		SIrrBMJoint
+		name padded to 4 bytes
+		u32 child joint indices
+		u32 attached meshbuffer indices
+		position, scale and rotation keys as in memory
+		SIrrBMWeight weights
+
+	The vertex and index blocks can be read directly into the meshbuffers.
+*/
+
+//! Magic number of .irrbm files
+const u32 IRRBM_MAGIC = MAKE_IRR_ID('I','R','B','M');
+
+//! Version of the format, increased on every incompatible change
+const u32 IRRBM_VERSION = 2;
+
+//! Flags in SIrrBMHeader::Flags
+enum E_IRRBM_FLAGS
+{
+	//! Joints follow the meshbuffers, the mesh is loaded as ISkinnedMesh
+	EIRRBM_SKINNED = 0x1
+};
+
+//! Flags in SIrrBMMaterial::Flags
+enum E_IRRBM_MATERIAL_FLAGS
+{
+	EIRRBM_WIREFRAME = 0x1,
+	EIRRBM_POINTCLOUD = 0x2,
+	EIRRBM_GOURAUD_SHADING = 0x4,
+	EIRRBM_LIGHTING = 0x8,
+	EIRRBM_BACKFACE_CULLING = 0x10,
+	EIRRBM_FRONTFACE_CULLING = 0x20,
+	EIRRBM_FOG_ENABLE = 0x40,
+	EIRRBM_NORMALIZE_NORMALS = 0x80,
+	EIRRBM_USE_MIPMAPS = 0x100
+};
+
+struct SIrrBMHeader
+{
+	u32 Magic;
+	u32 Version;
+	u32 Flags;
+	//! E_ANIMATED_MESH_TYPE of the mesh which was written
+	u32 MeshType;
+	u32 BufferCount;
+	u32 TextureCount;
+	u32 DependencyCount;
+	u32 LayerCount;
+	u32 JointCount;
+	f32 AnimationSpeed;
+	f32 BoundingBox[6];
+};
+
+struct SIrrBMBuffer
+{
+	u32 VertexType;
+	u32 IndexType;
+	u32 PrimitiveType;
+	u32 VertexCount;
+	u32 IndexCount;
+	u32 MappingHintVertex;
+	u32 MappingHintIndex;
+	f32 BoundingBox[6];
+};
+
+struct SIrrBMMaterial
+{
+	u32 MaterialType;
+	u32 AmbientColor;
+	u32 DiffuseColor;
+	u32 EmissiveColor;
+	u32 SpecularColor;
+	f32 Shininess;
+	f32 MaterialTypeParam;
+	f32 MaterialTypeParam2;
+	f32 Thickness;
+	u32 AntiAliasing;
+	u32 ZBuffer;
+	u32 ZWriteEnable;
+	u32 ColorMask;
+	u32 ColorMaterial;
+	u32 BlendOperation;
+	f32 BlendFactor;
+	u32 PolygonOffsetFactor;
+	u32 PolygonOffsetDirection;
+	f32 PolygonOffsetDepthBias;
+	f32 PolygonOffsetSlopeScale;
+	u32 Flags;
+};
+
+struct SIrrBMMaterialLayer
+{
+	//! Index into the texture names, -1 for no texture
+	s32 Texture;
+	u32 TextureWrapU;
+	u32 TextureWrapV;
+	u32 TextureWrapW;
+	u32 BilinearFilter;
+	u32 TrilinearFilter;
+	u32 AnisotropicFilter;
+	s32 LODBias;
+	//! 0 for the identity matrix
+	u32 TextureMatrixUsed;
+	f32 TextureMatrix[16];
+};
+
+struct SIrrBMJoint
+{
+	u32 NameLength;
+	f32 LocalMatrix[16];
+	f32 GlobalInversedMatrix[16];
+	u32 ChildCount;
+	u32 AttachedMeshCount;
+	u32 PositionKeyCount;
+	u32 ScaleKeyCount;
+	u32 RotationKeyCount;
+	u32 WeightCount;
+};
+
+struct SIrrBMWeight
+{
+	u32 Buffer;
+	u32 Vertex;
+	f32 Strength;
+};
+
+//! State of a file the mesh was converted from
+/** Files like the material libraries of .obj files are no part of the
+binary mesh, it is outdated when they change. */
+struct SIrrBMDependency
+{
+	//! Size of the file, -1 if it did not exist
+	s32 Size;
+	//! Hashes of the contents
+	u32 Hash[2];
+};
+
+//! Hashes file contents
+/** Two independent 32 bit hashes keep collisions unlikely. */
+inline void hashIrrBMData(const u8* data, u32 size, u32* outHash)
+{
+	u32 fnv = 2166136261u;
+	u32 djb = 5381u;
+	for (u32 i=0; i<size; ++i)
+	{
+		fnv = (fnv ^ data[i]) * 16777619u;
+		djb = djb * 33u + data[i];
+	}
+	outHash[0] = fnv;
+	outHash[1] = djb;
+}
+
+//! Returns the current state of a file a binary mesh depends on
+inline SIrrBMDependency getIrrBMDependency(io::IFileSystem* fs, const io::path& filename)
+{
+	SIrrBMDependency dependency;
+	dependency.Size = -1;
+	dependency.Hash[0] = dependency.Hash[1] = 0;
+
+	io::IReadFile* file = fs->createAndOpenFile(filename);
+	if (!file)
+		return dependency;
+
+	core::array<u8> data;
+	data.set_used((u32)core::max_(file->getSize(), 0L));
+	if (file->read(data.pointer(), data.size()) == data.size())
+	{
+		dependency.Size = (s32)data.size();
+		hashIrrBMData(data.const_pointer(), data.size(), dependency.Hash);
+	}
+	file->drop();
+	return dependency;
+}
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -201,6 +201,18 @@ static inline interlaced_control interlaced_disabled()
 //#define fill_convention_right(x) 65535 - int(65536.0f - x)
 
 
+//Depth and stencil buffers are divided into square tiles of (1 << SOFTWARE_DRIVER_2_TILE_SHIFT) pixels
+#define SOFTWARE_DRIVER_2_TILE_SHIFT 3
+
+//Hierarchical z: reject triangles and scanlines behind the farthest depth of a tile
+#if defined(SOFTWARE_DRIVER_2_USE_WBUFFER)
+#define SOFTWARE_DRIVER_2_HIERARCHICAL_Z
+#endif
+
+//Deferred clear: clears are recorded per tile and written when the rasterizer first touches a tile
+#define SOFTWARE_DRIVER_2_DEFERRED_CLEAR
+
+
 //Check that coordinates are in render target/window space
 //#define SOFTWARE_DRIVER_2_DO_CLIPCHECK
 #if defined (SOFTWARE_DRIVER_2_DO_CLIPCHECK) && defined(_WIN32)
@@ -49,6 +49,8 @@ void burning_shader_class::OnSetMaterialBurning(const SBurningShaderMaterial& ma
 		break;
 	}
 
+	depth_test = material.org.ZBuffer == ECFN_LESSEQUAL;
+
 	if (0 == RenderPass_ShaderIsTransparent)
 	{
 		if (material.org.ZBuffer == ECFN_LESSEQUAL)
@@ -10,6 +10,7 @@ public:
 	//! draws an indexed triangle list
 	virtual void drawTriangle(const s4DVertex* burning_restrict a, const s4DVertex* burning_restrict b, const s4DVertex* burning_restrict c) IRR_OVERRIDE;
 	virtual bool canWireFrame() IRR_OVERRIDE { return true; }
+	virtual bool canHierarchicalZ() IRR_OVERRIDE { return depth_test != 0; }
 
 	virtual void OnSetMaterialBurning(const SBurningShaderMaterial& material) IRR_OVERRIDE;
 
@@ -30,6 +31,7 @@ private:
 	void fragment_depth_less_equal_no_depth_write_colormask_none();
 
 	tFragmentShader fragmentShader;
+	int depth_test;
 
 };
 
@@ -43,6 +45,7 @@ burning_shader_class::burning_shader_class(CBurningVideoDriver* driver)
 #endif
 
 	fragmentShader = &burning_shader_class::fragment_depth_less_equal_depth_write_blend_one_zero;
+	depth_test = 1;
 
 }
 
@@ -96,6 +96,14 @@ void burning_shader_class::burning_shader_fragment()
 	z = (fp24*)DepthBuffer->lock() + (line.y * RenderTarget->getDimension().Width) + xStart;
 #endif
 
+#ifdef CMP_W
+	if (hiz_span_hidden(xStart, dx))
+		return;
+#endif
+#ifdef WRITE_W
+	hiz_span_written(xStart, dx);
+#endif
+
 #ifdef burning_shader_colormask
 #else
 	f32 inversew = INVERSE_W_RANGE;
@@ -0,0 +1,250 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+#include <stdio.h>
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! writes the mesh into memory and loads it again
+IAnimatedMesh* roundTrip(IrrlichtDevice* device, IMesh* mesh, array<u8>& memory, const c8* name)
+{
+	memory.set_used(4*1024*1024);
+	io::IWriteFile* writeFile = device->getFileSystem()->createMemoryWriteFile(memory.pointer(), memory.size(), name);
+	IMeshWriter* writer = device->getSceneManager()->createMeshWriter(EMWT_IRR_BINARY_MESH);
+	const bool written = writer && writer->writeMesh(writeFile, mesh);
+	const long size = writeFile->getPos();
+	writeFile->drop();
+	if (writer)
+		writer->drop();
+	if (!written)
+		return 0;
+
+	io::IReadFile* readFile = device->getFileSystem()->createMemoryReadFile(memory.pointer(), size, name);
+	IAnimatedMesh* loaded = device->getSceneManager()->getMesh(readFile);
+	readFile->drop();
+	return loaded;
+}
+
+bool sameBuffers(IMesh* a, IMesh* b, f32 tolerance)
+{
+	if (a->getMeshBufferCount() != b->getMeshBufferCount())
+		return false;
+	for (u32 i=0; i<a->getMeshBufferCount(); ++i)
+	{
+		IMeshBuffer* ma = a->getMeshBuffer(i);
+		IMeshBuffer* mb = b->getMeshBuffer(i);
+		if (ma->getVertexType() != mb->getVertexType() || ma->getVertexCount() != mb->getVertexCount() ||
+			ma->getIndexCount() != mb->getIndexCount() || ma->getMaterial() != mb->getMaterial())
+			return false;
+		for (u32 v=0; v<ma->getVertexCount(); ++v)
+		{
+			if (!ma->getPosition(v).equals(mb->getPosition(v), tolerance) ||
+				!ma->getTCoords(v).equals(mb->getTCoords(v)))
+				return false;
+		}
+		for (u32 n=0; n<ma->getIndexCount(); ++n)
+		{
+			if (ma->getIndices()[n] != mb->getIndices()[n])
+				return false;
+		}
+	}
+	return true;
+}
+
+//! removes the files of the binary mesh cache from the results folder
+void removeCachedMeshes(io::IFileSystem* fs)
+{
+	const io::path workingDirectory = fs->getWorkingDirectory();
+	if (!fs->changeWorkingDirectoryTo("results"))
+		return;
+
+	io::IFileList* files = fs->createFileList();
+	for (u32 i=0; i<files->getFileCount(); ++i)
+	{
+		if (hasFileExtension(files->getFileName(i), "irrbm"))
+			remove(stringc(files->getFullFileName(i)).c_str());
+	}
+	files->drop();
+	fs->changeWorkingDirectoryTo(workingDirectory);
+}
+
+//! Counts the binary meshes the scene manager writes
+class CWriteCounter : public IEventReceiver
+{
+public:
+	CWriteCounter() : Writes(0) {}
+
+	virtual bool OnEvent(const SEvent& event) IRR_OVERRIDE
+	{
+		if (event.EventType == EET_LOG_TEXT_EVENT && strstr(event.LogEvent.Text, "Wrote binary mesh cache"))
+			++Writes;
+		return false;
+	}
+
+	u32 Writes;
+};
+
+//! writes a material library with one material of the given diffuse color
+void writeMaterialLibrary(io::IFileSystem* fs, const video::SColor& color)
+{
+	io::IWriteFile* file = fs->createAndWriteFile("results/binaryMesh.mtl");
+	if (!file)
+		return;
+	c8 text[64];
+	snprintf_irr(text, 64, "newmtl m\nKd %f %f %f\n", color.getRed()/255.f, color.getGreen()/255.f, color.getBlue()/255.f);
+	file->write(text, strlen(text));
+	file->drop();
+}
+
+} // end anonymous namespace
+
+/** Write static and skinned meshes in the binary .irrbm format, load them
+again and check the binary mesh cache of the scene manager. */
+bool binaryMesh(void)
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ITimer* timer = device->getTimer();
+	bool result = true;
+	array<u8> memory;
+
+	// static mesh with material settings and a texture
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(2.f, 3.f, 4.f));
+	video::SMaterial& material = cube->getMeshBuffer(0)->getMaterial();
+	material.setTexture(0, driver->addTexture(dimension2du(4, 4), "binaryMeshTexture"));
+	material.MaterialType = video::EMT_TRANSPARENT_ALPHA_CHANNEL;
+	material.DiffuseColor.set(255, 10, 20, 30);
+	material.BackfaceCulling = false;
+	material.TextureLayer[0].TextureWrapU = video::ETC_CLAMP;
+	material.getTextureMatrix(0).setTextureScale(2.f, 3.f);
+	cube->setHardwareMappingHint(EHM_STATIC);
+	IAnimatedMesh* loaded = roundTrip(device, cube, memory, "cube.irrbm");
+	if (!loaded || !sameBuffers(cube, loaded, 0.f) || loaded->getMeshType() != EAMT_STATIC ||
+		loaded->getMeshBuffer(0)->getHardwareMappingHint_Vertex() != EHM_STATIC ||
+		loaded->getBoundingBox() != cube->getBoundingBox())
+	{
+		logTestString("Static binary mesh differs\n");
+		result = false;
+	}
+	cube->drop();
+
+	// skinned mesh with joints and animation
+	u32 then = timer->getRealTime();
+	IAnimatedMesh* ninja = smgr->getMesh("../media/ninja.b3d");
+	const u32 b3dTime = timer->getRealTime() - then;
+	if (ninja)
+	{
+		then = timer->getRealTime();
+		loaded = roundTrip(device, ninja, memory, "ninja.irrbm");
+		const u32 binaryTime = timer->getRealTime() - then;
+		logTestString("ninja.b3d loaded in %u ms, written and loaded as .irrbm in %u ms\n", b3dTime, binaryTime);
+
+		if (!loaded || loaded->getMeshType() != EAMT_SKINNED ||
+			((ISkinnedMesh*)loaded)->getJointCount() != ((ISkinnedMesh*)ninja)->getJointCount() ||
+			loaded->getFrameCount() != ninja->getFrameCount() ||
+			loaded->getAnimationSpeed() != ninja->getAnimationSpeed())
+		{
+			logTestString("Skinned binary mesh differs\n");
+			result = false;
+		}
+		else
+		{
+			result &= (strcmp(((ISkinnedMesh*)loaded)->getJointName(3), ((ISkinnedMesh*)ninja)->getJointName(3)) == 0);
+
+			// same animation after skinning
+			for (s32 frame=0; frame<(s32)ninja->getFrameCount(); frame+=50)
+			{
+				if (!sameBuffers(ninja->getMesh(frame), loaded->getMesh(frame), 0.001f))
+				{
+					logTestString("Skinned binary mesh animates differently in frame %d\n", frame);
+					result = false;
+				}
+			}
+		}
+	}
+	else
+		result = false;
+
+	// corrupt files are rejected
+	memory[sizeof(u32)*3+3] = 0xff;	// high byte of the meshbuffer count
+	io::IReadFile* corrupt = device->getFileSystem()->createMemoryReadFile(memory.pointer(), 256, "corrupt.irrbm");
+	logTestString("Ignore error message in log, this is intended.\n");
+	result &= (smgr->getMesh(corrupt) == 0);
+	corrupt->drop();
+
+	// the binary mesh cache stores the conversion of loaded meshes
+	const c8 obj[] = "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n";
+	removeCachedMeshes(device->getFileSystem());
+	smgr->getParameters()->setAttribute(BINARY_MESH_CACHE_PATH, "results");
+	CWriteCounter counter;
+	device->setEventReceiver(&counter);
+	device->getLogger()->setLogLevel(ELL_DEBUG);
+	for (u32 i=0; i<2; ++i)
+	{
+		const u32 writes = counter.Writes;
+		io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(obj, sizeof(obj)-1, "cached.obj");
+		IAnimatedMesh* mesh = smgr->getMesh(file);
+		file->drop();
+		// the first load parses the obj and writes the binary file, the second one reads it, both keep the mesh type
+		result &= (counter.Writes - writes == (i == 0 ? 1u : 0u));
+		result &= (mesh && mesh->getMeshType() == EAMT_OBJ);
+		result &= (mesh && mesh->getMeshBuffer(0)->getIndexCount() == 3);
+		if (mesh)
+			smgr->getMeshCache()->removeMesh(mesh);
+	}
+
+	// the conversion is outdated when the material library changes
+	const c8 objWithMtl[] = "mtllib results/binaryMesh.mtl\nusemtl m\nv 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n";
+	const video::SColor colors[3] = { video::SColor(255, 255, 0, 0), video::SColor(255, 255, 0, 0), video::SColor(255, 0, 255, 0) };
+	const bool parsed[3] = { true, false, true };
+	for (u32 i=0; i<3; ++i)
+	{
+		if (i != 1)
+			writeMaterialLibrary(device->getFileSystem(), colors[i]);
+		const u32 writes = counter.Writes;
+		io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(objWithMtl, sizeof(objWithMtl)-1, "cachedMtl.obj");
+		IAnimatedMesh* mesh = smgr->getMesh(file);
+		file->drop();
+		result &= (counter.Writes - writes == (parsed[i] ? 1u : 0u));
+		result &= (mesh && mesh->getMeshBuffer(0)->getMaterial().DiffuseColor == colors[i]);
+		if (mesh)
+			smgr->getMeshCache()->removeMesh(mesh);
+	}
+	device->getLogger()->setLogLevel(ELL_INFORMATION);
+	device->setEventReceiver(0);
+	remove("results/binaryMesh.mtl");
+	removeCachedMeshes(device->getFileSystem());
+
+	// files too small for the mesh fail
+	IMesh* box = smgr->getGeometryCreator()->createCubeMesh();
+	IMeshWriter* writer = smgr->createMeshWriter(EMWT_IRR_BINARY_MESH);
+	for (u32 size=0; writer && size<200; size+=50)
+	{
+		io::IWriteFile* small = device->getFileSystem()->createMemoryWriteFile(memory.pointer(), size, "small.irrbm");
+		logTestString("Ignore error message in log, this is intended.\n");
+		result &= !writer->writeMesh(small, box);
+		small->drop();
+	}
+	if (writer)
+		writer->drop();
+	box->drop();
+
+	if (!result)
+		logTestString("binaryMesh failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
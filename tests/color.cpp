@@ -10,12 +10,103 @@ bool rounding()
     return col.getRed() == 1 && col.getGreen() == 2 && col.getBlue() == 3;
 }
 
+//! Convert between all formats supported by IVideoDriver::convertColor and back
+bool conversions()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, core::dimension2du(160, 120));
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+	const ECOLOR_FORMAT formats[] = { ECF_A1R5G5B5, ECF_R5G6B5, ECF_R8G8B8, ECF_A8R8G8B8 };
+	const u32 formatCount = sizeof(formats) / sizeof(formats[0]);
+	bool ok = true;
+
+	// odd sizes so kernels working on blocks of pixels also handle the rest
+	const u32 count = 1027;
+	core::array<u32> colors;
+	for (u32 i=0; i<count; ++i)
+		colors.push_back(0xFF000000 | (i * 2654435761u >> 8));
+
+	u8 src[count*4];
+	u8 tmp[count*4];
+	u8 back[count*4];
+	for (u32 s=0; s<formatCount; ++s)
+	{
+		const u32 srcSize = IImage::getBitsPerPixelFromFormat(formats[s]) / 8;
+		driver->convertColor(colors.const_pointer(), ECF_A8R8G8B8, count, src, formats[s]);
+		for (u32 d=0; d<formatCount; ++d)
+		{
+			// converting into a format with at least the same precision and back is lossless
+			if (IImage::getBitsPerPixelFromFormat(formats[d]) < IImage::getBitsPerPixelFromFormat(formats[s]) ||
+				(formats[s] == ECF_R5G6B5 && formats[d] == ECF_A1R5G5B5) ||
+				(formats[s] == ECF_A1R5G5B5 && formats[d] == ECF_R5G6B5))
+				continue;
+
+			memset(back, 0, sizeof(back));
+			driver->convertColor(src, formats[s], count, tmp, formats[d]);
+			driver->convertColor(tmp, formats[d], count, back, formats[s]);
+			for (u32 i=0; i<count; ++i)
+			{
+				if (memcmp(src + i*srcSize, back + i*srcSize, srcSize))
+				{
+					logTestString("Conversion %s -> %s -> %s changed pixel %u\n",
+						ColorFormatNames[formats[s]], ColorFormatNames[formats[d]], ColorFormatNames[formats[s]], i);
+					ok = false;
+					break;
+				}
+			}
+		}
+	}
+
+	// conversion speed of all pairs, also through images
+	ITimer* timer = device->getTimer();
+	const core::dimension2du size(1024, 1024);
+	for (u32 s=0; s<formatCount; ++s)
+	{
+		IImage* image = driver->createImage(formats[s], size);
+		image->fill(SColor(255, 40, 80, 120));
+		for (u32 d=0; d<formatCount; ++d)
+		{
+			IImage* target = driver->createImage(formats[d], size);
+
+			// row by row through the whole image, like loaders and copyToScaling convert
+			const u8* srcRow = (const u8*)image->getData();
+			u8* destRow = (u8*)target->getData();
+			u32 then = timer->getRealTime();
+			for (u32 y=0; y<size.Height; ++y)
+			{
+				driver->convertColor(srcRow, formats[s], size.Width, destRow, formats[d]);
+				srcRow += image->getPitch();
+				destRow += target->getPitch();
+			}
+			const u32 convertTime = timer->getRealTime() - then;
+
+			then = timer->getRealTime();
+			image->copyToScaling(target);
+			const u32 copyTime = timer->getRealTime() - then;
+
+			logTestString("%s -> %s: convertColor %u ms, copyToScaling %u ms for %ux%u\n",
+				ColorFormatNames[formats[s]], ColorFormatNames[formats[d]], convertTime, copyTime, size.Width, size.Height);
+			target->drop();
+		}
+		image->drop();
+	}
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return ok;
+}
+
 //! Test SColor and SColorf
 bool color(void)
 {
 	bool ok = true;
 
     ok &= rounding();
+	ok &= conversions();
 
 	return ok;
 }
@@ -0,0 +1,130 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+namespace
+{
+
+//! Draws a quad at depth z covering a rectangle of the screen
+/** The borders are fractions of the half screen width and height from the
+center, the projection has a field of view of 90 degrees. */
+void drawQuad(IVideoDriver* driver, f32 z, f32 left, f32 bottom, f32 right, f32 top, SColor color)
+{
+	const f32 aspect = 160.f / 120.f;
+	const S3DVertex vertices[4] = {
+		S3DVertex(left*aspect*z, bottom*z, z, 0,0,-1, color, 0,0),
+		S3DVertex(right*aspect*z, bottom*z, z, 0,0,-1, color, 0,0),
+		S3DVertex(right*aspect*z, top*z, z, 0,0,-1, color, 0,0),
+		S3DVertex(left*aspect*z, top*z, z, 0,0,-1, color, 0,0) };
+	const u16 indices[6] = { 0, 2, 1, 0, 3, 2 };
+	driver->drawVertexPrimitiveList(vertices, 4, indices, 2);
+}
+
+//! Counts the pixels of a screenshot with the color
+u32 countPixels(IVideoDriver* driver, SColor color)
+{
+	IImage* screenshot = driver->createScreenShot();
+	if (!screenshot)
+		return 0;
+
+	u32 count = 0;
+	const dimension2du& size = screenshot->getDimension();
+	for (u32 y=0; y<size.Height; ++y)
+	{
+		for (u32 x=0; x<size.Width; ++x)
+		{
+			const SColor pixel = screenshot->getPixel(x, y);
+			if (pixel.getRed() == color.getRed() && pixel.getGreen() == color.getGreen() && pixel.getBlue() == color.getBlue())
+				++count;
+		}
+	}
+	screenshot->drop();
+	return count;
+}
+
+//! Starts a frame clearing color and depth
+void beginFrame(IVideoDriver* driver, const SMaterial& material)
+{
+	matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(PI * 0.5f, 160.f / 120.f, 1.f, 1000.f);
+
+	driver->beginScene(ECBF_COLOR | ECBF_DEPTH, SColor(255, 0, 0, 0));
+	driver->setTransform(ETS_PROJECTION, projection);
+	driver->setTransform(ETS_VIEW, matrix4());
+	driver->setTransform(ETS_WORLD, matrix4());
+	driver->setMaterial(material);
+}
+
+} // end anonymous namespace
+
+/** Checks that the Burning's Video driver only records clears of its depth
+buffer and writes a tile when something is drawn to it, while drawing the
+same as with cleared buffers. */
+bool deferredClear(void)
+{
+	IrrlichtDevice* device = createDevice(EDT_BURNINGSVIDEO, dimension2du(160, 120), 32);
+	if (!device)
+		return true; // No error if device does not exist
+
+	IVideoDriver* driver = device->getVideoDriver();
+	bool result = true;
+
+	SMaterial material;
+	material.Lighting = false;
+
+	const SColor red(255, 255, 0, 0);
+	const SColor green(255, 0, 255, 0);
+	const u32 tiles = 20 * 15;
+
+	// a clear touches no tile, a small quad in a corner only some
+	device->run();
+	beginFrame(driver, material);
+	result &= (driver->getFrameStats(true).ClearTilesDeferred == tiles);
+	result &= (driver->getFrameStats(true).ClearTilesResolved == 0);
+	drawQuad(driver, 10.f, -1.f, 0.5f, -0.5f, 1.f, red);
+	const u32 cornerTiles = driver->getFrameStats(true).ClearTilesResolved;
+	result &= (cornerTiles > 0);
+	result &= (cornerTiles < tiles / 4);
+
+	// tiles are written once per clear
+	drawQuad(driver, 20.f, -1.f, 0.5f, -0.5f, 1.f, green);
+	result &= (driver->getFrameStats(true).ClearTilesResolved == cornerTiles);
+
+	// the near quad covers the whole screen
+	drawQuad(driver, 5.f, -2.f, -2.f, 2.f, 2.f, red);
+	driver->endScene();
+	result &= (driver->getFrameStats().ClearTilesResolved == tiles);
+	result &= (countPixels(driver, red) == 160 * 120);
+
+	// the depth of the last frame is cleared for all tiles
+	beginFrame(driver, material);
+	drawQuad(driver, 50.f, -2.f, -2.f, 2.f, 2.f, green);
+	driver->endScene();
+	result &= (driver->getFrameStats().ClearTilesResolved == tiles);
+	result &= (countPixels(driver, green) == 160 * 120);
+
+	// frames drawing nothing write no tile, the clear stays pending
+	beginFrame(driver, material);
+	driver->endScene();
+	result &= (driver->getFrameStats().ClearTilesDeferred == tiles);
+	result &= (driver->getFrameStats().ClearTilesResolved == 0);
+
+	beginFrame(driver, material);
+	drawQuad(driver, 50.f, -2.f, -2.f, 2.f, 2.f, red);
+	drawQuad(driver, 100.f, -2.f, -2.f, 2.f, 2.f, green);
+	driver->endScene();
+	result &= (countPixels(driver, red) == 160 * 120);
+
+	if (!result)
+		logTestString("deferredClear failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
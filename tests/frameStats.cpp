@@ -0,0 +1,131 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+/** Check that Burning's Video counts a texture bind when a material binds a
+different texture, not for each drawn primitive. */
+bool burningTextureBinds()
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_BURNINGSVIDEO, dimension2du(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	bool result = true;
+
+	const video::S3DVertex vertices[4] = {
+		video::S3DVertex(-1,-1,2, 0,0,-1, video::SColor(255,255,255,255), 0,1),
+		video::S3DVertex( 1,-1,2, 0,0,-1, video::SColor(255,255,255,255), 1,1),
+		video::S3DVertex( 1, 1,2, 0,0,-1, video::SColor(255,255,255,255), 1,0),
+		video::S3DVertex(-1, 1,2, 0,0,-1, video::SColor(255,255,255,255), 0,0) };
+	const u16 indices[6] = { 0, 2, 1, 0, 3, 2 };
+
+	video::ITexture* first = driver->addTexture(dimension2du(16, 16), "first", video::ECF_A8R8G8B8);
+	video::ITexture* second = driver->addTexture(dimension2du(16, 16), "second", video::ECF_A8R8G8B8);
+	video::SMaterial material;
+	material.Lighting = false;
+	material.setTexture(0, first);
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	driver->setTransform(video::ETS_PROJECTION, core::matrix4());
+	driver->setTransform(video::ETS_VIEW, core::matrix4());
+	driver->setTransform(video::ETS_WORLD, core::matrix4());
+	const u32 before = driver->getFrameStats(true).TextureBinds;
+	driver->setMaterial(material);
+	for (u32 i=0; i<4; ++i)
+		driver->drawVertexPrimitiveList(vertices, 4, indices, 2);
+	result &= (driver->getFrameStats(true).TextureBinds == before + 1);
+
+	// the same texture again is no bind, another texture is
+	driver->setMaterial(material);
+	driver->drawVertexPrimitiveList(vertices, 4, indices, 2);
+	result &= (driver->getFrameStats(true).TextureBinds == before + 1);
+	material.setTexture(0, second);
+	driver->setMaterial(material);
+	driver->drawVertexPrimitiveList(vertices, 4, indices, 2);
+	result &= (driver->getFrameStats(true).TextureBinds == before + 2);
+	result &= (driver->getFrameStats(true).Primitives == 12);
+	driver->endScene();
+
+	if (!result)
+		logTestString("frameStats: texture binds of Burning's Video failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+} // end anonymous namespace
+
+/** Check that the per-frame statistics of the null driver count draw calls,
+primitives, material changes and 2d batches and are reset by beginScene.
+Burning's Video counts texture binds per material. */
+bool frameStats(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	bool result = true;
+
+	const video::S3DVertex vertices[3] = {
+		video::S3DVertex(0,0,0, 0,0,-1, video::SColor(255,255,255,255), 0,0),
+		video::S3DVertex(1,0,0, 0,0,-1, video::SColor(255,255,255,255), 1,0),
+		video::S3DVertex(0,1,0, 0,0,-1, video::SColor(255,255,255,255), 0,1) };
+	const u16 indices[3] = { 0, 1, 2 };
+
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	driver->setMaterial(video::SMaterial());
+	for (u32 i=0; i<3; ++i)
+		driver->drawVertexPrimitiveList(vertices, 3, indices, 1);
+
+	video::ITexture* tex = driver->addTexture(dimension2du(16, 16), "frameStats", video::ECF_A8R8G8B8);
+	core::array<core::position2di> positions;
+	core::array<core::recti> rects;
+	positions.push_back(core::position2di(0, 0));
+	positions.push_back(core::position2di(8, 0));
+	rects.push_back(core::recti(0, 0, 8, 8));
+	rects.push_back(core::recti(8, 0, 16, 8));
+	driver->draw2DImageBatch(tex, positions, rects);
+
+	// counters of the frame in progress are visible before endScene
+	const video::SFrameStats& current = driver->getFrameStats(true);
+	result &= (current.DrawCalls == 5);
+	result &= (current.Primitives == 3);
+	driver->endScene();
+
+	const video::SFrameStats& last = driver->getFrameStats();
+	result &= (last.DrawCalls == 5);
+	result &= (last.Primitives == 3);
+	result &= (last.MaterialChanges == 1);
+	result &= (last.Draw2DBatches == 1);
+	result &= (last.Primitives == driver->getPrimitiveCountDrawn());
+
+	// a new frame starts from zero, the last frame keeps its values
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	result &= (driver->getFrameStats(true).DrawCalls == 0);
+	result &= (driver->getFrameStats().DrawCalls == 5);
+	driver->endScene();
+	result &= (driver->getFrameStats().DrawCalls == 0);
+
+	if (!result)
+		logTestString("frameStats failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	result &= burningTextureBinds();
+
+	return result;
+}
@@ -0,0 +1,55 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+
+/** Text drawn with a bitmap font is batched into one draw call per font
+texture, also when it is drawn again from the layout cache. */
+bool guiFont(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	gui::IGUIFont* font = device->getGUIEnvironment()->getBuiltInFont();
+	bool result = true;
+
+	const core::recti position(0, 0, 160, 120);
+	const core::stringw text(L"Hello\nWorld");
+
+	for (u32 i=0; i<2; ++i)
+	{
+		driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+		font->draw(text, position, video::SColor(255,255,255,255), true, true);
+		font->draw(L"other text", position, video::SColor(255,255,255,255), false, false, &position);
+		driver->endScene();
+
+		result &= (driver->getFrameStats().Draw2DBatches == 2);
+	}
+
+	// text completely outside the clip rectangle is not drawn at all
+	const core::recti clip(0, 0, 10, 10);
+	driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	font->draw(text, core::recti(50, 50, 160, 120), video::SColor(255,255,255,255), false, false, &clip);
+	driver->endScene();
+	result &= (driver->getFrameStats().Draw2DBatches == 0);
+
+	// changing the kerning must not use stale layouts
+	const core::dimension2du dim = font->getDimension(text.c_str());
+	font->setKerningWidth(2);
+	result &= (font->getDimension(text.c_str()).Width == dim.Width + 10);
+	font->setKerningWidth(0);
+
+	if (!result)
+		logTestString("guiFont failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,206 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+namespace
+{
+
+//! Draws a frame of the gui into the current render target
+void drawGUI(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	device->getGUIEnvironment()->drawAll();
+	driver->endScene();
+}
+
+//! Checks that state changes of the widgets mark their retained parent dirty
+bool widgetSetters(IrrlichtDevice* device)
+{
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	bool result = true;
+
+	IGUIWindow* window = env->addWindow(recti(0, 0, 160, 120));
+	IGUITable* table = env->addTable(recti(5, 25, 75, 60), window);
+	table->addColumn(L"column");
+	IGUIListBox* listBox = env->addListBox(recti(80, 25, 155, 60), window);
+	IGUIScrollBar* scrollBar = env->addScrollBar(true, recti(5, 65, 75, 75), window);
+	IGUICheckBox* checkBox = env->addCheckBox(false, recti(80, 65, 155, 75), window);
+	IGUIStaticText* text = env->addStaticText(L"text", recti(5, 80, 75, 95), false, true, window);
+	IGUIComboBox* comboBox = env->addComboBox(recti(80, 80, 155, 95), window);
+	comboBox->addItem(L"item");
+	window->setRetained(true);
+
+	// widgets which don't change stay clean after they were drawn
+	drawGUI(device);
+	drawGUI(device);
+	result &= !window->isDirty();
+
+#define CHECK_DIRTY(call) \
+	call; \
+	result &= window->isDirty(); \
+	if (!window->isDirty()) \
+		logTestString("guiRetained: %s didn't mark the window dirty\n", #call); \
+	drawGUI(device); \
+	result &= !window->isDirty();
+
+	CHECK_DIRTY(table->addRow(0))
+	CHECK_DIRTY(table->setCellText(0, 0, L"cell"))
+	CHECK_DIRTY(table->setSelected(0))
+	CHECK_DIRTY(listBox->addItem(L"item"))
+	CHECK_DIRTY(listBox->setSelected(0))
+	CHECK_DIRTY(scrollBar->setPos(50))
+	CHECK_DIRTY(checkBox->setChecked(true))
+	CHECK_DIRTY(text->setOverrideColor(video::SColor(255, 255, 0, 0)))
+	CHECK_DIRTY(text->setBackgroundColor(video::SColor(255, 0, 0, 255)))
+	CHECK_DIRTY(comboBox->setSelected(0))
+
+#undef CHECK_DIRTY
+
+	window->remove();
+	return result;
+}
+
+//! The cache is drawn as texture, which may change the colors slightly
+bool similarColor(video::SColor a, video::SColor b)
+{
+	return core::abs_((s32)a.getRed() - (s32)b.getRed()) < 4 &&
+		core::abs_((s32)a.getGreen() - (s32)b.getGreen()) < 4 &&
+		core::abs_((s32)a.getBlue() - (s32)b.getBlue()) < 4;
+}
+
+//! Checks that a gui drawn into a render target texture draws its retained elements there
+bool renderTarget()
+{
+	IrrlichtDevice* device = createDevice(video::EDT_BURNINGSVIDEO, dimension2du(160, 120));
+	if (!device)
+		return true; // No error if device does not exist
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	bool result = true;
+
+	IGUIWindow* window = env->addWindow(recti(0, 0, 80, 60));
+	IGUIStaticText* text = env->addStaticText(L"", recti(10, 25, 70, 50), false, false, window);
+	text->setBackgroundColor(video::SColor(255, 255, 0, 0));
+	window->setRetained(true);
+
+	video::ITexture* target = driver->addRenderTargetTexture(dimension2du(160, 120), "gui", video::ECF_A8R8G8B8);
+	if (!target)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return true;
+	}
+
+	// the first frame redraws the cache, the second only draws it
+	for (u32 i=0; i<2; ++i)
+	{
+		driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+		driver->setRenderTarget(target, video::ECBF_COLOR, video::SColor(255,0,0,255));
+		video::IRenderTarget* guiTarget = driver->getCurrentRenderTarget();
+		env->drawAll();
+		result &= (driver->getCurrentRenderTarget() == guiTarget);
+		driver->setRenderTarget(0, 0);
+		driver->endScene();
+
+		const u32* pixels = (const u32*)target->lock(video::ETLM_READ_ONLY);
+		result &= (pixels != 0);
+		if (pixels)
+		{
+			const u32 pitch = target->getPitch() / 4;
+			result &= similarColor(pixels[40*pitch + 40], video::SColor(255, 255, 0, 0));
+			result &= similarColor(pixels[100*pitch + 120], video::SColor(255, 0, 0, 255));
+			target->unlock();
+		}
+	}
+
+	if (!result)
+		logTestString("guiRetained: retained element not drawn into the render target\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+} // end anonymous namespace
+
+/** Check the dirty flags used to redraw retained gui elements. */
+bool guiRetained(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	bool result = true;
+
+	IGUIWindow* window = env->addWindow(recti(10, 10, 150, 110));
+	IGUIButton* button = env->addButton(recti(10, 30, 60, 50), window, -1, L"button");
+	IGUIEditBox* edit = env->addEditBox(L"text", recti(70, 30, 130, 50), true, window);
+	window->setRetained(true);
+	result &= window->isDirty();
+
+	driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	env->drawAll();
+	driver->endScene();
+	result &= !window->isDirty();
+	result &= !button->isDirty();
+
+	// changes of children propagate to the retained element
+	button->setText(L"changed");
+	result &= button->isDirty();
+	result &= window->isDirty();
+	result &= !edit->isDirty();
+
+	driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	env->drawAll();
+	driver->endScene();
+	result &= !window->isDirty();
+
+	// moving the window changes the absolute position of all children
+	window->move(position2di(5, 5));
+	result &= window->isDirty();
+	driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	env->drawAll();
+	driver->endScene();
+	result &= !window->isDirty();
+
+	// a focused edit box keeps the cursor blinking
+	env->setFocus(edit);
+	for (u32 i=0; i<2; ++i)
+	{
+		driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+		env->drawAll();
+		driver->endScene();
+		result &= window->isDirty();
+	}
+
+	// removing the element releases its cache
+	window->remove();
+	driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	env->drawAll();
+	driver->endScene();
+
+	result &= widgetSetters(device);
+
+	if (!result)
+		logTestString("guiRetained failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	result &= renderTarget();
+
+	return result;
+}
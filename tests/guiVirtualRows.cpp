@@ -0,0 +1,220 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace gui;
+
+namespace
+{
+
+class CountingTableSource : public IGUITableDataSource
+{
+public:
+	CountingTableSource(u32 rows) : Rows(rows), Calls(0), MaxRow(0) {}
+
+	virtual u32 getRowCount() const IRR_OVERRIDE
+	{
+		return Rows;
+	}
+
+	virtual const wchar_t* getCellText(u32 rowIndex, u32 columnIndex) IRR_OVERRIDE
+	{
+		++Calls;
+		MaxRow = core::max_(MaxRow, rowIndex);
+		Text = stringw(rowIndex);
+		return Text.c_str();
+	}
+
+	u32 Rows;
+	u32 Calls;
+	u32 MaxRow;
+	stringw Text;
+};
+
+class CountingListSource : public IGUIListBoxDataSource
+{
+public:
+	CountingListSource(u32 items) : Items(items), Calls(0) {}
+
+	virtual u32 getItemCount() const IRR_OVERRIDE
+	{
+		return Items;
+	}
+
+	virtual const wchar_t* getItemText(u32 index) IRR_OVERRIDE
+	{
+		++Calls;
+		Text = stringw(index);
+		return Text.c_str();
+	}
+
+	u32 Items;
+	u32 Calls;
+	stringw Text;
+};
+
+void drawFrame(IrrlichtDevice* device)
+{
+	device->getVideoDriver()->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	device->getGUIEnvironment()->drawAll();
+	device->getVideoDriver()->endScene();
+}
+
+//! Scrolls from the top to the bottom of a table and a list box, one frame per position
+u32 scrollTime(IrrlichtDevice* device, IGUIElement* element, IGUIScrollBar* scrollBar)
+{
+	ITimer* timer = device->getTimer();
+	const u32 frames = 500;
+	const u32 then = timer->getRealTime();
+	for (u32 i=0; i<frames; ++i)
+	{
+		scrollBar->setPos((s32)((f64)scrollBar->getMax() * i / (frames-1)));
+		drawFrame(device);
+	}
+	const u32 time = timer->getRealTime() - then;
+	element->remove();
+	return time;
+}
+
+//! Compares scrolling through a million rows from a data source with scrolling through stored rows
+void scrollBenchmark(IrrlichtDevice* device)
+{
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	const u32 storedRows = 10000;
+
+	IGUITable* table = env->addTable(recti(0, 0, 160, 120));
+	table->addColumn(L"a");
+	table->addColumn(L"b");
+	CountingTableSource* tableSource = new CountingTableSource(1000000);
+	table->setDataSource(tableSource);
+	tableSource->drop();
+	const u32 virtualTable = scrollTime(device, table, table->getVerticalScrollBar());
+
+	table = env->addTable(recti(0, 0, 160, 120));
+	table->addColumn(L"a");
+	table->addColumn(L"b");
+	for (u32 i=0; i<storedRows; ++i)
+	{
+		table->addRow(i);
+		table->setCellText(i, 0, stringw(i));
+		table->setCellText(i, 1, stringw(i));
+	}
+	const u32 storedTable = scrollTime(device, table, table->getVerticalScrollBar());
+
+	IGUIListBox* list = env->addListBox(recti(0, 0, 160, 120));
+	CountingListSource* listSource = new CountingListSource(1000000);
+	list->setDataSource(listSource);
+	listSource->drop();
+	// the list box has no public scrollbar, but scrolls to the selection
+	ITimer* timer = device->getTimer();
+	u32 then = timer->getRealTime();
+	for (u32 i=0; i<500; ++i)
+	{
+		list->setSelected((s32)((f64)999999 * i / 499));
+		drawFrame(device);
+	}
+	const u32 virtualList = timer->getRealTime() - then;
+	list->remove();
+
+	list = env->addListBox(recti(0, 0, 160, 120));
+	for (u32 i=0; i<storedRows; ++i)
+		list->addItem(stringw(i).c_str());
+	then = timer->getRealTime();
+	for (u32 i=0; i<500; ++i)
+	{
+		list->setSelected((s32)((f64)(storedRows-1) * i / 499));
+		drawFrame(device);
+	}
+	const u32 storedList = timer->getRealTime() - then;
+	list->remove();
+
+	logTestString("Scrolling 500 frames: table with 1000000 source rows %u ms, %u stored rows %u ms\n",
+		virtualTable, storedRows, storedTable);
+	logTestString("Scrolling 500 frames: list box with 1000000 source items %u ms, %u stored items %u ms\n",
+		virtualList, storedRows, storedList);
+}
+
+} // end anonymous namespace
+
+/** Tables and list boxes with a data source only query the rows in view,
+so drawing a million rows costs as much as drawing a few. */
+bool guiVirtualRows(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	IGUIEnvironment* env = device->getGUIEnvironment();
+	bool result = true;
+
+	IGUITable* table = env->addTable(recti(0, 0, 160, 60));
+	table->addColumn(L"a");
+	table->addColumn(L"b");
+	CountingTableSource* tableSource = new CountingTableSource(1000000);
+	table->setDataSource(tableSource);
+	result &= (table->getRowCount() == 1000000);
+	result &= (wcscmp(table->getCellText(999999, 0), L"999999") == 0);
+
+	tableSource->Calls = 0;
+	drawFrame(device);
+	result &= (tableSource->Calls > 0 && tableSource->Calls < 40);
+
+	// scrolling to the end only queries the last rows
+	table->setSelected(999999);
+	result &= (table->getSelected() == 999999);
+	table->getVerticalScrollBar()->setPos(table->getVerticalScrollBar()->getMax());
+	tableSource->Calls = 0;
+	tableSource->MaxRow = 0;
+	drawFrame(device);
+	result &= (tableSource->Calls > 0 && tableSource->Calls < 40);
+	result &= (tableSource->MaxRow == 999999);
+
+	// stored rows don't change the selected row of the data source
+	table->addRow(0);
+	table->removeRow(0);
+	result &= (table->getSelected() == 999999);
+	table->setColumnOrdering(0, EGCO_ASCENDING);
+	table->setActiveColumn(0, true);
+	result &= (table->getSelected() == 999999);
+
+	// shrinking data sources clamp the selection
+	tableSource->Rows = 10;
+	drawFrame(device);
+	result &= (table->getSelected() < 10);
+	table->setDataSource(0);
+	result &= (table->getRowCount() == 0);
+	tableSource->drop();
+
+	IGUIListBox* list = env->addListBox(recti(0, 60, 160, 120));
+	list->addItem(L"stored");
+	CountingListSource* listSource = new CountingListSource(1000000);
+	list->setDataSource(listSource);
+	result &= (list->getItemCount() == 1000000);
+	list->setSelected(L"500000");
+	result &= (list->getSelected() == 500000);
+
+	listSource->Calls = 0;
+	drawFrame(device);
+	result &= (listSource->Calls > 0 && listSource->Calls < 20);
+
+	list->removeItem(0);
+	result &= (list->getSelected() == 500000);
+
+	list->setDataSource(0);
+	result &= (list->getItemCount() == 0);
+	listSource->drop();
+
+	scrollBenchmark(device);
+
+	if (!result)
+		logTestString("guiVirtualRows failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
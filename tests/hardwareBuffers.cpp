@@ -0,0 +1,156 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Links are kept packed, so the handles of the linked meshbuffers are 0 to count-1
+bool handlesArePacked(const array<SMeshBuffer*>& buffers, const array<bool>& linked)
+{
+	u32 count = 0;
+	for (u32 i=0; i<buffers.size(); ++i)
+	{
+		if (buffers[i] && linked[i])
+			++count;
+	}
+
+	array<bool> used;
+	used.set_used(count);
+	for (u32 i=0; i<count; ++i)
+		used[i] = false;
+
+	for (u32 i=0; i<buffers.size(); ++i)
+	{
+		if (!buffers[i])
+			continue;
+		const u32 handle = buffers[i]->getHWBufferHandle();
+		if (!linked[i])
+		{
+			if (handle != 0xffffffff)
+				return false;
+			continue;
+		}
+		if (handle >= count || used[handle])
+			return false;
+		used[handle] = true;
+	}
+	return true;
+}
+
+//! Draws the linked meshbuffers, which creates their links or finds them
+void drawLinked(video::IVideoDriver* driver, const array<SMeshBuffer*>& buffers, const array<bool>& linked)
+{
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	driver->setTransform(video::ETS_WORLD, IdentityMatrix);
+	for (u32 i=0; i<buffers.size(); ++i)
+	{
+		if (buffers[i] && linked[i])
+		{
+			driver->setMaterial(buffers[i]->Material);
+			driver->drawMeshBuffer(buffers[i]);
+		}
+	}
+	driver->endScene();
+}
+
+bool testWithDriver(video::E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice* device = createDevice(driverType, dimension2du(160, 120));
+	if (!device)
+		return true;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	logTestString("Testing driver %ls\n", driver->getName());
+	driver->setMinHardwareBufferVertexCount(0);
+
+	const u32 count = 1000;
+	array<SMeshBuffer*> buffers;
+	array<bool> linked;
+	for (u32 i=0; i<count; ++i)
+	{
+		SMeshBuffer* buffer = new SMeshBuffer();
+		buffer->Vertices.push_back(video::S3DVertex(0.f, 0.f, 1.f, 0.f, 0.f, -1.f, video::SColor(255,255,255,255), 0.f, 0.f));
+		buffer->Vertices.push_back(video::S3DVertex(1.f, 0.f, 1.f, 0.f, 0.f, -1.f, video::SColor(255,255,255,255), 1.f, 0.f));
+		buffer->Vertices.push_back(video::S3DVertex(0.f, 1.f, 1.f, 0.f, 0.f, -1.f, video::SColor(255,255,255,255), 0.f, 1.f));
+		buffer->Indices.push_back(0);
+		buffer->Indices.push_back(1);
+		buffer->Indices.push_back(2);
+		buffer->Material.Lighting = false;
+		buffer->setHardwareMappingHint(EHM_STATIC);
+		buffers.push_back(buffer);
+		linked.push_back(true);
+	}
+
+	bool result = true;
+	drawLinked(driver, buffers, linked);
+	result &= handlesArePacked(buffers, linked);
+
+	// removing a link moves the last one into the gap
+	u32 links = count;
+	for (u32 i=0; i<count; i+=3)
+	{
+		driver->removeHardwareBuffer(buffers[i]);
+		linked[i] = false;
+		--links;
+	}
+	result &= handlesArePacked(buffers, linked);
+
+	// the moved links are found through the fixed handles, no new links are created
+	drawLinked(driver, buffers, linked);
+	result &= handlesArePacked(buffers, linked);
+
+	// a removed meshbuffer gets a new link at the end
+	linked[0] = true;
+	drawLinked(driver, buffers, linked);
+	result &= handlesArePacked(buffers, linked);
+	result &= (buffers[0]->getHWBufferHandle() == links);
+
+	// links of meshbuffers only used by the driver are deleted at the end of the frame
+	for (u32 i=1; i<count; i+=2)
+	{
+		if (linked[i])
+		{
+			buffers[i]->drop();
+			buffers[i] = 0;
+		}
+	}
+	drawLinked(driver, buffers, linked);
+	result &= handlesArePacked(buffers, linked);
+
+	driver->removeAllHardwareBuffers();
+	for (u32 i=0; i<count; ++i)
+		linked[i] = false;
+	result &= handlesArePacked(buffers, linked);
+
+	for (u32 i=0; i<count; ++i)
+	{
+		if (buffers[i])
+			buffers[i]->drop();
+	}
+
+	if (!result)
+		logTestString("hardwareBuffers failed with driver %ls\n", driver->getName());
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
+} // end anonymous namespace
+
+/** Meshbuffers find their hardware buffer links through the handle stored in
+them, also after other links were removed and the last links moved into the
+gaps. */
+bool hardwareBuffers(void)
+{
+	bool result = true;
+	TestWithAllHWDrivers(testWithDriver);
+	return result;
+}
@@ -0,0 +1,126 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+namespace
+{
+
+//! Draws a quad at depth z covering the screen horizontally between two heights
+/** The heights are fractions of the screen height above the center, the
+projection has a field of view of 90 degrees, so 1 is the top border. */
+void drawQuad(IVideoDriver* driver, f32 z, f32 bottom, f32 top, SColor color)
+{
+	const S3DVertex vertices[4] = {
+		S3DVertex(-2.f*z, bottom*z, z, 0,0,-1, color, 0,0),
+		S3DVertex( 2.f*z, bottom*z, z, 0,0,-1, color, 0,0),
+		S3DVertex( 2.f*z, top*z, z, 0,0,-1, color, 0,0),
+		S3DVertex(-2.f*z, top*z, z, 0,0,-1, color, 0,0) };
+	const u16 indices[6] = { 0, 2, 1, 0, 3, 2 };
+	driver->drawVertexPrimitiveList(vertices, 4, indices, 2);
+}
+
+//! Counts the pixels of a screenshot with the color
+u32 countPixels(IVideoDriver* driver, SColor color)
+{
+	IImage* screenshot = driver->createScreenShot();
+	if (!screenshot)
+		return 0;
+
+	u32 count = 0;
+	const dimension2du& size = screenshot->getDimension();
+	for (u32 y=0; y<size.Height; ++y)
+	{
+		for (u32 x=0; x<size.Width; ++x)
+		{
+			const SColor pixel = screenshot->getPixel(x, y);
+			if (pixel.getRed() == color.getRed() && pixel.getGreen() == color.getGreen() && pixel.getBlue() == color.getBlue())
+				++count;
+		}
+	}
+	screenshot->drop();
+	return count;
+}
+
+} // end anonymous namespace
+
+/** Checks that the Burning's Video driver rejects triangles and scanlines
+hidden behind the depth tiles of its hierarchical z test, without changing
+what is drawn. */
+bool hierarchicalZ(void)
+{
+	IrrlichtDevice* device = createDevice(EDT_BURNINGSVIDEO, dimension2du(160, 120), 32);
+	if (!device)
+		return true; // No error if device does not exist
+
+	IVideoDriver* driver = device->getVideoDriver();
+	bool result = true;
+
+	matrix4 projection;
+	projection.buildProjectionMatrixPerspectiveFovLH(PI * 0.5f, 160.f / 120.f, 1.f, 1000.f);
+	SMaterial material;
+	material.Lighting = false;
+
+	const SColor red(255, 255, 0, 0);
+	const SColor green(255, 0, 255, 0);
+	const SColor blue(255, 0, 0, 255);
+
+	device->run();
+	driver->beginScene(ECBF_COLOR | ECBF_DEPTH, SColor(255, 0, 0, 0));
+	driver->setTransform(ETS_PROJECTION, projection);
+	driver->setTransform(ETS_VIEW, matrix4());
+	driver->setTransform(ETS_WORLD, matrix4());
+	driver->setMaterial(material);
+
+	// the occluder covers the upper half of the screen
+	drawQuad(driver, 10.f, 0.f, 2.f, red);
+	SFrameStats before = driver->getFrameStats(true);
+
+	// whole triangles behind it are rejected
+	drawQuad(driver, 50.f, 0.2f, 1.5f, green);
+	SFrameStats after = driver->getFrameStats(true);
+	result &= (after.HiZTrianglesRejected > before.HiZTrianglesRejected);
+	result &= (after.HiZTileTests > before.HiZTileTests);
+	result &= (after.HiZTileUpdates > before.HiZTileUpdates);
+
+	// triangles reaching the lower half are drawn, their hidden scanlines are rejected
+	before = after;
+	drawQuad(driver, 100.f, -2.f, 2.f, blue);
+	after = driver->getFrameStats(true);
+	result &= (after.HiZTrianglesRejected == before.HiZTrianglesRejected);
+	result &= (after.HiZSpansRejected > before.HiZSpansRejected);
+
+	// nearer triangles are not rejected
+	before = after;
+	drawQuad(driver, 5.f, 0.5f, 0.6f, green);
+	after = driver->getFrameStats(true);
+	result &= (after.HiZTrianglesRejected == before.HiZTrianglesRejected);
+	result &= (after.HiZSpansRejected == before.HiZSpansRejected);
+	driver->endScene();
+
+	result &= (countPixels(driver, red) > 0);
+	result &= (countPixels(driver, blue) == 160 * 60);
+	result &= (countPixels(driver, green) > 0);
+	result &= (countPixels(driver, red) + countPixels(driver, blue) + countPixels(driver, green) == 160 * 120);
+
+	// the tiles are reset when the depth buffer is cleared
+	driver->beginScene(ECBF_COLOR | ECBF_DEPTH, SColor(255, 0, 0, 0));
+	driver->setMaterial(material);
+	drawQuad(driver, 50.f, 0.2f, 1.5f, green);
+	result &= (driver->getFrameStats(true).HiZTrianglesRejected == 0);
+	driver->endScene();
+	result &= (countPixels(driver, green) > 0);
+	result &= (driver->getFrameStats().HiZTrianglesRejected == 0);
+
+	if (!result)
+		logTestString("hierarchicalZ failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,117 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+namespace
+{
+
+//! fills an image with transparent, translucent and opaque pixels
+void fillPattern(IImage* image)
+{
+	const dimension2du& size = image->getDimension();
+	for (u32 y=0; y<size.Height; ++y)
+	{
+		for (u32 x=0; x<size.Width; ++x)
+		{
+			const u32 alpha = (x % 3 == 0) ? 0 : (x % 3 == 1) ? 255 : (x * 7 + y) & 0xFF;
+			image->setPixel(x, y, SColor(alpha, x & 0xFF, y & 0xFF, (x + y) & 0xFF));
+		}
+	}
+}
+
+bool similar(const SColor& a, const SColor& b)
+{
+	return core::abs_((s32)a.getRed() - (s32)b.getRed()) <= 1 &&
+		core::abs_((s32)a.getGreen() - (s32)b.getGreen()) <= 1 &&
+		core::abs_((s32)a.getBlue() - (s32)b.getBlue()) <= 1;
+}
+
+} // end anonymous namespace
+
+/** Check the results of the software blitters used by IImage and log their speed. */
+bool imageBlit(void)
+{
+	IrrlichtDevice* device = createDevice(EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+	ITimer* timer = device->getTimer();
+	bool result = true;
+
+	const SColor background(255, 10, 20, 30);
+	const u32 sizes[] = { 256, 1024 };
+	for (u32 s=0; s<sizeof(sizes)/sizeof(sizes[0]); ++s)
+	{
+		const dimension2du size(sizes[s], sizes[s]);
+		IImage* source = driver->createImage(ECF_A8R8G8B8, size);
+		IImage* target = driver->createImage(ECF_A8R8G8B8, size);
+		fillPattern(source);
+		const recti sourceRect(position2di(0, 0), size);
+
+		// alpha blending
+		target->fill(background);
+		u32 then = timer->getRealTime();
+		source->copyToWithAlpha(target, position2di(0, 0), sourceRect, SColor(255,255,255,255));
+		const u32 blendTime = timer->getRealTime() - then;
+		for (u32 x=0; x<6; ++x)
+		{
+			const SColor src = source->getPixel(x, 5);
+			const SColor dst = target->getPixel(x, 5);
+			if (src.getAlpha() == 0)
+				result &= (dst == background);
+			else if (src.getAlpha() == 255)
+				result &= (dst == src);
+			else
+				result &= similar(dst, src.getInterpolated(background, src.getAlpha() / 255.f));
+		}
+
+		// alpha blending with a color
+		target->fill(background);
+		then = timer->getRealTime();
+		source->copyToWithAlpha(target, position2di(0, 0), sourceRect, SColor(255,255,0,255));
+		const u32 blendColorTime = timer->getRealTime() - then;
+		result &= (target->getPixel(0, 5) == background);
+		result &= (target->getPixel(1, 5).getGreen() == 0);
+
+		// combining alpha
+		target->fill(SColor(0, 10, 20, 30));
+		then = timer->getRealTime();
+		source->copyToWithAlpha(target, position2di(0, 0), sourceRect, SColor(255,255,255,255), 0, true);
+		const u32 combineTime = timer->getRealTime() - then;
+		result &= (target->getPixel(0, 5) == SColor(0, 10, 20, 30));
+		result &= (target->getPixel(1, 5).getAlpha() >= 254);	// color modulation is c*255/256
+
+		// copy and conversion
+		then = timer->getRealTime();
+		source->copyTo(target, position2di(0, 0));
+		const u32 copyTime = timer->getRealTime() - then;
+		result &= (target->getPixel(2, 7) == source->getPixel(2, 7));
+
+		IImage* target16 = driver->createImage(ECF_A1R5G5B5, size);
+		then = timer->getRealTime();
+		source->copyTo(target16, position2di(0, 0));
+		const u32 convertTime = timer->getRealTime() - then;
+
+		logTestString("imageBlit %ux%u: blend %u ms, blend color %u ms, combine %u ms, copy %u ms, 32 to 16 bit %u ms\n",
+			size.Width, size.Height, blendTime, blendColorTime, combineTime, copyTime, convertTime);
+
+		target16->drop();
+		target->drop();
+		source->drop();
+	}
+
+	if (!result)
+		logTestString("imageBlit failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,145 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace video;
+
+namespace
+{
+
+bool isUniform(IImage* image, const SColor& color, u32 tolerance)
+{
+	const dimension2du& size = image->getDimension();
+	for (u32 y=0; y<size.Height; ++y)
+	{
+		for (u32 x=0; x<size.Width; ++x)
+		{
+			const SColor c = image->getPixel(x, y);
+			if ((u32)core::abs_((s32)c.getAlpha() - (s32)color.getAlpha()) > tolerance ||
+				(u32)core::abs_((s32)c.getRed() - (s32)color.getRed()) > tolerance ||
+				(u32)core::abs_((s32)c.getGreen() - (s32)color.getGreen()) > tolerance ||
+				(u32)core::abs_((s32)c.getBlue() - (s32)color.getBlue()) > tolerance)
+			{
+				logTestString("pixel %u,%u is %08x instead of %08x\n", x, y, c.color, color.color);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+} // end anonymous namespace
+
+/** Check the filters of IImage::copyToScalingFiltered and log their speed. */
+bool imageScaling(void)
+{
+	IrrlichtDevice* device = createDevice(EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	IVideoDriver* driver = device->getVideoDriver();
+	ITimer* timer = device->getTimer();
+	bool result = true;
+
+	const E_RESAMPLE_FILTER filters[] = { ERF_BOX, ERF_BILINEAR, ERF_BICUBIC, ERF_LANCZOS3 };
+	const u32 filterCount = sizeof(filters)/sizeof(filters[0]);
+
+	// a constant image stays constant, scaled up or down, also with negative lobes
+	const SColor constant(200, 40, 120, 250);
+	IImage* source = driver->createImage(ECF_A8R8G8B8, dimension2du(37, 23));
+	source->fill(constant);
+	const dimension2du sizes[] = { dimension2du(8, 5), dimension2du(100, 61), dimension2du(37, 23) };
+	for (u32 f=0; f<filterCount; ++f)
+	{
+		for (u32 s=0; s<sizeof(sizes)/sizeof(sizes[0]); ++s)
+		{
+			IImage* target = driver->createImage(source, sizes[s], filters[f]);
+			result &= (target && target->getDimension() == sizes[s] && target->getColorFormat() == ECF_A8R8G8B8);
+			if (target)
+			{
+				result &= isUniform(target, constant, 0);
+				target->drop();
+			}
+		}
+	}
+	source->drop();
+
+	// halving a checkerboard with a box filter averages each 2x2 block
+	source = driver->createImage(ECF_A8R8G8B8, dimension2du(64, 64));
+	for (u32 y=0; y<64; ++y)
+		for (u32 x=0; x<64; ++x)
+			source->setPixel(x, y, ((x ^ y) & 1) ? SColor(255,255,255,255) : SColor(255,0,0,0));
+	IImage* target = driver->createImage(ECF_A8R8G8B8, dimension2du(32, 32));
+	source->copyToScalingFiltered(target, ERF_BOX);
+	result &= isUniform(target, SColor(255,128,128,128), 1);
+	target->drop();
+	source->drop();
+
+	// transparent pixels don't bleed their color into visible ones
+	source = driver->createImage(ECF_A8R8G8B8, dimension2du(32, 32));
+	for (u32 y=0; y<32; ++y)
+		for (u32 x=0; x<32; ++x)
+			source->setPixel(x, y, (x & 1) ? SColor(255,255,0,0) : SColor(0,0,255,0));
+	for (u32 f=0; f<filterCount; ++f)
+	{
+		target = driver->createImage(ECF_A8R8G8B8, dimension2du(13, 13));
+		source->copyToScalingFiltered(target, filters[f]);
+		for (u32 y=0; y<13; ++y)
+		{
+			for (u32 x=0; x<13; ++x)
+			{
+				const SColor c = target->getPixel(x, y);
+				if (c.getAlpha() > 0 && (c.getGreen() > 1 || c.getRed() < 254))
+				{
+					logTestString("filter %u bleeds transparent color: %08x\n", f, c.color);
+					result = false;
+					break;
+				}
+			}
+		}
+		target->drop();
+	}
+	source->drop();
+
+	// other formats are converted on the fly
+	source = driver->createImage(ECF_R5G6B5, dimension2du(20, 20));
+	source->fill(SColor(255, 255, 0, 255));
+	target = driver->createImage(source, dimension2du(10, 30), ERF_BICUBIC);
+	result &= (target && target->getColorFormat() == ECF_R5G6B5);
+	if (target)
+	{
+		result &= isUniform(target, source->getPixel(0, 0), 0);
+		target->drop();
+	}
+	source->drop();
+
+	// speed of a strong downscale
+	source = driver->createImage(ECF_A8R8G8B8, dimension2du(2048, 2048));
+	for (u32 y=0; y<2048; ++y)
+		for (u32 x=0; x<2048; ++x)
+			source->setPixel(x, y, SColor(255, x & 0xFF, y & 0xFF, (x + y) & 0xFF));
+	target = driver->createImage(ECF_A8R8G8B8, dimension2du(128, 128));
+	u32 then = timer->getRealTime();
+	source->copyToScalingBoxFilter(target, 0, false);
+	logTestString("copyToScalingBoxFilter 2048->128: %u ms\n", timer->getRealTime() - then);
+	for (u32 f=0; f<filterCount; ++f)
+	{
+		then = timer->getRealTime();
+		source->copyToScalingFiltered(target, filters[f]);
+		logTestString("copyToScalingFiltered filter %u 2048->128: %u ms\n", f, timer->getRealTime() - then);
+	}
+	target->drop();
+	source->drop();
+
+	if (!result)
+		logTestString("imageScaling failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
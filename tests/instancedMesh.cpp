@@ -0,0 +1,153 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Draws the scene a few times and returns the time it took
+u32 drawScene(IrrlichtDevice* device, u32 frames)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	const u32 then = timer->getRealTime();
+	for (u32 f=0; f<frames; ++f)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	return timer->getRealTime() - then;
+}
+
+//! Transformation of an instance in a grid around the origin
+matrix4 gridTransform(u32 i, u32 size)
+{
+	matrix4 m;
+	m.setTranslation(vector3df(((s32)(i % size) - (s32)size/2) * 10.f, 0.f, ((s32)(i / size) - (s32)size/2) * 10.f));
+	return m;
+}
+
+} // end anonymous namespace
+
+/** An instanced mesh scene node culls its instances against the view frustum
+and draws the remaining ones with one draw call. Also logs how long drawing
+the instances takes compared to a mesh scene node per instance. */
+bool instancedMesh(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	bool result = true;
+
+	IMesh* mesh = smgr->getGeometryCreator()->createCubeMesh(vector3df(2.f, 2.f, 2.f));
+	const u32 primitives = mesh->getMeshBuffer(0)->getIndexCount() / 3;
+
+	result &= (smgr->addInstancedMeshSceneNode(0) == 0);
+	IInstancedMeshSceneNode* node = smgr->addInstancedMeshSceneNode(mesh);
+	result &= (node->getType() == ESNT_INSTANCED_MESH);
+	result &= (node->getMaterialCount() == mesh->getMeshBufferCount());
+
+	const u32 size = 100;
+	for (u32 i=0; i<size*size; ++i)
+		result &= (node->addInstance(gridTransform(i, size)) == i);
+	result &= (node->getInstanceCount() == size*size);
+	result &= node->getBoundingBox().isPointInside(vector3df(-500.f, 0.f, -500.f));
+	result &= node->getBoundingBox().isPointInside(vector3df(490.f, 0.f, 490.f));
+
+	// without a camera all instances are drawn with a single call
+	drawScene(device, 1);
+	result &= (node->getVisibleInstanceCount() == size*size);
+	result &= (driver->getFrameStats().DrawCalls == 1);
+	result &= (driver->getFrameStats().Instances == size*size);
+	result &= (driver->getFrameStats().Primitives == size*size*primitives);
+
+	// the camera looks along the grid, the half behind it is culled
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0.f, 20.f, 0.f), vector3df(0.f, 20.f, 100.f));
+	camera->setFarValue(10000.f);
+	drawScene(device, 1);
+	const u32 visible = node->getVisibleInstanceCount();
+	result &= (visible > 0 && visible < size*size/2);
+	result &= (driver->getFrameStats().DrawCalls == 1);
+	result &= (driver->getFrameStats().Instances == visible);
+
+	// instances are culled in the space of the node
+	node->setPosition(vector3df(0.f, 0.f, -2000.f));
+	node->updateAbsolutePosition();
+	drawScene(device, 1);
+	result &= (node->getVisibleInstanceCount() == 0);
+	result &= (driver->getFrameStats().DrawCalls == 0);
+	node->setPosition(vector3df(0.f, 0.f, 0.f));
+	node->updateAbsolutePosition();
+
+	// automatic culling can be switched off
+	node->setAutomaticCulling(EAC_OFF);
+	drawScene(device, 1);
+	result &= (node->getVisibleInstanceCount() == size*size);
+	node->setAutomaticCulling(EAC_BOX);
+
+	// the last instance moves into the gap of a removed one
+	const matrix4 last = node->getInstanceTransform(size*size-1);
+	node->removeInstance(3);
+	result &= (node->getInstanceCount() == size*size-1);
+	result &= (node->getInstanceTransform(3) == last);
+
+	// moved instances change the box of the node
+	matrix4 moved;
+	moved.setTranslation(vector3df(0.f, 5000.f, 0.f));
+	node->setInstanceTransform(0, moved);
+	result &= node->getBoundingBox().isPointInside(vector3df(0.f, 5000.f, 0.f));
+
+	// colors are kept per instance
+	node->setInstanceColor(5, video::SColor(255, 255, 0, 0));
+	result &= (node->getInstanceColor(5) == video::SColor(255, 255, 0, 0));
+	result &= (node->getInstanceColor(6) == video::SColor(255, 255, 255, 255));
+	drawScene(device, 1);
+	result &= (driver->getFrameStats().DrawCalls == 1);
+
+	// instances drawn directly with the driver
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	const matrix4 instances[2] = { gridTransform(0, size), gridTransform(1, size) };
+	driver->drawMeshBufferInstanced(mesh->getMeshBuffer(0), instances, 2);
+	result &= (driver->getFrameStats(true).DrawCalls == 1);
+	result &= (driver->getFrameStats(true).Instances == 2);
+	driver->endScene();
+
+	// compare with a mesh scene node per instance
+	node->removeAllInstances();
+	result &= (node->getInstanceCount() == 0);
+	for (u32 i=0; i<size*size; ++i)
+		node->addInstance(gridTransform(i, size));
+
+	const u32 frames = 10;
+	const u32 instancedTime = drawScene(device, frames);
+	node->setVisible(false);
+
+	for (u32 i=0; i<size*size; ++i)
+		smgr->addMeshSceneNode(mesh, 0, -1, gridTransform(i, size).getTranslation());
+	const u32 nodesTime = drawScene(device, frames);
+	result &= (driver->getFrameStats().DrawCalls >= visible);
+
+	logTestString("%u frames of %u cubes: instanced node %u ms, mesh nodes %u ms\n",
+		frames, size*size, instancedTime, nodesTime);
+
+	mesh->drop();
+
+	if (!result)
+		logTestString("instancedMesh failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
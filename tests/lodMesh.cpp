@@ -0,0 +1,175 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Returns the number of triangles of a mesh
+u32 getPrimitiveCount(const IMesh* mesh)
+{
+	u32 count = 0;
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+		count += mesh->getMeshBuffer(i)->getPrimitiveCount();
+	return count;
+}
+
+//! Draws a frame with the camera at a distance in front of the node
+void drawAt(IrrlichtDevice* device, ICameraSceneNode* camera, f32 distance)
+{
+	camera->setPosition(vector3df(0.f, 0.f, -distance));
+	device->getVideoDriver()->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	device->getVideoDriver()->endScene();
+}
+
+} // end anonymous namespace
+
+/** Simplifies meshes with the mesh manipulator and checks that a LOD mesh
+scene node chooses its level by its size on the screen, without changing
+back and forth near the border of two levels. */
+bool lodMesh(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	const IMeshManipulator* manipulator = smgr->getMeshManipulator();
+	bool result = true;
+
+	IMesh* sphere = smgr->getGeometryCreator()->createSphereMesh(10.f, 32, 32);
+	sphere->getMeshBuffer(0)->getMaterial().Lighting = false;
+	const u32 spherePrimitives = getPrimitiveCount(sphere);
+
+	// the simplified mesh keeps materials, size and shape
+	ITimer* timer = device->getTimer();
+	const u32 then = timer->getRealTime();
+	IMesh* half = manipulator->createSimplifiedMesh(sphere, 0.5f);
+	const u32 simplifyTime = timer->getRealTime() - then;
+	result &= (half->getMeshBufferCount() == 1);
+	result &= (getPrimitiveCount(half) <= spherePrimitives/2);
+	result &= (getPrimitiveCount(half) > spherePrimitives/4);
+	result &= (half->getMeshBuffer(0)->getVertexCount() < sphere->getMeshBuffer(0)->getVertexCount());
+	result &= !half->getMeshBuffer(0)->getMaterial().Lighting;
+	result &= half->getBoundingBox().isFullInside(sphere->getBoundingBox());
+	result &= (half->getBoundingBox().getExtent().X > 19.f);
+	const IMeshBuffer* mb = half->getMeshBuffer(0);
+	const u16* indices = mb->getIndices();
+	for (u32 i=0; i<mb->getIndexCount(); i+=3)
+	{
+		// no triangle cuts through the sphere
+		const vector3df center = (mb->getPosition(indices[i]) + mb->getPosition(indices[i+1]) + mb->getPosition(indices[i+2])) / 3.f;
+		result &= (center.getLength() > 9.f);
+	}
+	half->drop();
+
+	// the error limit stops the simplification before reaching the ratio
+	IMesh* exact = manipulator->createSimplifiedMesh(sphere, 0.01f, 0.01f);
+	result &= (getPrimitiveCount(exact) > spherePrimitives/100);
+	exact->drop();
+
+	// each collapse would move the flat sides of the cube
+	IMesh* cube = smgr->getGeometryCreator()->createCubeMesh();
+	IMesh* simplifiedCube = manipulator->createSimplifiedMesh(cube, 0.5f, 0.01f);
+	result &= (getPrimitiveCount(simplifiedCube) == getPrimitiveCount(cube));
+	simplifiedCube->drop();
+	cube->drop();
+
+	// all vertices of this cube have texture seams, they are kept
+	cube = smgr->getGeometryCreator()->createCubeMesh(vector3df(5.f, 5.f, 5.f), ECMT_1BUF_24VTX_NP);
+	simplifiedCube = manipulator->createSimplifiedMesh(cube, 0.5f);
+	result &= (getPrimitiveCount(simplifiedCube) == getPrimitiveCount(cube));
+	simplifiedCube->drop();
+	ILODMeshSceneNode* cubeNode = smgr->addLODMeshSceneNode(cube);
+	result &= (cubeNode->getLevelCount() == 1);
+	cubeNode->remove();
+	cube->drop();
+
+	result &= (smgr->addLODMeshSceneNode(0) == 0);
+	ILODMeshSceneNode* node = smgr->addLODMeshSceneNode(sphere, 0, -1, 4, 0.5f);
+	result &= (node->getType() == ESNT_LOD_MESH);
+	result &= (node->getLevelCount() == 4);
+	result &= (node->getLevelMesh(0) == sphere);
+	for (u32 i=1; i<node->getLevelCount(); ++i)
+	{
+		result &= (getPrimitiveCount(node->getLevelMesh(i)) < getPrimitiveCount(node->getLevelMesh(i-1)));
+		result &= (i == 1 || node->getLevelScreenSize(i) < node->getLevelScreenSize(i-1));
+	}
+	result &= !node->addLevel(0, node->getLevelScreenSize(3));
+	result &= (node->getMaterialCount() == 1);
+
+	// without a camera the most detailed level is drawn
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	smgr->drawAll();
+	driver->endScene();
+	result &= (node->getCurrentLevel() == 0);
+	result &= (driver->getFrameStats().LODLevels[0] == 1);
+	result &= (driver->getFrameStats().LODPrimitivesSaved == 0);
+	result &= (driver->getFrameStats().Primitives == spherePrimitives);
+
+	// the screen size shrinks with the distance
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0.f, 0.f, -100.f), vector3df(0.f, 0.f, 0.f));
+	camera->setFarValue(1000000.f);
+	drawAt(device, camera, 100.f);
+	const f32 sizeAtOne = node->getScreenSize() * 100.f;
+	result &= (sizeAtOne > 0.f);
+
+	// the distances where the levels change, the hysteresis is 0.1
+	const f32 border2 = node->getLevelScreenSize(2);
+	drawAt(device, camera, sizeAtOne / (border2 * 1.2f));
+	result &= (node->getCurrentLevel() == 1);
+
+	drawAt(device, camera, sizeAtOne / (border2 * 0.95f));
+	result &= (node->getCurrentLevel() == 1);
+
+	drawAt(device, camera, sizeAtOne / (border2 * 0.85f));
+	result &= (node->getCurrentLevel() == 2);
+	const u32 level2Primitives = getPrimitiveCount(node->getLevelMesh(2));
+	result &= (driver->getFrameStats().LODLevels[2] == 1);
+	result &= (driver->getFrameStats().LODLevels[0] == 0);
+	result &= (driver->getFrameStats().LODPrimitivesSaved == spherePrimitives - level2Primitives);
+	result &= (driver->getFrameStats().Primitives == level2Primitives);
+
+	drawAt(device, camera, sizeAtOne / (border2 * 1.05f));
+	result &= (node->getCurrentLevel() == 2);
+
+	drawAt(device, camera, sizeAtOne / (border2 * 1.15f));
+	result &= (node->getCurrentLevel() == 1);
+
+	// far away the least detailed level, close by all details
+	drawAt(device, camera, 100000.f);
+	result &= (node->getCurrentLevel() == 3);
+	drawAt(device, camera, 15.f);
+	result &= (node->getCurrentLevel() == 0);
+
+	// nothing is drawn for a level without a mesh
+	node->addLevel(0, node->getLevelScreenSize(3) * 0.5f);
+	drawAt(device, camera, 100000.f);
+	result &= (node->getCurrentLevel() == 4);
+	result &= (driver->getFrameStats().DrawCalls == 0);
+
+	node->removeLevels();
+	result &= (node->getLevelCount() == 1);
+	drawAt(device, camera, 100000.f);
+	result &= (node->getCurrentLevel() == 0);
+
+	logTestString("simplified %u triangles to half in %u ms\n", spherePrimitives, simplifyTime);
+
+	sphere->drop();
+
+	if (!result)
+		logTestString("lodMesh failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -87,6 +87,26 @@ int main(int argumentCount, char * arguments[])
 	TEST(meshLoaders);
 	TEST(testTimer);
 	TEST(testCoreutil);
+	TEST(frameStats);
+	TEST(guiFont);
+	TEST(guiRetained);
+	TEST(guiVirtualRows);
+	TEST(q3LevelVisibility);
+	TEST(q3ShaderNodes);
+	TEST(imageBlit);
+	TEST(imageScaling);
+	TEST(binaryMesh);
+	TEST(matrixSimd);
+	TEST(occlusionCulling);
+	TEST(occlusionQueries);
+	TEST(hardwareBuffers);
+	TEST(metaTriangleSelector);
+	TEST(md2Crowd);
+	TEST(instancedMesh);
+	TEST(staticBatch);
+	TEST(lodMesh);
+	TEST(hierarchicalZ);
+	TEST(deferredClear);
 	// software drivers only
 	TEST(softwareDevice);
 	TEST(b3dAnimation);
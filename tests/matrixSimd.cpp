@@ -0,0 +1,302 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+#include <stdlib.h>
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+f32 randomFloat(f32 range)
+{
+	return (rand() / (f32)RAND_MAX - 0.5f) * 2.f * range;
+}
+
+matrix4 randomMatrix()
+{
+	matrix4 m(matrix4::EM4CONST_NOTHING);
+	for (u32 i=0; i<16; ++i)
+		m[i] = randomFloat(10.f);
+	return m;
+}
+
+//! f32 matrices are compared with the plain C++ code of the f64 matrix
+CMatrix4<f64> toF64(const matrix4& m)
+{
+	CMatrix4<f64> d(CMatrix4<f64>::EM4CONST_NOTHING);
+	for (u32 i=0; i<16; ++i)
+		d[i] = m[i];
+	return d;
+}
+
+bool similar(f64 a, f64 b)
+{
+	return fabs(a - b) <= 0.0005 * (1.0 + fabs(b));
+}
+
+bool similar(const vector3df& a, const vector3d<f64>& b)
+{
+	return similar(a.X, b.X) && similar(a.Y, b.Y) && similar(a.Z, b.Z);
+}
+
+bool similar(const matrix4& a, const CMatrix4<f64>& b)
+{
+	for (u32 i=0; i<16; ++i)
+		if (!similar(a[i], b[i]))
+			return false;
+	return true;
+}
+
+vector3d<f64> transformF64(const CMatrix4<f64>& m, const vector3df& v)
+{
+	vector3d<f64> r;
+	r.X = v.X*m[0] + v.Y*m[4] + v.Z*m[8] + m[12];
+	r.Y = v.X*m[1] + v.Y*m[5] + v.Z*m[9] + m[13];
+	r.Z = v.X*m[2] + v.Y*m[6] + v.Z*m[10] + m[14];
+	return r;
+}
+
+//! Bounding box of the transformed corners
+aabbox3d<f64> transformBoxF64(const CMatrix4<f64>& m, const aabbox3df& box)
+{
+	vector3df corners[8];
+	box.getEdges(corners);
+	aabbox3d<f64> result(transformF64(m, corners[0]));
+	for (u32 i=1; i<8; ++i)
+		result.addInternalPoint(transformF64(m, corners[i]));
+	return result;
+}
+
+//! Check the f32 functions against the f64 ones on random input
+bool correctness()
+{
+	bool result = true;
+	for (u32 n=0; n<200 && result; ++n)
+	{
+		const matrix4 a = randomMatrix();
+		const matrix4 b = randomMatrix();
+		const CMatrix4<f64> a64 = toF64(a);
+		const CMatrix4<f64> b64 = toF64(b);
+
+		// products
+		matrix4 p;
+		p.setbyproduct_nocheck(a, b);
+		CMatrix4<f64> p64;
+		p64.setbyproduct_nocheck(a64, b64);
+		result &= similar(p, p64);
+		result &= similar(a*b, a64*b64);
+		matrix4 q(a);
+		q *= b;
+		result &= similar(q, p64);
+		// the product may be written into one of its factors
+		q = a;
+		q.setbyproduct_nocheck(q, b);
+		result &= similar(q, p64);
+		q = b;
+		q.setbyproduct_nocheck(a, q);
+		result &= similar(q, p64);
+
+		// vectors
+		const vector3df v(randomFloat(100.f), randomFloat(100.f), randomFloat(100.f));
+		vector3df out;
+		a.transformVect(out, v);
+		result &= similar(out, transformF64(a64, v));
+		out = v;
+		a.transformVect(out);
+		result &= similar(out, transformF64(a64, v));
+		f32 out4[4];
+		a.transformVect(out4, v);
+		result &= similar(out4[3], v.X*a64[3] + v.Y*a64[7] + v.Z*a64[11] + a64[15]);
+		const f32 in4[4] = { v.X, v.Y, v.Z, 2.f };
+		a.transformVec4(out4, in4);
+		for (u32 i=0; i<4; ++i)
+			result &= similar(out4[i], v.X*a64[i] + v.Y*a64[4+i] + v.Z*a64[8+i] + 2.0*a64[12+i]);
+
+		vector3df vects[5];
+		for (u32 i=0; i<5; ++i)
+			vects[i].set(randomFloat(100.f), randomFloat(100.f), randomFloat(100.f));
+		vector3df transformed[5];
+		a.transformVectArray(transformed, vects, 5);
+		for (u32 i=0; i<5; ++i)
+			result &= similar(transformed[i], transformF64(a64, vects[i]));
+		// in place
+		a.transformVectArray(vects, vects, 5);
+		for (u32 i=0; i<5; ++i)
+			result &= vects[i].equals(transformed[i]);
+
+		// boxes
+		aabbox3df box(vector3df(randomFloat(50.f), randomFloat(50.f), randomFloat(50.f)));
+		box.addInternalPoint(randomFloat(50.f), randomFloat(50.f), randomFloat(50.f));
+		const aabbox3d<f64> box64 = transformBoxF64(a64, box);
+		aabbox3df boxes[3] = { box, box, box };
+		a.transformBoxEx(box);
+		result &= similar(box.MinEdge, box64.MinEdge) && similar(box.MaxEdge, box64.MaxEdge);
+		a.transformBoxExArray(boxes, 3);
+		for (u32 i=0; i<3; ++i)
+			result &= (boxes[i] == box);
+
+		// inverse
+		matrix4 inv;
+		CMatrix4<f64> inv64;
+		const bool invertible = a.getInverse(inv);
+		result &= (invertible == a64.getInverse(inv64));
+		if (invertible)
+		{
+			result &= similar(inv, inv64);
+			result &= (inv*a).equals(IdentityMatrix, 0.001f);
+		}
+	}
+
+	// singular matrices have no inverse
+	matrix4 singular;
+	singular.setScale(vector3df(1.f, 0.f, 1.f));
+	matrix4 inv;
+	result &= !singular.getInverse(inv);
+
+	// affine transformations as used by scene nodes
+	matrix4 trs;
+	trs.setRotationDegrees(vector3df(30.f, 40.f, 50.f));
+	trs.setTranslation(vector3df(1.f, 2.f, 3.f));
+	matrix4 scale;
+	scale.setScale(vector3df(2.f, 3.f, 4.f));
+	trs *= scale;
+	result &= trs.getInverse(inv);
+	vector3df v(4.f, 5.f, 6.f);
+	trs.transformVect(v);
+	inv.transformVect(v);
+	result &= v.equals(vector3df(4.f, 5.f, 6.f), 0.0001f);
+
+	return result;
+}
+
+// Plain versions of the functions to compare the speed with
+void plainProduct(f32* M, const f32* m1, const f32* m2)
+{
+	for (u32 i=0; i<16; i+=4)
+		for (u32 j=0; j<4; ++j)
+			M[i+j] = m1[j]*m2[i] + m1[4+j]*m2[i+1] + m1[8+j]*m2[i+2] + m1[12+j]*m2[i+3];
+}
+
+void plainTransform(const f32* M, vector3df* out, const vector3df* in, u32 count)
+{
+	for (u32 i=0; i<count; ++i)
+	{
+		const vector3df v = in[i];
+		out[i].X = v.X*M[0] + v.Y*M[4] + v.Z*M[8] + M[12];
+		out[i].Y = v.X*M[1] + v.Y*M[5] + v.Z*M[9] + M[13];
+		out[i].Z = v.X*M[2] + v.Y*M[6] + v.Z*M[10] + M[14];
+	}
+}
+
+//! Logs the time of the f32 functions next to plain C++ code
+void benchmark(ITimer* timer)
+{
+	const u32 count = 1000;
+	const u32 runs = 200;
+	array<matrix4> matrices;
+	array<vector3df> vectors;
+	array<aabbox3df> boxes;
+	matrices.set_used(count);
+	vectors.set_used(count);
+	boxes.set_used(count);
+	for (u32 i=0; i<count; ++i)
+	{
+		matrices[i] = randomMatrix();
+		vectors[i].set(randomFloat(10.f), randomFloat(10.f), randomFloat(10.f));
+		boxes[i].reset(vectors[i]);
+		boxes[i].addInternalPoint(vectors[i] + vector3df(1.f, 2.f, 3.f));
+	}
+	array<vector3df> out(vectors);
+	matrix4 product;
+	f32 check = 0.f;
+
+	u32 then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+		for (u32 i=1; i<count; ++i)
+			product.setbyproduct_nocheck(matrices[i-1], matrices[i]);
+	const u32 productTime = timer->getRealTime() - then;
+	check += product[0];
+
+	then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+		for (u32 i=1; i<count; ++i)
+			plainProduct(product.pointer(), matrices[i-1].pointer(), matrices[i].pointer());
+	const u32 plainProductTime = timer->getRealTime() - then;
+	check += product[0];
+
+	then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+		matrices[r].transformVectArray(out.pointer(), vectors.const_pointer(), count);
+	const u32 arrayTime = timer->getRealTime() - then;
+	check += out[0].X;
+
+	then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+		for (u32 i=0; i<count; ++i)
+			matrices[r].transformVect(out[i], vectors[i]);
+	const u32 transformTime = timer->getRealTime() - then;
+	check += out[0].X;
+
+	then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+		plainTransform(matrices[r].pointer(), out.pointer(), vectors.const_pointer(), count);
+	const u32 plainTransformTime = timer->getRealTime() - then;
+	check += out[0].X;
+
+	then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+	{
+		array<aabbox3df> transformed(boxes);
+		matrices[r].transformBoxExArray(transformed.pointer(), count);
+		check += transformed[0].MinEdge.X;
+	}
+	const u32 boxTime = timer->getRealTime() - then;
+
+	matrix4 inv;
+	then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+		for (u32 i=0; i<count; ++i)
+			matrices[i].getInverse(inv);
+	const u32 inverseTime = timer->getRealTime() - then;
+	check += inv[0];
+
+	logTestString("%u matrix products: %u ms, plain code %u ms\n", runs*(count-1), productTime, plainProductTime);
+	logTestString("%u vector transformations: array %u ms, single %u ms, plain code %u ms\n", runs*count, arrayTime, transformTime, plainTransformTime);
+	logTestString("%u box transformations: %u ms\n", runs*count, boxTime);
+	logTestString("%u inverse matrices: %u ms (%f)\n", runs*count, inverseTime, check);
+}
+
+} // end anonymous namespace
+
+/** Checks the f32 matrix functions which use SIMD instructions when available
+against the plain C++ code and logs how long they take. */
+bool matrixSimd(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+#if defined(_IRR_COMPILE_WITH_SSE_)
+	logTestString("matrixSimd: using SSE\n");
+#elif defined(_IRR_COMPILE_WITH_NEON_)
+	logTestString("matrixSimd: using NEON\n");
+#else
+	logTestString("matrixSimd: using plain C++ code\n");
+#endif
+
+	srand(12345);
+	const bool result = correctness();
+	if (!result)
+		logTestString("matrixSimd: results differ from the plain code\n");
+
+	benchmark(device->getTimer());
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,138 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Copies the vertex positions of the first buffer of a mesh
+void getPositions(IMesh* mesh, array<vector3df>& positions)
+{
+	const IMeshBuffer* buffer = mesh->getMeshBuffer(0);
+	positions.set_used(buffer->getVertexCount());
+	for (u32 i=0; i<positions.size(); ++i)
+		positions[i] = buffer->getPosition(i);
+}
+
+//! Draws the crowd with the nodes in groups showing different frames
+u32 drawCrowd(IrrlichtDevice* device, array<IAnimatedMeshSceneNode*>& nodes, u32 frames, u32 groups)
+{
+	const u32 frameCount = nodes[0]->getMesh()->getFrameCount();
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	const u32 then = timer->getRealTime();
+	for (u32 f=0; f<frames; ++f)
+	{
+		for (u32 i=0; i<nodes.size(); ++i)
+			nodes[i]->setCurrentFrame((f32)((f + (i % groups) * 3) % frameCount));
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	return timer->getRealTime() - then;
+}
+
+} // end anonymous namespace
+
+/** Nodes sharing a MD2 mesh at the same frame share the interpolated mesh,
+which is the same as when each node interpolates it on its own. Also logs how
+long drawing a crowd of MD2 nodes takes. */
+bool md2Crowd(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	bool result = true;
+
+	IAnimatedMesh* mesh = smgr->getMesh("./media/sydney.md2");
+	assert_log(mesh);
+	if (!mesh)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	// the same frame gives the same mesh, other frames other meshes
+	IMesh* frame8 = mesh->getMesh(8);
+	result &= (mesh->getMesh(8) == frame8);
+	result &= (mesh->getMesh(10) != frame8);
+	result &= (mesh->getBoundingBox() == mesh->getMesh(10)->getBoundingBox());
+
+	// a frame between two key frames is the blend of both
+	array<vector3df> first, second, middle;
+	getPositions(mesh->getMesh(8), first);
+	getPositions(mesh->getMesh(12), second);
+	getPositions(mesh->getMesh(10), middle);
+	for (u32 i=0; i<middle.size(); ++i)
+		result &= middle[i].equals((first[i] + second[i]) * 0.5f, 0.001f);
+
+	// frames are recomputed after they were dropped from the cache
+	for (s32 f=0; f<100; ++f)
+		mesh->getMesh(f);
+	getPositions(mesh->getMesh(10), first);
+	for (u32 i=0; i<middle.size(); ++i)
+		result &= middle[i].equals(first[i]);
+
+	// materials of the mesh are used by cached frames
+	mesh->setMaterialFlag(video::EMF_LIGHTING, false);
+	result &= !mesh->getMesh(10)->getMeshBuffer(0)->getMaterial().Lighting;
+	result &= !mesh->getMesh(200)->getMeshBuffer(0)->getMaterial().Lighting;
+
+	// also when they are changed on the meshbuffer of the mesh
+	mesh->getMeshBuffer(0)->getMaterial().Wireframe = true;
+	result &= mesh->getMesh(10)->getMeshBuffer(0)->getMaterial().Wireframe;
+	mesh->getMeshBuffer(0)->getMaterial().Wireframe = false;
+	result &= !mesh->getMesh(200)->getMeshBuffer(0)->getMaterial().Wireframe;
+
+	// hints and dirty flags reach the cached frames
+	mesh->setHardwareMappingHint(EHM_DYNAMIC, EBT_INDEX);
+	result &= (mesh->getMesh(10)->getMeshBuffer(0)->getHardwareMappingHint_Index() == EHM_DYNAMIC);
+	mesh->getMeshBuffer(0)->setHardwareMappingHint(EHM_STATIC, EBT_INDEX);
+	result &= (mesh->getMesh(200)->getMeshBuffer(0)->getHardwareMappingHint_Index() == EHM_STATIC);
+	const u32 indexID = mesh->getMesh(10)->getMeshBuffer(0)->getChangedID_Index();
+	mesh->setDirty(EBT_INDEX);
+	result &= (mesh->getMesh(10)->getMeshBuffer(0)->getChangedID_Index() != indexID);
+
+	// changed vertices of the mesh are copied into the cached frames
+	video::S3DVertex* vertices = static_cast<video::S3DVertex*>(mesh->getMeshBuffer(0)->getVertices());
+	vertices[0].Color.set(255, 1, 2, 3);
+	mesh->getMeshBuffer(0)->setDirty();
+	result &= (static_cast<video::S3DVertex*>(mesh->getMesh(10)->getMeshBuffer(0)->getVertices())[0].Color == video::SColor(255, 1, 2, 3));
+
+	// a crowd of nodes
+	array<IAnimatedMeshSceneNode*> nodes;
+	for (u32 i=0; i<1000; ++i)
+	{
+		IAnimatedMeshSceneNode* node = smgr->addAnimatedMeshSceneNode(mesh, 0, -1, vector3df((i % 40) * 50.f, 0.f, (i / 40) * 50.f));
+		node->setAnimationSpeed(0.f);
+		nodes.push_back(node);
+	}
+	smgr->addCameraSceneNode(0, vector3df(1000.f, 500.f, -500.f), vector3df(1000.f, 0.f, 600.f));
+
+	const u32 frames = 10;
+	const u32 sameTime = drawCrowd(device, nodes, frames, 1);
+	const u32 groupTime = drawCrowd(device, nodes, frames, 4);
+	const u32 phaseTime = drawCrowd(device, nodes, frames, nodes.size());
+
+	logTestString("%u frames of %u md2 nodes: same frame %u ms, 4 frames %u ms, all frames %u ms\n",
+		frames, nodes.size(), sameTime, groupTime, phaseTime);
+
+	if (!result)
+		logTestString("md2Crowd failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
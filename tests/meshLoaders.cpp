@@ -5,6 +5,222 @@
 
 using namespace irr;
 
+namespace
+{
+
+//! Faces share vertices only when they use the same obj indices
+bool objVertexSharing(IrrlichtDevice* device)
+{
+	const c8 obj[] =
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 2 0 0\nv 2 1 0\n"
+		"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+		"f 1/1 2/2 3/3 4/4\n"
+		"f 2/2 5/1 6/4 3/3\r\n"
+		"f -5/-3 -2/-4 -1/-1\n";	// same corners as the second face, with relative indices
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(obj, sizeof(obj)-1, "sharing.obj");
+	scene::IAnimatedMesh* mesh = device->getSceneManager()->getMesh(file);
+	file->drop();
+	if (!mesh || mesh->getMeshBufferCount() != 1)
+		return false;
+
+	scene::IMeshBuffer* buffer = mesh->getMeshBuffer(0);
+	const bool result = (buffer->getVertexCount() == 6) && (buffer->getIndexCount() == 15);
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+	return result;
+}
+
+//! Logs the time to load a large obj grid
+bool objLoadSpeed(IrrlichtDevice* device)
+{
+	const u32 size = 300;
+	core::stringc obj;
+	obj.reserve(size * size * 96);
+	for (u32 y=0; y<=size; ++y)
+	{
+		for (u32 x=0; x<=size; ++x)
+		{
+			obj += "v ";
+			obj += x;
+			obj += " 0 ";
+			obj += y;
+			obj += "\nvt 0.5 0.25\n";
+		}
+	}
+	for (u32 y=0; y<size; ++y)
+	{
+		for (u32 x=0; x<size; ++x)
+		{
+			const u32 i = y * (size + 1) + x + 1;
+			obj += "f ";
+			obj += i; obj += "/"; obj += i; obj += " ";
+			obj += i + 1; obj += "/"; obj += i + 1; obj += " ";
+			obj += i + size + 2; obj += "/"; obj += i + size + 2; obj += " ";
+			obj += i + size + 1; obj += "/"; obj += i + size + 1; obj += "\n";
+		}
+	}
+
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(obj.c_str(), obj.size(), "grid.obj");
+	const u32 then = device->getTimer()->getRealTime();
+	scene::IAnimatedMesh* mesh = device->getSceneManager()->getMesh(file);
+	logTestString("Loading an obj with %u faces took %u ms\n", size * size, device->getTimer()->getRealTime() - then);
+	file->drop();
+	if (!mesh)
+		return false;
+
+	const bool result = (mesh->getMesh(0)->getMeshBuffer(0)->getVertexCount() == (size + 1) * (size + 1));
+	device->getSceneManager()->getMeshCache()->removeMesh(mesh);
+	return result;
+}
+
+//! Appends binary x file data in little endian byte order
+void xWrite(core::array<c8>& x, const void* data, u32 size)
+{
+	for (u32 i=0; i<size; ++i)
+		x.push_back(((const c8*)data)[i]);
+}
+
+void xName(core::array<c8>& x, const c8* name)
+{
+	const u16 token = 1;
+	const u32 length = (u32)strlen(name);
+	xWrite(x, &token, 2);
+	xWrite(x, &length, 4);
+	xWrite(x, name, length);
+}
+
+void xBrace(core::array<c8>& x, bool open)
+{
+	const u16 token = open ? 0x0a : 0x0b;
+	xWrite(x, &token, 2);
+}
+
+void xInts(core::array<c8>& x, const u32* values, u32 count)
+{
+	const u16 token = 6;
+	xWrite(x, &token, 2);
+	xWrite(x, &count, 4);
+	xWrite(x, values, count*4);
+}
+
+void xFloats(core::array<c8>& x, const f32* values, u32 count)
+{
+	const u16 token = 7;
+	xWrite(x, &token, 2);
+	xWrite(x, &count, 4);
+	xWrite(x, values, count*4);
+}
+
+//! A binary x file gives the same mesh as the text version
+bool xBinaryMatchesText(IrrlichtDevice* device)
+{
+	const c8 text[] =
+		"xof 0303txt 0032\n"
+		"Mesh quad {\n"
+		" 4;\n"
+		" 0.0;0.0;0.0;,\n 1.0;0.0;0.0;,\n 1.0;1.0;0.0;,\n 0.0;1.0;0.0;;\n"
+		" 1;\n"
+		" 4;0,1,2,3;;\n"
+		" MeshNormals {\n"
+		"  1;\n"
+		"  0.0;0.0;1.0;;\n"
+		"  1;\n"
+		"  4;0,0,0,0;;\n"
+		" }\n"
+		" MeshTextureCoords {\n"
+		"  4;\n"
+		"  0.0;1.0;,\n 1.0;1.0;,\n 1.0;0.0;,\n 0.0;0.0;;\n"
+		" }\n"
+		"}\n";
+
+	const u32 vertexCount = 4;
+	const f32 positions[] = { 0,0,0, 1,0,0, 1,1,0, 0,1,0 };
+	const u32 faces[] = { 1, 4, 0,1,2,3 };
+	const u32 one = 1;
+	const f32 normal[] = { 0,0,1 };
+	const u32 normalFaces[] = { 1, 4, 0,0,0,0 };
+	const f32 tcoords[] = { 0,1, 1,1, 1,0, 0,0 };
+
+	core::array<c8> binary;
+	xWrite(binary, "xof 0303bin 0032", 16);
+	xName(binary, "Mesh");
+	xName(binary, "quad");
+	xBrace(binary, true);
+	xInts(binary, &vertexCount, 1);
+	xFloats(binary, positions, 12);
+	const u32 positionsEnd = binary.size();
+	xInts(binary, faces, 6);
+	xName(binary, "MeshNormals");
+	xBrace(binary, true);
+	xInts(binary, &one, 1);
+	xFloats(binary, normal, 3);
+	xInts(binary, normalFaces, 6);
+	xBrace(binary, false);
+	xName(binary, "MeshTextureCoords");
+	xBrace(binary, true);
+	xInts(binary, &vertexCount, 1);
+	xFloats(binary, tcoords, 8);
+	xBrace(binary, false);
+	xBrace(binary, false);
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(text, sizeof(text)-1, "quad_text.x");
+	scene::IAnimatedMesh* textMesh = smgr->getMesh(file);
+	file->drop();
+	file = device->getFileSystem()->createMemoryReadFile(binary.pointer(), binary.size(), "quad_binary.x");
+	scene::IAnimatedMesh* binaryMesh = smgr->getMesh(file);
+	file->drop();
+
+	bool result = textMesh && binaryMesh &&
+		(textMesh->getMeshBufferCount() == 1) && (binaryMesh->getMeshBufferCount() == 1);
+	if (result)
+	{
+		scene::IMeshBuffer* a = textMesh->getMeshBuffer(0);
+		scene::IMeshBuffer* b = binaryMesh->getMeshBuffer(0);
+		result = (a->getVertexCount() == 4) && (b->getVertexCount() == 4) &&
+			(a->getIndexCount() == 6) && (b->getIndexCount() == 6);
+		for (u32 i=0; result && i<a->getIndexCount(); ++i)
+		{
+			const u32 ia = a->getIndices()[i];
+			const u32 ib = b->getIndices()[i];
+			result = (ia == ib) &&
+				a->getPosition(ia).equals(b->getPosition(ib)) &&
+				a->getNormal(ia).equals(core::vector3df(0,0,1)) &&
+				b->getNormal(ib).equals(core::vector3df(0,0,1)) &&
+				a->getTCoords(ia).equals(b->getTCoords(ib));
+		}
+		// the quad is triangulated with the first corner in every triangle
+		result &= b->getPosition(b->getIndices()[3]).equals(core::vector3df(0,0,0));
+		result &= b->getTCoords(b->getIndices()[5]).equals(core::vector2df(0,0));
+	}
+
+	if (textMesh)
+		smgr->getMeshCache()->removeMesh(textMesh);
+	if (binaryMesh)
+		smgr->getMeshCache()->removeMesh(binaryMesh);
+
+	// a truncated file drops the mesh as soon as its vertices are cut,
+	// and never gives indices past the vertices
+	for (u32 size=16; size<binary.size(); ++size)
+	{
+		file = device->getFileSystem()->createMemoryReadFile(binary.pointer(), size, "quad_truncated.x");
+		scene::IAnimatedMesh* truncatedMesh = smgr->getMesh(file);
+		file->drop();
+		if (!truncatedMesh)
+			continue;
+		result &= (size >= positionsEnd) || (truncatedMesh->getMeshBufferCount() == 0);
+		for (u32 i=0; i<truncatedMesh->getMeshBufferCount(); ++i)
+		{
+			scene::IMeshBuffer* b = truncatedMesh->getMeshBuffer(i);
+			for (u32 j=0; j<b->getIndexCount(); ++j)
+				result &= (b->getIndices()[j] < b->getVertexCount());
+		}
+		smgr->getMeshCache()->removeMesh(truncatedMesh);
+	}
+	return result;
+}
+
+} // end anonymous namespace
+
 // Tests mesh loading features and the mesh cache.
 /** This won't test render results. Currently, not all mesh loaders are tested. */
 bool meshLoaders(void)
@@ -29,6 +245,22 @@ bool meshLoaders(void)
 		}
 	}
 
+	if (!objVertexSharing(device))
+	{
+		logTestString("Obj loader doesn't share vertices of equal corners\n");
+		result=false;
+	}
+	if (!objLoadSpeed(device))
+	{
+		logTestString("Loading obj grid failed\n");
+		result=false;
+	}
+	if (!xBinaryMatchesText(device))
+	{
+		logTestString("Binary x file doesn't match the text version\n");
+		result=false;
+	}
+
 	device->closeDevice();
 	device->run();
 	device->drop();
@@ -0,0 +1,193 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Counts the triangles of all selectors in a box by asking each of them
+s32 countInBox(const array<ITriangleSelector*>& selectors, const aabbox3df& box,
+		const matrix4* transform, array<triangle3df>& buffer)
+{
+	s32 total = 0;
+	for (u32 i=0; i<selectors.size(); ++i)
+	{
+		s32 count = 0;
+		selectors[i]->getTriangles(buffer.pointer(), buffer.size(), count, box, transform);
+		total += count;
+	}
+	return total;
+}
+
+//! Finds the closest hit of a line by testing all triangles
+bool closestHit(const array<ITriangleSelector*>& selectors, const line3df& ray,
+		array<triangle3df>& buffer, vector3df& outHit)
+{
+	bool found = false;
+	f32 closest = FLT_MAX;
+	for (u32 i=0; i<selectors.size(); ++i)
+	{
+		s32 count = 0;
+		selectors[i]->getTriangles(buffer.pointer(), buffer.size(), count);
+		for (s32 t=0; t<count; ++t)
+		{
+			vector3df hit;
+			if (buffer[t].getIntersectionWithLimitedLine(ray, hit) &&
+				hit.getDistanceFromSQ(ray.start) < closest)
+			{
+				closest = hit.getDistanceFromSQ(ray.start);
+				outHit = hit;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+} // end anonymous namespace
+
+/** The meta triangle selector only asks the selectors whose bounds overlap a
+query, the results must be the same as when all selectors are asked. */
+bool metaTriangleSelector(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	ISceneCollisionManager* collisionManager = smgr->getSceneCollisionManager();
+	ITimer* timer = device->getTimer();
+	bool result = true;
+
+	// a grid of cubes, 20 units apart
+	IMetaTriangleSelector* meta = smgr->createMetaTriangleSelector();
+	array<ITriangleSelector*> selectors;
+	array<IMeshSceneNode*> nodes;
+	for (s32 z=0; z<5; ++z)
+	{
+		for (s32 y=0; y<20; ++y)
+		{
+			for (s32 x=0; x<20; ++x)
+			{
+				IMeshSceneNode* node = smgr->addCubeSceneNode(10.f, 0, -1, vector3df(x*20.f, y*20.f, z*20.f));
+				node->updateAbsolutePosition();
+				ITriangleSelector* selector = smgr->createTriangleSelector(node->getMesh(), node);
+				meta->addTriangleSelector(selector);
+				selectors.push_back(selector);
+				nodes.push_back(node);
+			}
+		}
+	}
+
+	array<triangle3df> buffer;
+	buffer.set_used(meta->getTriangleCount());
+	s32 count = 0;
+
+	// box queries
+	const aabbox3df box(vector3df(30.f, 30.f, 10.f), vector3df(95.f, 75.f, 45.f));
+	meta->getTriangles(buffer.pointer(), buffer.size(), count, box);
+	result &= (count > 0 && count == countInBox(selectors, box, 0, buffer));
+
+	matrix4 transform;
+	transform.setTranslation(vector3df(100.f, -50.f, 20.f));
+	transform.setScale(2.f);
+	meta->getTriangles(buffer.pointer(), buffer.size(), count, box, &transform);
+	result &= (count > 0 && count == countInBox(selectors, box, &transform, buffer));
+
+	// line queries return all triangles near the line
+	const line3df diagonal(vector3df(-10.f, -10.f, -10.f), vector3df(400.f, 400.f, 100.f));
+	meta->getTriangles(buffer.pointer(), buffer.size(), count, diagonal);
+	aabbox3df lineBox(diagonal.start);
+	lineBox.addInternalPoint(diagonal.end);
+	result &= (count == countInBox(selectors, lineBox, 0, buffer));
+
+	// the limit of the array is kept
+	meta->getTriangles(buffer.pointer(), 20, count, box);
+	result &= (count == 20);
+
+	// moved nodes are found at their new position
+	const aabbox3df moved(vector3df(990.f, -10.f, -10.f), vector3df(1010.f, 10.f, 10.f));
+	meta->getTriangles(buffer.pointer(), buffer.size(), count, moved);
+	result &= (count == 0);
+	nodes[0]->setPosition(vector3df(1000.f, 0.f, 0.f));
+	nodes[0]->updateAbsolutePosition();
+	meta->getTriangles(buffer.pointer(), buffer.size(), count, moved);
+	result &= (count == 12);
+	meta->getTriangles(buffer.pointer(), buffer.size(), count, aabbox3df(vector3df(-1.f), vector3df(1.f)));
+	result &= (count == 0);
+
+	// closest hits
+	const line3df rays[] = {
+		line3df(vector3df(-50.f, 40.f, 40.f), vector3df(500.f, 40.f, 40.f)),
+		line3df(vector3df(390.f, 390.f, 200.f), vector3df(0.f, 0.f, -100.f)),
+		line3df(vector3df(1100.f, 0.f, 0.f), vector3df(-100.f, 0.f, 0.f)),
+		line3df(vector3df(-50.f, 10.f, 0.f), vector3df(500.f, 10.f, 0.f)),
+		line3df(vector3df(-50.f, 500.f, 0.f), vector3df(500.f, 500.f, 0.f))
+	};
+	for (u32 i=0; i<sizeof(rays)/sizeof(rays[0]); ++i)
+	{
+		SCollisionHit hit;
+		vector3df expected;
+		const bool found = collisionManager->getCollisionPoint(hit, rays[i], meta);
+		result &= (found == closestHit(selectors, rays[i], buffer, expected));
+		if (found)
+		{
+			result &= hit.Intersection.equals(expected, 0.001f);
+			result &= (hit.Node && hit.Node->getTransformedBoundingBox().isPointInside(hit.Intersection));
+		}
+	}
+	// the ray from the far side hits the moved node first
+	SCollisionHit hit;
+	result &= collisionManager->getCollisionPoint(hit, rays[2], meta);
+	result &= (hit.Node == nodes[0]);
+
+	// removed selectors are not found anymore
+	meta->removeTriangleSelector(selectors[0]);
+	meta->getTriangles(buffer.pointer(), buffer.size(), count, moved);
+	result &= (count == 0);
+	result &= !collisionManager->getCollisionPoint(hit, line3df(vector3df(1100.f, 0.f, 0.f), vector3df(900.f, 0.f, 0.f)), meta);
+
+	// compare the time with asking all selectors
+	const u32 runs = 200;
+	u32 then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+	{
+		const f32 y = (r % 20) * 20.f;
+		collisionManager->getCollisionPoint(hit, line3df(vector3df(-50.f, y, 40.f), vector3df(500.f, y, 40.f)), meta);
+	}
+	const u32 metaTime = timer->getRealTime() - then;
+
+	vector3df expected;
+	then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+	{
+		const f32 y = (r % 20) * 20.f;
+		closestHit(selectors, line3df(vector3df(-50.f, y, 40.f), vector3df(500.f, y, 40.f)), buffer, expected);
+	}
+	const u32 bruteTime = timer->getRealTime() - then;
+
+	then = timer->getRealTime();
+	for (u32 r=0; r<runs; ++r)
+		meta->getTriangles(buffer.pointer(), buffer.size(), count, box);
+	const u32 boxTime = timer->getRealTime() - then;
+
+	logTestString("%u rays against %u selectors: %u ms, all triangles %u ms, %u box queries %u ms\n",
+		runs, selectors.size(), metaTime, bruteTime, runs, boxTime);
+
+	if (!result)
+		logTestString("metaTriangleSelector failed\n");
+
+	meta->drop();
+	for (u32 i=0; i<selectors.size(); ++i)
+		selectors[i]->drop();
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,157 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Draws a frame and returns the number of draw calls
+u32 drawFrame(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+	return driver->getFrameStats().DrawCalls;
+}
+
+//! Returns the largest x in normalized device coordinates of a box
+f32 maxScreenX(ICameraSceneNode* camera, const aabbox3df& box)
+{
+	matrix4 viewProjection(camera->getProjectionMatrix());
+	viewProjection *= camera->getViewMatrix();
+
+	vector3df edges[8];
+	box.getEdges(edges);
+	f32 maxX = -FLT_MAX;
+	for (u32 i=0; i<8; ++i)
+	{
+		f32 p[4];
+		viewProjection.transformVect(p, edges[i]);
+		maxX = core::max_(maxX, p[0] / p[3]);
+	}
+	return maxX;
+}
+
+} // end anonymous namespace
+
+/** Nodes hidden behind occluders are culled in the same frame by the software
+occlusion culling, also with the null driver. */
+bool occlusionCulling(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	ISceneManager* smgr = device->getSceneManager();
+	bool result = true;
+
+	ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0.f, 0.f, 0.f), vector3df(0.f, 0.f, 100.f));
+	// a 20x20 wall in front of the camera
+	IMeshSceneNode* wall = smgr->addCubeSceneNode(10.f, 0, -1, vector3df(0.f, 0.f, 20.f), vector3df(0.f, 0.f, 0.f), vector3df(2.f, 2.f, 0.1f));
+	IMeshSceneNode* hidden = smgr->addCubeSceneNode(2.f, 0, -1, vector3df(0.f, 0.f, 50.f));
+	IMeshSceneNode* beside = smgr->addCubeSceneNode(2.f, 0, -1, vector3df(40.f, 0.f, 50.f));
+	IMeshSceneNode* front = smgr->addCubeSceneNode(2.f, 0, -1, vector3df(0.f, 0.f, 10.f));
+	hidden->setAutomaticCulling(EAC_BOX | EAC_OCC_CPU);
+	beside->setAutomaticCulling(EAC_BOX | EAC_OCC_CPU);
+	front->setAutomaticCulling(EAC_BOX | EAC_OCC_CPU);
+
+	// without occluders everything is drawn
+	result &= (drawFrame(device) == 4);
+	result &= !smgr->isCulled(hidden);
+
+	smgr->addOccluder(wall);
+	result &= (drawFrame(device) == 3);
+	result &= smgr->isCulled(hidden);
+	result &= !smgr->isCulled(beside);
+	result &= !smgr->isCulled(front);
+	result &= !smgr->isCulled(wall);
+
+	// invisible occluders hide nothing
+	wall->setVisible(false);
+	result &= (drawFrame(device) == 3);
+	result &= !smgr->isCulled(hidden);
+	wall->setVisible(true);
+
+	// the occluder moved into the box of the node
+	wall->setPosition(vector3df(0.f, 0.f, 50.f));
+	result &= (drawFrame(device) == 4);
+	wall->setPosition(vector3df(0.f, 0.f, 20.f));
+	result &= (drawFrame(device) == 3);
+
+	// occluders behind the near plane are clipped
+	camera->setPosition(vector3df(0.f, 0.f, 25.f));
+	camera->setTarget(vector3df(0.f, 0.f, 100.f));
+	drawFrame(device);
+	result &= !smgr->isCulled(hidden);
+	camera->setPosition(vector3df(0.f, 0.f, 20.5f - camera->getNearValue() * 0.5f));
+	drawFrame(device);
+	result &= !smgr->isCulled(hidden);
+	camera->setPosition(vector3df(0.f, 0.f, 0.f));
+
+	// the other culling flags are not affected
+	hidden->setAutomaticCulling(EAC_BOX);
+	result &= (drawFrame(device) == 4);
+	hidden->setAutomaticCulling(EAC_BOX | EAC_OCC_CPU);
+	result &= (drawFrame(device) == 3);
+
+	// a box peeking out behind the edge of the wall by less than a pixel is drawn
+	ISceneNode* peek = smgr->addCubeSceneNode(2.f, 0, -1, vector3df(15.f, 0.f, 50.f));
+	peek->setAutomaticCulling(EAC_BOX | EAC_OCC_CPU);
+	drawFrame(device);
+	result &= smgr->isCulled(peek);
+	const f32 wallX = maxScreenX(camera, wall->getTransformedBoundingBox());
+	for (f32 x=22.f; x<27.f; x+=0.02f)
+	{
+		peek->setPosition(vector3df(x, 0.f, 50.f));
+		drawFrame(device);
+		if (maxScreenX(camera, peek->getTransformedBoundingBox()) > wallX)
+			result &= !smgr->isCulled(peek);
+	}
+	peek->remove();
+
+	smgr->removeOccluder(wall);
+	result &= (drawFrame(device) == 4);
+	result &= !smgr->isCulled(hidden);
+
+	// explicit meshes can be used for any node
+	ISceneNode* empty = smgr->addEmptySceneNode();
+	empty->setPosition(vector3df(0.f, 0.f, 20.f));
+	empty->setScale(vector3df(2.f, 2.f, 0.1f));
+	smgr->addOccluder(empty, wall->getMesh());
+	result &= (drawFrame(device) == 3);
+	result &= smgr->isCulled(hidden);
+	smgr->removeAllOccluders();
+	result &= (drawFrame(device) == 4);
+
+	// occluders removed from the scene hide nothing and are released by the next drawAll()
+	smgr->addOccluder(wall);
+	result &= (drawFrame(device) == 3);
+	wall->grab();
+	wall->remove();
+	result &= (drawFrame(device) == 3);
+	result &= !smgr->isCulled(hidden);
+	result &= (wall->getReferenceCount() == 1);
+
+	// clearing the scene releases the occluders
+	smgr->addOccluder(empty, wall->getMesh());
+	empty->grab();
+	smgr->clear();
+	result &= (empty->getReferenceCount() == 1);
+	empty->drop();
+	wall->drop();
+
+	if (!result)
+		logTestString("occlusionCulling failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
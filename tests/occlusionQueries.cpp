@@ -0,0 +1,96 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+/** Occlusion queries are found through the handle stored in the nodes, also
+after other queries have been removed. */
+bool occlusionQueries(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	bool result = true;
+
+	const u32 count = 10000;
+	IMesh* mesh = smgr->getGeometryCreator()->createCubeMesh();
+	array<IMeshSceneNode*> nodes;
+	nodes.reallocate(count);
+	for (u32 i=0; i<count; ++i)
+		nodes.push_back(smgr->addMeshSceneNode(mesh));
+
+	u32 then = timer->getRealTime();
+	for (u32 i=0; i<count; ++i)
+		driver->addOcclusionQuery(nodes[i]);
+	// adding again only replaces the mesh
+	driver->addOcclusionQuery(nodes[0]);
+
+	// remove every third query
+	for (u32 i=0; i<count; i+=3)
+		driver->removeOcclusionQuery(nodes[i]);
+	const u32 registryTime = timer->getRealTime() - then;
+
+	u32 queries = 0;
+	for (u32 i=0; i<count; ++i)
+	{
+		const bool removed = (i % 3) == 0;
+		if (removed)
+			result &= (nodes[i]->getOcclusionQueryHandle() == 0xffffffff);
+		else
+		{
+			result &= (nodes[i]->getOcclusionQueryHandle() < count);
+			++queries;
+		}
+		result &= (((nodes[i]->getAutomaticCulling() & EAC_OCC_QUERY) != 0) == !removed);
+	}
+
+	// each query draws its mesh once
+	then = timer->getRealTime();
+	driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	driver->runAllOcclusionQueries();
+	driver->runOcclusionQuery(nodes[0]);
+	driver->runOcclusionQuery(nodes[1]);
+	driver->endScene();
+	const u32 runTime = timer->getRealTime() - then;
+	result &= (driver->getFrameStats().DrawCalls == queries + 1);
+
+	// the null driver has no results
+	result &= (driver->getOcclusionQueryResult(nodes[1]) == ~0u);
+	result &= (driver->getOcclusionQueryResult(nodes[0]) == ~0u);
+
+	then = timer->getRealTime();
+	for (u32 i=0; i<count; ++i)
+		smgr->isCulled(nodes[i]);
+	const u32 cullTime = timer->getRealTime() - then;
+
+	driver->removeAllOcclusionQueries();
+	for (u32 i=0; i<count; ++i)
+	{
+		result &= (nodes[i]->getOcclusionQueryHandle() == 0xffffffff);
+		result &= ((nodes[i]->getAutomaticCulling() & EAC_OCC_QUERY) == 0);
+	}
+	driver->beginScene(video::ECBF_COLOR, video::SColor(255,0,0,0));
+	driver->runAllOcclusionQueries();
+	driver->endScene();
+	result &= (driver->getFrameStats().DrawCalls == 0);
+
+	logTestString("%u occlusion queries: add/remove %u ms, run %u ms, isCulled %u ms\n", count, registryTime, runTime, cullTime);
+
+	if (!result)
+		logTestString("occlusionQueries failed\n");
+
+	mesh->drop();
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
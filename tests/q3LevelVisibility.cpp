@@ -0,0 +1,105 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+
+namespace
+{
+
+u32 drawnPrimitives(IrrlichtDevice* device)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	driver->endScene();
+	return driver->getFrameStats().Primitives;
+}
+
+} // end anonymous namespace
+
+/** The quake3 level node only draws the faces potentially visible from the
+camera cluster, so it has to draw less than the octree node. */
+bool q3LevelVisibility(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	device->getFileSystem()->addFileArchive("../media/map-20kdm2.pk3");
+	scene::IQ3LevelMesh* level = (scene::IQ3LevelMesh*)smgr->getMesh("20kdm2.bsp");
+	if (!level)
+	{
+		logTestString("q3LevelVisibility could not load the level\n");
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	bool result = true;
+	const vector3df position(-1300,-144,-1249);
+
+	scene::ISceneNode* octree = smgr->addOctreeSceneNode(level->getMesh(scene::quake3::E_Q3_MESH_GEOMETRY), 0, -1, 1024);
+	octree->setPosition(position);
+	scene::ISceneNode* node = smgr->addQuake3LevelSceneNode(level);
+	result &= (node != 0);
+	if (!node)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+	node->setPosition(position);
+	result &= (node->getType() == scene::ESNT_Q3_LEVEL);
+
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(0,0,0), vector3df(0,0,100));
+	smgr->drawAll();	// update the absolute positions
+
+	result &= (level->getClusterAt(camera->getAbsolutePosition() - position) >= 0);
+	core::array<u32> faces;
+	result &= level->getVisibleFaces(camera->getAbsolutePosition() - position, 0, faces);
+	result &= !faces.empty();
+
+	node->setVisible(false);
+	const u32 octreePrimitives = drawnPrimitives(device);
+	node->setVisible(true);
+	octree->setVisible(false);
+
+	// pvs only
+	node->setAutomaticCulling(scene::EAC_OFF);
+	const u32 pvsPrimitives = drawnPrimitives(device);
+
+	// pvs and frustum culled leafs
+	node->setAutomaticCulling(scene::EAC_FRUSTUM_BOX);
+	const u32 culledPrimitives = drawnPrimitives(device);
+
+	logTestString("q3LevelVisibility: octree %u, pvs %u, pvs and frustum %u primitives\n",
+		octreePrimitives, pvsPrimitives, culledPrimitives);
+
+	result &= (culledPrimitives > 0);
+	result &= (culledPrimitives <= pvsPrimitives);
+	result &= (culledPrimitives < octreePrimitives);
+
+	// outside of the level everything is drawn
+	node->setAutomaticCulling(scene::EAC_OFF);
+	camera->setPosition(vector3df(100000.f, 100000.f, 100000.f));
+	u32 allPrimitives = 0;
+	for (u32 i=0; i<level->getMesh(scene::quake3::E_Q3_MESH_GEOMETRY)->getMeshBufferCount(); ++i)
+		allPrimitives += level->getMesh(scene::quake3::E_Q3_MESH_GEOMETRY)->getMeshBuffer(i)->getIndexCount() / 3;
+	drawnPrimitives(device);	// update the camera position
+	result &= (drawnPrimitives(device) == allPrimitives);
+
+	if (!result)
+		logTestString("q3LevelVisibility failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
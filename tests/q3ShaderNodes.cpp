@@ -0,0 +1,100 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+
+/** Quake3 shader nodes with vertex deformers use a bounding box which
+contains all deformed vertices, so they can be culled like other nodes. */
+bool q3ShaderNodes(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	device->getFileSystem()->addFileArchive("../media/map-20kdm2.pk3");
+	scene::IQ3LevelMesh* level = (scene::IQ3LevelMesh*)smgr->getMesh("20kdm2.bsp");
+	if (!level)
+	{
+		logTestString("q3ShaderNodes could not load the level\n");
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return false;
+	}
+
+	bool result = true;
+	core::array<scene::IMeshSceneNode*> nodes;
+	const scene::IMesh* items = level->getMesh(scene::quake3::E_Q3_MESH_ITEMS);
+	for (u32 i=0; i<items->getMeshBufferCount(); ++i)
+	{
+		const scene::IMeshBuffer* buffer = items->getMeshBuffer(i);
+		const scene::quake3::IShader* shader = level->getShader((s32)buffer->getMaterial().MaterialTypeParam2);
+		if (shader)
+			nodes.push_back(smgr->addQuake3SceneNode(buffer, shader));
+	}
+	result &= !nodes.empty();
+
+	u32 culledNodes = 0;
+	for (u32 i=0; i<nodes.size(); ++i)
+	{
+		if (nodes[i]->getAutomaticCulling() != scene::EAC_OFF)
+			++culledNodes;
+	}
+	result &= (culledNodes > 0);
+
+	// looking into the void nothing with a culling box is drawn
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0, vector3df(100000.f,100000.f,100000.f), vector3df(200000.f,200000.f,200000.f));
+	driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+	smgr->drawAll();
+	driver->endScene();
+	const u32 voidDrawCalls = driver->getFrameStats().DrawCalls;
+
+	// deform all nodes and check the deformed vertices against the boxes
+	for (u32 i=0; i<nodes.size(); ++i)
+		nodes[i]->setAutomaticCulling(scene::EAC_OFF);
+	camera->setTarget(vector3df(0,0,0));
+	for (u32 frame=0; frame<4; ++frame)
+	{
+		device->getTimer()->setTime(frame * 250);
+		smgr->getRootSceneNode()->OnAnimate(device->getTimer()->getTime());
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		driver->endScene();
+
+		for (u32 i=0; i<nodes.size(); ++i)
+		{
+			aabbox3df box(nodes[i]->getBoundingBox());
+			box.MinEdge -= vector3df(0.01f);
+			box.MaxEdge += vector3df(0.01f);
+			const scene::IMeshBuffer* buffer = nodes[i]->getMesh()->getMeshBuffer(0);
+			for (u32 v=0; v<buffer->getVertexCount(); ++v)
+			{
+				if (!box.isPointInside(buffer->getPosition(v)))
+				{
+					logTestString("q3ShaderNodes: vertex %u of node %u outside of the bounding box\n", v, i);
+					result = false;
+					break;
+				}
+			}
+		}
+	}
+	const u32 allDrawCalls = driver->getFrameStats().DrawCalls;
+
+	logTestString("q3ShaderNodes: %u of %u nodes cullable, %u draw calls in the void, %u without culling\n",
+		culledNodes, nodes.size(), voidDrawCalls, allDrawCalls);
+	result &= (voidDrawCalls < allDrawCalls);
+
+	if (!result)
+		logTestString("q3ShaderNodes failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -0,0 +1,162 @@
+// No rights reserved: this software is in the public domain.
+
+#include "testUtils.h"
+
+using namespace irr;
+using namespace core;
+using namespace scene;
+
+namespace
+{
+
+//! Draws the scene a few times and returns the time it took
+u32 drawScene(IrrlichtDevice* device, u32 frames)
+{
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	ITimer* timer = device->getTimer();
+	const u32 then = timer->getRealTime();
+	for (u32 f=0; f<frames; ++f)
+	{
+		driver->beginScene(video::ECBF_COLOR | video::ECBF_DEPTH, video::SColor(255,0,0,0));
+		smgr->drawAll();
+		driver->endScene();
+	}
+	return timer->getRealTime() - then;
+}
+
+//! Finds the node hit by a ray straight down onto a point of the grid
+ISceneNode* pick(ISceneManager* smgr, f32 x, f32 z)
+{
+	SCollisionHit hit;
+	return smgr->getSceneCollisionManager()->getSceneNodeAndCollisionPointFromRay(hit,
+		line3df(x, 100.f, z, x, -100.f, z));
+}
+
+} // end anonymous namespace
+
+/** A static batch node merges the geometry of mesh scene nodes into few
+clustered meshbuffers, draws them with few calls and still finds the merged
+nodes when picking. Also logs how long drawing the merged nodes takes compared
+to drawing the nodes themselves. */
+bool staticBatch(void)
+{
+	IrrlichtDevice * device = irr::createDevice(video::EDT_NULL, dimension2du(160, 120));
+	assert_log(device);
+	if (!device)
+		return false;
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+	ISceneManager* smgr = device->getSceneManager();
+	bool result = true;
+
+	IMesh* mesh = smgr->getGeometryCreator()->createCubeMesh(vector3df(2.f, 2.f, 2.f));
+	const u32 primitives = mesh->getMeshBuffer(0)->getIndexCount() / 3;
+
+	// a grid of cubes with two materials, the static ones are marked by their id
+	const u32 size = 64;
+	const s32 staticId = 1;
+	array<IMeshSceneNode*> nodes;
+	for (u32 i=0; i<size*size; ++i)
+	{
+		IMeshSceneNode* node = smgr->addMeshSceneNode(mesh, 0, (i < size*size-1) ? staticId : 2,
+			vector3df((i % size) * 4.f, 0.f, (i / size) * 4.f), vector3df(0.f, (f32)(i % 90), 0.f));
+		node->getMaterial(0).Lighting = (i % 2) == 0;
+		nodes.push_back(node);
+	}
+	// a child of a batched node
+	IMeshSceneNode* child = smgr->addMeshSceneNode(mesh, nodes[0], staticId, vector3df(0.f, 4.f, 0.f));
+
+	drawScene(device, 1);
+	result &= (driver->getFrameStats().DrawCalls == size*size+1);
+	const u32 allPrimitives = driver->getFrameStats().Primitives;
+	result &= (allPrimitives == (size*size+1)*primitives);
+
+	IStaticBatchSceneNode* batch = smgr->addStaticBatchSceneNode(0, -1, 64.f);
+	result &= (batch->getType() == ESNT_STATIC_BATCH);
+	result &= (batch->addNodes(smgr->getRootSceneNode(), staticId) == size*size);
+	result &= (batch->getNodeCount() == size*size);
+	result &= !nodes[0]->isVisible() && !child->isVisible() && nodes[size*size-1]->isVisible();
+	result &= !batch->addNode(nodes[0]);
+	result &= (batch->getMaterialCount() == 2);
+
+	// 4x4 cells with two materials
+	result &= (batch->getClusterCount() == 32);
+	result &= batch->getBoundingBox().isPointInside(vector3df((size-1) * 4.f, 0.f, (size-1) * 4.f));
+
+	// without a camera all clusters and the unbatched node are drawn
+	drawScene(device, 1);
+	result &= (batch->getVisibleClusterCount() == batch->getClusterCount());
+	result &= (driver->getFrameStats().DrawCalls == batch->getClusterCount()+1);
+	result &= (driver->getFrameStats().Primitives == allPrimitives);
+
+	// materials are set once for all their clusters, once for the unbatched
+	// node and once by the scene manager
+	result &= (driver->getFrameStats().MaterialChanges == 4);
+
+	// picking finds the batched nodes
+	result &= (pick(smgr, 0.f, 0.f) == child);
+	result &= (pick(smgr, 4.f, 8.f) == nodes[size*2+1]);
+	result &= (pick(smgr, 2.f, 2.f) == 0);
+
+	// clusters behind the camera are culled
+	smgr->addCameraSceneNode(0, vector3df(128.f, 10.f, 128.f), vector3df(128.f, 10.f, 300.f));
+	drawScene(device, 1);
+	result &= (batch->getVisibleClusterCount() > 0);
+	result &= (batch->getVisibleClusterCount() < batch->getClusterCount());
+
+	// removed nodes are drawn on their own again
+	result &= batch->removeNode(nodes[size*2+1]);
+	result &= !batch->removeNode(nodes[size*2+1]);
+	result &= nodes[size*2+1]->isVisible();
+	result &= (batch->getNodeCount() == size*size-1);
+	nodes[size*2+1]->setTriangleSelector(smgr->createTriangleSelectorFromBoundingBox(nodes[size*2+1]));
+	nodes[size*2+1]->getTriangleSelector()->drop();
+	result &= (pick(smgr, 4.f, 8.f) == nodes[size*2+1]);
+	result &= (pick(smgr, 0.f, 0.f) == child);
+	smgr->setActiveCamera(0);
+	drawScene(device, 1);
+	result &= (driver->getFrameStats().Primitives == allPrimitives);
+
+	// the geometry of the other nodes in the cluster is kept
+	result &= batch->removeNode(nodes[0]);
+	result &= batch->removeNode(child);
+	drawScene(device, 1);
+	result &= (driver->getFrameStats().Primitives == allPrimitives);
+	result &= (driver->getFrameStats().DrawCalls == batch->getClusterCount()+4);
+
+	const u32 frames = 10;
+	const u32 batchTime = drawScene(device, frames);
+	const u32 batchDrawCalls = driver->getFrameStats().DrawCalls;
+
+	batch->removeAllNodes();
+	result &= (batch->getNodeCount() == 0);
+	result &= (batch->getClusterCount() == 0);
+	result &= nodes[5]->isVisible();
+	const u32 nodesTime = drawScene(device, frames);
+	result &= (driver->getFrameStats().Primitives == allPrimitives);
+	result &= (driver->getFrameStats().DrawCalls == size*size+1);
+
+	logTestString("%u frames of %u cubes: batched %u ms with %u draw calls, nodes %u ms with %u draw calls\n",
+		frames, size*size+1, batchTime, batchDrawCalls, nodesTime, driver->getFrameStats().DrawCalls);
+
+	// batched nodes need not be children of the root
+	ISceneNode* parent = smgr->addEmptySceneNode();
+	parent->setPosition(vector3df(100.f, 0.f, 0.f));
+	IMeshSceneNode* moved = smgr->addMeshSceneNode(mesh, parent, staticId);
+	IStaticBatchSceneNode* batch2 = smgr->addStaticBatchSceneNode();
+	result &= batch2->addNode(moved);
+	result &= batch2->getBoundingBox().isPointInside(vector3df(100.f, 0.f, 0.f));
+	result &= (pick(smgr, 100.f, 0.f) == moved);
+
+	mesh->drop();
+
+	if (!result)
+		logTestString("staticBatch failed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
@@ -88,6 +88,85 @@ static bool selfShadowing(video::E_DRIVER_TYPE driverType)
 	return result;
 }
 
+//! Draws the scene and returns a screenshot of it
+static video::IImage* drawScene(IrrlichtDevice* device)
+{
+	device->getVideoDriver()->beginScene(video::ECBF_ALL, video::SColor(255,0,0,0));
+	device->getSceneManager()->drawAll();
+	device->getVideoDriver()->endScene();
+	return device->getVideoDriver()->createScreenShot();
+}
+
+// test that the shadow of a vertex animated mesh follows the animation
+static bool animatedShadow(video::E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice *device = createDevice (driverType, core::dimension2d<u32>(160,120), 16, false, true);
+	if (!device)
+		return true; // No error if device does not exist
+
+	scene::ISceneManager* smgr = device->getSceneManager();
+	if (!device->getVideoDriver()->queryFeature(video::EVDF_STENCIL_BUFFER))
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return true;
+	}
+
+	stabilizeScreenBackground(device->getVideoDriver());
+
+	smgr->setAmbientLight(video::SColorf(.5f,.5f,.5f));
+	smgr->setShadowColor(video::SColor(255, 50, 0, 50));
+
+	// only the floor the shadow falls on is visible
+	smgr->addCubeSceneNode(200, 0, -1, core::vector3df(0,70,0), core::vector3df(), core::vector3df(-1,-1,-1));
+
+	scene::IAnimatedMesh* mesh = smgr->getMesh("./media/sydney.md2");
+	scene::IAnimatedMeshSceneNode* node = smgr->addAnimatedMeshSceneNode(mesh);
+	node->addShadowVolumeSceneNode(0, -1, false, 1000.f);
+	node->setAnimationSpeed(0.f);
+
+	scene::ILightSceneNode* light = smgr->addLightSceneNode(0, core::vector3df(-100,100,0));
+	light->setLightType(video::ELT_POINT);
+	light->setRadius(1000.f);
+
+	smgr->addCameraSceneNode(0, core::vector3df(70,30,0), core::vector3df(70,-30,1));
+
+	// standing and lying on the ground
+	node->setCurrentFrame(0.f);
+	video::IImage* standing = drawScene(device);
+	node->setCurrentFrame((f32)(mesh->getFrameCount() - 60));
+	video::IImage* lying = drawScene(device);
+
+	u32 changed = 0;
+	if (standing && lying)
+	{
+		const core::dimension2du size = standing->getDimension();
+		for (u32 y=0; y<size.Height; ++y)
+		{
+			for (u32 x=0; x<size.Width; ++x)
+			{
+				if (standing->getPixel(x, y) != lying->getPixel(x, y))
+					++changed;
+			}
+		}
+	}
+	if (standing)
+		standing->drop();
+	if (lying)
+		lying->drop();
+
+	const bool result = (changed > 100);
+	if (!result)
+		logTestString("Shadow of animated mesh did not change with %ls\n", device->getVideoDriver()->getName());
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 bool stencilShadow(void)
 {
 	bool passed = true;
@@ -104,5 +183,9 @@ bool stencilShadow(void)
 //	passed &= selfShadowing(video::EDT_SOFTWARE);
 	passed &= selfShadowing(video::EDT_BURNINGSVIDEO);
 
+	passed &= animatedShadow(video::EDT_OPENGL);
+	passed &= animatedShadow(video::EDT_DIRECT3D9);
+	passed &= animatedShadow(video::EDT_BURNINGSVIDEO);
+
 	return passed;
 }
@@ -316,6 +316,81 @@ bool lockWithAutoMipmap(video::E_DRIVER_TYPE driverType)
 	return result;
 }
 
+//! Tests the box filter of the software mip levels and their update after a lock
+bool filterMipLevels(video::E_DRIVER_TYPE driverType)
+{
+	IrrlichtDevice *device = createDevice( driverType, dimension2d<u32>(160, 120), 32);
+	if (!device)
+		return true; // Treat a failure to create a driver as benign; this saves a lot of #ifdefs
+
+	video::IVideoDriver* driver = device->getVideoDriver();
+
+	logTestString("Testing driver %ls\n", driver->getName());
+
+	// textures named light are filtered without gamma, the 1x1 level is the plain average
+	const u32 texData[2*2] = { 0xffc86400, 0xff640028, 0xff003c14, 0xff281450 };
+	video::IImage* image = driver->createImageFromData(video::ECF_A8R8G8B8, core::dimension2du(2,2), (void*)texData, false);
+	video::ITexture* tex = driver->addTexture("lightmiptest", image);
+	image->drop();
+	if (!tex || tex->getColorFormat() != video::ECF_A8R8G8B8)
+	{
+		device->closeDevice();
+		device->run();
+		device->drop();
+		return true;
+	}
+
+	video::SColor* bits = (video::SColor*)tex->lock(video::ETLM_READ_ONLY, 1);
+	video::SColor* const level1 = bits;
+	bool result = bits && (bits[0].color==0xff552d23);
+	tex->unlock();
+	if (!result)
+		logTestString("2x2 to 1x1 average with driver %ls failed.\n", driver->getName());
+
+	// levels are refiltered in place after a change of level 0
+	bits = (video::SColor*)tex->lock(video::ETLM_READ_WRITE, 0);
+	if ( bits )
+	{
+		bits[0]=0xff000000;
+		bits[1]=0xff000000;
+		bits[2]=0xff0000c8;
+		bits[3]=0xff0000c8;
+	}
+	tex->unlock();
+	tex->regenerateMipMapLevels();
+	bits = (video::SColor*)tex->lock(video::ETLM_READ_ONLY, 1);
+	result &= (bits == level1) && bits && (bits[0].color==0xff000064);
+	tex->unlock();
+	if (!result)
+		logTestString("mip level update after lock with driver %ls failed.\n", driver->getName());
+
+	// opaque white stays opaque white at the borders of gamma corrected levels
+	u32 whiteData[4*4];
+	for (u32 i=0; i<4*4; ++i)
+		whiteData[i]=0xffffffff;
+	image = driver->createImageFromData(video::ECF_A8R8G8B8, core::dimension2du(4,4), whiteData, false);
+	tex = driver->addTexture("miptest", image);
+	image->drop();
+	for (u32 level=1; tex && level<3; ++level)
+	{
+		bits = (video::SColor*)tex->lock(video::ETLM_READ_ONLY, level);
+		const u32 count = (4>>level)*(4>>level);
+		for (u32 i=0; bits && i<count; ++i)
+			result &= (bits[i].color==0xffffffff);
+		tex->unlock();
+	}
+	if (!result)
+		logTestString("gamma corrected mip levels with driver %ls failed.\n", driver->getName());
+	else
+		logTestString("Passed\n");
+
+	device->closeDevice();
+	device->run();
+	device->drop();
+
+	return result;
+}
+
 //! Tests locking
 bool lockCubemapTexture(video::E_DRIVER_TYPE driverType)
 {
@@ -450,6 +525,7 @@ bool textureFeatures(void)
 	TestWithAllDrivers(lockAllMipLevels);
 	TestWithAllDrivers(lockWithAutoMipmap);
 	TestWithAllDrivers(lockCubemapTexture);
+	result &= filterMipLevels(video::EDT_BURNINGSVIDEO);
 
 	return result;
 }